@@ -7,6 +7,8 @@
 
 #include "dg/algorithm.h"
 #include "file/nc_utilities.h"
+#include "file/async_writer.h"
+#include "file/record_reader.h"
 #include "geometries/geometries.h"
 #include "feltor/parameters.h"
 
@@ -85,7 +87,6 @@ int main( int argc, char* argv[])
     dg::HVec transfer1d = dg::evaluate(dg::zero,g1d_out);
     //read in midplane of electrons, ions Ue, Ui, and potential, and energy
     std::string names[5] = {"electrons", "ions", "Ue", "Ui", "potential"}; 
-    int dataIDs[5];
 
     std::string names2d[13] = {"Ne_avg", "Ni_avg", "Ue_avg", "Ui_avg", "phi_avg","dNe_mp", "dNi_mp", "dUe_mp", "dUi_mp", "dphi_mp","vor_avg","Depsi_avg","Lperpinv_avg"}; 
     int dataIDs2d[13];
@@ -101,13 +102,11 @@ int main( int argc, char* argv[])
     for( unsigned i=0; i<13; i++){
         err2d = nc_def_var( ncid2d, names2d[i].data(), NC_DOUBLE, 3, dim_ids, &dataIDs2d[i]);
     }   
-    err2d = nc_close(ncid2d);
+    err2d = nc_enddef( ncid2d);
 
     //midplane 2d fields
     size_t count2d[3]  = {1, g3d_out.n()*g3d_out.Ny(), g3d_out.n()*g3d_out.Nx()};
     size_t start2d[3]  = {0, 0, 0};
-    size_t count3d[4]  = {1, g3d_out.Nz(), g3d_out.n()*g3d_out.Ny(), g3d_out.n()*g3d_out.Nx()};
-    size_t start3d[4]  = {0, 0, 0, 0};
     //size_t count3dp[4] = {1, 1, g3d_out.n()*g3d_out.Ny(), g3d_out.n()*g3d_out.Nx()};
 //     size_t start3dp[4] = {0, 0, 0, 0};
 
@@ -129,7 +128,7 @@ int main( int argc, char* argv[])
     size_t count1d[2] = {1, g1d_out.n()*g1d_out.N()};
     size_t start1d[2] = {0, 0};
 
-    err1d = nc_close(ncid1d);
+    err1d = nc_enddef( ncid1d);
     double time=0.;
 
 //     double energy_0 =0.,U_i_0=0.,U_e_0=0.,U_phi_0=0.,U_pare_0=0.,U_pari_0=0.,mass_0=0.;
@@ -148,6 +147,9 @@ int main( int argc, char* argv[])
     dg::DVec vor3d    = dg::evaluate( dg::zero, g3d_out);
     dg::Elliptic<dg::CylindricalGrid3d, dg::DMatrix, dg::DVec> laplacian(g3d_out,dg::DIR, dg::DIR, dg::normed, dg::centered); 
     dg::IDMatrix fsaonrzmatrix,fsaonrzphimatrix;     
+    //the flux surface average of any 2d field on g1d_out is one sparse matrix-vector product
+    dg::IDMatrix fsamatrix = dg::geo::create::flux_surface_average( g2d_out, c, g1d_out);
+    dg::DVec data1dfsa = dg::evaluate( dg::zero, g1d_out);
     fsaonrzmatrix    =  dg::create::interpolation(psipupilog2d ,g1d_out);    
     fsaonrzphimatrix =  dg::create::interpolation(psipupilog3d ,g1d_out);    
     
@@ -173,7 +175,6 @@ int main( int argc, char* argv[])
 #ifdef GRADIENTLENGTH
     dg::DVec Lperpinv3d =  dg::evaluate(dg::zero , g3d_out) ;   
 #endif
-    std::vector<dg::HVec> fields3d_h(5,dg::evaluate(dg::zero,g3d_out));
     std::vector<dg::DVec> fields3d(5,dg::evaluate(dg::zero,g3d_out));
     std::vector<dg::DVec> fields2d(5,dg::evaluate(dg::zero,g3d_out));
     unsigned outlim = 0.; int timeID;
@@ -184,15 +185,19 @@ int main( int argc, char* argv[])
     steps-=1;
     outlim = steps/p.itstp;
     dg::Average<dg::DVec> toroidal_average( g3d_out, dg::coo3d::z);
+    //the input file stays open and the next records are read while the current one is processed
+    file::RecordReader reader( ncid, std::vector<std::string>( names, names+5));
+    reader.schedule( 0, outlim);
+    //the output files stay open and are written on a background thread
+    file::AsyncWriter writer2d( ncid2d), writer1d( ncid1d);
+    //the records are processed one after the other (not with file::for_each_record)
+    //since the analysis uses dg::DVec library calls, which must not run inside its parallel loop
     for( unsigned i=0; i<outlim; i++)//timestepping
     {
-//      start3dp[0] = i; //set specific time  
-        start3d[0] = i; //set specific time  
         start2d[0] = i;
         start1d[0] = i;
         time += p.itstp*p.dt;
-        err2d = nc_open(argv[3], NC_WRITE, &ncid2d);
-        err1d = nc_open(argv[2], NC_WRITE, &ncid1d);
+        std::vector<dg::HVec> fields3d_h = reader.take( i);
 
         std::cout << "Timestep = " << i << "  time = " << time << "\n";
 
@@ -212,10 +217,6 @@ int main( int argc, char* argv[])
             data2dfsa = dg::evaluate( dg::zero, g2d_out);    
 
             //get 3d data
-            err = nc_open( argv[1], NC_NOWRITE, &ncid); //open 3d file
-            err = nc_inq_varid(ncid, names[j].data(), &dataIDs[j]);
-            err = nc_get_vara_double( ncid, dataIDs[j], start3d, count3d, fields3d_h[j].data());
-            err = nc_close(ncid);  //close 3d file
             fields3d[j] = fields3d_h[j];
     
             //get 2d data and sum up for avg
@@ -228,20 +229,19 @@ int main( int argc, char* argv[])
             //for fluctuations to be  f_varphi
 //             dg::blas1::axpby(1.0,data2dflucmid,-1.0,data2davg,data2dflucmid); //Compute z fluctuation
             dg::blas1::transfer(data2davg,transfer2d);            
-            err2d = nc_put_vara_double( ncid2d, dataIDs2d[j],   start2d, count2d, transfer2d.data()); //write avg
+            writer2d.put_vara( dataIDs2d[j],   start2d, count2d, transfer2d); //write avg
 
 
             //computa fsa of quantities
-            dg::geo::FluxSurfaceAverage<dg::DVec> fsadata(g2d_out,c, data2davg );
-            dg::DVec data1dfsa = dg::evaluate(fsadata,g1d_out);
+            dg::blas2::gemv( fsamatrix, data2davg, data1dfsa);
             dg::blas1::transfer(data1dfsa,transfer1d);
-            err1d = nc_put_vara_double( ncid1d, dataIDs1d[j], start1d, count1d,  transfer1d.data());
+            writer1d.put_vara( dataIDs1d[j], start1d, count1d,  transfer1d);
             
             //compute delta f on midplane : df = f_mp - <f>
             dg::blas2::gemv(fsaonrzmatrix, data1dfsa, data2dfsa); //fsa on RZ grid
             dg::blas1::axpby(1.0,data2dflucmid,-1.0,data2dfsa,data2dflucmid); 
             dg::blas1::transfer(data2dflucmid,transfer2d);     
-            err2d = nc_put_vara_double( ncid2d, dataIDs2d[j+5], start2d, count2d, transfer2d.data());
+            writer2d.put_vara( dataIDs2d[j+5], start2d, count2d, transfer2d);
 
         }
         //----------------Start vorticity computation
@@ -249,11 +249,10 @@ int main( int argc, char* argv[])
         toroidal_average(vor3d,vor2davg,false);
         dg::blas1::transfer(vor2davg,transfer2d);     
 
-        err2d = nc_put_vara_double( ncid2d, dataIDs2d[10],   start2d, count2d, transfer2d.data());
-        dg::geo::FluxSurfaceAverage<dg::DVec> fsavor(g2d_out,c, vor2davg );
-        dg::DVec vor1dfsa = dg::evaluate(fsavor,g1d_out);
-        dg::blas1::transfer(vor1dfsa,transfer1d);
-        err1d = nc_put_vara_double( ncid1d, dataIDs1d[6], start1d, count1d,  transfer1d.data()); 
+        writer2d.put_vara( dataIDs2d[10],   start2d, count2d, transfer2d);
+        dg::blas2::gemv( fsamatrix, vor2davg, data1dfsa);
+        dg::blas1::transfer(data1dfsa,transfer1d);
+        writer1d.put_vara( dataIDs1d[6], start1d, count1d,  transfer1d); 
         //----------------Stop vorticity computation
         
         //--------------- Start RADIALELECTRONDENSITYFLUX computation
@@ -285,8 +284,8 @@ int main( int argc, char* argv[])
       
         toroidal_average(Depsip3d,Depsip2davg,false);
 
-        dg::geo::FluxSurfaceAverage<dg::DVec> fsaDepsip(g2d_out,c, Depsip2davg );
-        dg::DVec  Depsip1Dfsa = dg::evaluate(fsaDepsip,g1d_out);
+        dg::DVec  Depsip1Dfsa = data1dfsa;
+        dg::blas2::gemv( fsamatrix, Depsip2davg, Depsip1Dfsa);
         //compute delta f on midplane : d Depsip2d = Depsip - <Depsip>       
         dg::blas2::gemv(fsaonrzphimatrix, Depsip1Dfsa , Depsip3dfluc ); //fsa on RZ grid
         dg::blas1::axpby(1.0,Depsip3d,-1.0, Depsip3dfluc, Depsip3dfluc); 
@@ -296,11 +295,10 @@ int main( int argc, char* argv[])
 //         transfer2d = Depsip2dflucavg;
         //toroidal avg
         transfer2d = Depsip2davg;
-        err2d = nc_put_vara_double( ncid2d, dataIDs2d[11],   start2d, count2d, transfer2d.data());
-        dg::geo::FluxSurfaceAverage< dg::DVec> fsaDepsipfluc(g2d_out,c, Depsip2dflucavg );
-        dg::DVec  Depsip1Dflucfsa = dg::evaluate(fsaDepsipfluc,g1d_out);
-        transfer1d =Depsip1Dflucfsa;
-        err1d = nc_put_vara_double( ncid1d, dataIDs1d[7], start1d, count1d,   transfer1d.data()); 
+        writer2d.put_vara( dataIDs2d[11],   start2d, count2d, transfer2d);
+        dg::blas2::gemv( fsamatrix, Depsip2dflucavg, data1dfsa);
+        transfer1d = data1dfsa;
+        writer1d.put_vara( dataIDs1d[7], start1d, count1d,   transfer1d); 
 //         std::cout << "Depsip =" << dg::blas2::dot(psipupilog3d,w3d, Depsip3dfluc) << std::endl;
         #endif
         //STOP RADIALELECTRONDENSITYFLUX
@@ -310,24 +308,21 @@ int main( int argc, char* argv[])
         dg::blas1::transform(temp2, Lperpinv3d, dg::SQRT<double>()); // |(nabla_perp N)|
         toroidal_average(Lperpinv3d,Lperpinv2davg,false);
         transfer2d = Lperpinv2davg;
-        err2d = nc_put_vara_double( ncid2d, dataIDs2d[12],   start2d, count2d, transfer2d.data());
-        dg::geo::FluxSurfaceAverage< dg::DVec> fsaLperpinv(g2d_out,c, Lperpinv2davg );
-        dg::DVec  Lperpinv1Dfsa = dg::evaluate(fsaLperpinv,g1d_out);
-        transfer1d =Lperpinv1Dfsa;
-        err1d = nc_put_vara_double( ncid1d, dataIDs1d[8], start1d, count1d,   transfer1d.data()); 
+        writer2d.put_vara( dataIDs2d[12],   start2d, count2d, transfer2d);
+        dg::blas2::gemv( fsamatrix, Lperpinv2davg, data1dfsa);
+        transfer1d = data1dfsa;
+        writer1d.put_vara( dataIDs1d[8], start1d, count1d,   transfer1d); 
 //         std::cout << "Lperpinv=" <<dg::blas2::dot(psipupilog3d,w3d, Lperpinv3d) << std::endl;
         #endif
         
         //put safety factor into file
         dg::blas1::transfer(sf,transfer1d);
-        err1d = nc_put_vara_double( ncid1d, dataIDs1d[5], start1d, count1d,  transfer1d.data());
+        writer1d.put_vara( dataIDs1d[5], start1d, count1d,  transfer1d);
         dg::blas1::transfer(abs,transfer1d);
-        err1d = nc_put_vara_double( ncid1d, dataIDs1d[9], start1d, count1d, transfer1d.data());
+        writer1d.put_vara( dataIDs1d[9], start1d, count1d, transfer1d);
         //write time data
-        err1d = nc_put_vara_double( ncid1d, tvarID1d, start1d, count1d, &time);
-        err1d = nc_close(ncid1d);  //close 1d netcdf files
-        err2d = nc_put_vara_double( ncid2d, tvarID, start2d, count2d, &time);
-        err2d = nc_close(ncid2d); //close 2d netcdf files
+        writer1d.put_var1( tvarID1d, i, time);
+        writer2d.put_var1( tvarID, i, time);
       
 //         //Probe 
 //         const dg::DVec Rprobe(1,gp.R_0+p.boxscaleRm*gp.a*0.8);
@@ -347,6 +342,11 @@ int main( int argc, char* argv[])
         
         
     } //end timestepping
+    writer1d.flush();
+    writer2d.flush();
+    err1d = nc_close(ncid1d);
+    err2d = nc_close(ncid2d);
+    err = nc_close(ncid);
     //cross coherence between phi and ne
     //relative fluctuation amplitude(R,Z,phi) = delta n(R,Z,phi)/n0(psi)
     
@@ -8,6 +8,8 @@
 #include "dg/algorithm.h"
 
 #include "file/nc_utilities.h"
+#include "file/async_writer.h"
+#include "file/record_reader.h"
 #include "toefl/parameters.h"
 // #include "probes.h"
 
@@ -90,18 +92,13 @@ int main( int argc, char* argv[])
     dg::ArakawaX< dg::CartesianGrid2d, dg::DMatrix, dg::DVec> arakawa( g2d); 
     double time = 0.;
     //2d field
-    size_t count2d[3]  = {1, g2d.n()*g2d.Ny(), g2d.n()*g2d.Nx()};
-    size_t start2d[3]  = {0, 0, 0};
-    std::string names[3] = {"electrons", "ions", "potential"}; 
-    int dataIDs[3];
+    std::vector<std::string> names = {"electrons", "ions", "potential"};
   
     std::vector<dg::DVec> npe(2, dg::evaluate(dg::zero,g2d));
     std::vector<dg::DVec> ntilde(2, dg::evaluate(dg::zero,g2d));
     std::vector<dg::DVec> lnn(2, dg::evaluate(dg::zero,g2d));
     dg::DVec phi(dg::evaluate(dg::zero,g2d));
     //dg::DVec vor(dg::evaluate(dg::zero,g2d));
-    std::vector<dg::HVec> npe_h(2,dg::evaluate(dg::zero,g2d));
-    dg::HVec phi_h(dg::evaluate(dg::zero,g2d));
     //dg::HVec vor_h(dg::evaluate(dg::zero,g2d));
     dg::DVec xvec = dg::evaluate( dg::cooX2d, g2d);
     dg::DVec yvec = dg::evaluate( dg::cooY2d, g2d);
@@ -126,8 +123,6 @@ int main( int argc, char* argv[])
     double velX,velY,velX_old=0. , velY_old=0.;    
     double accX,accY=0.;
     double deltaT = p.dt*p.itstp;
-    size_t count0d[1]  = {1};
-    size_t start0d[1]  = {0};    
     //size_t count1d[2]  = {1, g2d.n()*g2d.Nx()};
     //size_t start1d[2]  = {0, 0};    
     //1d netcdf output file    
@@ -171,23 +166,23 @@ int main( int argc, char* argv[])
     //-----------------Start timestepping
     err = nc_open( argv[1], NC_NOWRITE, &ncid);   
     err_out = nc_open( argv[2], NC_WRITE, &ncid_out);
-    for( unsigned i=0; i<=p.maxout; i++)
+    //the next records are read and the results are written on background threads
+    file::RecordReader reader( ncid, names);
+    //the file may contain fewer outputs than p.maxout+1 (e.g. if the simulation was stopped)
+    const size_t num_records = std::min<size_t>( p.maxout+1, reader.size());
+    reader.schedule( 0, num_records);
+    file::AsyncWriter writer( ncid_out);
+    //the records are processed one after the other (not with file::for_each_record)
+    //since the analysis uses dg::DVec library calls, which must not run inside its parallel loop
+    for( unsigned i=0; i<num_records; i++)
     {
-        start2d[0] = i;
-        //start1d[0] = i;
-        start0d[0] = i;
-
-
+        std::vector<dg::HVec> record = reader.take( i);
         for (unsigned j=0;j<2;j++)
         {
-            err = nc_inq_varid(ncid, names[j].data(), &dataIDs[j]);
-            err = nc_get_vara_double( ncid, dataIDs[j], start2d, count2d, npe_h[j].data());
-            npe[j] = npe_h[j];
+            npe[j] = record[j];
             dg::blas1::plus(npe[j], 1);
         }
-        err = nc_inq_varid(ncid, names[2].data(), &dataIDs[2]);
-        err = nc_get_vara_double( ncid, dataIDs[2], start2d, count2d, phi_h.data());
-        phi = phi_h;
+        phi = record[2];
         //err = nc_inq_varid(ncid, names[5].data(), &dataIDs[5]);
         //err = nc_get_vara_double( ncid, dataIDs[5], start2d, count2d, vor_h.data());
         //vor = vor_h;
@@ -223,22 +218,22 @@ int main( int argc, char* argv[])
         }
 
         
-       err_out = nc_put_vara_double( ncid_out, namescomID[16], start0d, count0d, &mass_);
-       err_out = nc_put_vara_double( ncid_out, namescomID[0], start0d, count0d, &posX);
-       err_out = nc_put_vara_double( ncid_out, namescomID[1], start0d, count0d, &posY);
-       err_out = nc_put_vara_double( ncid_out, namescomID[2], start0d, count0d, &velX);
-       err_out = nc_put_vara_double( ncid_out, namescomID[3], start0d, count0d, &velY);
-       err_out = nc_put_vara_double( ncid_out, namescomID[4], start0d, count0d, &accX);
-       err_out = nc_put_vara_double( ncid_out, namescomID[5], start0d, count0d, &accY);
-       err_out = nc_put_vara_double( ncid_out, namescomID[11], start0d, count0d, &velCOM);
-       //err_out = nc_put_vara_double( ncid_out, timevarID, start0d, count0d, &time);
-       err_out = nc_put_vara_double( ncid_out, tvarID1d, start0d, count0d, &time);         
+       writer.put_var1( namescomID[16], i, mass_);
+       writer.put_var1( namescomID[0], i, posX);
+       writer.put_var1( namescomID[1], i, posY);
+       writer.put_var1( namescomID[2], i, velX);
+       writer.put_var1( namescomID[3], i, velY);
+       writer.put_var1( namescomID[4], i, accX);
+       writer.put_var1( namescomID[5], i, accY);
+       writer.put_var1( namescomID[11], i, velCOM);
+       //writer.put_var1( timevarID, i, time);
+       writer.put_var1( tvarID1d, i, time);         
        double maxamp;
        if ( p.amp > 0)
            maxamp = *thrust::max_element( npe[0].begin(), npe[0].end());
        else
            maxamp = *thrust::min_element( npe[0].begin(), npe[0].end());
-       err_out = nc_put_vara_double( ncid_out, namescomID[12], start0d, count0d, &maxamp);
+       writer.put_var1( namescomID[12], i, maxamp);
        
        //get max position and value(x,y_max) of electron density
         dg::blas2::gemv( equi, npe[0], helper);
@@ -248,8 +243,8 @@ int main( int argc, char* argv[])
         posX_max_hs = hx*(1./2. + (double)(position%Nx));
         posY_max_hs = hy*(1./2. + (double)(position/Nx));
 //         std::cout << "posXmax "<<posX_max<<" posYmax "<<posY_max << std::endl;
-        err_out = nc_put_vara_double( ncid_out, namescomID[6], start0d, count0d, &posX_max);
-        err_out = nc_put_vara_double( ncid_out, namescomID[7], start0d, count0d, &posY_max);      
+        writer.put_var1( namescomID[6], i, posX_max);
+        writer.put_var1( namescomID[7], i, posY_max);      
         velX_max = (posX_max - posX_max_old)/deltaT;
         velY_max = (posY_max - posY_max_old)/deltaT;
         if( i==0) std::cout << "COM: t = "<< time << " amp :" << maxamp << " X_init :" << posX_init << " Y_init :" << posY_init << "\n";
@@ -258,8 +253,8 @@ int main( int argc, char* argv[])
         if (i>0){
             posX_max_old = posX_max; posY_max_old = posY_max;
         }  
-        err_out = nc_put_vara_double( ncid_out, namescomID[8], start0d, count0d, &velX_max);
-        err_out = nc_put_vara_double( ncid_out, namescomID[9], start0d, count0d, &velY_max);      
+        writer.put_var1( namescomID[8], i, velX_max);
+        writer.put_var1( namescomID[9], i, velY_max);      
 //         std::cout << "maxval "<<*thrust::max_element( helper.begin(), helper.end())<< std::endl;        
         //Compute interpolation matrix for 1d field    
         //dg::HVec y0coone(dg::evaluate(dg::CONSTANT(posY_max_hs ),g1d));
@@ -280,7 +275,7 @@ int main( int argc, char* argv[])
         heavy = dg::evaluate( heavi, g2d);
 //         std::cout <<std::scientific<< dg::blas2::dot( heavy, w2d, npe[0])/normalize << std::endl;
         compactness_ne =  dg::blas2::dot( heavy, w2d, ntilde[0])/normalize ;
-        err_out = nc_put_vara_double( ncid_out, namescomID[10], start0d, count0d, &compactness_ne);            
+        writer.put_var1( namescomID[10], i, compactness_ne);            
         /////////////////BLOB energetics/////////////////
         double Ue, Ui, Uphi;
         for( unsigned j=0; j<2; j++)
@@ -298,11 +293,12 @@ int main( int argc, char* argv[])
             Ui = 0.5*p.tau*dg::blas2::dot( ntilde[1], w2d, ntilde[1]);
             Uphi = 0.5*dg::blas2::dot( one, w2d, helper); 
         }
-        err_out = nc_put_vara_double( ncid_out, namescomID[13], start0d, count0d, &Ue);            
-        err_out = nc_put_vara_double( ncid_out, namescomID[14], start0d, count0d, &Ui);            
-        err_out = nc_put_vara_double( ncid_out, namescomID[15], start0d, count0d, &Uphi); 
+        writer.put_var1( namescomID[13], i, Ue);            
+        writer.put_var1( namescomID[14], i, Ui);            
+        writer.put_var1( namescomID[15], i, Uphi); 
 
     }
+    writer.flush();
     err_out = nc_close(ncid_out);
     err = nc_close(ncid);
     
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include "backend/exceptions.h"
+#include "runge_kutta.h"
+#include "multistep.h"
+
+/*! @file
+  @brief contains the adaptive timestep control for embedded time-integrators
+  */
+namespace dg{
+
+/**
+ * @brief Adaptive timestepping with an embedded method and a PI step-size controller
+ *
+ * Each step is computed by the embedded method \c Stepper, which returns the
+ * solution of the higher order together with the difference to the embedded lower order solution \f$ \delta\f$.
+ * The step is accepted if the error
+ * \f[ \epsilon = \frac{||\delta||}{\epsilon_{abs} + \epsilon_{rel}||u^{n+1}||} \leq 1 \f]
+ * and repeated with a smaller timestep otherwise.
+ * The next timestep is chosen by the PI controller (Gustafsson, Hairer & Wanner, Solving ODEs II)
+ * \f[ \Delta t^{n+1} = 0.9 \Delta t^n \epsilon_n^{-0.7/q} \epsilon_{n-1}^{0.4/q} \f]
+ * where \f$ q\f$ is the order of the embedded method plus one; the timestep grows at most by a factor 5 and shrinks at most by a factor 5 per step.
+ * The norm is the discrete l2-norm \f$ ||\delta|| = \sqrt{\delta\cdot\delta}\f$ (\c dg::blas1::dot).
+ *
+@code
+    dg::Adaptive< dg::EmbeddedRK<dg::dormand_prince, dg::DVec> > adaptive( y0);
+    double time = 0, dt = 1e-3; //dt is only a first guess
+    while( time < T)
+    {
+        adaptive.integrate( rhs, time, y0, time+deltaT, y0, dt, 1e-6, 1e-10);
+        time += deltaT;
+        //... output
+    }
+@endcode
+ * The ImEx method \c ARK is used in the same way with an explicit and an implicit part:
+@snippet multistep_t.cu adaptive
+ * @ingroup time
+ * @tparam Stepper \c EmbeddedRK or \c ARK
+ */
+template<class Stepper>
+struct Adaptive
+{
+    using container_type = typename Stepper::container_type;
+    using real_type = typename Stepper::real_type;
+    ///@copydoc RK_opt::RK_opt()
+    Adaptive(){}
+    /**
+     * @brief Construct the stepper and reserve internal workspace
+     *
+     * @param copyable container_type of the size that is used in \c step
+     * @param ps further parameters that are forwarded to the constructor of \c Stepper (e.g. \c max_iter and \c eps for \c ARK)
+     */
+    template<class ...StepperParams>
+    Adaptive( const container_type& copyable, StepperParams&& ...ps): m_stepper( copyable, std::forward<StepperParams>(ps)...),
+        m_u1( copyable), m_delta( copyable){ }
+    ///@brief Access the underlying stepper
+    Stepper& stepper(){ return m_stepper;}
+    ///@brief Access the underlying stepper
+    const Stepper& stepper() const{ return m_stepper;}
+    ///@brief Number of accepted steps so far
+    unsigned nsteps() const{ return m_nsteps;}
+    ///@brief Number of rejected steps so far
+    unsigned nrejected() const{ return m_nrejected;}
+    ///@brief Normalized error of the last accepted step
+    real_type last_error() const{ return m_err_old;}
+
+    /**
+     * @brief Make one accepted step with an explicit method
+     *
+     * The step is repeated with smaller timesteps until the error is acceptable
+     * @copydoc hide_rhs
+     * @param rhs right hand side subroutine
+     * @param t (read and write) start time on input, end time on output
+     * @param u (read and write) value at \c t on input, solution at the new \c t on output
+     * @param dt (read and write) timestep to try first on input, recommended next timestep on output
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     * @return the timestep that was actually made
+     * @throw dg::Error if the timestep cannot be reduced any further or the error is not finite after repeated attempts
+     */
+    template<class RHS>
+    real_type step( RHS& rhs, real_type& t, container_type& u, real_type& dt, real_type rtol, real_type atol)
+    {
+        return adaptive_step( [&]( real_type t0, const container_type& u0, real_type& t1, container_type& u1, real_type h, container_type& delta){
+                m_stepper.step( rhs, t0, u0, t1, u1, h, delta);}, t, u, dt, rtol, atol);
+    }
+    /**
+     * @brief Make one accepted step with an ImEx method
+     *
+     * The step is repeated with smaller timesteps until the error is acceptable
+     * @copydoc hide_explicit_implicit
+     * @param t (read and write) start time on input, end time on output
+     * @param u (read and write) value at \c t on input, solution at the new \c t on output
+     * @param dt (read and write) timestep to try first on input, recommended next timestep on output
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     * @return the timestep that was actually made
+     * @throw dg::Error if the timestep cannot be reduced any further or the error is not finite after repeated attempts
+     */
+    template<class Explicit, class Implicit>
+    real_type step( Explicit& exp, Implicit& imp, real_type& t, container_type& u, real_type& dt, real_type rtol, real_type atol)
+    {
+        return adaptive_step( [&]( real_type t0, const container_type& u0, real_type& t1, container_type& u1, real_type h, container_type& delta){
+                m_stepper.step( exp, imp, t0, u0, t1, u1, h, delta);}, t, u, dt, rtol, atol);
+    }
+    /**
+     * @brief Integrate with an explicit method from \c t0 to exactly \c t1
+     *
+     * The last step is shortened to hit \c t1; the recommended timestep is kept for the next call.
+     * @copydoc hide_rhs
+     * @param rhs right hand side subroutine
+     * @param t0 start time
+     * @param u0 value at \c t0
+     * @param t1 end time (may alias \c t0, may be smaller than \c t0 to integrate backwards)
+     * @param u1 (write only) contains solution at \c t1 on output (may alias \c u0)
+     * @param dt (read and write) first timestep to try on input (0 means \c t1-t0), recommended next timestep on output
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     */
+    template<class RHS>
+    void integrate( RHS& rhs, real_type t0, const container_type& u0, const real_type& t1, container_type& u1, real_type& dt, real_type rtol, real_type atol)
+    {
+        integrate_to( [&]( real_type& t, container_type& u, real_type& h){
+                step( rhs, t, u, h, rtol, atol);}, t0, u0, t1, u1, dt);
+    }
+    /**
+     * @brief Integrate with an ImEx method from \c t0 to exactly \c t1
+     *
+     * The last step is shortened to hit \c t1; the recommended timestep is kept for the next call.
+     * @copydoc hide_explicit_implicit
+     * @param t0 start time
+     * @param u0 value at \c t0
+     * @param t1 end time (may alias \c t0, may be smaller than \c t0 to integrate backwards)
+     * @param u1 (write only) contains solution at \c t1 on output (may alias \c u0)
+     * @param dt (read and write) first timestep to try on input, recommended next timestep on output
+     * @param rtol relative tolerance
+     * @param atol absolute tolerance
+     */
+    template<class Explicit, class Implicit>
+    void integrate( Explicit& exp, Implicit& imp, real_type t0, const container_type& u0, const real_type& t1, container_type& u1, real_type& dt, real_type rtol, real_type atol)
+    {
+        integrate_to( [&]( real_type& t, container_type& u, real_type& h){
+                step( exp, imp, t, u, h, rtol, atol);}, t0, u0, t1, u1, dt);
+    }
+    private:
+    template<class StepFunction>
+    void integrate_to( StepFunction do_step, real_type t0, const container_type& u0, const real_type& t1, container_type& u1, real_type& dt)
+    {
+        real_type t_end = t1; //t1 may alias t0
+        dg::blas1::copy( u0, u1);
+        //integrate backwards if t_end < t0
+        const real_type direction = t_end < t0 ? -1. : 1.;
+        if( dt == 0)
+            dt = t_end - t0;
+        dt = direction*fabs( dt);
+        while( direction*( t_end - t0) > 0)
+        {
+            bool last = direction*( t0 + dt - t_end) >= 0;
+            real_type h = last ? t_end - t0 : dt;
+            unsigned rejected = m_nrejected;
+            do_step( t0, u1, h);
+            if( last && rejected == m_nrejected)
+                t0 = t_end; //avoid an additional tiny step due to round-off
+            else
+                dt = h; //do not let the shortened last step reduce dt
+        }
+    }
+    template<class StepFunction>
+    real_type adaptive_step( StepFunction do_step, real_type& t, container_type& u, real_type& dt, real_type rtol, real_type atol)
+    {
+        const real_type q = (real_type)m_stepper.embedded_order() + 1;
+        for( unsigned rejected=0; rejected<100; rejected++)
+        {
+            real_type t1;
+            do_step( t, u, t1, m_u1, dt, m_delta);
+            real_type err = sqrt( dg::blas1::dot( m_delta, m_delta))/
+                ( atol + rtol*sqrt( dg::blas1::dot( m_u1, m_u1)));
+            if( err <= 1)
+            {
+                //accept and compute next timestep with PI controller
+                real_type factor = 5.;
+                if( err > 0)
+                    factor = 0.9*pow( err, -0.7/q)*pow( m_err_old, 0.4/q);
+                factor = std::min( std::max( factor, (real_type)0.2), m_rejected_last ? (real_type)1 : (real_type)5);
+                m_err_old = std::max( err, (real_type)1e-4);
+                m_rejected_last = false;
+                m_nsteps++;
+                real_type dt_made = t1 - t;
+                t = t1;
+                u.swap( m_u1);
+                dt = dt_made*factor;
+                return dt_made;
+            }
+            //reject and try again with smaller timestep
+            m_nrejected++;
+            m_rejected_last = true;
+            real_type factor = std::isfinite( err) ? 0.9*pow( err, -1./q) : 0.2;
+            dt *= std::min( std::max( factor, (real_type)0.2), (real_type)0.9);
+            if( t + dt == t)
+                break;
+        }
+        throw dg::Error( dg::Message(_ping_)<<"Adaptive timestep failed at time "<<t<<" with timestep "<<dt<<"!");
+    }
+    Stepper m_stepper;
+    container_type m_u1, m_delta;
+    real_type m_err_old = 1e-4;
+    bool m_rejected_last = false;
+    unsigned m_nsteps = 0, m_nrejected = 0;
+};
+
+/**
+ * @brief Integrate a differential equation to a given accuracy with an embedded Runge-Kutta scheme and adaptive timestep
+ *
+ * In contrast to \c integrateRK the integration is done in a single pass: the
+ * local error of each step is estimated by the embedded method and the timestep
+ * is chosen by the \c Adaptive controller such that
+ * \f$ ||\delta|| \leq \epsilon_{abs}\f$ in every step.
+ * The same controller can integrate forward and backward in time.
+ * @attention \c eps_abs bounds the local error of each step and not, as in \c integrateRK,
+ * the global error at \c t_end. The local errors accumulate over the steps, such that the global error
+ * is typically larger (at most by the number of steps, given by the return value) and a call that replaces \c integrateRK
+ * needs a correspondingly smaller \c eps_abs to reach the same accuracy.
+@code
+    std::array<double,2> begin{ {1,0} }, end;
+    dg::integrateERK<dg::dormand_prince>( rhs, 0., begin, 2.*M_PI, end, 1e-10);
+@endcode
+ * @ingroup time
+ * @tparam Tableau one of \c bogacki_shampine, \c cash_karp or \c dormand_prince
+ * @copydoc hide_rhs
+ * @copydoc hide_ContainerType
+ * @param rhs The right-hand-side
+ * @param t_begin initial time
+ * @param begin initial condition
+ * @param t_end final time (may be smaller than \c t_begin)
+ * @param end (write-only) contains solution at \c t_end on output (may alias begin)
+ * @param eps_abs desired accuracy of each step in the l2-norm (local error)
+ * @param dt_init first timestep to try (0 means \c t_end-t_begin)
+ * @return number of accepted steps if converged, -2 and a warning to \c std::cerr if the timestep cannot be reduced any further (e.g. because \c isnan appears)
+ */
+template<template<class> class Tableau, class RHS, class ContainerType>
+int integrateERK( RHS& rhs, get_value_type<ContainerType> t_begin, const ContainerType& begin, get_value_type<ContainerType> t_end, ContainerType& end, get_value_type<ContainerType> eps_abs, get_value_type<ContainerType> dt_init = 0)
+{
+    using real_type = get_value_type<ContainerType>;
+    if( t_end == t_begin){ dg::blas1::copy( begin, end); return 0;}
+    Adaptive<EmbeddedRK<Tableau, ContainerType> > adaptive( begin);
+    real_type dt = dt_init;
+    try{
+        adaptive.integrate( rhs, t_begin, begin, t_end, end, dt, 0., eps_abs);
+    }
+    catch( dg::Error& err)
+    {
+        std::cerr << "ATTENTION: Runge Kutta failed to converge. "<<err.what()<<std::endl;
+        return -2;
+    }
+    return adaptive.nsteps();
+}
+
+} //namespace dg
@@ -6,6 +6,7 @@
  * @note include <mpi.h> before this header to activate mpi support
  */
 #include "backend/timer.h"
+#include "backend/profiler.h"
 #include "backend/transpose.h"
 #include "geometry/split_and_join.h"
 #include "geometry/xspacelib.h"
@@ -18,10 +19,12 @@
 #include "blas.h"
 #include "helmholtz.h"
 #include "cg.h"
+#include "chebyshev.h"
 #include "functors.h"
 #include "multistep.h"
 #include "elliptic.h"
 #include "runge_kutta.h"
+#include "adaptive.h"
 #include "multigrid.h"
 #include "refined_elliptic.h"
 #include "arakawa.h"
@@ -6,6 +6,10 @@
 #include "enums.h"
 #include "geometry/evaluation.h"
 #include "geometry/derivatives.h"
+#include "backend/arakawa_cpu.h"
+#ifdef _OPENMP
+#include "backend/arakawa_omp.h"
+#endif
 #ifdef MPI_VERSION
 #include "geometry/mpi_derivatives.h"
 #include "geometry/mpi_evaluation.h"
@@ -17,6 +21,60 @@
   */
 namespace dg
 {
+///@cond
+namespace detail{
+//host copies of the derivatives for the matrix-free bracket
+//(only available for shared vectors on the host)
+template<class ContainerType>
+struct ArakawaFusion
+{
+    using value_type = get_value_type<ContainerType>;
+    using policy = get_execution_policy<ContainerType>;
+    //the fused kernel exists only for shared vectors on the host
+    static constexpr bool host = std::is_base_of<SharedVectorTag, get_tensor_category<ContainerType>>::value && (
+        std::is_same<policy, SerialTag>::value
+#ifdef _OPENMP
+        || std::is_same<policy, OmpTag>::value
+#endif //_OPENMP
+        );
+    ArakawaFusion():m_available(false){}
+    template<class MatrixType>
+    void construct( const MatrixType&, const MatrixType&){
+        m_available = false;
+    }
+    void construct( const EllSparseBlockMat<value_type>& dx, const EllSparseBlockMat<value_type>& dy)
+    {
+        m_available = false;
+        if( !host) //do not keep copies that are never used
+            return;
+        m_dx = dx, m_dy = dy;
+        m_available = dx.right_size == 1 && dx.left_size == dy.left_size*dy.num_rows*dy.n
+            && dx.num_rows*dx.n == dy.right_size && dx.num_rows == dx.num_cols && dy.num_rows == dy.num_cols
+            && dx.n == dy.n && dy.n <= 6 && dx.blocks_per_line <= 4 && dy.blocks_per_line <= 4;
+    }
+    //return false if the matrix-free version is not available
+    bool apply( const SparseElement<ContainerType>& vol, const ContainerType& lhs, const ContainerType& rhs, ContainerType& result) const
+    {
+        if( !m_available)
+            return false;
+        return doApply( vol, lhs, rhs, result, std::integral_constant<bool, host>());
+    }
+    private:
+    bool doApply( const SparseElement<ContainerType>&, const ContainerType&, const ContainerType&, ContainerType&, std::false_type) const{
+        return false;
+    }
+    bool doApply( const SparseElement<ContainerType>& vol, const ContainerType& lhs, const ContainerType& rhs, ContainerType& result, std::true_type) const
+    {
+        ell_arakawa( policy(), m_dx, m_dy, vol.isSet() ? thrust::raw_pointer_cast( vol.value().data()) : nullptr,
+            thrust::raw_pointer_cast( lhs.data()), thrust::raw_pointer_cast( rhs.data()), thrust::raw_pointer_cast( result.data()));
+        return true;
+    }
+    EllSparseBlockMat<value_type> m_dx, m_dy;
+    bool m_available;
+};
+}//namespace detail
+///@endcond
+
 //citation missing in documentation
 /**
  * @brief X-space generalized version of Arakawa's scheme
@@ -53,6 +111,11 @@ struct ArakawaX
      * @param rhs rights hand side in x-space
      * @param result Poisson's bracket in x-space
      * @note memops: 25 reads; 9 writes (+ 2 reads and 1 write, if geometry is nontrivial)
+     * @note If the vectors are shared and reside on the host (\c SerialTag or \c OmpTag)
+     * the bracket is evaluated matrix-free in a single sweep over the grid, which
+     * reduces the memops to 2 reads and 1 write (+ 1 read if geometry is nontrivial);
+     * the result is binary identical to the one of the separate application of the matrices
+     * @attention \c result may not alias \c lhs or \c rhs
      */
     void operator()( const container& lhs, const container& rhs, container& result);
 
@@ -93,27 +156,26 @@ struct ArakawaX
     Matrix bdxf, bdyf;
     SparseElement<container> perp_vol_inv_;
     SparseTensor<container> metric_;
+    detail::ArakawaFusion<container> fusion_;
 };
 ///@cond
 template<class Geometry, class Matrix, class container>
 ArakawaX<Geometry, Matrix, container>::ArakawaX( const Geometry& g ):
-    dxlhs( dg::transfer<container>(dg::evaluate( one, g)) ), dxrhs(dxlhs), dylhs(dxlhs), dyrhs( dxlhs), helper_( dxlhs),
-    bdxf( dg::create::dx( g, g.bcx())),
-    bdyf( dg::create::dy( g, g.bcy()))
+    ArakawaX( g, g.bcx(), g.bcy())
 {
-    metric_=g.metric().perp();
-    perp_vol_inv_ = dg::tensor::determinant(metric_);
-    dg::tensor::sqrt(perp_vol_inv_);
 }
 template<class Geometry, class Matrix, class container>
 ArakawaX<Geometry, Matrix, container>::ArakawaX( const Geometry& g, bc bcx, bc bcy):
-    dxlhs( dg::transfer<container>(dg::evaluate( one, g)) ), dxrhs(dxlhs), dylhs(dxlhs), dyrhs( dxlhs), helper_( dxlhs),
-    bdxf(dg::create::dx( g, bcx)),
-    bdyf(dg::create::dy( g, bcy))
+    dxlhs( dg::transfer<container>(dg::evaluate( one, g)) ), dxrhs(dxlhs), dylhs(dxlhs), dyrhs( dxlhs), helper_( dxlhs)
 {
     metric_=g.metric().perp();
     perp_vol_inv_ = dg::tensor::determinant(metric_);
     dg::tensor::sqrt(perp_vol_inv_);
+    auto dx = dg::create::dx( g, bcx);
+    auto dy = dg::create::dy( g, bcy);
+    dg::blas2::transfer( dx, bdxf);
+    dg::blas2::transfer( dy, bdyf);
+    fusion_.construct( dx, dy);
 }
 
 template<class T>
@@ -140,11 +202,11 @@ struct ArakawaFunctor
 template< class Geometry, class Matrix, class container>
 void ArakawaX< Geometry, Matrix, container>::operator()( const container& lhs, const container& rhs, container& result)
 {
+    if( fusion_.apply( perp_vol_inv_, lhs, rhs, result))
+        return;
     //compute derivatives in x-space
-    blas2::symv( bdxf, lhs, dxlhs);
-    blas2::symv( bdyf, lhs, dylhs);
-    blas2::symv( bdxf, rhs, dxrhs);
-    blas2::symv( bdyf, rhs, result);
+    blas2::symv( bdxf, {&lhs, &rhs}, {&dxlhs, &dxrhs});
+    blas2::symv( bdyf, {&lhs, &rhs}, {&dylhs, &result});
     blas1::subroutine( ArakawaFunctor<get_value_type<container>>(), lhs, rhs, dxlhs, dylhs, dxrhs, result);
 
     //blas1::pointwiseDot( 1./3., dxlhs, dyrhs, -1./3., dylhs, dxrhs, 0., result);
@@ -61,6 +61,19 @@ double jacobian( double x, double y)
 }
 */
 
+//the same sequence of operations as ArakawaX::operator() without fusion
+dg::HVec arakawa_generic( const dg::CartesianGrid2d& g, const dg::HVec& lhs, const dg::HVec& rhs)
+{
+    dg::HMatrix bdxf = dg::create::dx( g, g.bcx()), bdyf = dg::create::dy( g, g.bcy());
+    dg::HVec dxlhs( lhs), dxrhs( lhs), dylhs( lhs), result( lhs);
+    dg::blas2::symv( bdxf, {&lhs, &rhs}, {&dxlhs, &dxrhs});
+    dg::blas2::symv( bdyf, {&lhs, &rhs}, {&dylhs, &result});
+    dg::blas1::subroutine( dg::ArakawaFunctor<double>(), lhs, rhs, dxlhs, dylhs, dxrhs, result);
+    dg::blas2::symv( 1., bdxf, dylhs, 1., result);
+    dg::blas2::symv( 1., bdyf, dxrhs, 1., result);
+    return result;
+}
+
 int main()
 {
     std::cout<<"This program tests the execution of the arakawa scheme! A test is passed if the number in the second column shows exactly zero!\n";
@@ -111,6 +124,22 @@ int main()
     dg::blas1::axpby( 1., variation, -1., jac);
     res.d = sqrt( dg::blas2::dot( w2d, jac));
     std::cout << "Variation distance   "<<res.d<<"\t"<<res.i-binary[4]<<std::endl; //don't forget sqrt when comuting errors
+    std::cout << "Number of elements that differ between the matrix-free bracket on the host\n"
+              << "and the separate application of the matrices (must be exactly zero!)\n";
+    for( unsigned k=1; k<=5; k+=2)
+    {
+        const dg::CartesianGrid2d g2d( 0, lx, 0, ly, k, 20, 24, dg::DIR, bcy);
+        const dg::HVec l = dg::evaluate( left, g2d), r = dg::evaluate( right, g2d);
+        dg::HVec fused( l);
+        dg::ArakawaX<dg::CartesianGrid2d, dg::HMatrix, dg::HVec> host_arakawa( g2d);
+        host_arakawa( l, r, fused);
+        const dg::HVec generic = arakawa_generic( g2d, l, r);
+        unsigned number = 0;
+        for( unsigned i=0; i<fused.size(); i++)
+            if( fused[i] != generic[i])
+                number++;
+        std::cout << "    n = "<<k<<": "<<number<<"\n";
+    }
     std::cout << "\nContinue with geometry/average_t.cu !\n\n";
     return 0;
 }
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "config.h"
+#include "execution_policy.h"
+#include "sparseblockmat_strip.h"
+
+namespace dg
+{
+///@cond
+namespace detail{
+
+//compute dx lhs, dx rhs and (dx lhs rhs - lhs dx rhs)/3 on the strip key
+template<class value_type, int n>
+void ell_arakawa_strip( const EllSparseBlockMat<value_type>& dx, int key, int size, int L,
+        const value_type* RESTRICT lhs, const value_type* RESTRICT rhs,
+        value_type* RESTRICT dxlhs, value_type* RESTRICT dxrhs, value_type* RESTRICT c)
+{
+    for( int k=0; k<size; k++)
+        dxlhs[k] = dxrhs[k] = 0;
+    for( int k=0; k<n; k++)
+    {
+        const int I = key*size + k*L;
+        ell_line_multiply<value_type, n>( dx, value_type(1), lhs+I, dxlhs+k*L);
+        ell_line_multiply<value_type, n>( dx, value_type(1), rhs+I, dxrhs+k*L);
+    }
+    const value_type* l = lhs + key*size;
+    const value_type* r = rhs + key*size;
+    for( int k=0; k<size; k++)
+    {
+        value_type temp = value_type(0);
+        temp = DG_FMA(  (1./3.)*dxlhs[k], r[k], temp);
+        temp = DG_FMA( -(1./3.)*l[k], dxrhs[k], temp);
+        c[k] = temp;
+    }
+}
+
+template<class value_type, int n>
+void ell_arakawa_kernel( const EllSparseBlockMat<value_type>& dx, const EllSparseBlockMat<value_type>& dy,
+        const value_type* RESTRICT vol,
+        const value_type* RESTRICT lhs, const value_type* RESTRICT rhs, value_type* RESTRICT result,
+        int strip_begin, int strip_end)
+{
+    const int L = dy.right_size, Ny = dy.num_rows;
+    const int size = n*L;
+    //each strip in the ring holds (dx lhs rhs - lhs dx rhs)/3, dx lhs and dx rhs
+    StripRing<value_type> ring( 3, size);
+    auto entry = [&]( int key)
+    {
+        int slot = ring.find( key);
+        if( slot == -1)
+        {
+            slot = ring.insert( key);
+            ell_arakawa_strip<value_type, n>( dx, key, size, L, lhs, rhs,
+                    ring.get( slot, 1), ring.get( slot, 2), ring.get( slot, 0));
+        }
+        return slot;
+    };
+    thrust::host_vector<value_type> buffer( 2*size + L);
+    value_type* dylhs = thrust::raw_pointer_cast( buffer.data());
+    value_type* dyrhs = dylhs + size;
+    value_type* line  = dylhs + 2*size;
+    for( int si = strip_begin; si<strip_end; si++)
+    {
+        const int p = si/Ny, i = si%Ny;
+        const value_type* lp = lhs + p*Ny*size;
+        const value_type* rp = rhs + p*Ny*size;
+        for( int k=0; k<size; k++)
+            dylhs[k] = dyrhs[k] = 0;
+        ell_strip_multiply<value_type, n>( dy, i, value_type(1), lp, dylhs);
+        ell_strip_multiply<value_type, n>( dy, i, value_type(1), rp, dyrhs);
+        //result = (dx lhs dy rhs - dy lhs dx rhs)/3 + dx( (lhs dy rhs - dy lhs rhs)/3 )
+        {
+            const int slot = entry( si);
+            const value_type* dxlhs = ring.get( slot, 1);
+            const value_type* dxrhs = ring.get( slot, 2);
+            for( int k=0; k<n; k++)
+            {
+                const int I = si*size + k*L;
+                for( int j=0; j<L; j++)
+                {
+                    const int K = k*L+j;
+                    value_type temp = value_type(0);
+                    temp = DG_FMA(  (1./3.)*dxlhs[K], dyrhs[K], temp);
+                    temp = DG_FMA( -(1./3.)*dylhs[K], dxrhs[K], temp);
+                    result[I+j] = temp;
+                    temp = value_type(0);
+                    temp = DG_FMA(  (1./3.)*lhs[I+j], dyrhs[K], temp);
+                    temp = DG_FMA( -(1./3.)*dylhs[K], rhs[I+j], temp);
+                    line[j] = temp;
+                }
+                ell_line_multiply<value_type, n>( dx, value_type(1), line, result+I);
+            }
+        }
+        //result += dy( (dx lhs rhs - lhs dx rhs)/3 ), block by block
+        //(each block is summed separately and then added as in ell_multiply_kernel)
+        value_type* rs = result + si*size;
+        for( int d=0; d<dy.blocks_per_line; d++)
+        {
+            const int c = dy.cols_idx[i*dy.blocks_per_line+d];
+            const value_type* g = ring.get( entry( p*Ny+c), 0);
+            const value_type* data = &dy.data[dy.data_idx[i*dy.blocks_per_line+d]*n*n];
+            for( int k=0; k<n; k++)
+            {
+                value_type a[n];
+                for( int q=0; q<n; q++)
+                    a[q] = data[k*n+q];
+#ifndef _MSC_VER
+#pragma omp SIMD
+#endif
+                for( int j=0; j<L; j++)
+                {
+                    value_type temp = value_type(0);
+                    for( int q=0; q<n; q++)
+                        temp = DG_FMA( a[q], g[q*L+j], temp);
+                    rs[k*L+j] = DG_FMA( value_type(1), temp, rs[k*L+j]);
+                }
+            }
+        }
+        if( vol != nullptr)
+            for( int k=0; k<size; k++)
+                rs[k] *= vol[si*size+k];
+    }
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Matrix-free evaluation of Arakawa's scheme
+ *
+ * Computes \f[ r = v\left( \frac{1}{3}(\partial_x l\partial_y r - \partial_y l \partial_x r)
+ * + \frac{1}{3}\partial_x( l\partial_y r - \partial_y l r) + \frac{1}{3}\partial_y( \partial_x l r - l\partial_x r)\right)\f]
+ * in one sweep over the block rows (strips of \c n lines) in y-direction.
+ * The x-derivatives and the last flux of the neighboring strips are kept in a small ring buffer
+ * such that only \c lhs, \c rhs and \c vol are read and only \c result is written.
+ * The order of operations is the same as in the separate application of the matrices
+ * in \c dg::ArakawaX such that the result is binary identical.
+ * @param dx centered derivative in x (\c right_size==1)
+ * @param dy centered derivative in y (\c right_size is the line length)
+ * @param vol the inverse perpendicular volume element multiplying the result, may be \c nullptr (then 1 is assumed)
+ * @param lhs left hand side
+ * @param rhs right hand side
+ * @param result output (may not alias lhs or rhs)
+ * @param strip_begin first strip (plane*num_rows+row of dy) to compute
+ * @param strip_end one past the last strip to compute
+ * @attention only \c n<=6 and \c blocks_per_line<=4 are supported
+ */
+template<class value_type>
+void ell_arakawa_kernel( const EllSparseBlockMat<value_type>& dx, const EllSparseBlockMat<value_type>& dy,
+        const value_type* RESTRICT vol,
+        const value_type* RESTRICT lhs, const value_type* RESTRICT rhs, value_type* RESTRICT result,
+        int strip_begin, int strip_end)
+{
+    switch( dy.n)
+    {
+        case 1: detail::ell_arakawa_kernel<value_type, 1>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+        case 2: detail::ell_arakawa_kernel<value_type, 2>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+        case 3: detail::ell_arakawa_kernel<value_type, 3>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+        case 4: detail::ell_arakawa_kernel<value_type, 4>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+        case 5: detail::ell_arakawa_kernel<value_type, 5>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+        case 6: detail::ell_arakawa_kernel<value_type, 6>( dx, dy, vol, lhs, rhs, result, strip_begin, strip_end); break;
+    }
+}
+
+///@cond
+template<class value_type>
+void ell_arakawa( SerialTag, const EllSparseBlockMat<value_type>& dx, const EllSparseBlockMat<value_type>& dy,
+        const value_type* vol, const value_type* lhs, const value_type* rhs, value_type* result)
+{
+    ell_arakawa_kernel( dx, dy, vol, lhs, rhs, result, 0, dy.left_size*dy.num_rows);
+}
+///@endcond
+
+}//namespace dg
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <omp.h>
+#include "arakawa_cpu.h"
+
+namespace dg
+{
+///@cond
+template<class value_type>
+void ell_arakawa( OmpTag, const EllSparseBlockMat<value_type>& dx, const EllSparseBlockMat<value_type>& dy,
+        const value_type* vol, const value_type* lhs, const value_type* rhs, value_type* result)
+{
+    const int num_strips = dy.left_size*dy.num_rows;
+    //every thread computes a contiguous chunk of strips such that the ring buffer is reused
+    auto chunk = [&]()
+    {
+        int begin, end;
+        detail::omp_strip_range( num_strips, begin, end);
+        ell_arakawa_kernel( dx, dy, vol, lhs, rhs, result, begin, end);
+    };
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel
+        {
+            chunk();
+        }
+        return;
+    }
+    //we are in an enclosing parallel region: x may have been written by other threads
+    #pragma omp barrier
+    chunk();
+    #pragma omp barrier
+}
+///@endcond
+
+}//namespace dg
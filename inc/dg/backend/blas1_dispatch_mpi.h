@@ -59,9 +59,7 @@ std::vector<int64_t> doDot_superacc( const Vector1& x, const Vector2& y, MPIVect
     std::vector<int64_t> receive(exblas::BIN_COUNT, (int64_t)0);
     //get communicator from MPIVector
     auto comm = get_idx<vector_idx>(x,y).communicator();
-    auto comm_mod = get_idx<vector_idx>(x,y).communicator_mod();
-    auto comm_red = get_idx<vector_idx>(x,y).communicator_mod_reduce();
-    exblas::reduce_mpi_cpu( 1, acc.data(), receive.data(), comm, comm_mod, comm_red);
+    exblas::allreduce_mpi_cpu( 1, acc.data(), receive.data(), comm);
     return receive;
 }
 
@@ -16,7 +16,17 @@ template<class PointerOrValue1, class PointerOrValue2>
 inline std::vector<int64_t> doDot_dispatch( OmpTag, unsigned size, PointerOrValue1 x_ptr, PointerOrValue2 y_ptr) {
     std::vector<int64_t> h_superacc(exblas::BIN_COUNT);
     if(size<MIN_SIZE)
+    {
+        if(omp_in_parallel()) //make the writes of the other threads visible
+        {
+            #pragma omp barrier
+        }
         exblas::exdot_cpu( size, x_ptr,y_ptr, &h_superacc[0]);
+        if(omp_in_parallel()) //the other threads may write x and y in the next (nowait) call
+        {
+            #pragma omp barrier
+        }
+    }
     else
         exblas::exdot_omp( size, x_ptr,y_ptr, &h_superacc[0]);
     return h_superacc;
@@ -25,7 +35,17 @@ template<class PointerOrValue1, class PointerOrValue2, class PointerOrValue3>
 inline std::vector<int64_t> doDot_dispatch( OmpTag, unsigned size, PointerOrValue1 x_ptr, PointerOrValue2 y_ptr, PointerOrValue3 z_ptr) {
     std::vector<int64_t> h_superacc(exblas::BIN_COUNT);
     if(size<MIN_SIZE)
+    {
+        if(omp_in_parallel()) //make the writes of the other threads visible
+        {
+            #pragma omp barrier
+        }
         exblas::exdot_cpu( size, x_ptr,y_ptr,z_ptr, &h_superacc[0]);
+        if(omp_in_parallel()) //the other threads may write x and y in the next (nowait) call
+        {
+            #pragma omp barrier
+        }
+    }
     else
         exblas::exdot_omp( size, x_ptr,y_ptr,z_ptr, &h_superacc[0]);
     return h_superacc;
@@ -34,7 +54,9 @@ inline std::vector<int64_t> doDot_dispatch( OmpTag, unsigned size, PointerOrValu
 template< class Subroutine, class PointerOrValue, class ...PointerOrValues>
 inline void doSubroutine_omp( int size, Subroutine f, PointerOrValue x, PointerOrValues... xs)
 {
-#pragma omp for nowait
+//a static schedule assigns the same indices to the same thread in every call
+//such that consecutive calls inside a parallel region need no barrier
+#pragma omp for schedule(static) nowait
     for( int i=0; i<size; i++)
         //f(x[i], xs[i]...);
         //f(thrust::raw_reference_cast(*(x+i)), thrust::raw_reference_cast(*(xs+i))...);
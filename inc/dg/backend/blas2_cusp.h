@@ -7,11 +7,13 @@
 
 #include <typeinfo>
 #include <limits.h>
+#include <vector>
 #include <cusp/multiply.h>
 #include <cusp/convert.h>
 #include <cusp/array1d.h>
 
 #include "config.h"
+#include "exceptions.h"
 #include "tensor_traits.h"
 
 ///@cond
@@ -115,6 +117,125 @@ inline void doSymv( Matrix&& m,
         doSymv( std::forward<Matrix>(m), x[i], y[i], CuspMatrixTag(), get_tensor_category<inner_container>());
 }
 
+//apply row i of a csr matrix to K vectors at once, the indices and values of the row are read from memory once
+template<class index_type, class value_type>
+inline void doSymv_csr_batch_row( value_type alpha,
+    const index_type* RESTRICT row_ptr, const index_type* RESTRICT col_ptr, const value_type* RESTRICT val_ptr,
+    unsigned K, const value_type* const * x_ptr, value_type beta, value_type* const * y_ptr, int i)
+{
+    for( unsigned v=0; v<K; v++)
+    {
+        const value_type* RESTRICT xv = x_ptr[v];
+        value_type temp = 0.;
+        for (index_type jj = row_ptr[i]; jj < row_ptr[i+1]; jj++)
+            temp += val_ptr[jj]*xv[col_ptr[jj]];
+        if( alpha == (value_type)1 && beta == (value_type)0)
+            y_ptr[v][i] = temp;
+        else
+            y_ptr[v][i] = DG_FMA( alpha, temp, beta*y_ptr[v][i]);
+    }
+}
+
+template< class Matrix, class Container1, class Container2>
+inline void doSymv_cusp_batch_dispatch( get_value_type<Container1> alpha,
+                    Matrix&& m,
+                    const std::vector<const Container1*>& x,
+                    get_value_type<Container1> beta,
+                    const std::vector<Container2*>& y,
+                    cusp::csr_format,
+                    SerialTag)
+{
+    typedef typename std::decay<Matrix>::type::index_type index_type;
+    using value_type = get_value_type<Container1>;
+    const unsigned K = x.size();
+    std::vector<const value_type*> x_ptr( K);
+    std::vector<value_type*> y_ptr( K);
+    for( unsigned v=0; v<K; v++)
+    {
+        x_ptr[v] = thrust::raw_pointer_cast( x[v]->data());
+        y_ptr[v] = thrust::raw_pointer_cast( y[v]->data());
+    }
+    const value_type* val_ptr = thrust::raw_pointer_cast( m.values.data());
+    const index_type* row_ptr = thrust::raw_pointer_cast( m.row_offsets.data());
+    const index_type* col_ptr = thrust::raw_pointer_cast( m.column_indices.data());
+    const int rows = m.num_rows;
+    for(int i = 0; i < rows; i++)
+        doSymv_csr_batch_row( alpha, row_ptr, col_ptr, val_ptr, K, x_ptr.data(), beta, y_ptr.data(), i);
+}
+
+#ifdef _OPENMP
+template< class Matrix, class Container1, class Container2>
+inline void doSymv_cusp_batch_dispatch( get_value_type<Container1> alpha,
+                    Matrix&& m,
+                    const std::vector<const Container1*>& x,
+                    get_value_type<Container1> beta,
+                    const std::vector<Container2*>& y,
+                    cusp::csr_format,
+                    OmpTag)
+{
+    typedef typename std::decay<Matrix>::type::index_type index_type;
+    using value_type = get_value_type<Container1>;
+    const unsigned K = x.size();
+    std::vector<const value_type*> x_ptr( K);
+    std::vector<value_type*> y_ptr( K);
+    for( unsigned v=0; v<K; v++)
+    {
+        x_ptr[v] = thrust::raw_pointer_cast( x[v]->data());
+        y_ptr[v] = thrust::raw_pointer_cast( y[v]->data());
+    }
+    const value_type* val_ptr = thrust::raw_pointer_cast( m.values.data());
+    const index_type* row_ptr = thrust::raw_pointer_cast( m.row_offsets.data());
+    const index_type* col_ptr = thrust::raw_pointer_cast( m.column_indices.data());
+    const int rows = m.num_rows;
+    #pragma omp parallel for
+    for(int i = 0; i < rows; i++)
+        doSymv_csr_batch_row( alpha, row_ptr, col_ptr, val_ptr, K, x_ptr.data(), beta, y_ptr.data(), i);
+}
+#endif// _OPENMP
+
+//on the device and for other formats apply the matrix to one vector after the other
+template< class Matrix, class Container1, class Container2>
+inline void doSymv_cusp_batch_dispatch( get_value_type<Container1> alpha,
+                    Matrix&& m,
+                    const std::vector<const Container1*>& x,
+                    get_value_type<Container1> beta,
+                    const std::vector<Container2*>& y,
+                    cusp::sparse_format,
+                    AnyPolicyTag)
+{
+    if( alpha != (get_value_type<Container1>)1 || beta != (get_value_type<Container1>)0)
+        throw Error( Message(_ping_)<<"cusp matrices can only compute y = M x!");
+    for( unsigned v=0; v<x.size(); v++)
+        doSymv_cusp_dispatch( std::forward<Matrix>(m), *x[v], *y[v],
+            typename std::decay<Matrix>::type::format(),
+            get_execution_policy<Container1>());
+}
+
+template< class Matrix, class Vector1, class Vector2>
+inline void doSymv_batch( get_value_type<Vector1> alpha,
+                    Matrix&& m,
+                    const std::vector<const Vector1*>& x,
+                    get_value_type<Vector1> beta,
+                    const std::vector<Vector2*>& y,
+                    CuspMatrixTag,
+                    ThrustVectorTag  )
+{
+    static_assert( std::is_same< get_execution_policy<Vector1>, get_execution_policy<Vector2> >::value, "Execution policies must be equal!");
+    if( x.size() != y.size()) {
+        throw Error( Message(_ping_)<<"Number of inputs "<<x.size()<<" and outputs "<<y.size()<<" differ!");
+    }
+#ifdef DG_DEBUG
+    for( unsigned v=0; v<x.size(); v++)
+    {
+        assert( m.num_rows == y[v]->size() );
+        assert( m.num_cols == x[v]->size() );
+    }
+#endif //DG_DEBUG
+    doSymv_cusp_batch_dispatch( alpha, std::forward<Matrix>(m), x, beta, y,
+            typename std::decay<Matrix>::type::format(),
+            get_execution_policy<Vector1>());
+}
+
 } //namespace detail
 } //namespace blas2
 } //namespace dg
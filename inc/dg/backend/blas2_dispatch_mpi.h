@@ -36,9 +36,7 @@ inline std::vector<int64_t> doDot_superacc( const Vector1& x, const Matrix& m, c
     std::vector<int64_t> receive(exblas::BIN_COUNT, (int64_t)0);
     //get communicator from MPIVector
     auto comm = get_idx<vector_idx>(x,y).communicator();
-    auto comm_mod = get_idx<vector_idx>(x,y).communicator_mod();
-    auto comm_red = get_idx<vector_idx>(x,y).communicator_mod_reduce();
-    exblas::reduce_mpi_cpu( 1, acc.data(), receive.data(), comm, comm_mod, comm_red);
+    exblas::allreduce_mpi_cpu( 1, acc.data(), receive.data(), comm);
     return receive;
 }
 template< class Vector1, class Matrix, class Vector2 >
@@ -54,7 +52,7 @@ inline std::vector<int64_t> doDot_superacc( const Vector1& x, const Matrix& m, c
         m.data(),
         do_get_data(y, get_tensor_category<Vector2>()));
     std::vector<int64_t> receive(exblas::BIN_COUNT, (int64_t)0);
-    exblas::reduce_mpi_cpu( 1, acc.data(), receive.data(), m.communicator(), m.communicator_mod(), m.communicator_mod_reduce());
+    exblas::allreduce_mpi_cpu( 1, acc.data(), receive.data(), m.communicator());
 
     return receive;
 }
@@ -166,6 +164,19 @@ inline void doSymv( get_value_type<Vector1> alpha,
         dg::blas2::symv( alpha, std::forward<Matrix>(m), x[i], beta, y[i]);
 }
 
+template< class Matrix, class Vector1, class Vector2>
+inline void doSymv_batch( get_value_type<Vector1> alpha,
+                Matrix&& m,
+                const std::vector<const Vector1*>& x,
+                get_value_type<Vector1> beta,
+                const std::vector<Vector2*>& y,
+                MPIMatrixTag,
+                MPIVectorTag
+                )
+{
+    m.symv( alpha, x, beta, y);
+}
+
 
 } //namespace detail
 } //namespace blas2
@@ -1,5 +1,6 @@
 #ifndef _DG_BLAS_SPARSEBLOCKMAT_
 #define _DG_BLAS_SPARSEBLOCKMAT_
+#include <vector>
 #include "tensor_traits.h"
 #include "tensor_traits.h"
 #include "sparseblockmat.h"
@@ -118,6 +119,38 @@ inline void doSymv(
     doSymv( 1., std::forward<Matrix>(m), x, 0., y, SparseBlockMatrixTag());
 }
 
+template< class Matrix, class Vector1, class Vector2>
+inline void doSymv_batch(
+              get_value_type<Vector1> alpha,
+              Matrix&& m,
+              const std::vector<const Vector1*>& x,
+              get_value_type<Vector1> beta,
+              const std::vector<Vector2*>& y,
+              SparseBlockMatrixTag,
+              SharedVectorTag)
+{
+    using value_type = get_value_type<Vector1>;
+    if( x.size() != y.size()) {
+        throw Error( Message(_ping_)<<"Number of inputs "<<x.size()<<" and outputs "<<y.size()<<" differ!");
+    }
+    std::vector<const value_type*> x_ptr( x.size());
+    std::vector<value_type*> y_ptr( y.size());
+    for( unsigned v=0; v<x.size(); v++)
+    {
+        int size_x = x[v]->size();
+        int size_y = y[v]->size();
+        if( size_x != m.total_num_cols()) {
+            throw Error( Message(_ping_)<<"x["<<v<<"] has the wrong size "<<size_x<<" and not "<<m.total_num_cols());
+        }
+        if( size_y != m.total_num_rows()) {
+            throw Error( Message(_ping_)<<"y["<<v<<"] has the wrong size "<<size_y<<" and not "<<m.total_num_rows());
+        }
+        x_ptr[v] = thrust::raw_pointer_cast(x[v]->data());
+        y_ptr[v] = thrust::raw_pointer_cast(y[v]->data());
+    }
+    m.symv( SharedVectorTag(), get_execution_policy<Vector1>(), alpha, x.size(), x_ptr.data(), beta, y_ptr.data());
+}
+
 } //namespace detail
 } //namespace blas2
 } //namespace dg
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "exblas/accumulate.h"
+#ifdef MPI_VERSION
+#include <mpi.h>
+#include "exblas/mpi_accumulate.h"
+#endif //MPI_VERSION
+
+/*!@file
+ *
+ * @brief contains the handle of an asynchronous scalar product
+ */
+namespace dg
+{
+
+/**
+ * @brief Handle to one or more binary reproducible scalar products whose global reduction may still be in progress
+ *
+ * Returned by \c dg::blas1::async_dot and \c dg::blas2::async_dot. The process-local
+ * parts of the scalar products are computed when the handle is created; with MPI the
+ * global reduction of the superaccumulators is a non-blocking \c MPI_Iallreduce, such that
+ * work that does not depend on the result can be done before calling \c get():
+ * @code
+dg::DotFuture future = dg::blas1::async_dot( r, r);
+dg::blas2::symv( A, p, Ap); //overlaps with the reduction
+double rr = future.get();
+ * @endcode
+ * For shared memory vectors the result is available immediately.
+ * @note the handle can be moved but not copied; its destructor waits for the reduction to finish
+ * @ingroup blas1
+ */
+struct DotFuture
+{
+    ///@brief Empty handle
+    DotFuture(){}
+    /**
+     * @brief Handle to already reduced superaccumulators
+     *
+     * @param num number of scalar products
+     * @param acc \c num superaccumulators (size \c num*exblas::BIN_COUNT)
+     */
+    DotFuture( unsigned num, std::vector<int64_t> acc): m_num( num), m_out( std::move(acc)){}
+#ifdef MPI_VERSION
+    /**
+     * @brief Initiate the reduction of process-local superaccumulators
+     *
+     * @param num number of scalar products
+     * @param acc \c num process-local superaccumulators (size \c num*exblas::BIN_COUNT)
+     * @param comm the communicator of all participating processes
+     */
+    DotFuture( unsigned num, std::vector<int64_t> acc, MPI_Comm comm): m_num( num), m_in( std::move(acc)), m_out( m_in.size())
+    {
+        exblas::iallreduce_mpi_cpu( m_num, m_in.data(), m_out.data(), comm, &m_request);
+    }
+#endif //MPI_VERSION
+    DotFuture( const DotFuture&) = delete;
+    DotFuture& operator=( const DotFuture&) = delete;
+    ///@brief Take over the (possibly unfinished) reduction of \c src
+    DotFuture( DotFuture&& src){
+        *this = std::move( src);
+    }
+    ///@brief Wait for the current reduction and take over the (possibly unfinished) reduction of \c src
+    DotFuture& operator=( DotFuture&& src){
+        if( this == &src) return *this;
+        wait();
+        //moving a std::vector keeps its buffer, so the pending communication is unaffected
+        m_num = src.m_num, m_in.swap( src.m_in), m_out.swap( src.m_out);
+#ifdef MPI_VERSION
+        m_request = src.m_request;
+        src.m_request = MPI_REQUEST_NULL;
+#endif //MPI_VERSION
+        return *this;
+    }
+    ~DotFuture(){ wait();}
+
+    ///@brief Number of scalar products in the handle
+    unsigned size() const{ return m_num;}
+    ///@brief Return true if the reduction has finished (does not block)
+    bool ready(){
+#ifdef MPI_VERSION
+        int flag = 1;
+        if( m_request != MPI_REQUEST_NULL)
+            MPI_Test( &m_request, &flag, MPI_STATUS_IGNORE);
+        return flag;
+#else
+        return true;
+#endif //MPI_VERSION
+    }
+    ///@brief Block until the reduction has finished
+    void wait(){
+#ifdef MPI_VERSION
+        if( m_request != MPI_REQUEST_NULL)
+            MPI_Wait( &m_request, MPI_STATUS_IGNORE);
+#endif //MPI_VERSION
+    }
+    /**
+     * @brief Wait for the reduction and return a scalar product
+     *
+     * @param i index of the scalar product (\c 0<=i<size())
+     * @return the scalar product rounded to the nearest double, the same on all processes
+     */
+    double get( unsigned i = 0){
+        wait();
+        return exblas::cpu::Round( &m_out[i*exblas::BIN_COUNT]);
+    }
+    private:
+    unsigned m_num = 0;
+    std::vector<int64_t> m_in, m_out;
+#ifdef MPI_VERSION
+    MPI_Request m_request = MPI_REQUEST_NULL;
+#endif //MPI_VERSION
+};
+
+}//namespace dg
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <vector>
+#include "config.h"
+#include "execution_policy.h"
+#include "sparseblockmat_strip.h"
+
+namespace dg
+{
+///@cond
+namespace detail{
+
+template<class value_type, int n>
+void ell_elliptic2d_kernel(
+        const EllSparseBlockMat<value_type>& lx, const EllSparseBlockMat<value_type>& rx, const EllSparseBlockMat<value_type>& jx,
+        const EllSparseBlockMat<value_type>& ly, const EllSparseBlockMat<value_type>& ry, const EllSparseBlockMat<value_type>& jy,
+        value_type jfactor,
+        const value_type* RESTRICT chi_xx, const value_type* RESTRICT chi_yy,
+        const value_type* RESTRICT w, const value_type* RESTRICT vol,
+        const value_type* RESTRICT x, value_type* RESTRICT y, int strip_begin, int strip_end,
+        StripWorkspace<value_type>& workspace)
+{
+    //the order of operations for every element is the same as in Elliptic::symv with
+    //separate matrix applications, such that the results are binary identical
+    const int L = ry.right_size, Ny = ry.num_rows;
+    const int size = n*L;
+    StripRing<value_type>& ring = workspace.ring;
+    ring.clear();
+    value_type* line = thrust::raw_pointer_cast( workspace.line.data());
+    for( int si = strip_begin; si<strip_end; si++)
+    {
+        const int p = si/Ny, i = si%Ny;
+        const value_type* xp = x + p*Ny*size;
+        value_type* ys = y + si*size;
+        for( int k=0; k<size; k++)
+            ys[k] = 0;
+        //y = L_y chi_yy R_y x, block by block
+        for( int d=0; d<ly.blocks_per_line; d++)
+        {
+            const int c = ly.cols_idx[i*ly.blocks_per_line+d];
+            const int key = p*Ny+c;
+            int slot = ring.find( key);
+            if( slot == -1)
+            {
+                slot = ring.insert( key);
+                value_type* g = ring.get( slot, 0);
+                for( int k=0; k<size; k++)
+                    g[k] = 0;
+                ell_strip_multiply<value_type, n>( ry, c, value_type(1), xp, g);
+                if( chi_yy != nullptr)
+                    for( int k=0; k<size; k++)
+                        g[k] = chi_yy[key*size+k]*g[k];
+            }
+            const value_type* g = ring.get( slot, 0);
+            const value_type* data = &ly.data[ly.data_idx[i*ly.blocks_per_line+d]*n*n];
+            for( int k=0; k<n; k++)
+            {
+                value_type a[n];
+                for( int q=0; q<n; q++)
+                    a[q] = data[k*n+q];
+#ifndef _MSC_VER
+#pragma omp SIMD
+#endif
+                for( int j=0; j<L; j++)
+                {
+                    value_type temp = 0;
+                    for( int q=0; q<n; q++)
+                        temp = DG_FMA( a[q], g[q*L+j], temp);
+                    ys[k*L+j] = DG_FMA( value_type(1), temp, ys[k*L+j]);
+                }
+            }
+        }
+        //y = -L_x chi_xx R_x x - y + alpha J_x x, line by line
+        for( int k=0; k<size; k++)
+            ys[k] = -ys[k];
+        for( int k=0; k<n; k++)
+        {
+            const int I = si*size + k*L;
+            for( int j=0; j<L; j++)
+                line[j] = 0;
+            ell_line_multiply<value_type, n>( rx, value_type(1), x+I, line);
+            if( chi_xx != nullptr)
+                for( int j=0; j<L; j++)
+                    line[j] = chi_xx[I+j]*line[j];
+            ell_line_multiply<value_type, n>( lx, value_type(-1), line, y+I);
+            ell_line_multiply<value_type, n>( jx, jfactor, x+I, y+I);
+        }
+        //y += alpha J_y x
+        ell_strip_multiply<value_type, n>( jy, i, jfactor, xp, ys);
+        if( w != nullptr)
+            for( int k=0; k<size; k++)
+                ys[k] = w[si*size+k]*ys[k];
+        if( vol != nullptr)
+            for( int k=0; k<size; k++)
+                ys[k] = ys[k]/vol[si*size+k];
+    }
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Matrix-free application of the orthogonal 2d elliptic operator
+ *
+ * Computes \f[ y = \frac{W}{V}\left(-L_x \chi^{xx} R_x x - L_y\chi^{yy} R_y x + \alpha (J_x + J_y) x\right)\f]
+ * in one sweep over the block rows (strips of \c n lines) in y-direction.
+ * The chi-weighted y-gradient of the neighboring strips is kept in a small ring buffer
+ * and the x-gradient is computed line by line, such that apart from the input vector
+ * only \c chi_xx, \c chi_yy and \c w (or \c vol) are read and only \c y is written.
+ * The result is binary identical to the separate application of the matrices in \c dg::Elliptic::symv.
+ * @param lx,rx,jx left, right derivative and jump matrices in x (\c right_size==1)
+ * @param ly,ry,jy left, right derivative and jump matrices in y (\c right_size is the line length)
+ * @param jfactor \f$ \alpha\f$
+ * @param chi_xx may be \c nullptr (then 1 is assumed)
+ * @param chi_yy may be \c nullptr (then 1 is assumed)
+ * @param w the weights multiplying the result, may be \c nullptr (then 1 is assumed)
+ * @param vol the volume element dividing the result, may be \c nullptr (then 1 is assumed)
+ * @param x input
+ * @param y output (may not alias x)
+ * @param strip_begin first strip (plane*num_rows+row of the y-matrices) to compute
+ * @param strip_end one past the last strip to compute
+ * @param workspace scratch memory of the calling thread (one strip with \c ry.n*ry.right_size and one line with \c ry.right_size elements)
+ * @attention only \c n<=6 and \c blocks_per_line<=4 are supported
+ */
+template<class value_type>
+void ell_elliptic2d_kernel(
+        const EllSparseBlockMat<value_type>& lx, const EllSparseBlockMat<value_type>& rx, const EllSparseBlockMat<value_type>& jx,
+        const EllSparseBlockMat<value_type>& ly, const EllSparseBlockMat<value_type>& ry, const EllSparseBlockMat<value_type>& jy,
+        value_type jfactor,
+        const value_type* RESTRICT chi_xx, const value_type* RESTRICT chi_yy,
+        const value_type* RESTRICT w, const value_type* RESTRICT vol,
+        const value_type* RESTRICT x, value_type* RESTRICT y, int strip_begin, int strip_end,
+        detail::StripWorkspace<value_type>& workspace)
+{
+    switch( ry.n)
+    {
+        case 1: detail::ell_elliptic2d_kernel<value_type, 1>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+        case 2: detail::ell_elliptic2d_kernel<value_type, 2>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+        case 3: detail::ell_elliptic2d_kernel<value_type, 3>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+        case 4: detail::ell_elliptic2d_kernel<value_type, 4>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+        case 5: detail::ell_elliptic2d_kernel<value_type, 5>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+        case 6: detail::ell_elliptic2d_kernel<value_type, 6>( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, strip_begin, strip_end, workspace); break;
+    }
+}
+
+///@cond
+template<class value_type>
+void ell_elliptic2d( SerialTag,
+        const EllSparseBlockMat<value_type>& lx, const EllSparseBlockMat<value_type>& rx, const EllSparseBlockMat<value_type>& jx,
+        const EllSparseBlockMat<value_type>& ly, const EllSparseBlockMat<value_type>& ry, const EllSparseBlockMat<value_type>& jy,
+        value_type jfactor, const value_type* chi_xx, const value_type* chi_yy,
+        const value_type* w, const value_type* vol,
+        const value_type* x, value_type* y, std::vector<detail::StripWorkspace<value_type>>& workspace)
+{
+    ell_elliptic2d_kernel( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, 0, ry.left_size*ry.num_rows, workspace[0]);
+}
+///@endcond
+
+}//namespace dg
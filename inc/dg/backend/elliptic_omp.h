@@ -0,0 +1,47 @@
+#pragma once
+
+#include <omp.h>
+#include "elliptic_cpu.h"
+
+namespace dg
+{
+///@cond
+template<class value_type>
+void ell_elliptic2d( OmpTag,
+        const EllSparseBlockMat<value_type>& lx, const EllSparseBlockMat<value_type>& rx, const EllSparseBlockMat<value_type>& jx,
+        const EllSparseBlockMat<value_type>& ly, const EllSparseBlockMat<value_type>& ry, const EllSparseBlockMat<value_type>& jy,
+        value_type jfactor, const value_type* chi_xx, const value_type* chi_yy,
+        const value_type* w, const value_type* vol,
+        const value_type* x, value_type* y, std::vector<detail::StripWorkspace<value_type>>& workspace)
+{
+    const int num_strips = ry.left_size*ry.num_rows;
+    //every thread computes a contiguous chunk of strips such that the ring buffer is reused
+    auto chunk = [&]()
+    {
+        int begin, end;
+        detail::omp_strip_range( num_strips, begin, end);
+        const unsigned rank = omp_get_thread_num();
+        if( rank < workspace.size())
+            ell_elliptic2d_kernel( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, begin, end, workspace[rank]);
+        else //the team is larger than at construction
+        {
+            detail::StripWorkspace<value_type> local( 1, ry.n*ry.right_size, ry.right_size);
+            ell_elliptic2d_kernel( lx, rx, jx, ly, ry, jy, jfactor, chi_xx, chi_yy, w, vol, x, y, begin, end, local);
+        }
+    };
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel
+        {
+            chunk();
+        }
+        return;
+    }
+    //we are in an enclosing parallel region: x may have been written by other threads
+    #pragma omp barrier
+    chunk();
+    #pragma omp barrier
+}
+///@endcond
+
+}//namespace dg
@@ -21,6 +21,8 @@
 #include <cstdio>
 #include <cmath>
 #include <iostream>
+#include <vector>
+#include <memory>
 
 #include "accumulate.h"
 #include "ExSUM.FPE.hpp"
@@ -89,136 +91,194 @@ inline static void Reduction(unsigned int tid, unsigned int tnum, std::vector<in
     }
 }
 
+///@cond
+//the accumulators and ready flags shared by the threads of one team
+struct TeamBuffers
+{
+    std::vector<int64_t> acc;
+    std::vector<int32_t> ready;
+};
+///@endcond
+/**
+ * \brief Orphaned version of the reduction: called by all threads of an enclosing parallel region
+ *
+ * The superaccumulators and ready flags are shared among the team, every thread receives the result.
+ * The buffers are allocated per call and team, such that nested or concurrent teams do not interfere;
+ * they are freed by the last thread that leaves the function.
+ * \param thread_reduce called by every thread with the shared accumulators and ready flags
+ * \param linesize distance of the ready flags
+ * \param h_superacc thread-private result
+ */
+template<class ThreadReduce>
+void OrphanedReduction( ThreadReduce thread_reduce, int const linesize, int64_t* h_superacc)
+{
+    std::shared_ptr<TeamBuffers> team;
+    #pragma omp single copyprivate( team)
+    {
+        team = std::make_shared<TeamBuffers>();
+        team->acc.assign( omp_get_num_threads()*BIN_COUNT, 0);
+        team->ready.assign( omp_get_num_threads()*linesize, 0);
+    }//implicit barrier
+    thread_reduce( team->acc, team->ready);
+    #pragma omp barrier //the inputs are read completely and the result is ready
+    for( int i=IMIN; i<=IMAX; i++)
+        h_superacc[i] = team->acc[i];
+}
+
+template<typename CACHE, typename PointerOrValue1, typename PointerOrValue2>
+void ExDOTFPE_thread(int N, PointerOrValue1 a, PointerOrValue2 b, std::vector<int64_t>& acc, std::vector<int32_t>& ready, int const linesize) {
+    unsigned int tid = omp_get_thread_num();
+    unsigned int tnum = omp_get_num_threads();
+
+    CACHE cache(&acc[tid*BIN_COUNT]);
+    *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
+
+#ifndef _WITHOUT_VCL
+    int l = ((tid * int64_t(N)) / tnum) & ~7ul; // & ~7ul == round down to multiple of 8
+    int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
+
+    for(int i = l; i < r; i+=8) {
+#ifndef _MSC_VER
+        asm ("# myloop");
+#endif
+        vcl::Vec8d r1 ;
+        vcl::Vec8d x  = TwoProductFMA(make_vcl_vec8d(a,i), make_vcl_vec8d(b,i), r1);
+        //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load(a+i), vcl::Vec8d().load(b+i), r1);
+        //vcl::Vec8d x  = vcl::mul_add( vcl::Vec8d().load(a+i),vcl::Vec8d().load(b+i),0);
+        cache.Accumulate(x);
+        cache.Accumulate(r1); //MW: exact product but halfs the speed
+    }
+    if( tid+1==tnum && r != N-1) {
+        r+=1;
+        //accumulate remainder
+        vcl::Vec8d r1;
+        vcl::Vec8d x  = TwoProductFMA(make_vcl_vec8d(a,r,N-r), make_vcl_vec8d(b,r,N-r), r1);
+        //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load_partial(N-r, a+r), vcl::Vec8d().load_partial(N-r,b+r), r1);
+        //vcl::Vec8d x  = vcl::mul_add( vcl::Vec8d().load_partial(N-r,a+r),vcl::Vec8d().load_partial(N-r,b+r),0);
+        cache.Accumulate(x);
+        cache.Accumulate(r1);
+    }
+#else// _WITHOUT_VCL
+    int l = ((tid * int64_t(N)) / tnum);
+    int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
+    for(int i = l; i <= r; i++) {
+        double r1;
+        double x = TwoProductFMA(get_element(a,i),get_element(b,i),r1);
+        cache.Accumulate(x);
+        cache.Accumulate(r1);
+    }
+#endif// _WITHOUT_VCL
+    cache.Flush();
+    int imin=IMIN, imax=IMAX;
+    Normalize(&acc[tid*BIN_COUNT], imin, imax);
+
+    Reduction(tid, tnum, ready, acc, linesize);
+}
+
 template<typename CACHE, typename PointerOrValue1, typename PointerOrValue2>
 void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, int64_t* h_superacc) {
     // OpenMP sum+reduction
     int const linesize = 16;    // * sizeof(int32_t)
+    if( omp_in_parallel())
+    {
+        //we are inside an enclosing parallel region (orphaned call)
+        OrphanedReduction( [&]( std::vector<int64_t>& acc, std::vector<int32_t>& ready){
+                ExDOTFPE_thread<CACHE>(N, a, b, acc, ready, linesize);}, linesize, h_superacc);
+        return;
+    }
     int maxthreads = omp_get_max_threads();
     std::vector<int64_t> acc(maxthreads*BIN_COUNT,0);
     std::vector<int32_t> ready(maxthreads * linesize);
 
     #pragma omp parallel
     {
-        unsigned int tid = omp_get_thread_num();
-        unsigned int tnum = omp_get_num_threads();
+        ExDOTFPE_thread<CACHE>(N, a, b, acc, ready, linesize);
+    }
+    for( int i=IMIN; i<=IMAX; i++)
+        h_superacc[i] = acc[i];
+}
 
-        CACHE cache(&acc[tid*BIN_COUNT]);
-        *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
+template<typename CACHE, typename PointerOrValue1, typename PointerOrValue2, typename PointerOrValue3>
+void ExDOTFPE_thread(int N, PointerOrValue1 a, PointerOrValue2 b, PointerOrValue3 c, std::vector<int64_t>& acc, std::vector<int32_t>& ready, int const linesize) {
+    unsigned int tid = omp_get_thread_num();
+    unsigned int tnum = omp_get_num_threads();
+
+    CACHE cache(&acc[tid*BIN_COUNT]);
+    *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
 
 #ifndef _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum) & ~7ul; // & ~7ul == round down to multiple of 8
-        int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
+    int l = ((tid * int64_t(N)) / tnum) & ~7ul;// & ~7ul == round down to multiple of 8
+    int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
 
-        for(int i = l; i < r; i+=8) {
+    for(int i = l; i < r; i+=8) {
 #ifndef _MSC_VER
-            asm ("# myloop");
+        asm ("# myloop");
 #endif
-            vcl::Vec8d r1 ;
-            vcl::Vec8d x  = TwoProductFMA(make_vcl_vec8d(a,i), make_vcl_vec8d(b,i), r1);
-            //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load(a+i), vcl::Vec8d().load(b+i), r1);
-            //vcl::Vec8d x  = vcl::mul_add( vcl::Vec8d().load(a+i),vcl::Vec8d().load(b+i),0);
-            cache.Accumulate(x);
-            cache.Accumulate(r1); //MW: exact product but halfs the speed
-        }
-        if( tid+1==tnum && r != N-1) {
-            r+=1;
-            //accumulate remainder
-            vcl::Vec8d r1;
-            vcl::Vec8d x  = TwoProductFMA(make_vcl_vec8d(a,r,N-r), make_vcl_vec8d(b,r,N-r), r1);
-            //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load_partial(N-r, a+r), vcl::Vec8d().load_partial(N-r,b+r), r1);
-            //vcl::Vec8d x  = vcl::mul_add( vcl::Vec8d().load_partial(N-r,a+r),vcl::Vec8d().load_partial(N-r,b+r),0);
-            cache.Accumulate(x);
-            cache.Accumulate(r1);
-        }
+        //vcl::Vec8d r1 , r2, cvec = vcl::Vec8d().load(c+i);
+        //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load(a+i), vcl::Vec8d().load(b+i), r1);
+        //vcl::Vec8d x2 = TwoProductFMA(x , cvec, r2);
+        //vcl::Vec8d x1  = vcl::mul_add(vcl::Vec8d().load(a+i),vcl::Vec8d().load(b+i), 0);
+        //vcl::Vec8d x2  = vcl::mul_add( x1                   ,vcl::Vec8d().load(c+i), 0);
+        vcl::Vec8d x1  = vcl::mul_add(make_vcl_vec8d(a,i),make_vcl_vec8d(b,i), 0);
+        vcl::Vec8d x2  = vcl::mul_add( x1                ,make_vcl_vec8d(c,i), 0);
+        cache.Accumulate(x2);
+        //cache.Accumulate(r2);
+        //x2 = TwoProductFMA(r1, cvec, r2);
+        //cache.Accumulate(x2);
+        //cache.Accumulate(r2);
+    }
+    if( tid+1 == tnum && r != N-1) {
+        r+=1;
+        //accumulate remainder
+        //vcl::Vec8d r1 , r2, cvec = vcl::Vec8d().load_partial(N-r, c+r);
+        //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load_partial(N-r, a+r), vcl::Vec8d().load_partial(N-r,b+r), r1);
+        //vcl::Vec8d x2 = TwoProductFMA(x , cvec, r2);
+        //vcl::Vec8d x1  = vcl::mul_add(vcl::Vec8d().load_partial(N-r, a+r),vcl::Vec8d().load_partial(N-r,b+r), 0);
+        //vcl::Vec8d x2  = vcl::mul_add( x1                   ,vcl::Vec8d().load_partial(N-r,c+r), 0);
+        vcl::Vec8d x1  = vcl::mul_add(make_vcl_vec8d(a,r,N-r),make_vcl_vec8d(b,r,N-r), 0);
+        vcl::Vec8d x2  = vcl::mul_add( x1                    ,make_vcl_vec8d(c,r,N-r), 0);
+        cache.Accumulate(x2);
+        //cache.Accumulate(r2);
+        //x2 = TwoProductFMA(r1, cvec, r2);
+        //cache.Accumulate(x2);
+        //cache.Accumulate(r2);
+    }
 #else// _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum);
-        int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
-        for(int i = l; i <= r; i++) {
-            double r1;
-            double x = TwoProductFMA(get_element(a,i),get_element(b,i),r1);
-            cache.Accumulate(x);
-            cache.Accumulate(r1);
-        }
+    int l = ((tid * int64_t(N)) / tnum);
+    int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
+    for(int i = l; i <= r; i++) {
+        //double x1 = a[i]*b[i];
+        //double x2 = x1*c[i];
+        double x1 = get_element(a,i)*get_element(b,i);
+        double x2 = x1*get_element(c,i);
+        cache.Accumulate(x2);
+    }
 #endif// _WITHOUT_VCL
-        cache.Flush();
-        int imin=IMIN, imax=IMAX;
-        Normalize(&acc[tid*BIN_COUNT], imin, imax);
+    cache.Flush();
+    int imin=IMIN, imax=IMAX;
+    Normalize(&acc[tid*BIN_COUNT], imin, imax);
 
-        Reduction(tid, tnum, ready, acc, linesize);
-    }
-    for( int i=IMIN; i<=IMAX; i++)
-        h_superacc[i] = acc[i];
+    Reduction(tid, tnum, ready, acc, linesize);
 }
 
 template<typename CACHE, typename PointerOrValue1, typename PointerOrValue2, typename PointerOrValue3>
 void ExDOTFPE(int N, PointerOrValue1 a, PointerOrValue2 b, PointerOrValue3 c, int64_t* h_superacc) {
     // OpenMP sum+reduction
     int const linesize = 16;    // * sizeof(int32_t) (MW avoid false sharing?)
+    if( omp_in_parallel())
+    {
+        //we are inside an enclosing parallel region (orphaned call)
+        OrphanedReduction( [&]( std::vector<int64_t>& acc, std::vector<int32_t>& ready){
+                ExDOTFPE_thread<CACHE>(N, a, b, c, acc, ready, linesize);}, linesize, h_superacc);
+        return;
+    }
     int maxthreads = omp_get_max_threads();
     std::vector<int64_t> acc(maxthreads*BIN_COUNT,0);
     std::vector<int32_t> ready(maxthreads * linesize);
 
     #pragma omp parallel
     {
-        unsigned int tid = omp_get_thread_num();
-        unsigned int tnum = omp_get_num_threads();
-
-        CACHE cache(&acc[tid*BIN_COUNT]);
-        *(int32_t volatile *)(&ready[tid * linesize]) = 0;  // Race here, who cares?
-
-#ifndef _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum) & ~7ul;// & ~7ul == round down to multiple of 8
-        int r = ((((tid+1) * int64_t(N)) / tnum) & ~7ul) - 1;
-
-        for(int i = l; i < r; i+=8) {
-#ifndef _MSC_VER
-            asm ("# myloop");
-#endif
-            //vcl::Vec8d r1 , r2, cvec = vcl::Vec8d().load(c+i);
-            //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load(a+i), vcl::Vec8d().load(b+i), r1);
-            //vcl::Vec8d x2 = TwoProductFMA(x , cvec, r2);
-            //vcl::Vec8d x1  = vcl::mul_add(vcl::Vec8d().load(a+i),vcl::Vec8d().load(b+i), 0);
-            //vcl::Vec8d x2  = vcl::mul_add( x1                   ,vcl::Vec8d().load(c+i), 0);
-            vcl::Vec8d x1  = vcl::mul_add(make_vcl_vec8d(a,i),make_vcl_vec8d(b,i), 0);
-            vcl::Vec8d x2  = vcl::mul_add( x1                ,make_vcl_vec8d(c,i), 0);
-            cache.Accumulate(x2);
-            //cache.Accumulate(r2);
-            //x2 = TwoProductFMA(r1, cvec, r2);
-            //cache.Accumulate(x2);
-            //cache.Accumulate(r2);
-        }
-        if( tid+1 == tnum && r != N-1) {
-            r+=1;
-            //accumulate remainder
-            //vcl::Vec8d r1 , r2, cvec = vcl::Vec8d().load_partial(N-r, c+r);
-            //vcl::Vec8d x  = TwoProductFMA(vcl::Vec8d().load_partial(N-r, a+r), vcl::Vec8d().load_partial(N-r,b+r), r1);
-            //vcl::Vec8d x2 = TwoProductFMA(x , cvec, r2);
-            //vcl::Vec8d x1  = vcl::mul_add(vcl::Vec8d().load_partial(N-r, a+r),vcl::Vec8d().load_partial(N-r,b+r), 0);
-            //vcl::Vec8d x2  = vcl::mul_add( x1                   ,vcl::Vec8d().load_partial(N-r,c+r), 0);
-            vcl::Vec8d x1  = vcl::mul_add(make_vcl_vec8d(a,r,N-r),make_vcl_vec8d(b,r,N-r), 0);
-            vcl::Vec8d x2  = vcl::mul_add( x1                    ,make_vcl_vec8d(c,r,N-r), 0);
-            cache.Accumulate(x2);
-            //cache.Accumulate(r2);
-            //x2 = TwoProductFMA(r1, cvec, r2);
-            //cache.Accumulate(x2);
-            //cache.Accumulate(r2);
-        }
-#else// _WITHOUT_VCL
-        int l = ((tid * int64_t(N)) / tnum);
-        int r = ((((tid+1) * int64_t(N)) / tnum) ) - 1;
-        for(int i = l; i <= r; i++) {
-            //double x1 = a[i]*b[i];
-            //double x2 = x1*c[i];
-            double x1 = get_element(a,i)*get_element(b,i);
-            double x2 = x1*get_element(c,i);
-            cache.Accumulate(x2);
-        }
-#endif// _WITHOUT_VCL
-        cache.Flush();
-        int imin=IMIN, imax=IMAX;
-        Normalize(&acc[tid*BIN_COUNT], imin, imax);
-
-        Reduction(tid, tnum, ready, acc, linesize);
+        ExDOTFPE_thread<CACHE>(N, a, b, c, acc, ready, linesize);
     }
     for( int i=IMIN; i<=IMAX; i++)
         h_superacc[i] = acc[i];
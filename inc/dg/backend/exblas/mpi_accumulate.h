@@ -7,6 +7,12 @@
  */
 #pragma once
 #include <mpi.h>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
 #include "accumulate.h"
 
 namespace exblas {
@@ -20,7 +26,7 @@ namespace exblas {
  * @param comm_mod_reduce a subgroup of comm, consists of all rank 0 processes in comm_mod
  * @note the creation of new communicators involves communication between all participation processes (comm in this case)
  */
-static void mpi_reduce_communicator(MPI_Comm comm, MPI_Comm* comm_mod, MPI_Comm* comm_mod_reduce){
+inline void mpi_reduce_communicator(MPI_Comm comm, MPI_Comm* comm_mod, MPI_Comm* comm_mod_reduce){
     int mod = 128;
     int rank, size;
     MPI_Comm_rank( comm, &rank);
@@ -51,7 +57,7 @@ processes.  As usual the resulting superaccumulator is unnormalized.
 @param comm_mod_reduce This is the communicator consisting of all rank 0 processes in comm_mod, may be \c MPI_COMM_NULL
 @sa \c exblas::mpi_reduce_communicator to generate the required communicators
 */
-static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce )
+inline void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Comm comm_mod, MPI_Comm comm_mod_reduce )
 {
     for( unsigned i=0; i<num_superacc; i++)
     {
@@ -75,4 +81,106 @@ static void reduce_mpi_cpu(  unsigned num_superacc, int64_t* in, int64_t* out, M
     MPI_Bcast( out, num_superacc*exblas::BIN_COUNT, MPI_LONG, 0, comm);
 }
 
+///@cond
+namespace detail{
+//MPI_User_function: add normalized superaccumulators and normalize the result
+//(two normalized accumulators can be added without overflow)
+//(all BIN_COUNT words are summed: the active range IMIN..IMAX spans the whole accumulator)
+inline void superacc_sum( void* invec, void* inoutvec, int* len, MPI_Datatype*)
+{
+    const int64_t* in = static_cast<const int64_t*>(invec);
+    int64_t* inout = static_cast<int64_t*>(inoutvec);
+    for( int i=0; i<*len; i++)
+    {
+        for( int k=0; k<exblas::BIN_COUNT; k++)
+            inout[i*BIN_COUNT+k] += in[i*BIN_COUNT+k];
+        int imin=exblas::IMIN, imax=exblas::IMAX;
+        cpu::Normalize(&inout[i*BIN_COUNT], imin, imax);
+    }
+}
+struct SuperaccOp
+{
+    SuperaccOp(){
+        MPI_Type_contiguous( exblas::BIN_COUNT, MPI_INT64_T, &type);
+        MPI_Type_commit( &type);
+        MPI_Op_create( &superacc_sum, 1, &op);
+    }
+    MPI_Datatype type; //one superaccumulator
+    MPI_Op op;
+};
+//created once on first use (after MPI_Init) and never freed
+inline const SuperaccOp& superacc_op(){
+    static SuperaccOp s;
+    return s;
+}
+inline void normalize_all( unsigned num_superacc, int64_t* in)
+{
+    for( unsigned i=0; i<num_superacc; i++)
+    {
+        int imin=exblas::IMIN, imax=exblas::IMAX;
+        cpu::Normalize(&in[i*exblas::BIN_COUNT], imin, imax);
+    }
+}
+}//namespace detail
+///@endcond
+
+/*! @brief reduce a number of superaccumulators distributed among mpi processes in a single collective
+
+The superaccumulators are normalized locally and summed with a user-defined reduction
+operation that normalizes after each addition. This is one \c MPI_Allreduce instead of the
+two reductions and the broadcast of \c exblas::reduce_mpi_cpu (and needs no split communicators) with the same, exact, result.
+ * @ingroup highlevel
+@param num_superacc number of Superaccumulators eaach process holds
+@param in unnormalized input superaccumulators ( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (read/write, undefined on out)
+@param out each process contains the result on output( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (write, may not alias in)
+@param comm The complete MPI communicator
+@note If called inside an OpenMP parallel region all threads of the team must call the function with the same \c in. Only the master thread communicates (compatible with \c MPI_THREAD_FUNNELED) and every thread receives the result in its \c out
+*/
+inline void allreduce_mpi_cpu( unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm)
+{
+#ifdef _OPENMP
+    if( omp_in_parallel())
+    {
+        //the receive buffer is allocated per call and team and freed by the last thread leaving
+        std::shared_ptr<std::vector<int64_t>> shared;
+        #pragma omp single copyprivate( shared)
+        shared = std::make_shared<std::vector<int64_t>>( num_superacc*exblas::BIN_COUNT);
+        //implicit barrier
+        #pragma omp master
+        {
+            detail::normalize_all( num_superacc, in);
+            MPI_Allreduce( in, shared->data(), num_superacc, detail::superacc_op().type, detail::superacc_op().op, comm);
+        }
+        #pragma omp barrier
+        std::copy( shared->begin(), shared->end(), out);
+        return;
+    }
+#endif //_OPENMP
+    detail::normalize_all( num_superacc, in);
+    MPI_Allreduce( in, out, num_superacc, detail::superacc_op().type, detail::superacc_op().op, comm);
+}
+
+/*! @brief Initiate the reduction of a number of superaccumulators distributed among mpi processes
+
+Non-blocking version of \c exblas::allreduce_mpi_cpu. The result is available in \c out after \c MPI_Wait
+returns on \c request; until then neither \c in nor \c out may be accessed.
+ * @ingroup highlevel
+@param num_superacc number of Superaccumulators eaach process holds
+@param in unnormalized input superaccumulators ( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (read/write, undefined on out)
+@param out each process contains the result after the communication finished ( must be of size num_superacc*\c exblas::BIN_COUNT, allocated on the cpu) (write, may not alias in)
+@param comm The complete MPI communicator
+@param request (write only) to be used in \c MPI_Wait or \c MPI_Test
+@note MPI implementations older than MPI-3 have no non-blocking collectives, in which case the reduction is done immediately and \c request is \c MPI_REQUEST_NULL
+*/
+inline void iallreduce_mpi_cpu( unsigned num_superacc, int64_t* in, int64_t* out, MPI_Comm comm, MPI_Request* request)
+{
+    detail::normalize_all( num_superacc, in);
+#if MPI_VERSION >= 3
+    MPI_Iallreduce( in, out, num_superacc, detail::superacc_op().type, detail::superacc_op().op, comm, request);
+#else
+    MPI_Allreduce( in, out, num_superacc, detail::superacc_op().type, detail::superacc_op().op, comm);
+    *request = MPI_REQUEST_NULL;
+#endif //MPI_VERSION
+}
+
 }//namespace exblas
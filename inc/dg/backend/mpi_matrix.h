@@ -1,7 +1,9 @@
 #pragma once
 
+#include <vector>
 #include "mpi_vector.h"
 #include "memory.h"
+#include "exceptions.h"
 
 /*!@file
 
@@ -49,6 +51,22 @@ inline void doSymv( MatrixType&& M,
                   const ContainerType1& x,
                   ContainerType2& y,
                   SelfMadeMatrixTag);
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void doSymv_batch( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  const std::vector<const ContainerType1*>& x,
+                  get_value_type<ContainerType1> beta,
+                  const std::vector<ContainerType2*>& y,
+                  AnyMatrixTag,
+                  AnyVectorTag);
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void doSymv_batch( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  const std::vector<const ContainerType1*>& x,
+                  get_value_type<ContainerType1> beta,
+                  const std::vector<ContainerType2*>& y,
+                  SparseBlockMatrixTag,
+                  SharedVectorTag);
 }//namespace detail
 }//namespace blas2
 ///@endcond
@@ -176,6 +194,41 @@ struct RowColDistMat
                        );
     }
 
+    /**
+    * @brief Matrix Vector product for several vectors at once
+    *
+    * If no communication is needed the inner matrix is applied to all vectors in one batch.
+    * Otherwise the single vector product is called for each vector, which
+    * overlaps the communication with the inner computations.
+    * @tparam ContainerType container class of the vector elements
+    * @param alpha scalar
+    * @param x inputs
+    * @param beta scalar
+    * @param y outputs
+    */
+    template<class ContainerType1, class ContainerType2>
+    void symv( double alpha, const std::vector<const ContainerType1*>& x, double beta, const std::vector<ContainerType2*>& y) const
+    {
+        if( m_c.size() == 0) //no communication needed
+        {
+            using local_container1 = typename ContainerType1::container_type;
+            using local_container2 = typename ContainerType2::container_type;
+            std::vector<const local_container1*> x_data( x.size());
+            std::vector<local_container2*> y_data( y.size());
+            for( unsigned v=0; v<x.size(); v++)
+                x_data[v] = &x[v]->data();
+            for( unsigned v=0; v<y.size(); v++)
+                y_data[v] = &y[v]->data();
+            dg::blas2::detail::doSymv_batch( alpha, m_i, x_data, beta, y_data,
+                       get_tensor_category<LocalMatrixInner>(),
+                       get_tensor_category<local_container1>()
+                       );
+            return;
+        }
+        for( unsigned v=0; v<x.size(); v++)
+            symv( alpha, *x[v], beta, *y[v]);
+    }
+
     /**
     * @brief Matrix Vector product
     *
@@ -291,7 +344,7 @@ struct MPIDistMat
     template<class ContainerType1, class ContainerType2>
     void symv( double alpha, const ContainerType1& x, double beta, ContainerType2& y) const
     {
-        if( m_c.size() == 0) //no communication needed
+        if( m_c.get().size() == 0) //no communication needed
         {
             dg::blas2::detail::doSymv( alpha, m_m, x.data(), beta, y.data(),
                        get_tensor_category<LocalMatrix>()
@@ -305,7 +358,7 @@ struct MPIDistMat
         MPI_Comm_compare( x.communicator(), m_c.get().communicator(), &result);
         assert( result == MPI_CONGRUENT || result == MPI_IDENT);
         if( m_dist == row_dist){
-            m_c.global_gather( x.data(), m_buffer.data());
+            m_c.get().global_gather( x.data(), m_buffer.data());
             dg::blas2::detail::doSymv( alpha, m_m, m_buffer.data(), beta, y.data(),
                        get_tensor_category<LocalMatrix>()
                        );
@@ -347,10 +400,65 @@ struct MPIDistMat
         }
     }
 
+    /**
+    * @brief Matrix Vector product for several vectors at once
+    *
+    * If no communication is needed or the matrix is row distributed
+    * all inputs are gathered first and then the local matrix is applied to all
+    * vectors in one batch. Column distributed matrices apply the single vector
+    * product to each vector.
+    * @attention for column distributed matrices only \c alpha=1 and \c beta=0 are allowed
+    * @tparam ContainerType container class of the vector elements
+    * @param alpha scalar
+    * @param x inputs
+    * @param beta scalar
+    * @param y outputs
+    */
+    template<class ContainerType1, class ContainerType2>
+    void symv( double alpha, const std::vector<const ContainerType1*>& x, double beta, const std::vector<ContainerType2*>& y) const
+    {
+        using local_container1 = typename ContainerType1::container_type;
+        using local_container2 = typename ContainerType2::container_type;
+        std::vector<const local_container1*> x_data( x.size());
+        std::vector<local_container2*> y_data( y.size());
+        for( unsigned v=0; v<y.size(); v++)
+            y_data[v] = &y[v]->data();
+        if( m_c.get().size() == 0) //no communication needed
+        {
+            for( unsigned v=0; v<x.size(); v++)
+                x_data[v] = &x[v]->data();
+            dg::blas2::detail::doSymv_batch( alpha, m_m, x_data, beta, y_data,
+                       get_tensor_category<LocalMatrix>(),
+                       get_tensor_category<local_container1>()
+                       );
+            return;
+        }
+        if( m_dist == row_dist){
+            std::vector<typename Collective::container_type>& buffer = m_batch_buffer.data();
+            if( buffer.size() < x.size())
+                buffer.resize( x.size(), m_buffer.data());
+            for( unsigned v=0; v<x.size(); v++)
+            {
+                m_c.get().global_gather( x[v]->data(), buffer[v]);
+                x_data[v] = &buffer[v];
+            }
+            dg::blas2::detail::doSymv_batch( alpha, m_m, x_data, beta, y_data,
+                       get_tensor_category<LocalMatrix>(),
+                       get_tensor_category<local_container1>()
+                       );
+            return;
+        }
+        if( alpha != 1. || beta != 0.)
+            throw Error( Message(_ping_)<<"Column distributed matrices can only compute y = M x for several vectors at once!");
+        for( unsigned v=0; v<x.size(); v++)
+            symv( *x[v], *y[v]);
+    }
+
     private:
     LocalMatrix m_m;
     ClonePtr<Collective> m_c;
     Buffer< typename Collective::container_type> m_buffer;
+    Buffer< std::vector<typename Collective::container_type>> m_batch_buffer;
     enum dist_type m_dist;
 };
 ///@}
@@ -373,6 +373,21 @@ template<class I, class V>
 void NearestNeighborComm<I,V>::do_global_gather_init( OmpTag, const value_type* input, MPI_Request rqst[4]) const
 {
     unsigned size = buffer_size();
+    if( omp_in_parallel())
+    {
+        //we are in an enclosing parallel region: input may have been written by other threads
+#pragma omp barrier
+#pragma omp for //implicit barrier: the send buffers are complete
+        for( unsigned i=0; i<size; i++)
+        {
+            sb1.data()[i] = input[gather_map1[i]];
+            sb2.data()[i] = input[gather_map2[i]];
+        }
+        //only the master thread communicates
+#pragma omp master
+        sendrecv( rqst);
+        return;
+    }
 #pragma omp parallel for
     for( unsigned i=0; i<size; i++)
     {
@@ -386,6 +401,23 @@ template<class I, class V>
 void NearestNeighborComm<I,V>::do_global_gather_wait(OmpTag, const value_type* input, value_type* values, MPI_Request rqst[4]) const
 {
     unsigned size = buffer_size();
+    if( omp_in_parallel())
+    {
+#pragma omp for nowait
+        for( unsigned i=0; i<4*size; i++)
+            values[scatter_map_middle[i]] = input[gather_map_middle[i]];
+        //rqst is only valid on the master thread (cf. do_global_gather_init)
+#pragma omp master
+        MPI_Waitall( 4, rqst, MPI_STATUSES_IGNORE );
+#pragma omp barrier
+#pragma omp for
+        for( unsigned i=0; i<size; i++)
+        {
+            values[scatter_map1[i]] = rb1.data()[i];
+            values[scatter_map2[i]] = rb2.data()[i];
+        }
+        return;
+    }
 #pragma omp parallel for
     for( unsigned i=0; i<4*size; i++)
         values[scatter_map_middle[i]] = input[gather_map_middle[i]];
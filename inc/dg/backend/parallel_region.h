@@ -0,0 +1,68 @@
+#pragma once
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
+
+/*!@file
+ *
+ * @brief contains the persistent OpenMP parallel region
+ */
+namespace dg
+{
+
+/**
+ * @brief Execute \c f() by all threads of one persistent OpenMP parallel region
+ *
+ * Outside a parallel region every OpenMP-backend call of the library (\c blas1, \c blas2,
+ * \c dg::Elliptic, \c dg::ArakawaX, ...) opens and closes its own parallel region.
+ * For small and medium sized grids the fork/join cost of hundreds of such calls per
+ * right hand side evaluation dominates. Inside \c parallel_region the library calls
+ * recognize the enclosing team (\c omp_in_parallel()) and use orphaned worksharing instead:
+ *  - elementwise \c blas1 routines distribute the loop with a static schedule and
+ *  need no barrier, since every thread touches the same indices in every call
+ *  - matrix-vector products and scalar products synchronize the team before reading and (matrices) after writing
+ *  - scalar products return the same result on all threads
+ *  - in MPI programs only the master thread communicates, compatible with \c MPI_THREAD_FUNNELED
+ *  .
+@code
+dg::parallel_region( [&](){
+    for( unsigned i=0; i<100; i++)
+        rhs( t, y0, y1); //no fork and join inside
+});
+@endcode
+ * @attention \c f is executed by every thread of the team. All containers that
+ * are written inside must be shared, i.e. live outside of \c f (e.g. as class members) and
+ * must not be resized inside; local containers declared inside \c f (and inside any
+ * function called by it) are private to each thread and thus not filled completely.
+ * Code other than library calls (e.g. output or scalar updates of shared variables)
+ * must be protected by \c "#pragma omp master" or \c "#pragma omp single" by the user.
+ * @attention Every library call must be encountered by all threads of the team in the same order.
+ * A \c dg::OmpTag library call from inside a \c "#pragma omp master" or \c "#pragma omp single" block
+ * or from inside a user \c "#pragma omp for" loop (i.e. by a subset of the team or from inside
+ * another worksharing construct) deadlocks at the team barriers of the orphaned worksharing.
+ * @note Only \c dg::OmpTag vectors (also inside \c dg::MPI_Vector), \c dg::EllSparseBlockMat and
+ * \c dg::CooSparseBlockMat based matrices and the \c dg::NearestNeighborComm are supported.
+ * The non-blocking \c dg::blas1::async_dot (and thus \c dg::PipelinedCG) is not supported inside.
+ * Without OpenMP the function simply calls \c f()
+ * @tparam Functor a callable with signature <tt> void f() </tt>
+ * @param f executed by each thread of the team
+ * @ingroup blas
+ */
+template<class Functor>
+void parallel_region( Functor f)
+{
+#ifdef _OPENMP
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel
+        {
+            f();
+        }
+        return;
+    }
+#endif //_OPENMP
+    f();
+}
+
+}//namespace dg
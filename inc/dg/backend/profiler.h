@@ -0,0 +1,456 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include "thrust/device_vector.h"
+//the <thrust/device_vector.h> header must be included for the THRUST_DEVICE_SYSTEM macros to work
+#include "tensor_traits.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
+
+/*!@file
+ *
+ * @brief contains the hierarchical run-time profiler
+ */
+namespace dg
+{
+
+///@cond
+namespace detail
+{
+//iteration numbers are binned in powers of two: bin 0 holds 0 and 1, bin k holds [2^k, 2^(k+1))
+static const unsigned PROFILE_BINS = 32;
+inline unsigned profile_bin( unsigned number)
+{
+    unsigned bin = 0;
+    while( number >>= 1)
+        bin++;
+    return bin;
+}
+
+struct ProfileNode
+{
+    ProfileNode( const char* name, ProfileNode* parent):
+        name(name), parent(parent), hist(PROFILE_BINS, 0.){}
+    ProfileNode* child( const char* name)
+    {
+        for( auto& c : children)
+            if( c->name == name)
+                return c.get();
+        children.emplace_back( new ProfileNode( name, this));
+        return children.back().get();
+    }
+    std::string path() const{
+        if( parent == nullptr || parent->parent == nullptr) return name;
+        return parent->path() + "/" + name;
+    }
+    std::string name;
+    ProfileNode* parent;
+    std::vector<std::unique_ptr<ProfileNode>> children;
+    double calls = 0, time = 0, time_min = std::numeric_limits<double>::max(), time_max = 0, bytes = 0;
+    double solves = 0, iter = 0, iter_min = std::numeric_limits<double>::max(), iter_max = 0;
+    std::vector<double> hist;
+};
+
+//The flat, rank-reduced record of one region in the summary
+struct ProfileRecord
+{
+    std::string path;
+    double calls, time_min, time_mean, time_max, call_min, call_max, bytes;
+    double solves, iter, iter_min, iter_max;
+    std::vector<double> hist;
+};
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Hierarchical run-time profiler
+ *
+ * Collects wall clock times, call counts, solver iteration numbers and estimates of
+ * moved memory of named regions that are opened and closed by \c dg::ProfileScope.
+ * Regions opened while another region is open become its children, i.e.
+ * the same solver called from two different places appears twice in the summary.
+ * The overhead is two clock reads and a search among the children of the current region
+ * per scope, so the profiler is meant to stay enabled in production runs
+ * as long as the regions are coarse (a solver call, a time step, an output)
+ * and not single vector operations.
+ *
+ * There is one profiler per process, accessible through \c dg::profiler().
+ * At the end of a run \c write_json prints the summary, in an MPI program
+ * the minimum, mean and maximum times across all ranks are computed.
+@code
+dg::profiler().set_enabled( js.get("profile", true).asBool());
+...
+{
+    dg::ProfileScope scope( "step");
+    karniadakis.step( feltor, rolkar, time, y0); //solvers inside add their own regions
+}
+...
+dg::profiler().write_json( std::cout); //in MPI: collective, only rank 0 prints
+@endcode
+ * @note With the CUDA backend kernels run asynchronously to the host, so the time of
+ * a region is only meaningful if it ends with a synchronizing operation
+ * (e.g. a scalar product or a copy to the host), or if \c set_synchronize(true) is called.
+ * @note The profiler is not thread safe. Inside an OpenMP parallel region (e.g. \c dg::parallel_region)
+ * only the thread with number 0 records; other threads must not open regions.
+ * @ingroup timer
+ */
+struct Profiler
+{
+    Profiler(): m_root( new detail::ProfileNode( "", nullptr)), m_current( m_root.get()){}
+    /**
+     * @brief Switch recording on or off (default is on)
+     * @param enabled if false, \c dg::ProfileScope does nothing
+     */
+    void set_enabled( bool enabled){ m_enabled = enabled;}
+    /// Is recording on?
+    bool enabled() const { return m_enabled;}
+    /**
+     * @brief Synchronize the device before every clock read (default is off)
+     *
+     * Only has an effect with the CUDA backend, where it makes region times
+     * accurate at the price of some lost overlap between host and device
+     * @param sync if true call \c cudaDeviceSynchronize on opening and closing a region
+     */
+    void set_synchronize( bool sync){ m_sync = sync;}
+    /// Discard all recorded regions (must not be called while a region is open)
+    void clear(){
+        m_root.reset( new detail::ProfileNode( "", nullptr));
+        m_current = m_root.get();
+    }
+
+    /**
+     * @brief Write the summary of all recorded regions in JSON format
+     *
+     * Every region is identified by its path, the names of the enclosing regions separated by "/".
+     * For every region the number of calls, the total time (minimum, mean and maximum across ranks),
+     * the minimum and maximum time of a single call, the estimated bytes
+     * moved and the resulting bandwidth are written. Regions that recorded solver iterations
+     * additionally contain the number of solves, the mean, minimum and maximum
+     * number of iterations and a histogram in powers of two (the key is the lower bound of the bin).
+     * @param os the output stream
+     */
+    void write_json( std::ostream& os) const
+    {
+        std::vector<detail::ProfileRecord> records;
+        std::vector<const detail::ProfileNode*> nodes;
+        flatten( m_root.get(), nodes);
+        for( auto node : nodes)
+            records.push_back( make_record( node));
+        print_json( os, records, 1);
+    }
+#ifdef MPI_VERSION
+    /**
+     * @brief Reduce the summary across all ranks and write it in JSON format on rank 0
+     *
+     * Collective call. The number of calls is the maximum, bytes and iterations are the sum across ranks.
+     * Regions that are recorded only on some ranks enter the reduction with zero time on the others.
+     * @param os the output stream (only used on rank 0)
+     * @param comm the communicator across which to reduce
+     */
+    void write_json( std::ostream& os, MPI_Comm comm) const
+    {
+        int rank, size;
+        MPI_Comm_rank( comm, &rank);
+        MPI_Comm_size( comm, &size);
+        std::vector<const detail::ProfileNode*> nodes;
+        flatten( m_root.get(), nodes);
+        //1. agree on the union of all paths (in the order of first appearance)
+        std::string local;
+        for( auto node : nodes)
+            local += node->path() + '\n';
+        int length = local.size();
+        std::vector<int> lengths( size), displ( size, 0);
+        MPI_Gather( &length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, comm);
+        for( int i=1; i<size; i++)
+            displ[i] = displ[i-1] + lengths[i-1];
+        std::vector<char> all( rank==0 ? displ[size-1]+lengths[size-1]+1 : 1);
+        MPI_Gatherv( &local[0], length, MPI_CHAR, all.data(), lengths.data(), displ.data(), MPI_CHAR, 0, comm);
+        std::vector<std::string> paths;
+        std::string joined;
+        if( rank == 0)
+        {
+            paths = split( std::string( all.begin(), all.end()-1));
+            std::vector<std::string> unique;
+            for( auto& p : paths)
+                if( std::find( unique.begin(), unique.end(), p) == unique.end())
+                {
+                    unique.push_back( p);
+                    joined += p + '\n';
+                }
+            paths.swap( unique);
+        }
+        length = joined.size();
+        MPI_Bcast( &length, 1, MPI_INT, 0, comm);
+        joined.resize( length);
+        MPI_Bcast( &joined[0], length, MPI_CHAR, 0, comm);
+        if( rank != 0)
+            paths = split( joined);
+        //2. reduce the values of every path
+        const unsigned num = paths.size(), stride = 4+detail::PROFILE_BINS;
+        std::vector<double> sum( num*stride), mini( num*3), maxi( num*4);
+        for( unsigned i=0; i<num; i++)
+        {
+            auto it = std::find_if( nodes.begin(), nodes.end(),
+                    [&]( const detail::ProfileNode* n){ return n->path() == paths[i];});
+            //a region that is missing on this rank enters with zero calls
+            detail::ProfileNode empty( "", nullptr);
+            detail::ProfileRecord r = make_record( it == nodes.end() ? &empty : *it);
+            sum[i*stride+0] = r.time_mean, sum[i*stride+1] = r.bytes;
+            sum[i*stride+2] = r.solves, sum[i*stride+3] = r.iter;
+            std::copy( r.hist.begin(), r.hist.end(), &sum[i*stride+4]);
+            mini[3*i+0] = r.time_min, mini[3*i+1] = r.call_min, mini[3*i+2] = r.iter_min;
+            maxi[4*i+0] = r.time_max, maxi[4*i+1] = r.call_max;
+            maxi[4*i+2] = r.iter_max, maxi[4*i+3] = r.calls;
+        }
+        MPI_Allreduce( MPI_IN_PLACE, sum.data(), sum.size(), MPI_DOUBLE, MPI_SUM, comm);
+        MPI_Allreduce( MPI_IN_PLACE, mini.data(), mini.size(), MPI_DOUBLE, MPI_MIN, comm);
+        MPI_Allreduce( MPI_IN_PLACE, maxi.data(), maxi.size(), MPI_DOUBLE, MPI_MAX, comm);
+        if( rank != 0)
+            return;
+        std::vector<detail::ProfileRecord> records( num);
+        for( unsigned i=0; i<num; i++)
+        {
+            detail::ProfileRecord& r = records[i];
+            r.path = paths[i];
+            r.time_mean = sum[i*stride+0]/(double)size, r.bytes = sum[i*stride+1];
+            r.solves = sum[i*stride+2], r.iter = sum[i*stride+3];
+            r.hist.assign( &sum[i*stride+4], &sum[i*stride+4]+detail::PROFILE_BINS);
+            r.time_min = mini[3*i+0], r.call_min = mini[3*i+1], r.iter_min = mini[3*i+2];
+            r.time_max = maxi[4*i+0], r.call_max = maxi[4*i+1], r.iter_max = maxi[4*i+2];
+            r.calls = maxi[4*i+3];
+        }
+        print_json( os, records, size);
+    }
+#endif //MPI_VERSION
+
+    ///@cond
+    detail::ProfileNode* open( const char* name){
+        m_current = m_current->child( name);
+        return m_current;
+    }
+    void close( detail::ProfileNode* node){
+        m_current = node->parent;
+    }
+    void synchronize() const{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+        if( m_sync) cudaDeviceSynchronize();
+#endif //THRUST
+    }
+    ///@endcond
+  private:
+    static void flatten( const detail::ProfileNode* node, std::vector<const detail::ProfileNode*>& nodes)
+    {
+        for( auto& c : node->children)
+        {
+            nodes.push_back( c.get());
+            flatten( c.get(), nodes);
+        }
+    }
+    static std::vector<std::string> split( const std::string& lines)
+    {
+        std::vector<std::string> out;
+        std::istringstream is( lines);
+        std::string line;
+        while( std::getline( is, line))
+            out.push_back( line);
+        return out;
+    }
+    static detail::ProfileRecord make_record( const detail::ProfileNode* node)
+    {
+        detail::ProfileRecord r;
+        r.path = node->path();
+        r.calls = node->calls;
+        r.time_min = r.time_mean = r.time_max = node->time;
+        r.call_min = node->time_min, r.call_max = node->time_max;
+        r.bytes = node->bytes;
+        r.solves = node->solves, r.iter = node->iter;
+        r.iter_min = node->iter_min, r.iter_max = node->iter_max;
+        r.hist = node->hist;
+        return r;
+    }
+    static void print_json( std::ostream& os, const std::vector<detail::ProfileRecord>& records, int ranks)
+    {
+        std::ostringstream out; //do not change the state of os
+        out << std::setprecision(6);
+        out << "{\n  \"ranks\": "<<ranks<<",\n  \"regions\": [";
+        for( unsigned i=0; i<records.size(); i++)
+        {
+            const detail::ProfileRecord& r = records[i];
+            out << (i==0 ? "\n" : ",\n");
+            out << "    {\"name\": \""<<r.path<<"\", \"calls\": "<<r.calls;
+            out << ", \"time\": {\"min\": "<<r.time_min<<", \"mean\": "<<r.time_mean<<", \"max\": "<<r.time_max<<"}";
+            if( r.calls > 0)
+                out << ", \"per_call\": {\"min\": "<<r.call_min<<", \"max\": "<<r.call_max<<"}";
+            if( r.bytes > 0)
+                out << ", \"bytes\": "<<r.bytes<<", \"bandwidth_GBs\": "<<r.bytes/r.time_max/1e9;
+            if( r.solves > 0)
+            {
+                out << ", \"iterations\": {\"solves\": "<<r.solves<<", \"mean\": "<<r.iter/r.solves;
+                out << ", \"min\": "<<r.iter_min<<", \"max\": "<<r.iter_max<<", \"histogram\": {";
+                bool first = true;
+                for( unsigned k=0; k<detail::PROFILE_BINS; k++)
+                    if( r.hist[k] > 0)
+                    {
+                        out << (first ? "" : ", ") <<"\""<<(k==0 ? 0u : 1u<<k)<<"\": "<<r.hist[k];
+                        first = false;
+                    }
+                out << "}}";
+            }
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+        os << out.str();
+    }
+    std::unique_ptr<detail::ProfileNode> m_root;
+    detail::ProfileNode* m_current;
+    bool m_enabled = true, m_sync = false;
+};
+
+/**
+ * @brief The profiler of this process
+ * @return a reference to the one \c dg::Profiler object
+ * @ingroup timer
+ */
+inline Profiler& profiler()
+{
+    static Profiler p;
+    return p;
+}
+
+/**
+ * @brief Record the lifetime of this object as a region of \c dg::profiler()
+ *
+ * The region is opened in the constructor and closed in the destructor,
+ * also when an exception leaves the scope.
+@code
+unsigned number;
+{
+    dg::ProfileScope scope( "cg");
+    number = pcg( A, x, b, v2d, eps);
+    scope.add_iterations( number);
+    scope.add_bytes( 15.*number*dg::container_bytes( x)); //15 memops per iteration
+}
+@endcode
+ * @ingroup timer
+ */
+struct ProfileScope
+{
+    /**
+     * @brief Open a region
+     * @param name the name of the region (must not contain "/")
+     * @param bytes estimate of the bytes moved in memory in this call
+     */
+    ProfileScope( const char* name, double bytes = 0): m_start( clock::now())
+    {
+        if( !recording())
+            return;
+        profiler().synchronize();
+        m_node = profiler().open( name);
+        m_node->bytes += bytes;
+        m_start = clock::now();
+    }
+    /**
+     * @brief Add to the estimate of bytes moved in memory
+     * @param bytes the number of bytes
+     */
+    void add_bytes( double bytes){
+        if( m_node) m_node->bytes += bytes;
+    }
+    /**
+     * @brief Record the iteration number of a solve inside this region
+     *
+     * May be called several times per region
+     * @param number the number of iterations
+     */
+    void add_iterations( unsigned number){
+        if( !m_node) return;
+        m_node->solves += 1;
+        m_node->iter += number;
+        m_node->iter_min = std::min( m_node->iter_min, (double)number);
+        m_node->iter_max = std::max( m_node->iter_max, (double)number);
+        unsigned bin = detail::profile_bin( number);
+        m_node->hist[ std::min( bin, detail::PROFILE_BINS-1)] += 1;
+    }
+    /**
+     * @brief The time since the region was opened
+     * @return time in seconds
+     */
+    double elapsed() const{
+        return std::chrono::duration<double>( clock::now() - m_start).count();
+    }
+    ~ProfileScope()
+    {
+        if( !m_node)
+            return;
+        profiler().synchronize();
+        double time = elapsed();
+        m_node->calls += 1;
+        m_node->time += time;
+        m_node->time_min = std::min( m_node->time_min, time);
+        m_node->time_max = std::max( m_node->time_max, time);
+        profiler().close( m_node);
+    }
+  private:
+    using clock = std::chrono::steady_clock;
+    static bool recording(){
+#ifdef _OPENMP
+        if( omp_get_thread_num() != 0)
+            return false;
+#endif //_OPENMP
+        return profiler().enabled();
+    }
+    ProfileScope( const ProfileScope&) = delete;
+    ProfileScope& operator=( const ProfileScope&) = delete;
+    detail::ProfileNode* m_node = nullptr;
+    clock::time_point m_start;
+};
+
+///@cond
+template<class ContainerType>
+double container_bytes( const ContainerType& x);
+namespace detail
+{
+template<class ContainerType>
+double doContainerBytes( const ContainerType&, AnyScalarTag){ return sizeof( ContainerType);}
+template<class ContainerType>
+double doContainerBytes( const ContainerType& x, SharedVectorTag){
+    return (double)x.size()*sizeof( get_value_type<ContainerType>);
+}
+template<class ContainerType>
+double doContainerBytes( const ContainerType& x, MPIVectorTag){
+    return container_bytes( x.data());
+}
+template<class ContainerType>
+double doContainerBytes( const ContainerType& x, RecursiveVectorTag){
+    double bytes = 0;
+    for( const auto& xi : x)
+        bytes += container_bytes( xi);
+    return bytes;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief The (process-local) number of bytes one container occupies
+ *
+ * Used to convert the memops of a routine to the byte estimate of a \c dg::ProfileScope
+ * @param x a container
+ * @return size times \c sizeof(value_type), summed over all elements of recursive and MPI containers
+ * @ingroup timer
+ */
+template<class ContainerType>
+double container_bytes( const ContainerType& x)
+{
+    return detail::doContainerBytes( x, get_tensor_category<ContainerType>());
+}
+
+}//namespace dg
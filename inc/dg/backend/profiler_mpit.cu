@@ -0,0 +1,26 @@
+#include <iostream>
+#include <mpi.h>
+
+#include "profiler.h"
+
+int main( int argc, char* argv[])
+{
+    MPI_Init( &argc, &argv);
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    if(rank==0)std::cout << "This program reduces the profile of "<<size<<" ranks\n";
+    for( int i=0; i<=rank; i++)
+    {
+        dg::ProfileScope scope( "step");
+        scope.add_iterations( 10*(rank+1));
+    }
+    if( rank == size-1)
+    {
+        dg::ProfileScope scope( "last"); //only recorded on the last rank
+    }
+    dg::profiler().write_json( std::cout, MPI_COMM_WORLD);
+    if(rank==0)std::cout << "Expected: step with "<<size<<" calls and "<<size*(size+1)/2<<" solves, last with 1 call\n";
+    MPI_Finalize();
+    return 0;
+}
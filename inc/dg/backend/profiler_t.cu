@@ -0,0 +1,47 @@
+#include <iostream>
+#include <cmath>
+
+#include "profiler.h"
+
+double work( unsigned n)
+{
+    double sum = 0;
+    for( unsigned i=0; i<n; i++)
+        sum += sin( (double)i);
+    return sum;
+}
+
+unsigned solve( unsigned k)
+{
+    dg::ProfileScope scope( "solve", 8.*k*1000);
+    work( 1000*k);
+    scope.add_iterations( k);
+    return k;
+}
+
+int main()
+{
+    std::cout << "This program records nested regions and writes the summary as JSON\n";
+    for( unsigned i=1; i<=10; i++)
+    {
+        dg::ProfileScope scope( "step");
+        solve( i);
+        solve( 2*i);
+        {
+            dg::ProfileScope inner( "rhs");
+            work( 500);
+        }
+    }
+    {
+        dg::ProfileScope scope( "output");
+        solve( 100); //appears as a separate region "output/solve"
+    }
+    dg::profiler().set_enabled( false);
+    {
+        dg::ProfileScope scope( "ignored");
+        work( 100);
+    }
+    dg::profiler().write_json( std::cout);
+    std::cout << "Expected: step (10 calls), step/solve (20 solves of 1 to 20 iterations), step/rhs, output, output/solve, no ignored region\n";
+    return 0;
+}
@@ -60,10 +60,28 @@ struct EllSparseBlockMatDevice
     void symv(SharedVectorTag, CudaTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
 #ifdef _OPENMP
     void symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+#endif //_OPENMP
+    /**
+    * @brief Apply the matrix to several vectors at once
+    *
+    * \f[  y_v= \alpha M x_v + \beta y_v\f] for \f$ v = 0,\dots, K-1\f$.
+    * In the OpenMP version the index and data arrays are read only once per
+    * row for all vectors. The result is bitwise identical to \c K calls of the
+    * single vector version.
+    * @param alpha multiplies input
+    * @param num_vectors number of vectors \c K
+    * @param x array (on the host) of \c K pointers to device input
+    * @param beta premultiplies output
+    * @param y array (on the host) of \c K pointers to device output (may not alias any input)
+    */
+    void symv(SharedVectorTag, CudaTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const;
+#ifdef _OPENMP
+    void symv(SharedVectorTag, OmpTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const;
 #endif //_OPENMP
     private:
     using IVec = thrust::device_vector<int>;
     void launch_multiply_kernel(value_type alpha, const value_type* x, value_type beta, value_type* y) const;
+    void launch_multiply_kernel(value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const;
 
     thrust::device_vector<value_type> data;
     IVec cols_idx, data_idx;
@@ -125,6 +143,21 @@ struct CooSparseBlockMatDevice
 #ifdef _OPENMP
     void symv(SharedVectorTag, OmpTag, value_type alpha, const value_type* x, value_type beta, value_type* y) const;
 #endif //_OPENMP
+    /**
+    * @brief Apply the matrix to several vectors (one after the other)
+    *
+    * @param alpha multiplies input
+    * @param num_vectors number of vectors \c K
+    * @param x array (on the host) of \c K pointers to device input
+    * @param beta premultiplies output
+    * @param y array (on the host) of \c K pointers to device output
+    */
+    template<class Policy>
+    void symv(SharedVectorTag, Policy, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const
+    {
+        for( unsigned v=0; v<num_vectors; v++)
+            symv( SharedVectorTag(), Policy(), alpha, x[v], beta, y[v]);
+    }
     using IVec = thrust::device_vector<int>;
 
     void launch_multiply_kernel(value_type alpha, const value_type* x, value_type beta, value_type* y) const;
@@ -143,6 +176,12 @@ inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
     launch_multiply_kernel( alpha, x, beta, y);
 }
 template<class value_type>
+inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
+        value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const
+{
+    launch_multiply_kernel( alpha, num_vectors, x, beta, y);
+}
+template<class value_type>
 inline void CooSparseBlockMatDevice<value_type>::symv(SharedVectorTag, CudaTag,
         value_type alpha, const value_type* x, value_type beta, value_type* y) const
 {
@@ -160,7 +199,27 @@ inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, OmpTag, v
         }
         return;
     }
+    //we are in an enclosing parallel region: x may have been written by other threads
+    #pragma omp barrier
     launch_multiply_kernel(alpha, x, beta, y);
+    #pragma omp barrier
+}
+
+template<class value_type>
+inline void EllSparseBlockMatDevice<value_type>::symv(SharedVectorTag, OmpTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const
+{
+    if( !omp_in_parallel())
+    {
+        #pragma omp parallel
+        {
+            launch_multiply_kernel(alpha, num_vectors, x, beta, y);
+        }
+        return;
+    }
+    //we are in an enclosing parallel region: x may have been written by other threads
+    #pragma omp barrier
+    launch_multiply_kernel(alpha, num_vectors, x, beta, y);
+    #pragma omp barrier
 }
 
 template<class value_type>
@@ -174,7 +233,10 @@ inline void CooSparseBlockMatDevice<value_type>::symv(SharedVectorTag, OmpTag, v
         }
         return;
     }
+    //we are in an enclosing parallel region: x may have been written by other threads
+    #pragma omp barrier
     launch_multiply_kernel(alpha, x, beta, y);
+    #pragma omp barrier
 }
 #endif //_OPENMP
 
@@ -80,6 +80,19 @@ struct EllSparseBlockMat
     * @param y output may not alias input
     */
     void symv(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const;
+    /**
+    * @brief Apply the matrix to several vectors at once
+    *
+    * \f[  y_v= \alpha M x_v + \beta y_v\f] for \f$ v = 0,\dots, K-1\f$.
+    * The index and data arrays are traversed only once for all vectors.
+    * The result is bitwise identical to \c K calls of the single vector version.
+    * @param alpha multiplies input
+    * @param num_vectors number of vectors \c K
+    * @param x array of \c K input pointers
+    * @param beta premultiplies output
+    * @param y array of \c K output pointers (may not alias any input)
+    */
+    void symv(SharedVectorTag, SerialTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const;
     public:
 
     /**
@@ -185,6 +198,21 @@ struct CooSparseBlockMat
     * @attention beta == 1 (anything else is ignored)
     */
     void symv(SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const;
+    /**
+    * @brief Apply the matrix to several vectors (one after the other)
+    *
+    * @param alpha multiplies input
+    * @param num_vectors number of vectors \c K
+    * @param x array of \c K input pointers
+    * @param beta premultiplies output (cannot be anything other than 1, the given value is ignored)
+    * @param y array of \c K output pointers
+    * @attention beta == 1 (anything else is ignored)
+    */
+    void symv(SharedVectorTag, SerialTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const
+    {
+        for( unsigned v=0; v<num_vectors; v++)
+            symv( SharedVectorTag(), SerialTag(), alpha, x[v], beta, y[v]);
+    }
     public:
     /**
     * @brief Display internal data to a stream
@@ -230,6 +258,34 @@ void EllSparseBlockMat<value_type>::symv(SharedVectorTag, SerialTag, value_type
     }
 }
 
+template<class value_type>
+void EllSparseBlockMat<value_type>::symv(SharedVectorTag, SerialTag, value_type alpha, unsigned num_vectors, const value_type* const * x, value_type beta, value_type* const * y) const
+{
+    //same order of operations as the single vector version, only the index reads are shared
+    for( int s=0; s<left_size; s++)
+    for( int i=0; i<num_rows; i++)
+    for( int k=0; k<n; k++)
+    for( unsigned v=0; v<num_vectors; v++)
+    {
+        const value_type * RESTRICT xv = x[v];
+        value_type * RESTRICT yv = y[v];
+        for( int j=right_range[0]; j<right_range[1]; j++)
+        {
+            int I = ((s*num_rows + i)*n+k)*right_size+j;
+            yv[I]*= beta;
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                value_type temp = 0;
+                for( int q=0; q<n; q++) //multiplication-loop
+                    temp = DG_FMA( data[ (data_idx[i*blocks_per_line+d]*n + k)*n+q],
+                                xv[((s*num_cols + cols_idx[i*blocks_per_line+d])*n+q)*right_size+j],
+                                temp);
+                yv[I] = DG_FMA( alpha,temp, yv[I]);
+            }
+        }
+    }
+}
+
 template<class value_type>
 void CooSparseBlockMat<value_type>::symv( SharedVectorTag, SerialTag, value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const
 {
@@ -161,6 +161,14 @@ void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
     }
 }
 
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alpha, unsigned num_vectors, const value_type* const * x_ptr, value_type beta, value_type* const * y_ptr) const
+{
+    //the kernels are bandwidth bound by the vectors on the gpu, the index arrays are cached
+    for( unsigned v=0; v<num_vectors; v++)
+        launch_multiply_kernel( alpha, x_ptr[v], beta, y_ptr[v]);
+}
+
 //////////////////// COO multiply kernel
 template<class value_type>
  __global__ void coo_multiply_kernel(
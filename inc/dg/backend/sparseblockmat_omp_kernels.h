@@ -1,10 +1,194 @@
 #include <omp.h>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
 #include "config.h"
+#include "exblas/config.h"
 
 //for the fmas it is important to activate -mfma compiler flag
 
+//%%%%%%%%%%%%%%%%explicit SIMD width for the right_size != 1 kernels%%%%%%%%%%%%%%%%
+//DG_SIMD_WIDTH is the number of doubles per SIMD register (0 deactivates the explicit kernels)
+#ifndef DG_SIMD_WIDTH
+#if defined( _WITHOUT_VCL)
+#define DG_SIMD_WIDTH 0
+#elif INSTRSET >= 9 //AVX512F
+#define DG_SIMD_WIDTH 8
+#elif INSTRSET >= 7 //AVX and AVX2
+#define DG_SIMD_WIDTH 4
+#else
+#define DG_SIMD_WIDTH 0
+#endif
+#endif//DG_SIMD_WIDTH
+
+#if DG_SIMD_WIDTH != 0 && defined( _WITHOUT_VCL)
+#error "DG_SIMD_WIDTH != 0 needs the vcl library"
+#endif
+
 namespace dg{
 
+///@cond
+namespace detail{
+//the vcl vector type that holds DG_SIMD_WIDTH doubles (or twice as many floats)
+template<class value_type, int width>
+struct SimdType{ static constexpr bool enabled = false;};
+#if DG_SIMD_WIDTH != 0
+template<>
+struct SimdType<double, 4>{ static constexpr bool enabled = true; using type = vcl::Vec4d;};
+template<>
+struct SimdType<double, 8>{ static constexpr bool enabled = true; using type = vcl::Vec8d;};
+template<>
+struct SimdType<float, 4>{ static constexpr bool enabled = true; using type = vcl::Vec8f;};
+template<>
+struct SimdType<float, 8>{ static constexpr bool enabled = true; using type = vcl::Vec16f;};
+#endif//DG_SIMD_WIDTH
+
+//a fast (hardware) fma exists for value_type: FP_FAST_FMA for double, FP_FAST_FMAF for float
+template<class value_type>
+struct FastFma : public std::false_type{};
+#ifdef FP_FAST_FMA
+template<>
+struct FastFma<double> : public std::true_type{};
+#endif//FP_FAST_FMA
+#ifdef FP_FAST_FMAF
+template<>
+struct FastFma<float> : public std::true_type{};
+#endif//FP_FAST_FMAF
+//DG_FMA fuses for every type if FP_FAST_FMA is defined; the explicit kernels
+//are used only if simd_fma rounds the same way, else the results would differ
+template<class value_type>
+struct UseSimd : public std::integral_constant<bool, SimdType<value_type, DG_SIMD_WIDTH>::enabled
+    && FastFma<value_type>::value == FastFma<double>::value>{};
+
+//compute one line y[I0+j] for j in [j0,j1) (the right_size != 1 case)
+//the order of operations is the same for every j and every width
+template<class value_type, int n, int blocks_per_line>
+inline void ell_multiply_line( value_type alpha, value_type beta,
+         const value_type * RESTRICT dprivate, const int * RESTRICT J,
+         const int right_size, const int I0, const int j0, const int j1,
+         const value_type * RESTRICT x, value_type * RESTRICT y, std::false_type)
+{
+#ifndef _MSC_VER
+#pragma omp SIMD //very important for KNL
+#endif
+    for( int j=j0; j<j1; j++)
+    {
+        int I = I0+j;
+        y[I]*= beta;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            value_type temp = 0;
+            int Jd = J[d];
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp = DG_FMA( dprivate[ d*n+q],
+                            x[(Jd+q)*right_size+j],
+                            temp);
+            y[I] = DG_FMA(alpha, temp, y[I]);
+        }
+    }
+}
+
+#if DG_SIMD_WIDTH != 0
+//fused if a fast fma exists for value_type (same rounding as DG_FMA if UseSimd<value_type>)
+template<class value_type, class Vec>
+inline Vec simd_fma( const Vec& a, const Vec& b, const Vec& c)
+{
+    if( FastFma<value_type>::value)
+        return vcl::mul_add( a, b, c);
+    return a*b+c;
+}
+
+template<class Vec, bool aligned>
+struct SimdLoadStore
+{
+    template<class T>
+    static Vec load( const T* ptr){ return Vec().load( ptr);}
+    template<class T>
+    static void store( const Vec& v, T* ptr){ v.store( ptr);}
+};
+template<class Vec>
+struct SimdLoadStore<Vec,true>
+{
+    template<class T>
+    static Vec load( const T* ptr){ return Vec().load_a( ptr);}
+    template<class T>
+    static void store( const Vec& v, T* ptr){ v.store_a( ptr);}
+};
+
+//explicitly vectorized version: a scalar head until I0+j is aligned, then full
+//SIMD lanes, then a scalar tail
+template<class value_type, int n, int blocks_per_line, bool aligned>
+inline void ell_multiply_line_simd( value_type alpha, value_type beta,
+         const value_type * RESTRICT dprivate, const int * RESTRICT J,
+         const int right_size, const int I0, const int j0, const int j1,
+         const value_type * RESTRICT x, value_type * RESTRICT y)
+{
+    using Vec = typename SimdType<value_type, DG_SIMD_WIDTH>::type;
+    using LS = SimdLoadStore<Vec, aligned>;
+    const int W = Vec::size();
+    int head = j0;
+    if( aligned)
+        head = std::min( j1, j0 + (W - (I0+j0)%W)%W);
+    ell_multiply_line<value_type, n, blocks_per_line>( alpha, beta, dprivate,
+            J, right_size, I0, j0, head, x, y, std::false_type());
+    Vec va( alpha), vb( beta);
+    Vec vd[blocks_per_line*n];
+    for( int dq=0; dq<blocks_per_line*n; dq++)
+        vd[dq] = Vec( dprivate[dq]);
+    int j=head;
+    for( ; j+W<=j1; j+=W)
+    {
+        int I = I0+j;
+        Vec vy = LS::load( y+I);
+        vy *= vb;
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            Vec temp( value_type(0));
+            int Jd = J[d];
+            for( int q=0; q<n; q++) //multiplication-loop
+                temp = simd_fma<value_type>( vd[ d*n+q], LS::load( x+(Jd+q)*right_size+j), temp);
+            vy = simd_fma<value_type>( va, temp, vy);
+        }
+        LS::store( vy, y+I);
+    }
+    ell_multiply_line<value_type, n, blocks_per_line>( alpha, beta, dprivate,
+            J, right_size, I0, j, j1, x, y, std::false_type());
+}
+
+template<class value_type, int n, int blocks_per_line>
+inline void ell_multiply_line( value_type alpha, value_type beta,
+         const value_type * RESTRICT dprivate, const int * RESTRICT J,
+         const int right_size, const int I0, const int j0, const int j1,
+         const value_type * RESTRICT x, value_type * RESTRICT y, std::true_type)
+{
+    //aligned loads are possible if all lines start at an aligned address
+    using Vec = typename SimdType<value_type, DG_SIMD_WIDTH>::type;
+    const unsigned bytes = Vec::size()*sizeof(value_type);
+    bool aligned = right_size%Vec::size() == 0
+        && reinterpret_cast<std::uintptr_t>(x)%bytes == 0
+        && reinterpret_cast<std::uintptr_t>(y)%bytes == 0;
+    if( aligned)
+        ell_multiply_line_simd<value_type, n, blocks_per_line, true>( alpha, beta,
+            dprivate, J, right_size, I0, j0, j1, x, y);
+    else
+        ell_multiply_line_simd<value_type, n, blocks_per_line, false>( alpha, beta,
+            dprivate, J, right_size, I0, j0, j1, x, y);
+}
+#endif//DG_SIMD_WIDTH
+
+template<class value_type, int n, int blocks_per_line>
+inline void ell_multiply_line( value_type alpha, value_type beta,
+         const value_type * RESTRICT dprivate, const int * RESTRICT J,
+         const int right_size, const int I0, const int j0, const int j1,
+         const value_type * RESTRICT x, value_type * RESTRICT y)
+{
+    ell_multiply_line<value_type, n, blocks_per_line>( alpha, beta, dprivate,
+            J, right_size, I0, j0, j1, x, y,
+            std::integral_constant<bool, UseSimd<value_type>::value>());
+}
+}//namespace detail
+///@endcond
+
 // general multiply kernel
 template<class value_type>
 void ell_multiply_kernel( value_type alpha, value_type beta,
@@ -219,25 +403,82 @@ void ell_multiply_kernel( value_type alpha, value_type beta,
             for(int q=0; q<n; q++)
                 dprivate[d*n+q] = data[B+q];
         }
-#ifndef _MSC_VER
-#pragma omp SIMD //very important for KNL
-#endif
-        for( int j=right_range[0]; j<right_range[1]; j++)
+        detail::ell_multiply_line<value_type, n, blocks_per_line>( alpha, beta,
+                dprivate, J, right_size, ((s*num_rows + i)*n+k)*right_size,
+                right_range[0], right_range[1], x, y);
+    }
+    }
+}
+
+//specialized multiply kernel for several vectors at once
+//(the order of operations for each vector is the same as in the kernel above)
+template<class value_type, int n, int blocks_per_line>
+void ell_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data, const int * RESTRICT cols_idx, const int * RESTRICT data_idx,
+         const int num_rows, const int num_cols,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range,
+         const int num_vectors,
+         const value_type * const * x, value_type * const * y
+         )
+{
+    if(right_size==1)
+    {
+    value_type dprivate[blocks_per_line*n*n];
+    int J[blocks_per_line];
+    #pragma omp for nowait
+    for( int si = 0; si<left_size*num_rows; si++)
+    {
+        int s = si / num_rows;
+        int i = si % num_rows;
+        for( int d=0; d<blocks_per_line; d++)
         {
-            int I = ((s*num_rows + i)*n+k)*right_size+j;
-            y[I]*= beta;
-            for( int d=0; d<blocks_per_line; d++)
+            J[d] = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+            int B = data_idx[i*blocks_per_line+d]*n*n;
+            for( int kq=0; kq<n*n; kq++)
+                dprivate[d*n*n+kq] = data[B+kq];
+        }
+        for( int v=0; v<num_vectors; v++)
+        {
+            const value_type * RESTRICT xv = x[v];
+            value_type * RESTRICT yv = y[v];
+            for( int k=0; k<n; k++)
             {
-                value_type temp = 0;
-                int Jd = J[d];
-                for( int q=0; q<n; q++) //multiplication-loop
-                    temp = DG_FMA( dprivate[ d*n+q],
-                                x[(Jd+q)*right_size+j],
-                                temp);
-                y[I] = DG_FMA(alpha, temp, y[I]);
+                value_type temp[blocks_per_line] = {0};
+                for( int d=0; d<blocks_per_line; d++)
+                    for( int q=0; q<n; q++) //multiplication-loop
+                        temp[d] = DG_FMA( dprivate[(d*n+k)*n+q], xv[J[d]+q], temp[d]);
+                int I = ((s*num_rows + i)*n+k);
+                yv[I]*= beta;
+                for( int d=0; d<blocks_per_line; d++)
+                    yv[I] = DG_FMA(alpha, temp[d], yv[I]);
             }
         }
     }
+    }// right_size==1
+    else // right_size != 1
+    {
+    value_type dprivate[blocks_per_line*n];
+    int J[blocks_per_line];
+#pragma omp for nowait
+	for (int sik = 0; sik < left_size*num_rows*n; sik++)
+	{
+		int s = sik / (num_rows*n);
+		int i = (sik % (num_rows*n)) / n;
+		int k = (sik % (num_rows*n)) % n;
+
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            J[d] = (s*num_cols+cols_idx[i*blocks_per_line+d])*n;
+            int B = (data_idx[i*blocks_per_line+d]*n+k)*n;
+            for(int q=0; q<n; q++)
+                dprivate[d*n+q] = data[B+q];
+        }
+        for( int v=0; v<num_vectors; v++)
+            detail::ell_multiply_line<value_type, n, blocks_per_line>( alpha, beta,
+                dprivate, J, right_size, ((s*num_rows + i)*n+k)*right_size,
+                right_range[0], right_range[1], x[v], y[v]);
+    }
     }
 }
 
@@ -298,6 +539,65 @@ void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alp
             data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, n, left_size, right_size, right_range_ptr,  x_ptr,y_ptr);
 }
 
+template<class value_type, int n>
+void call_ell_multiply_kernel( value_type alpha, value_type beta,
+         const value_type * RESTRICT data_ptr, const int * RESTRICT cols_ptr, const int * RESTRICT block_ptr,
+         const int num_rows, const int num_cols, const int blocks_per_line,
+         const int left_size, const int right_size,
+         const int * RESTRICT right_range_ptr,
+         const int num_vectors,
+         const value_type * const * x_ptr, value_type * const * y_ptr)
+{
+    if( blocks_per_line == 1)
+        ell_multiply_kernel<value_type, n, 1>  (alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, left_size, right_size, right_range_ptr, num_vectors, x_ptr,y_ptr);
+    else if (blocks_per_line == 2)
+        ell_multiply_kernel<value_type, n, 2>  (alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, left_size, right_size, right_range_ptr, num_vectors, x_ptr,y_ptr);
+    else if (blocks_per_line == 3)
+        ell_multiply_kernel<value_type, n, 3>  (alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, left_size, right_size, right_range_ptr, num_vectors, x_ptr,y_ptr);
+    else if (blocks_per_line == 4)
+        ell_multiply_kernel<value_type, n, 4>  (alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, left_size, right_size, right_range_ptr, num_vectors, x_ptr,y_ptr);
+    else
+        for( int v=0; v<num_vectors; v++)
+            ell_multiply_kernel<value_type>  (alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, n, left_size, right_size, right_range_ptr,  x_ptr[v],y_ptr[v]);
+}
+
+template<class value_type>
+void EllSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alpha, unsigned num_vectors, const value_type* const * x_ptr, value_type beta, value_type* const * y_ptr) const
+{
+    const value_type* data_ptr = thrust::raw_pointer_cast( &data[0]);
+    const int* cols_ptr = thrust::raw_pointer_cast( &cols_idx[0]);
+    const int* block_ptr = thrust::raw_pointer_cast( &data_idx[0]);
+    const int* right_range_ptr = thrust::raw_pointer_cast( &right_range[0]);
+    const int K = num_vectors;
+    if( n == 1)
+        call_ell_multiply_kernel<value_type, 1>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else if( n == 2)
+        call_ell_multiply_kernel<value_type, 2>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else if( n == 3)
+        call_ell_multiply_kernel<value_type, 3>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else if( n == 4)
+        call_ell_multiply_kernel<value_type, 4>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else if( n == 5)
+        call_ell_multiply_kernel<value_type, 5>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else if( n == 6)
+        call_ell_multiply_kernel<value_type, 6>  (alpha, beta,
+            data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, left_size, right_size, right_range_ptr, K, x_ptr,y_ptr);
+    else
+        for( int v=0; v<K; v++)
+            ell_multiply_kernel<value_type> ( alpha, beta,
+                data_ptr, cols_ptr, block_ptr, num_rows, num_cols, blocks_per_line, n, left_size, right_size, right_range_ptr,  x_ptr[v],y_ptr[v]);
+}
+
 template<class value_type>
 void CooSparseBlockMatDevice<value_type>::launch_multiply_kernel( value_type alpha, const value_type* RESTRICT x, value_type beta, value_type* RESTRICT y) const
 {
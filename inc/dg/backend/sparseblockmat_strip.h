@@ -0,0 +1,160 @@
+#pragma once
+
+#include "config.h"
+#include "sparseblockmat.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
+
+//helper functions for kernels that sweep over the block rows of a 2d grid
+//and combine several x- and y-matrices (cf. elliptic_cpu.h and arakawa_cpu.h)
+namespace dg
+{
+///@cond
+namespace detail{
+
+//y[k*L+j] += alpha*(M x)[k*L+j] for one block row i of a y-matrix (right_size = L)
+//x points to the beginning of the plane
+//(the order of operations is the same as in ell_multiply_kernel such that the results are binary identical)
+template<class value_type, int n, int blocks_per_line>
+void ell_strip_multiply( const EllSparseBlockMat<value_type>& m, int i, value_type alpha,
+        const value_type* RESTRICT x, value_type* RESTRICT y)
+{
+    const int L = m.right_size;
+    const value_type* xd[blocks_per_line];
+    value_type a[n*blocks_per_line*n];
+    for( int d=0; d<blocks_per_line; d++)
+    {
+        xd[d] = x + m.cols_idx[i*blocks_per_line+d]*n*L;
+        const value_type* data = &m.data[m.data_idx[i*blocks_per_line+d]*n*n];
+        for( int k=0; k<n; k++)
+        for( int q=0; q<n; q++)
+            a[(k*blocks_per_line+d)*n+q] = data[k*n+q];
+    }
+    for( int k=0; k<n; k++)
+    {
+#ifndef _MSC_VER
+#pragma omp SIMD
+#endif
+        for( int j=0; j<L; j++)
+        {
+            value_type yy = y[k*L+j];
+            for( int d=0; d<blocks_per_line; d++)
+            {
+                value_type temp = 0;
+                for( int q=0; q<n; q++)
+                    temp = DG_FMA( a[(k*blocks_per_line+d)*n+q], xd[d][q*L+j], temp);
+                yy = DG_FMA( alpha, temp, yy);
+            }
+            y[k*L+j] = yy;
+        }
+    }
+}
+template<class value_type, int n>
+void ell_strip_multiply( const EllSparseBlockMat<value_type>& m, int i, value_type alpha,
+        const value_type* RESTRICT x, value_type* RESTRICT y)
+{
+    switch( m.blocks_per_line)
+    {
+        case 1: ell_strip_multiply<value_type, n, 1>( m, i, alpha, x, y); break;
+        case 2: ell_strip_multiply<value_type, n, 2>( m, i, alpha, x, y); break;
+        case 3: ell_strip_multiply<value_type, n, 3>( m, i, alpha, x, y); break;
+        case 4: ell_strip_multiply<value_type, n, 4>( m, i, alpha, x, y); break;
+    }
+}
+
+//y += alpha*M x for one line of an x-matrix (right_size = 1)
+//(the order of operations is the same as in ell_multiply_kernel such that the results are binary identical)
+template<class value_type, int n, int blocks_per_line>
+void ell_line_multiply( const EllSparseBlockMat<value_type>& m, value_type alpha,
+        const value_type* RESTRICT x, value_type* RESTRICT y)
+{
+    for( int i=0; i<m.num_rows; i++)
+    {
+        value_type temp[blocks_per_line][n];
+        for( int d=0; d<blocks_per_line; d++)
+        {
+            const value_type* data = &m.data[m.data_idx[i*blocks_per_line+d]*n*n];
+            const value_type* xd = x + m.cols_idx[i*blocks_per_line+d]*n;
+            for( int k=0; k<n; k++)
+            {
+                temp[d][k] = 0;
+                for( int q=0; q<n; q++)
+                    temp[d][k] = DG_FMA( data[k*n+q], xd[q], temp[d][k]);
+            }
+        }
+        for( int k=0; k<n; k++)
+        for( int d=0; d<blocks_per_line; d++)
+            y[i*n+k] = DG_FMA( alpha, temp[d][k], y[i*n+k]);
+    }
+}
+template<class value_type, int n>
+void ell_line_multiply( const EllSparseBlockMat<value_type>& m, value_type alpha,
+        const value_type* RESTRICT x, value_type* RESTRICT y)
+{
+    switch( m.blocks_per_line)
+    {
+        case 1: ell_line_multiply<value_type, n, 1>( m, alpha, x, y); break;
+        case 2: ell_line_multiply<value_type, n, 2>( m, alpha, x, y); break;
+        case 3: ell_line_multiply<value_type, n, 3>( m, alpha, x, y); break;
+        case 4: ell_line_multiply<value_type, n, 4>( m, alpha, x, y); break;
+    }
+}
+
+//a FIFO cache of (up to) three strips, each holding num_arrays arrays of strip_size
+//(in a sweep over the block rows the neighbors of the previous row are reused)
+template<class value_type>
+struct StripRing
+{
+    StripRing( int num_arrays, int strip_size): m_data( 3*num_arrays*strip_size), m_num( num_arrays), m_size( strip_size){}
+    //return the slot holding key or -1
+    int find( int key) const{
+        for( int b=0; b<3; b++)
+            if( m_tag[b] == key) return b;
+        return -1;
+    }
+    //claim the oldest slot for key
+    int insert( int key){
+        int slot = m_next;
+        m_next = (m_next+1)%3;
+        m_tag[slot] = key;
+        return slot;
+    }
+    value_type* get( int slot, int array){
+        return thrust::raw_pointer_cast( m_data.data()) + (slot*m_num+array)*m_size;
+    }
+    //forget all keys (the memory is kept)
+    void clear(){
+        m_tag[0] = m_tag[1] = m_tag[2] = -1;
+        m_next = 0;
+    }
+    private:
+    thrust::host_vector<value_type> m_data;
+    int m_num, m_size;
+    int m_tag[3] = {-1,-1,-1}, m_next = 0;
+};
+
+//the scratch memory of one thread in a strip kernel: a ring of strips and one line
+//(allocated once by the caller and reused in every call)
+template<class value_type>
+struct StripWorkspace
+{
+    StripWorkspace( int num_arrays, int strip_size, int line_size): ring( num_arrays, strip_size), line( line_size){}
+    StripRing<value_type> ring;
+    thrust::host_vector<value_type> line;
+};
+
+#ifdef _OPENMP
+//the contiguous range of strips of the calling thread
+inline void omp_strip_range( int num_strips, int& begin, int& end)
+{
+    const int size = omp_get_num_threads(), rank = omp_get_thread_num();
+    const int local = num_strips/size, rest = num_strips%size;
+    begin = rank*local + (rank < rest ? rank : rest);
+    end = begin + local + (rank < rest ? 1 : 0);
+}
+#endif //_OPENMP
+
+}//namespace detail
+///@endcond
+}//namespace dg
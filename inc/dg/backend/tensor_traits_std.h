@@ -11,8 +11,9 @@ namespace dg
 ///@{
 
 ///@brief Prototypical Recursive Vector
+///@note a \c std::vector of pointers is not a vector but a list of arguments (e.g. to the batched \c dg::blas2::symv)
 template<class T>
-struct TensorTraits<std::vector<T>>
+struct TensorTraits<std::vector<T>, typename std::enable_if< !std::is_pointer<T>::value>::type>
 {
     using value_type        = get_value_type<T>;
     using tensor_category   = RecursiveVectorTag;
@@ -15,6 +15,8 @@
 #include "backend/blas1_dispatch_mpi.h"
 #endif
 #include "backend/blas1_dispatch_vector.h"
+#include "backend/dot_future.h"
+#include "backend/parallel_region.h"
 #include "subroutines.h"
 
 /*!@file
@@ -463,6 +465,104 @@ inline std::vector<int64_t> doDot_superacc( const ContainerType1& x, const Conta
     return doDot_superacc( x, y, tensor_category());
 }
 
+//The process-local part of doDot_superacc i.e. without the MPI reduction.
+//Several of these can be reduced together in one call to doReduce_superacc
+template< class ContainerType1, class ContainerType2>
+inline std::vector<int64_t> doLocalDot_superacc( const ContainerType1& x, const ContainerType2& y);
+
+template< class Vector1, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Vector2& y, AnyVectorTag)
+{
+    return doDot_superacc( x,y);
+}
+#ifdef MPI_VERSION
+template< class Vector1, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Vector2& y, MPIVectorTag)
+{
+#ifdef DG_DEBUG
+    mpi_assert( x,y);
+#endif //DG_DEBUG
+    return doLocalDot_superacc(
+        do_get_data(x,get_tensor_category<Vector1>()),
+        do_get_data(y,get_tensor_category<Vector2>()));
+}
+#endif //MPI_VERSION
+template< class Vector1, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Vector2& y, RecursiveVectorTag)
+{
+    constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, Vector1, Vector1, Vector2>::value;
+    auto size = get_idx<vector_idx>(x,y).size();
+    std::vector<int64_t> acc( exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<size; i++)
+    {
+        std::vector<int64_t> temp = doLocalDot_superacc( do_get_vector_element(x,i,get_tensor_category<Vector1>()), do_get_vector_element(y,i,get_tensor_category<Vector2>()));
+        int imin = exblas::IMIN, imax = exblas::IMAX;
+        exblas::cpu::Normalize( &(temp[0]), imin, imax);
+        for( int k=exblas::IMIN; k<exblas::IMAX; k++)
+            acc[k] += temp[k];
+        if( i%128 == 0)
+        {
+            imin = exblas::IMIN, imax = exblas::IMAX;
+            exblas::cpu::Normalize( &(acc[0]), imin, imax);
+        }
+    }
+    return acc;
+}
+template< class ContainerType1, class ContainerType2>
+inline std::vector<int64_t> doLocalDot_superacc( const ContainerType1& x, const ContainerType2& y)
+{
+    using vector_type = find_if_t<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>;
+    return doLocalDot_superacc( x, y, get_tensor_category<vector_type>());
+}
+
+//Reduce num_superacc process-local superaccumulators (stored contiguously in acc)
+//among all processes that share the vector x (no-op for shared memory vectors)
+template<class ContainerType>
+inline void doReduce_superacc( unsigned num_superacc, std::vector<int64_t>& acc, const ContainerType& x, AnyVectorTag){ }
+#ifdef MPI_VERSION
+template<class ContainerType>
+inline void doReduce_superacc( unsigned num_superacc, std::vector<int64_t>& acc, const ContainerType& x, MPIVectorTag)
+{
+    std::vector<int64_t> receive( num_superacc*exblas::BIN_COUNT, (int64_t)0);
+    exblas::allreduce_mpi_cpu( num_superacc, acc.data(), receive.data(), x.communicator());
+    acc.swap( receive);
+}
+#endif //MPI_VERSION
+template<class ContainerType>
+inline void doReduce_superacc( unsigned num_superacc, std::vector<int64_t>& acc, const ContainerType& x, RecursiveVectorTag)
+{
+    //all elements share the same communicator
+    if( x.size() > 0)
+        doReduce_superacc( num_superacc, acc, x[0], get_tensor_category<decltype(x[0])>());
+}
+
+//Initiate the reduction of num_superacc process-local superaccumulators, returns immediately
+template<class ContainerType>
+inline DotFuture doReduce_superacc_async( unsigned num_superacc, std::vector<int64_t>&& acc, const ContainerType& x, AnyVectorTag)
+{
+    return DotFuture( num_superacc, std::move(acc));
+}
+#ifdef MPI_VERSION
+template<class ContainerType>
+inline DotFuture doReduce_superacc_async( unsigned num_superacc, std::vector<int64_t>&& acc, const ContainerType& x, MPIVectorTag)
+{
+    return DotFuture( num_superacc, std::move(acc), x.communicator());
+}
+#endif //MPI_VERSION
+template<class ContainerType>
+inline DotFuture doReduce_superacc_async( unsigned num_superacc, std::vector<int64_t>&& acc, const ContainerType& x, RecursiveVectorTag)
+{
+    //all elements share the same communicator
+    if( x.size() > 0)
+        return doReduce_superacc_async( num_superacc, std::move(acc), x[0], get_tensor_category<decltype(x[0])>());
+    return DotFuture( num_superacc, std::move(acc));
+}
+template<class ContainerType>
+inline DotFuture doReduce_superacc_async( unsigned num_superacc, std::vector<int64_t>&& acc, const ContainerType& x)
+{
+    return doReduce_superacc_async( num_superacc, std::move(acc), x, get_tensor_category<ContainerType>());
+}
+
 }//namespace detail
 ///@endcond
 
@@ -515,6 +615,52 @@ inline void subroutine( Subroutine f, ContainerType&& x, ContainerTypes&&... xs)
     dg::blas1::detail::doSubroutine(tensor_category(), f, std::forward<ContainerType>(x), std::forward<ContainerTypes>(xs)...);
 }
 
+/**
+ * @brief Bind a subroutine to a selection of the arguments of a fused subroutine (s.a. \c dg::blas1::fuse)
+ *
+ * The returned functor called with the elements \f$ x_0, x_1, ...\f$ calls \c f with the elements at the positions \c Is
+ * i.e. \f$ f(x_{I_0}, x_{I_1}, ...)\f$
+ * @tparam Is The positions of the arguments (starting at 0) in the order \c f expects them
+ * @param f a subroutine as in \c dg::blas1::subroutine
+ * @return a subroutine that can be used in \c dg::blas1::fuse
+ */
+template<unsigned ...Is, class Subroutine>
+inline SubroutineOn<Subroutine, Is...> on( Subroutine f)
+{
+    return SubroutineOn<Subroutine, Is...>( f);
+}
+
+/**
+ * @brief Record a chain of elementwise subroutines to be evaluated in a single pass through memory
+ *
+ * The returned subroutine calls all \c fs one after the other on the same elements.
+ * Passed to \c dg::blas1::subroutine the whole chain is evaluated in a single loop (a single parallel region
+ * with OpenMP and a single kernel with CUDA), i.e. every vector is read and written only once
+ * while the equivalent sequence of \c blas1 calls streams it once per call.
+@code
+dg::DVec x( 100, 2), y( 100, 4), z( 100);
+//y = 2x+y and then z = x*y in one pass, i.e.
+//dg::blas1::axpby( 2., x, 1., y); dg::blas1::pointwiseDot( x, y, z);
+dg::blas1::subroutine( dg::blas1::fuse(
+        dg::blas1::on<0,1>( dg::Axpby<double>( 2., 1.)),
+        dg::blas1::on<0,1,2>( dg::PointwiseDot<double>( 1., 0.))),
+    x, y, z);
+// y[i] now has the value 8 and z[i] the value 16
+@endcode
+ * The functors \c dg::Axpby, \c dg::Axpbypgz, \c dg::PointwiseDot, \c dg::PointwiseDivide, \c dg::Scal and \c dg::Plus
+ * are the ones used by the corresponding \c blas1 functions (with the same meaning of the parameters);
+ * \c dg::Evaluate combines e.g. \c dg::equals with a functor as in \c dg::blas1::transform.
+ * @param fs the subroutines to fuse (usually created with \c dg::blas1::on)
+ * @return a subroutine for the use in \c dg::blas1::subroutine
+ * @note the result is binary identical to the one of the sequence of \c blas1 calls unless the
+ * short-cuts of the \c blas1 functions for zero coefficients matter (e.g. \c axpby with \c beta=0 and a \c NaN in \c y)
+ */
+template<class ...Subroutines>
+inline Fused<Subroutines...> fuse( Subroutines... fs)
+{
+    return Fused<Subroutines...>( fs...);
+}
+
 /*! @brief \f$ x^T y\f$ Binary reproducible Euclidean dot product between two vectors
  *
  * This routine computes \f[ x^T y = \sum_{i=0}^{N-1} x_i y_i \f]
@@ -545,6 +691,32 @@ inline get_value_type<ContainerType1> dot( const ContainerType1& x, const Contai
 //    return dg::blas1::detail::doDot( x, y, get_tensor_category<ContainerType1>(), get_tensor_category<ContainerType2>() );
 }
 
+/*! @brief \f$ x^T y\f$ Binary reproducible Euclidean dot product that is reduced asynchronously
+ *
+ * Computes the same scalar product as \c dg::blas1::dot but returns as soon as the process-local
+ * part is computed. With MPI the global reduction continues in the background while work
+ * that does not depend on the result is done:
+@code
+dg::DotFuture future = dg::blas1::async_dot( r, r);
+dg::blas2::symv( A, p, Ap); //overlaps with the reduction
+double rr = future.get(); //identical to dg::blas1::dot( r, r)
+@endcode
+ * @param x Left ContainerType
+ * @param y Right ContainerType may alias x
+ * @return handle to the scalar product, call \c get() to obtain its value
+ * @note \c x and \c y may be changed once the function returns
+ * @attention not supported inside a \c dg::parallel_region
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class ContainerType2>
+inline DotFuture async_dot( const ContainerType1& x, const ContainerType2& y)
+{
+    using vector_type = find_if_t<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>;
+    constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>::value;
+    return dg::blas1::detail::doReduce_superacc_async( 1, dg::blas1::detail::doLocalDot_superacc( x,y),
+        get_idx<vector_idx>(x,y), get_tensor_category<vector_type>());
+}
+
 /**
  * @brief y=x; Generic way to copy-construct/assign-to an object of \c to_ContainerType type from a different \c from_ContainerType type
  *
@@ -85,6 +85,18 @@ int main()
     dg::blas1::scal( w2, 0.6);
     dg::blas1::plus( w3, -7.0);
     std::cout << "e^2-7 = " << w3[0][0] <<" (0.389056...)"<< std::endl;
+    //y = 2x+y and then z = x*y in one pass
+    dg::blas1::subroutine( dg::blas1::fuse(
+            dg::blas1::on<0,1>( dg::Axpby<double>( 2., 1.)),
+            dg::blas1::on<0,1,2>( dg::PointwiseDot<double>( 1., 0.))),
+        v1, v2, v3);
+    std::cout << "fused 2*2+3 = " << v2[0] <<" (7)"<< std::endl;
+    std::cout << "fused 2*7 = " << v3[0] <<" (14)"<< std::endl;
+    dg::blas1::subroutine( dg::blas1::fuse(
+            dg::blas1::on<0>( dg::Scal<double>( 0.5)),
+            dg::blas1::on<2,0,1>( dg::PointwiseDot<double>( 1., 0.))),
+        w1, w4, 1.);
+    std::cout << "fused 0.5*2*1 = " << w4[0][0] <<" (1)"<< std::endl;
     std::cout << "\nFINISHED! Continue with geometry/evaluation_t.cu !\n\n";
 
     return 0;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
 #include "backend/tensor_traits.h"
 #include "backend/tensor_traits_std.h"
 #include "backend/tensor_traits_thrust.h"
@@ -51,6 +54,64 @@ inline std::vector<int64_t> doDot_superacc( const ContainerType1& x, const Matri
     return doDot_superacc( x, m, y, get_tensor_category<MatrixType>(), vector_category());
 }
 
+//The process-local part of doDot_superacc i.e. without the MPI reduction (s.a. dg::blas1::detail::doReduce_superacc)
+template< class ContainerType1, class MatrixType, class ContainerType2>
+inline std::vector<int64_t> doLocalDot_superacc( const ContainerType1& x, const MatrixType& m, const ContainerType2& y);
+
+template< class Vector1, class Matrix, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Matrix& m, const Vector2& y, AnyVectorTag)
+{
+    return doDot_superacc( x,m,y);
+}
+#ifdef MPI_VERSION
+template< class Vector1, class Matrix, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Matrix& m, const Vector2& y, MPIVectorTag)
+{
+    return doLocalDot_superacc(
+        do_get_data(x, get_tensor_category<Vector1>()),
+        do_get_data(m, get_tensor_category<Matrix>()),
+        do_get_data(y, get_tensor_category<Vector2>()));
+}
+#endif //MPI_VERSION
+template< class Matrix>
+inline const Matrix& get_local_weights( const Matrix& m, unsigned i, AnyVectorTag){
+    return m;
+}
+template< class Matrix>
+inline auto get_local_weights( const Matrix& m, unsigned i, RecursiveVectorTag) -> decltype( m[i]){
+    return m[i];
+}
+template< class Vector1, class Matrix, class Vector2>
+inline std::vector<int64_t> doLocalDot_superacc( const Vector1& x, const Matrix& m, const Vector2& y, RecursiveVectorTag)
+{
+    constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, Vector1, Vector1, Vector2>::value;
+    auto size = get_idx<vector_idx>(x,y).size();
+    std::vector<int64_t> acc( exblas::BIN_COUNT, (int64_t)0);
+    for( unsigned i=0; i<size; i++)
+    {
+        std::vector<int64_t> temp = doLocalDot_superacc(
+            do_get_vector_element(x,i,get_tensor_category<Vector1>()),
+            get_local_weights( m, i, get_tensor_category<Matrix>()),
+            do_get_vector_element(y,i,get_tensor_category<Vector2>()));
+        int imin = exblas::IMIN, imax = exblas::IMAX;
+        exblas::cpu::Normalize( &(temp[0]), imin, imax);
+        for( int k=exblas::IMIN; k<exblas::IMAX; k++)
+            acc[k] += temp[k];
+        if( i%128 == 0)
+        {
+            imin = exblas::IMIN, imax = exblas::IMAX;
+            exblas::cpu::Normalize( &(acc[0]), imin, imax);
+        }
+    }
+    return acc;
+}
+template< class ContainerType1, class MatrixType, class ContainerType2>
+inline std::vector<int64_t> doLocalDot_superacc( const ContainerType1& x, const MatrixType& m, const ContainerType2& y)
+{
+    using vector_type = find_if_t<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>;
+    return doLocalDot_superacc( x, m, y, get_tensor_category<vector_type>());
+}
+
 }//namespace detail
 ///@endcond
 
@@ -101,6 +162,94 @@ inline get_value_type<MatrixType> dot( const MatrixType& m, const ContainerType&
 {
     return dg::blas2::dot( x, m, x);
 }
+
+/*! @brief \f$ x^T M y\f$; Binary reproducible general dot product that is reduced asynchronously
+ *
+ * Computes the same scalar product as \c dg::blas2::dot(x,m,y) but returns as soon as the process-local
+ * part is computed. With MPI the global reduction continues in the background.
+ * @param x Left input
+ * @param m The diagonal Matrix
+ * @param y Right input (may alias \c x)
+ * @return handle to the scalar product, call \c get() to obtain its value
+ * @note \c x, \c m and \c y may be changed once the function returns
+ * @sa dg::blas1::async_dot
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class MatrixType, class ContainerType2>
+inline DotFuture async_dot( const ContainerType1& x, const MatrixType& m, const ContainerType2& y)
+{
+    using vector_type = find_if_t<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>;
+    constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>::value;
+    return dg::blas1::detail::doReduce_superacc_async( 1, dg::blas2::detail::doLocalDot_superacc( x,m,y),
+        get_idx<vector_idx>(x,y), get_tensor_category<vector_type>());
+}
+/*! @brief \f$ x^T M x\f$; Binary reproducible general dot product that is reduced asynchronously
+ *
+ * Equivalent to \c dg::blas2::async_dot( x,m,x)
+ * @param m The diagonal Matrix
+ * @param x Right input
+ * @return handle to the scalar product, call \c get() to obtain its value
+ * @copydoc hide_ContainerType
+ */
+template< class MatrixType, class ContainerType>
+inline DotFuture async_dot( const MatrixType& m, const ContainerType& x)
+{
+    return dg::blas2::async_dot( x, m, x);
+}
+
+/*! @brief \f$ x_k^T M y_k\f$ for several pairs of vectors at once; Binary reproducible
+ *
+ * Computes the scalar products \f$ x_k^T M y_k\f$ for \f$ k=0,...,K-1\f$
+ * and reduces all of them together, i.e. with MPI there is only one
+ * global reduction instead of \c K. Use this
+ * when many scalar products with the same matrix (usually the weights) are needed at
+ * the same time like in the energy diagnostics of a model.
+ * @code
+    std::vector<double> result = dg::blas2::dot( {&ne, &Ni}, w3d, {&lnne, &lnNi});
+ * @endcode
+ * @param x Left inputs
+ * @param m The diagonal Matrix
+ * @param y Right inputs (must have the same size as \c x, \c y[k] may alias \c x[k])
+ * @return <tt> result[k] </tt> is binary identical to <tt> dg::blas2::dot( *x[k], m, *y[k]) </tt>
+ * @note This routine is always executed synchronously due to the
+    implicit memcpy of the result.
+ * @tparam MatrixType \c MatrixType has to have a category derived from \c AnyVectorTag and must be compatible with the \c ContainerTypes
+ * @copydoc hide_ContainerType
+ */
+template< class ContainerType1, class MatrixType, class ContainerType2>
+std::vector<get_value_type<MatrixType>> dot(
+        const std::vector<const ContainerType1*>& x,
+        const MatrixType& m,
+        const std::vector<const ContainerType2*>& y)
+{
+    const unsigned num = x.size();
+    std::vector<get_value_type<MatrixType>> result( num);
+    if( num == 0)
+        return result;
+    std::vector<int64_t> acc( num*exblas::BIN_COUNT);
+    for( unsigned k=0; k<num; k++)
+    {
+        std::vector<int64_t> temp = dg::blas2::detail::doLocalDot_superacc( *x[k], m, *y[k]);
+        std::copy( temp.begin(), temp.end(), acc.begin()+k*exblas::BIN_COUNT);
+    }
+    using vector_type = find_if_t<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>;
+    constexpr unsigned vector_idx = find_if_v<dg::is_not_scalar, ContainerType1, ContainerType1, ContainerType2>::value;
+    dg::blas1::detail::doReduce_superacc( num, acc, get_idx<vector_idx>(*x[0],*y[0]),
+        get_tensor_category<vector_type>());
+    for( unsigned k=0; k<num; k++)
+        result[k] = exblas::cpu::Round( &acc[k*exblas::BIN_COUNT]);
+    return result;
+}
+///@copydoc dot(const std::vector<const ContainerType1*>&,const MatrixType&,const std::vector<const ContainerType2*>&)
+template< class ContainerType1, class MatrixType, class ContainerType2>
+inline std::vector<get_value_type<MatrixType>> dot(
+        std::initializer_list<const ContainerType1*> x,
+        const MatrixType& m,
+        std::initializer_list<const ContainerType2*> y)
+{
+    return dg::blas2::dot( std::vector<const ContainerType1*>(x), m,
+            std::vector<const ContainerType2*>(y));
+}
 ///@cond
 namespace detail{
 //resolve tags in two stages: first the matrix and then the container type
@@ -168,6 +317,21 @@ inline void doSymv( MatrixType&& M,
             get_tensor_category<ContainerType1>());
 }
 
+//if there is no batched version we apply the matrix to one vector after the other
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void doSymv_batch( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  const std::vector<const ContainerType1*>& x,
+                  get_value_type<ContainerType1> beta,
+                  const std::vector<ContainerType2*>& y,
+                  AnyMatrixTag,
+                  AnyVectorTag)
+{
+    for( unsigned v=0; v<x.size(); v++)
+        dg::blas2::detail::doSymv( alpha, std::forward<MatrixType>(M), *x[v], beta, *y[v],
+                get_tensor_category<MatrixType>());
+}
+
 }//namespace detail
 ///@endcond
 
@@ -220,6 +384,91 @@ inline void symv( MatrixType&& M,
 {
     dg::blas2::detail::doSymv( std::forward<MatrixType>(M), x, y, get_tensor_category<MatrixType>());
 }
+/*! @brief \f$ y_v = \alpha M x_v + \beta y_v\f$ for several vectors at once
+ *
+ * This routine computes \f[ y_v = \alpha M x_v + \beta y_v \f]
+ * for \f$ v=0,\dots,K-1\f$ where \f$ M\f$ is a matrix that is the same for all vectors.
+ * Use this when the same matrix is applied to different vectors back-to-back, e.g.
+ * @code
+ dg::blas2::symv( 1., dx, {&lhs, &rhs}, 0., {&dxlhs, &dxrhs});
+ * @endcode
+ * For our sparse block matrices and for \c cusp::csr_matrix in the serial and OpenMP backends the index and data arrays of \c M
+ * are read only once for all \c K vectors. For all other matrix types the
+ * call is equivalent to \c K consecutive calls to \c dg::blas2::symv.
+ * The result is binary identical to the one of \c K consecutive calls.
+ * @param alpha A Scalar
+ * @param M The Matrix
+ * @param x list of \c K pointers to input vectors
+ * @param beta A Scalar
+ * @param y list of \c K pointers to output vectors (no \c y may alias any \c x)
+ * @attention \c x and \c y must have the same number of elements
+ * @copydoc hide_matrix
+ * @copydoc hide_ContainerType
+ */
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void symv( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  const std::vector<const ContainerType1*>& x,
+                  get_value_type<ContainerType1> beta,
+                  const std::vector<ContainerType2*>& y)
+{
+    static_assert( std::is_same<get_tensor_category<ContainerType1>,
+                                get_tensor_category<ContainerType2>>::value,
+                                "Vector types must have same data layout");
+    if(alpha == (get_value_type<ContainerType1>)0) {
+        for( auto v : y)
+            dg::blas1::scal( *v, beta);
+        return;
+    }
+    dg::blas2::detail::doSymv_batch( alpha, std::forward<MatrixType>(M),
+            x, beta, y,
+            get_tensor_category<MatrixType>(),
+            get_tensor_category<ContainerType1>());
+}
+///@copydoc symv(get_value_type<ContainerType1>,MatrixType&&,const std::vector<const ContainerType1*>&,get_value_type<ContainerType1>,const std::vector<ContainerType2*>&)
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void symv( get_value_type<ContainerType1> alpha,
+                  MatrixType&& M,
+                  std::initializer_list<const ContainerType1*> x,
+                  get_value_type<ContainerType1> beta,
+                  std::initializer_list<ContainerType2*> y)
+{
+    dg::blas2::symv( alpha, std::forward<MatrixType>(M),
+            std::vector<const ContainerType1*>(x), beta, std::vector<ContainerType2*>(y));
+}
+
+/*! @brief \f$ y_v = M x_v\f$ for several vectors at once
+ *
+ * Equivalent to <tt> dg::blas2::symv( 1., M, x, 0., y) </tt>
+ * @param M The Matrix
+ * @param x list of \c K pointers to input vectors
+ * @param y list of \c K pointers to output vectors (no \c y may alias any \c x)
+ * @copydoc hide_matrix
+ * @copydoc hide_ContainerType
+ */
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void symv( MatrixType&& M,
+                  const std::vector<const ContainerType1*>& x,
+                  const std::vector<ContainerType2*>& y)
+{
+    static_assert( std::is_same<get_tensor_category<ContainerType1>,
+                                get_tensor_category<ContainerType2>>::value,
+                                "Vector types must have same data layout");
+    dg::blas2::detail::doSymv_batch( 1., std::forward<MatrixType>(M),
+            x, 0., y,
+            get_tensor_category<MatrixType>(),
+            get_tensor_category<ContainerType1>());
+}
+///@copydoc symv(MatrixType&&,const std::vector<const ContainerType1*>&,const std::vector<ContainerType2*>&)
+template< class MatrixType, class ContainerType1, class ContainerType2>
+inline void symv( MatrixType&& M,
+                  std::initializer_list<const ContainerType1*> x,
+                  std::initializer_list<ContainerType2*> y)
+{
+    dg::blas2::symv( std::forward<MatrixType>(M),
+            std::vector<const ContainerType1*>(x), std::vector<ContainerType2*>(y));
+}
+
 /*! @brief \f$ y = \alpha M x + \beta y \f$;
  * (alias for symv)
  *
@@ -59,6 +59,8 @@ int main( int argc, char* argv[])
     result = dg::blas2::dot( 1., arrdvec1, arrdvec1 )/(double)size;
     double result1 = dg::blas1::dot( arrdvec1, arrdvec1)/(double)size;
     if(rank==0)std::cout << "blas1/2 dot recursive Scalar Vector "<< (result == result1) <<"\n";
+    std::vector<double> results = dg::blas2::dot( {&arrdvec1[0], &arrdvec1[1]}, 4., {&arrdvec1[0], &arrdvec1[1]});
+    if(rank==0)std::cout << "blas2 multi dot                     "<< (results[0] == dg::blas2::dot( arrdvec1[0], 4., arrdvec1[0]) && results[1] == dg::blas2::dot( arrdvec1[1], 4., arrdvec1[1])) <<"\n";
     if(rank==0)std::cout << "Test SYMV functions:\n";
     dg::blas2::symv( 2., arrdvec1, arrdvec1);
     if(rank==0)std::cout << "symv Scalar times Vector          "<<( arrdvec1[0].data()[0] == 52) << std::endl;
@@ -54,6 +54,8 @@ int main()
     result = dg::blas2::dot( 1., arrdvec1, arrdvec1 );
     double result1 = dg::blas1::dot( arrdvec1, arrdvec1);
     std::cout << "blas1/2 dot recursive Scalar Vector "<< (result == result1) <<"\n";
+    std::vector<double> results = dg::blas2::dot( {&arrdvec1[0], &arrdvec1[1]}, 4., {&arrdvec1[0], &arrdvec1[1]});
+    std::cout << "blas2 multi dot                     "<< (results[0] == dg::blas2::dot( arrdvec1[0], 4., arrdvec1[0]) && results[1] == dg::blas2::dot( arrdvec1[1], 4., arrdvec1[1])) <<"\n";
     std::cout << "Test SYMV functions:\n";
     dg::blas2::symv( 2., arrdvec1, arrdvec1);
     std::cout << "symv Scalar times Vector          "<<( arrdvec1[0][0] == 52) << std::endl;
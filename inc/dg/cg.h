@@ -2,10 +2,14 @@
 #define _DG_CG_
 
 #include <cmath>
+#include <vector>
+#include <string>
+#include <algorithm>
 
 #include "blas.h"
 #include "functors.h"
 
+#include "backend/profiler.h"
 #ifdef DG_BENCHMARK
 #include "backend/timer.h"
 #endif //DG_BENCHMARK
@@ -245,6 +249,651 @@ unsigned CG< ContainerType>::operator()( Matrix& A, ContainerType& x, const Cont
 }
 ///@endcond
 
+///@cond
+namespace detail{
+//all vector updates of one pipelined cg iteration in a single pass through memory
+template<class T>
+struct PipelinedCGUpdate
+{
+    PipelinedCGUpdate( T alpha, T beta): m_alpha(alpha), m_beta(beta){}
+    DG_DEVICE
+    void operator()( T& z, T& q, T& s, T& p, T& x, T& r, T& u, T& w, T n, T m) const
+    {
+        z = DG_FMA( m_beta, z, n);
+        q = DG_FMA( m_beta, q, m);
+        s = DG_FMA( m_beta, s, w);
+        p = DG_FMA( m_beta, p, u);
+        x = DG_FMA( m_alpha, p, x);
+        r = DG_FMA( -m_alpha, s, r);
+        u = DG_FMA( -m_alpha, q, u);
+        w = DG_FMA( -m_alpha, z, w);
+    }
+    private:
+    T m_alpha, m_beta;
+};
+}//namespace detail
+///@endcond
+
+/**
+* @brief Functor class for the pipelined preconditioned conjugate gradient method to solve
+* \f[ Ax=b\f]
+*
+* This is the single-reduction variant of the preconditioned conjugate gradient method
+* by Ghysels and Vanroose (Parallel Computing 40, 2014). It is mathematically equivalent
+* to \c dg::CG but the recurrences are rearranged such that
+*  - all scalar products of one iteration are computed in a single global reduction
+*  (one \c MPI_Allreduce instead of two or three) and
+*  - the application of the preconditioner and the matrix that follows the reduction does not
+*  depend on its result, so the two overlap (the reduction is a non-blocking \c MPI_Iallreduce, s.a. \c dg::DotFuture).
+*  - all vector updates are fused into a single pass through memory
+*
+* The price are five additional vectors, more memops per iteration and a slightly
+* larger accumulation of rounding errors. The method pays off when the global reduction
+* dominates, i.e. for many MPI processes and small local problem sizes.
+* @ingroup invert
+*
+* @attention beware the sign: a negative definite matrix does @b not work in Conjugate gradient
+* @attention The solver uses \c dg::blas1::async_dot and is therefore not supported inside a
+* \c dg::parallel_region; call it outside (the library calls then open their own parallel regions)
+* or use \c dg::CG instead
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class PipelinedCG
+{
+  public:
+    typedef typename TensorTraits<ContainerType>::value_type value_type;//!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    PipelinedCG(){}
+    ///@copydoc construct()
+    PipelinedCG( const ContainerType& copyable, unsigned max_iterations){
+        construct( copyable, max_iterations);
+    }
+    ///@brief Set the maximum number of iterations
+    ///@param new_max New maximum number
+    void set_max( unsigned new_max) {m_max_iter = new_max;}
+    ///@brief Get the current maximum number of iterations
+    ///@return the current maximum
+    unsigned get_max() const {return m_max_iter;}
+
+    /**
+     * @brief Allocate memory for the pipelined pcg method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of iterations to be used
+     */
+    void construct( const ContainerType& copyable, unsigned max_iterations) {
+        m_r = m_u = m_w = m_m = m_n = m_z = m_q = m_s = m_p = copyable;
+        m_max_iter = max_iterations;
+    }
+    /**
+     * @brief Solve the system A*x = b using the pipelined preconditioned conjugate gradient method
+     *
+     * The iteration stops if \f$ ||b - Ax||_P < \epsilon( ||b||_P + C) \f$ where \f$C\f$ is
+     * a correction factor to the absolute error
+     * @param A A symmetric, positive definit matrix
+     * @param x Contains an initial value on input and the solution on output.
+     * @param b The right hand side vector. x and b may be the same vector.
+     * @param P The preconditioner to be used
+     * @param eps The relative error to be respected
+     * @param nrmb_correction Correction factor C for norm of b
+     * @attention This version uses the Preconditioner to compute the norm for the error condition (this is free since \f$ r^T P r\f$ is computed anyway)
+     *
+     * @return Number of iterations used to achieve desired precision
+     * @note Required memops per iteration (\c P is assumed vector):
+             - 16 reads + 8 writes
+             - plus the number of memops for \c A and \c P;
+             - 1 global reduction of 2 scalar products
+     * @copydoc hide_matrix
+     * @tparam Preconditioner A type for which the blas2::symv(Preconditioner&, ContainerType&, ContainerType&) function is callable.
+     */
+    template< class MatrixType, class Preconditioner >
+    unsigned operator()( MatrixType& A, ContainerType& x, const ContainerType& b, Preconditioner& P , value_type eps = 1e-12, value_type nrmb_correction = 1)
+    {
+        //b is only a placeholder for the unused weights
+        return solve( A, x, b, P, b, false, sqrt( blas2::dot( P, b)), eps, nrmb_correction);
+    }
+    /**
+     * @brief Solve \f$ Ax = b\f$ using the pipelined preconditioned conjugate gradient method
+     *
+     * The iteration stops if \f$ ||b-Ax||_S < \epsilon( ||b||_S + C) \f$ where \f$C\f$ is
+     * a correction factor to the absolute error and \f$ S \f$ defines a square norm
+     * @param A A symmetric positive definit matrix
+     * @param x Contains an initial value on input and the solution on output.
+     * @param b The right hand side vector. x and b may be the same vector.
+     * @param P The preconditioner to be used
+     * @param S Weights used to compute the norm for the error condition
+     * @param eps The relative error to be respected
+     * @param nrmb_correction Correction factor C for norm of b
+     *
+     * @return Number of iterations used to achieve desired precision
+     * @note Required memops per iteration (\c P and \c S are assumed vectors):
+             - 18 reads + 8 writes
+             - plus the number of memops for \c A and \c P;
+             - 1 global reduction of 3 scalar products
+     * @copydoc hide_matrix
+     * @tparam Preconditioner A type for which the blas2::symv(Preconditioner&, ContainerType&, ContainerType&) function is callable.
+     * @tparam SquareNorm A type for which the blas2::dot( const SquareNorm&, const ContainerType&) function is callable. This can e.g. be one of the ContainerType types.
+     */
+    template< class MatrixType, class Preconditioner, class SquareNorm >
+    unsigned operator()( MatrixType& A, ContainerType& x, const ContainerType& b, Preconditioner& P, SquareNorm& S, value_type eps = 1e-12, value_type nrmb_correction = 1)
+    {
+        return solve( A, x, b, P, S, true, sqrt( blas2::dot( S, b)), eps, nrmb_correction);
+    }
+  private:
+    template< class MatrixType, class Preconditioner, class SquareNorm >
+    unsigned solve( MatrixType& A, ContainerType& x, const ContainerType& b, Preconditioner& P, const SquareNorm& S, bool use_S, value_type nrmb, value_type eps, value_type nrmb_correction);
+    ContainerType m_r, m_u, m_w, m_m, m_n, m_z, m_q, m_s, m_p;
+    unsigned m_max_iter;
+};
+
+///@cond
+template< class ContainerType>
+template< class Matrix, class Preconditioner, class SquareNorm>
+unsigned PipelinedCG< ContainerType>::solve( Matrix& A, ContainerType& x, const ContainerType& b, Preconditioner& P, const SquareNorm& S, bool use_S, value_type nrmb, value_type eps, value_type nrmb_correction)
+{
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if(rank==0)
+#endif //MPI
+    {
+    std::cout << "Norm of b "<<nrmb <<"\n";
+    std::cout << "Residual errors: \n";
+    }
+#endif //DG_DEBUG
+    if( nrmb == 0)
+    {
+        blas1::copy( b, x);
+        return 0;
+    }
+    blas2::symv( A,x,m_r);
+    blas1::axpby( 1., b, -1., m_r);
+    blas2::symv( P, m_r, m_u);
+    blas2::symv( A, m_u, m_w);
+    blas1::copy( 0., m_z), blas1::copy( 0., m_q), blas1::copy( 0., m_s), blas1::copy( 0., m_p);
+    const unsigned num = use_S ? 3 : 2;
+    value_type gamma_old = 1., alpha_old = 1.;
+    for( unsigned i=0; i<m_max_iter; i++)
+    {
+        //compute all process-local scalar products ...
+        std::vector<int64_t> acc( num*exblas::BIN_COUNT);
+        std::vector<int64_t> temp = blas1::detail::doLocalDot_superacc( m_r, m_u);
+        std::copy( temp.begin(), temp.end(), acc.begin());
+        temp = blas1::detail::doLocalDot_superacc( m_w, m_u);
+        std::copy( temp.begin(), temp.end(), acc.begin()+exblas::BIN_COUNT);
+        if( use_S)
+        {
+            temp = blas2::detail::doLocalDot_superacc( m_r, S, m_r);
+            std::copy( temp.begin(), temp.end(), acc.begin()+2*exblas::BIN_COUNT);
+        }
+        //... start to reduce them in one go ...
+        DotFuture dots = blas1::detail::doReduce_superacc_async( num, std::move(acc), m_r);
+        //... and do the work that does not depend on the result while the reduction is in flight
+        blas2::symv( P, m_w, m_m);
+        blas2::symv( A, m_m, m_n);
+        value_type gamma = dots.get(0);
+        value_type delta = dots.get(1);
+        value_type nrm2r = use_S ? dots.get(2) : gamma;
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+    if(rank==0)
+#endif //MPI
+    {
+        std::cout << "Absolute "<<sqrt( nrm2r) <<"\t ";
+        std::cout << " < Critical "<<eps*nrmb + eps <<"\t ";
+        std::cout << "(Relative "<<sqrt( nrm2r)/nrmb << ")\n";
+    }
+#endif //DG_DEBUG
+        if( sqrt( nrm2r) < eps*(nrmb + nrmb_correction))
+            return i;
+        value_type beta = 0., alpha = gamma/delta;
+        if( i > 0)
+        {
+            beta = gamma/gamma_old;
+            alpha = gamma/( delta - beta*gamma/alpha_old);
+        }
+        blas1::subroutine( detail::PipelinedCGUpdate<value_type>( alpha, beta),
+            m_z, m_q, m_s, m_p, x, m_r, m_u, m_w, m_n, m_m);
+        gamma_old = gamma, alpha_old = alpha;
+    }
+    return m_max_iter;
+}
+///@endcond
+
+
+/*!@class hide_checkpoint
+ * @tparam Checkpoint a class with the member functions <tt> put( std::string name, double value) </tt> and
+ * <tt> put( std::string name, const ContainerType& value)</tt> (for \c save_state) or the corresponding
+ * \c get members (for \c load_state), e.g. \c file::Checkpoint
+ * @param chk the checkpoint
+ * @param name prefix of the names of all stored values (must be unique within \c chk)
+ */
+
+///@cond
+namespace detail{
+//small dense symmetric matrices are stored row-major in a std::vector
+
+//in-place Cholesky factorization A = L L^T of the leading n x n block (the lower triangle contains L)
+//returns false if A is not (numerically) positive definite
+template<class T>
+bool cholesky( std::vector<T>& a, unsigned n)
+{
+    for( unsigned j=0; j<n; j++)
+    {
+        T d = a[j*n+j];
+        for( unsigned k=0; k<j; k++)
+            d -= a[j*n+k]*a[j*n+k];
+        if( !(d > 1e-14*fabs(a[j*n+j]))) //also catches NaN
+            return false;
+        a[j*n+j] = sqrt( d);
+        for( unsigned i=j+1; i<n; i++)
+        {
+            T s = a[i*n+j];
+            for( unsigned k=0; k<j; k++)
+                s -= a[i*n+k]*a[j*n+k];
+            a[i*n+j] = s/a[j*n+j];
+        }
+    }
+    return true;
+}
+//solve L y = b in place
+template<class T>
+void forward_subst( const std::vector<T>& l, unsigned n, T* b)
+{
+    for( unsigned i=0; i<n; i++)
+    {
+        for( unsigned k=0; k<i; k++)
+            b[i] -= l[i*n+k]*b[k];
+        b[i] /= l[i*n+i];
+    }
+}
+//solve L^T x = y in place
+template<class T>
+void backward_subst( const std::vector<T>& l, unsigned n, T* b)
+{
+    for( int i=n-1; i>=0; i--)
+    {
+        for( unsigned k=i+1; k<n; k++)
+            b[i] -= l[k*n+i]*b[k];
+        b[i] /= l[i*n+i];
+    }
+}
+//cyclic Jacobi method: on output the diagonal of a contains the eigenvalues
+//and the columns of v the orthonormal eigenvectors of the symmetric matrix a
+template<class T>
+void jacobi_eigen( std::vector<T>& a, unsigned n, std::vector<T>& v)
+{
+    v.assign( n*n, 0.);
+    for( unsigned i=0; i<n; i++)
+        v[i*n+i] = 1.;
+    for( unsigned sweep=0; sweep<50; sweep++)
+    {
+        T off = 0., norm = 0.;
+        for( unsigned i=0; i<n; i++)
+            for( unsigned j=0; j<n; j++)
+                (i==j ? norm : off) += a[i*n+j]*a[i*n+j];
+        if( off <= 1e-28*norm)
+            return;
+        for( unsigned p=0; p<n; p++)
+        for( unsigned q=p+1; q<n; q++)
+        {
+            if( a[p*n+q] == 0.)
+                continue;
+            T theta = (a[q*n+q]-a[p*n+p])/(2.*a[p*n+q]);
+            T t = (theta >= 0 ? 1. : -1.)/(fabs(theta) + sqrt( theta*theta+1.));
+            T c = 1./sqrt(t*t+1.), s = t*c;
+            for( unsigned k=0; k<n; k++) //A = A J
+            {
+                T akp = a[k*n+p], akq = a[k*n+q];
+                a[k*n+p] = c*akp - s*akq;
+                a[k*n+q] = s*akp + c*akq;
+            }
+            for( unsigned k=0; k<n; k++) //A = J^T A
+            {
+                T apk = a[p*n+k], aqk = a[q*n+k];
+                a[p*n+k] = c*apk - s*aqk;
+                a[q*n+k] = s*apk + c*aqk;
+            }
+            for( unsigned k=0; k<n; k++) //V = V J
+            {
+                T vkp = v[k*n+p], vkq = v[k*n+q];
+                v[k*n+p] = c*vkp - s*vkq;
+                v[k*n+q] = s*vkp + c*vkq;
+            }
+        }
+    }
+}
+}//namespace detail
+///@endcond
+
+/**
+* @brief Deflated preconditioned conjugate gradient method with Krylov subspace recycling to solve
+* \f[ Ax=b\f]
+*
+* The class is meant for sequences of (slowly changing) systems, e.g. the polarisation equation
+* in every timestep. It keeps up to \c num_deflation vectors \f$ W\f$ that approximate the eigenvectors
+* of \f$ A\f$ with the smallest eigenvalues across calls. These slow modes, which otherwise dominate the iteration count,
+* are projected out of the initial residual and all search directions (deflated CG of Saad, Yeung, Erhel and Guyomarc'h,
+* SIAM J. Sci. Comput. 21, 2000):
+* \f[ x_0 \leftarrow x_0 + W E^{-1} W^T r_0,\quad p_{j} = z_{j} + \beta_{j} p_{j-1} - W E^{-1}(AW)^T z_{j},\quad E = W^T A W\f]
+* The first \c num_recycle search directions \f$ P\f$ of every call are stored and, once the iteration has converged,
+* the new deflation space is extracted from \f$ \text{span}[W,P]\f$ by the Rayleigh-Ritz procedure
+* (the Ritz vectors with the smallest Ritz values are kept). The initial guess (e.g. from \c Extrapolation)
+* and the deflation space complement each other.
+*
+* @note Each call costs \c num_deflation additional matrix-vector multiplications to renew \f$ AW\f$
+* (the matrix may change between calls), \c num_deflation additional scalar products and vector updates per iteration
+* (the scalar products are reduced together in a single reduction) and about \f$(k+m)^2\f$ scalar products and vector updates
+* for the recycling, where \f$ k\f$ and \f$ m\f$ are the numbers of deflation and recycled vectors.
+* This pays off for systems that need many iterations.
+* The storage is \f$ 2(k+m)+4\f$ vectors.
+* @note The Ritz values are computed with respect to the Euclidean scalar product of \c ContainerType
+* @ingroup invert
+*
+* @attention beware the sign: a negative definite matrix does @b not work in Conjugate gradient
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class DeflatedCG
+{
+  public:
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    DeflatedCG(){}
+    ///@copydoc construct()
+    DeflatedCG( const ContainerType& copyable, unsigned max_iterations, unsigned num_deflation = 8, unsigned num_recycle = 16){
+        construct( copyable, max_iterations, num_deflation, num_recycle);
+    }
+    ///@brief Set the maximum number of iterations
+    ///@param new_max New maximum number
+    void set_max( unsigned new_max) {m_max_iter = new_max;}
+    ///@brief Get the current maximum number of iterations
+    ///@return the current maximum
+    unsigned get_max() const {return m_max_iter;}
+    ///@brief Get the number of deflation vectors currently in use (grows to \c num_deflation in the first calls)
+    ///@return the current number of deflation vectors
+    unsigned get_deflation_number() const {return m_k;}
+    /**
+     * @brief Forget the deflation space
+     *
+     * Call this when the matrix changes completely (e.g. after a change of grid or boundary conditions)
+     */
+    void clear() {m_k = 0;}
+    /**
+     * @brief Allocate memory for the pcg method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of iterations to be used
+     * @param num_deflation maximum number of deflation vectors kept between calls
+     * @param num_recycle number of search directions stored in every call to update the deflation space (0 keeps the deflation space fixed)
+     */
+    void construct( const ContainerType& copyable, unsigned max_iterations, unsigned num_deflation = 8, unsigned num_recycle = 16)
+    {
+        m_ap = m_p = m_r = m_z = copyable;
+        m_max_iter = max_iterations;
+        m_W.assign( num_deflation, copyable);
+        m_AW.assign( num_deflation, copyable);
+        m_P.assign( num_recycle, copyable);
+        m_AP.assign( num_recycle, copyable);
+        m_k = 0;
+    }
+
+    /**
+     * @brief Solve the system A*x = b using a deflated preconditioned conjugate gradient method
+     *
+     * The iteration stops if \f$ ||b - Ax||_S < \epsilon( ||b||_S + C) \f$ where \f$C\f$ is
+     * a correction factor to the absolute error and \f$ S \f$ defines a square norm
+     * @copydoc hide_matrix
+     * @tparam Preconditioner A class for which the blas2::symv(const Preconditioner&, const ContainerType&, ContainerType&) function is callable.
+     * @tparam SquareNorm A type for which the blas2::dot( const SquareNorm&, const ContainerType&) function is callable. This can e.g. be one of the ContainerType types.
+     * @param A A symmetric positive definite matrix
+     * @param x Contains an initial value on input and the solution on output.
+     * @param b The right hand side vector. x and b may be the same vector.
+     * @param P The preconditioner to be used
+     * @param S (Inverse) Weights used to compute the norm for the error condition
+     * @param eps The relative error to be respected
+     * @param nrmb_correction the absolute error \c C in units of \c eps to be respected
+     *
+     * @return Number of iterations used to achieve desired precision
+     * @note the deflation space is updated at the end of every call
+     */
+    template< class MatrixType, class Preconditioner, class SquareNorm >
+    unsigned operator()( MatrixType& A, ContainerType& x, const ContainerType& b, Preconditioner& P, SquareNorm& S, value_type eps = 1e-12, value_type nrmb_correction = 1);
+
+    /**
+     * @brief Write the deflation space into a checkpoint
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        chk.put( name+"_number", (double)m_k);
+        for( unsigned u=0; u<m_k; u++)
+            chk.put( name+"_w"+std::to_string(u), m_W[u]);
+    }
+    /**
+     * @brief Restore the deflation space from a checkpoint
+     * @copydoc hide_checkpoint
+     * @note if more vectors are stored than \c num_deflation only the first \c num_deflation are restored
+     */
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        double number;
+        chk.get( name+"_number", number);
+        m_k = std::min( (unsigned)number, (unsigned)m_W.size());
+        for( unsigned u=0; u<m_k; u++)
+            chk.get( name+"_w"+std::to_string(u), m_W[u]);
+    }
+  private:
+    //local parts of out[i] = V[i]^T y, i<num are accumulated from acc[offset] on
+    void local_dots( unsigned num, const std::vector<ContainerType>& V, const ContainerType& y, std::vector<int64_t>& acc, unsigned offset) const
+    {
+        for( unsigned i=0; i<num; i++)
+        {
+            std::vector<int64_t> temp = blas1::detail::doLocalDot_superacc( V[i], y);
+            std::copy( temp.begin(), temp.end(), acc.begin()+(offset+i)*exblas::BIN_COUNT);
+        }
+    }
+    //reduce all accumulators in one go and round them
+    void reduce( unsigned num, std::vector<int64_t>& acc, value_type* out) const
+    {
+        if( num == 0) return;
+        blas1::detail::doReduce_superacc( num, acc, m_r, get_tensor_category<ContainerType>());
+        for( unsigned i=0; i<num; i++)
+            out[i] = exblas::cpu::Round( &acc[i*exblas::BIN_COUNT]);
+    }
+    //mu = E^{-1} V^T y
+    void project( const std::vector<ContainerType>& V, const ContainerType& y)
+    {
+        std::vector<int64_t> acc( m_k*exblas::BIN_COUNT);
+        local_dots( m_k, V, y, acc, 0);
+        reduce( m_k, acc, m_mu.data());
+        detail::forward_subst( m_E, m_k, m_mu.data());
+        detail::backward_subst( m_E, m_k, m_mu.data());
+    }
+    void recycle( unsigned num_p);
+    ContainerType m_r, m_z, m_p, m_ap;
+    std::vector<ContainerType> m_W, m_AW, m_P, m_AP;
+    std::vector<value_type> m_E, m_G, m_mu, m_pAp;
+    unsigned m_max_iter = 0, m_k = 0;
+};
+
+///@cond
+template< class ContainerType>
+template< class Matrix, class Preconditioner, class SquareNorm>
+unsigned DeflatedCG< ContainerType>::operator()( Matrix& A, ContainerType& x, const ContainerType& b, Preconditioner& P, SquareNorm& S, value_type eps, value_type nrmb_correction)
+{
+    value_type nrmb = sqrt( blas2::dot( S, b));
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if(rank==0)
+#endif //MPI
+    {
+    std::cout << "Norm of b "<<nrmb <<"\n";
+    std::cout << "Number of deflation vectors "<<m_k <<"\n";
+    std::cout << "Residual errors: \n";
+    }
+#endif //DG_DEBUG
+    if( nrmb == 0)
+    {
+        blas1::copy( 0., x);
+        return 0;
+    }
+    //renew AW and E = W^T A W (the matrix may have changed since the last call)
+    for( unsigned j=0; j<m_k; j++)
+        blas2::symv( A, m_W[j], m_AW[j]);
+    m_E.assign( m_k*m_k, 0.);
+    m_mu.resize( m_W.size());
+    {
+        std::vector<int64_t> acc( m_k*(m_k+1)/2*exblas::BIN_COUNT);
+        for( unsigned i=0; i<m_k; i++)
+            local_dots( i+1, m_AW, m_W[i], acc, i*(i+1)/2);
+        std::vector<value_type> e( m_k*(m_k+1)/2);
+        reduce( m_k*(m_k+1)/2, acc, e.data());
+        for( unsigned i=0; i<m_k; i++)
+            for( unsigned j=0; j<=i; j++)
+                m_E[i*m_k+j] = m_E[j*m_k+i] = e[i*(i+1)/2+j];
+    }
+    m_G = m_E;
+    if( !detail::cholesky( m_E, m_k)) //the deflation space has degenerated
+        m_k = 0;
+    //deflated initial guess
+    blas2::symv( A,x,m_r);
+    blas1::axpby( 1., b, -1., m_r);
+    if( m_k > 0)
+    {
+        project( m_W, m_r);
+        for( unsigned j=0; j<m_k; j++)
+        {
+            blas1::axpby( m_mu[j], m_W[j], 1., x);
+            blas1::axpby( -m_mu[j], m_AW[j], 1., m_r);
+        }
+    }
+    if( sqrt( blas2::dot(S,m_r) ) < eps*(nrmb + nrmb_correction)) //if x happens to be the solution
+        return 0;
+    blas2::symv( P, m_r, m_z);
+    blas1::copy( m_z, m_p);
+    if( m_k > 0)
+    {
+        project( m_AW, m_z);
+        for( unsigned j=0; j<m_k; j++)
+            blas1::axpby( -m_mu[j], m_W[j], 1., m_p);
+    }
+    value_type nrmzr_old = blas1::dot( m_z,m_r); //and store the scalar product
+    value_type alpha, nrmzr_new;
+    m_pAp.resize( m_P.size());
+    unsigned num_p = 0;
+    for( unsigned i=1; i<m_max_iter; i++)
+    {
+        blas2::symv( A, m_p, m_ap);
+        value_type pAp = blas1::dot( m_p, m_ap);
+        if( num_p < m_P.size())
+        {
+            //store the (A-orthogonal) search directions for the recycling
+            blas1::copy( m_p, m_P[num_p]);
+            blas1::copy( m_ap, m_AP[num_p]);
+            m_pAp[num_p] = pAp;
+            num_p++;
+        }
+        alpha = nrmzr_old/pAp;
+        blas1::axpby( alpha, m_p, 1.,x);
+        blas1::axpby( -alpha, m_ap, 1., m_r);
+        value_type nrmr = sqrt( blas2::dot(S,m_r));
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+        if(rank==0)
+#endif //MPI
+        {
+            std::cout << "Absolute "<<nrmr <<"\t ";
+            std::cout << " < Critical "<<eps*nrmb + eps <<"\t ";
+            std::cout << "(Relative "<<nrmr/nrmb << ")\n";
+        }
+#endif //DG_DEBUG
+        if( nrmr < eps*(nrmb + nrmb_correction))
+        {
+            recycle( num_p);
+            return i;
+        }
+        blas2::symv(P,m_r,m_z);
+        nrmzr_new = blas1::dot( m_z, m_r);
+        blas1::axpby(1.,m_z, nrmzr_new/nrmzr_old, m_p );
+        if( m_k > 0)
+        {
+            project( m_AW, m_z);
+            for( unsigned j=0; j<m_k; j++)
+                blas1::axpby( -m_mu[j], m_W[j], 1., m_p);
+        }
+        nrmzr_old=nrmzr_new;
+    }
+    recycle( num_p);
+    return m_max_iter;
+}
+
+template< class ContainerType>
+void DeflatedCG< ContainerType>::recycle( unsigned num_p)
+{
+    //Rayleigh-Ritz on Z = [W,P]: G y = theta F y with G = Z^T A Z and F = Z^T Z
+    const unsigned k = m_k, n = m_k + num_p;
+    const unsigned k_new = std::min( n, (unsigned)m_W.size());
+    if( num_p == 0 || k_new == 0)
+        return;
+    auto Z = [&]( unsigned i)->const ContainerType& { return i<k ? m_W[i] : m_P[i-k];};
+    //the search directions are A-orthogonal to each other and to W
+    std::vector<value_type> G( n*n, 0.);
+    for( unsigned i=0; i<k; i++)
+        for( unsigned j=0; j<k; j++)
+            G[i*n+j] = m_G[i*k+j];
+    for( unsigned i=0; i<num_p; i++)
+        G[(k+i)*n+k+i] = m_pAp[i];
+    std::vector<value_type> F( n*n), f( n*(n+1)/2);
+    std::vector<int64_t> acc( n*(n+1)/2*exblas::BIN_COUNT);
+    for( unsigned i=0; i<n; i++)
+        for( unsigned j=0; j<=i; j++)
+        {
+            std::vector<int64_t> temp = blas1::detail::doLocalDot_superacc( Z(i), Z(j));
+            std::copy( temp.begin(), temp.end(), acc.begin()+(i*(i+1)/2+j)*exblas::BIN_COUNT);
+        }
+    reduce( n*(n+1)/2, acc, f.data());
+    for( unsigned i=0; i<n; i++)
+        for( unsigned j=0; j<=i; j++)
+            F[i*n+j] = F[j*n+i] = f[i*(i+1)/2+j];
+    //with G = L L^T the largest eigenvalues of C = L^{-1} F L^{-T} are the inverse smallest Ritz values
+    if( !detail::cholesky( G, n))
+        return;
+    for( unsigned j=0; j<n; j++) //columns of F
+    {
+        std::vector<value_type> col( n);
+        for( unsigned i=0; i<n; i++) col[i] = F[i*n+j];
+        detail::forward_subst( G, n, col.data());
+        for( unsigned i=0; i<n; i++) F[i*n+j] = col[i];
+    }
+    for( unsigned i=0; i<n; i++) //rows of L^{-1} F
+        detail::forward_subst( G, n, &F[i*n]);
+    std::vector<value_type> U;
+    detail::jacobi_eigen( F, n, U);
+    std::vector<unsigned> idx( n);
+    for( unsigned i=0; i<n; i++) idx[i] = i;
+    std::sort( idx.begin(), idx.end(), [&]( unsigned a, unsigned b){ return F[a*n+a] > F[b*n+b];});
+    //W_new = Z L^{-T} U (the new W are A-orthonormal); AW is used as temporary storage
+    for( unsigned j=0; j<k_new; j++)
+    {
+        std::vector<value_type> y( n);
+        for( unsigned i=0; i<n; i++) y[i] = U[i*n+idx[j]];
+        detail::backward_subst( G, n, y.data());
+        blas1::axpby( y[0], Z(0), 0., m_AW[j]);
+        for( unsigned i=1; i<n; i++)
+            blas1::axpby( y[i], Z(i), 1., m_AW[j]);
+    }
+    for( unsigned j=0; j<k_new; j++)
+        m_W[j].swap( m_AW[j]);
+    m_k = k_new;
+}
+///@endcond
 
 /**
 * @brief Class that stores up to three solutions of iterative methods and
@@ -331,6 +980,38 @@ struct Extrapolation
     ///read access to tail value ( the one that will be deleted in the next update
     const ContainerType& tail()const{return m_x[m_number-1];}
 
+    /**
+     * @brief Write the stored solutions into a checkpoint
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        chk.put( name+"_number", (double)m_number);
+        for( unsigned u=0; u<m_number; u++)
+            chk.put( name+"_x"+std::to_string(u), m_x[u]);
+    }
+    /**
+     * @brief Restore the stored solutions from a checkpoint
+     *
+     * The extrapolation number is set to the stored one
+     * @copydoc hide_checkpoint
+     * @note the stored vectors must have the same size as \c head()
+     */
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        double number;
+        chk.get( name+"_number", number);
+        if( (unsigned)number > 0 && m_x.empty())
+            throw Error( Message(_ping_)<<"Extrapolation must be initialized with a vector before its state is loaded!");
+        if( (unsigned)number > 0)
+            m_x.resize( (unsigned)number, m_x[0]);
+        m_number = (unsigned)number;
+        for( unsigned u=0; u<m_number; u++)
+            chk.get( name+"_x"+std::to_string(u), m_x[u]);
+    }
+
     private:
     unsigned m_number;
     std::vector<ContainerType> m_x;
@@ -437,6 +1118,19 @@ struct Invert
     /// @brief Return last solution
     const ContainerType& get_last() const { return m_ex.head();}
 
+    /**
+     * @brief Write the past solutions used for the extrapolation into a checkpoint
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const { m_ex.save_state( chk, name);}
+    /**
+     * @brief Restore the past solutions used for the extrapolation from a checkpoint
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name) { m_ex.load_state( chk, name);}
+
     /**
      * @brief Solve linear problem
      *
@@ -448,7 +1142,8 @@ struct Invert
      * @param phi solution (write only)
      * @param rho right-hand-side (will be multiplied by \c weights)
      * @note computes inverse weights from the weights
-     * @note If the Macro DG_BENCHMARK is defined this function will write timings to std::cout
+     * @note The call is recorded as region "invert" in \c dg::profiler().
+     * If the Macro DG_BENCHMARK is defined this function will write timings to std::cout
      *
      * @return number of iterations used
      */
@@ -474,6 +1169,8 @@ struct Invert
      * @param inv_weights The inverse of the weights that normalize the symmetric operator
      * @param p The preconditioner
      * @note (15+N)memops per iteration where N is the memops contained in \c op.
+     *   The call is recorded as region "invert" in \c dg::profiler()
+     *   with an estimate of the bytes of the 15 memops per iteration (the memops of \c op are not known and not counted).
      *   If the Macro DG_BENCHMARK is defined this function will write timings to std::cout
      *
      * @return number of iterations used
@@ -483,10 +1180,7 @@ struct Invert
     {
         assert( phi.size() != 0);
         assert( &rho != &phi);
-#ifdef DG_BENCHMARK
-        Timer t;
-        t.tic();
-#endif //DG_BENCHMARK
+        ProfileScope scope( "invert");
         m_ex.extrapolate( phi);
 
         unsigned number;
@@ -499,8 +1193,9 @@ struct Invert
             number = cg( op, phi, rho, p, inv_weights, eps_, nrmb_correction_);
 
         m_ex.update(phi);
+        scope.add_iterations( number);
+        scope.add_bytes( 15.*number*container_bytes( phi)); //without the memops of op
 #ifdef DG_BENCHMARK
-        t.toc();
 #ifdef MPI_VERSION
         int rank;
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -508,7 +1203,7 @@ struct Invert
 #endif //MPI
         {
             std::cout << "# of cg iterations \t"<< number << "\t";
-            std::cout<< "took \t"<<t.diff()<<"s\n";
+            std::cout<< "took \t"<<scope.elapsed()<<"s\n";
         }
 #endif //DG_BENCHMARK
         return number;
@@ -521,6 +1216,131 @@ struct Invert
     bool multiplyWeights_;
 };
 
+/**
+* @brief Mixed precision iterative refinement to solve \f[ Ax=b\f]
+*
+* In every outer iteration the residual \f$ r = b-Ax\f$ is computed in the
+* precision of \c ContainerType (typically \c double), scaled to unit norm and converted to
+* \c InnerContainerType (typically \c float). An inner solver computes an approximate
+* solution of the correction equation \f$ A d = r\f$ in low precision, which is added to \f$ x\f$.
+* The accuracy of the final solution is determined by the high precision residual only, so the
+* inner solver just has to reduce the residual by a moderate factor (e.g. \f$ 10^{-3}\f$).
+* Since the inner iterations dominate the cost and their vectors are half the size,
+* the solution of bandwidth-bound problems is up to twice as fast.
+*
+* The following code snippet solves an elliptic equation with a multigrid preconditioned CG in single precision:
+* @snippet elliptic2d_b.cu refinement
+* @note The refinement converges as long as the inner solver reduces the residual, i.e. as long as
+* the condition number of \f$ A\f$ is well below the inverse precision of \c InnerContainerType (\f$ 10^7\f$ for \c float)
+* @ingroup invert
+* @copydoc hide_ContainerType
+* @tparam InnerContainerType The container type of the inner solver
+* (must have the same data layout as \c ContainerType but may differ in the value type)
+*/
+template<class ContainerType, class InnerContainerType>
+class IterativeRefinement
+{
+  public:
+    using value_type = get_value_type<ContainerType>; //!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    IterativeRefinement(){}
+    ///@copydoc construct()
+    IterativeRefinement( const ContainerType& copyable, const InnerContainerType& inner_copyable, unsigned max_iterations){
+        construct( copyable, inner_copyable, max_iterations);
+    }
+    /**
+     * @brief Allocate memory for the residuals and set the maximum number of outer iterations
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param inner_copyable An InnerContainerType must be copy-constructible from this
+     * @param max_iterations Maximum number of outer iterations to be used
+     */
+    void construct( const ContainerType& copyable, const InnerContainerType& inner_copyable, unsigned max_iterations)
+    {
+        m_r = copyable;
+        m_r_inner = m_d_inner = inner_copyable;
+        m_max_iter = max_iterations;
+    }
+    ///@brief Set the maximum number of outer iterations
+    ///@param new_max New maximum number
+    void set_max( unsigned new_max) {m_max_iter = new_max;}
+    ///@brief Get the current maximum number of outer iterations
+    ///@return the current maximum
+    unsigned get_max() const {return m_max_iter;}
+    ///@brief Get the total number of inner iterations of the last call to \c solve
+    ///@return the sum of the return values of the inner solver
+    unsigned get_inner_iterations() const {return m_inner_iter;}
+
+    /**
+     * @brief Solve the system A*x = b by iterative refinement
+     *
+     * The iteration stops if \f$ ||b - Ax||_S < \epsilon( ||b||_S + C) \f$ where \f$C\f$ is
+     * a correction factor to the absolute error and \f$ S \f$ defines a square norm
+     * @copydoc hide_matrix
+     * @tparam InnerSolver A callable with signature <tt> unsigned inner( const InnerContainerType& r, InnerContainerType& d)</tt>
+     * that approximately solves \f$ A d = r\f$ (in low precision) and returns the number of iterations it used,
+     * e.g. a lambda calling \c CG with a low precision copy of \c A. On input \c d is zero and \f$||r||_S=1\f$,
+     * so the inner solver should use an absolute error criterion (a zero \c nrmb_correction in \c CG)
+     * @tparam SquareNorm A type for which the blas2::dot( const SquareNorm&, const ContainerType&) function is callable. This can e.g. be one of the ContainerType types.
+     * @param A A symmetric positive definite matrix in high precision
+     * @param x Contains an initial value on input and the solution on output.
+     * @param b The right hand side vector. x and b may be the same vector.
+     * @param inner The inner low precision solver
+     * @param S (Inverse) Weights used to compute the norm for the error condition
+     * @param eps The relative error to be respected
+     * @param nrmb_correction the absolute error \c C in units of \c eps to be respected
+     *
+     * @return Number of outer iterations used to achieve desired precision
+     * @note Each outer iteration costs one application of \c A, 3 memops to convert the residual and correction and the cost of \c inner
+     */
+    template< class MatrixType, class InnerSolver, class SquareNorm>
+    unsigned solve( MatrixType& A, ContainerType& x, const ContainerType& b, InnerSolver&& inner, const SquareNorm& S, value_type eps = 1e-12, value_type nrmb_correction = 1)
+    {
+        m_inner_iter = 0;
+        value_type nrmb = sqrt( blas2::dot( S, b));
+        if( nrmb == 0)
+        {
+            blas1::copy( 0., x);
+            return 0;
+        }
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif //MPI
+#endif //DG_DEBUG
+        for( unsigned i=0; i<m_max_iter; i++)
+        {
+            //residual in high precision
+            blas2::symv( A, x, m_r);
+            blas1::axpby( 1., b, -1., m_r);
+            value_type nrmr = sqrt( blas2::dot( S, m_r));
+#ifdef DG_DEBUG
+#ifdef MPI_VERSION
+            if(rank==0)
+#endif //MPI
+            {
+                std::cout << "Outer iteration "<<i<<" Absolute "<<nrmr <<"\t ";
+                std::cout << " < Critical "<<eps*(nrmb + nrmb_correction) <<"\t ";
+                std::cout << "(Relative "<<nrmr/nrmb << ")\n";
+            }
+#endif //DG_DEBUG
+            if( nrmr < eps*(nrmb + nrmb_correction))
+                return i;
+            //unit norm keeps the low precision residual away from under- and overflow
+            blas1::axpby( 1./nrmr, m_r, 0., m_r_inner);
+            blas1::copy( 0., m_d_inner);
+            m_inner_iter += inner( m_r_inner, m_d_inner);
+            blas1::axpby( nrmr, m_d_inner, 1., x);
+        }
+        return m_max_iter;
+    }
+  private:
+    ContainerType m_r;
+    InnerContainerType m_r_inner, m_d_inner;
+    unsigned m_max_iter = 0, m_inner_iter = 0;
+};
+
 } //namespace dg
 
 
@@ -69,6 +69,16 @@ int main( int argc, char* argv[])
         std::cout << "... for a precision of "<< eps<<std::endl;
         std::cout << "...               took "<< t.diff()<<"s\n";
     }
+    dg::PipelinedCG< dg::MDVec > ppcg( x, n*n*Nx*Ny);
+    dg::MDVec x_pipe = dg::evaluate( initial, grid);
+    t.tic(comm);
+    number = ppcg( lap, x_pipe, b, v2d, eps);
+    t.toc(comm);
+    if( rank == 0)
+    {
+        std::cout << "# of pipelined pcg itersations "<<number<<std::endl;
+        std::cout << "...                     took "<< t.diff()<<"s\n";
+    }
 
     dg::MDVec  error(  solution);
     dg::blas1::axpby( 1., x,-1., error);
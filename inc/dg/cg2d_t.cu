@@ -11,6 +11,8 @@ const double ly = 2.*M_PI;
 double fct(double x, double y){ return sin(y)*sin(x);}
 double laplace_fct( double x, double y) { return 2*sin(y)*sin(x);}
 double initial( double x, double y) {return sin(0);}
+//a right hand side with many modes (zero mean)
+double many_modes( double x, double y) { return exp( sin(x))*cos(y) + cos(x)*sin(3.*x+2.*y);}
 
 int main()
 {
@@ -69,5 +71,62 @@ int main()
     std::cout << "L2 Norm of Residuum is        " << res.d<<"\t"<<res.i << std::endl;
     //Fehler der Integration des Sinus ist vernachlässigbar (vgl. evaluation_t)
 
+    std::cout << "Pipelined CG:\n";
+    dg::PipelinedCG<dg::HVec > ppcg( copyable_vector, max_iter);
+    dg::HVec x_pipe = dg::evaluate( initial, grid);
+    std::cout << "Number of pipelined pcg iterations "<< ppcg( A, x_pipe, b, v2d, eps)<<std::endl;
+    dg::blas1::axpby( 1.,x_pipe,-1.,x);
+    res.d = sqrt(dg::blas2::dot( w2d, x));
+    std::cout << "L2 Norm of difference to pcg  " << res.d<<" (should be small)"<< std::endl;
+
+    std::cout << "Deflated CG:\n";
+    dg::HVec b_modes = dg::evaluate( many_modes, grid);
+    dg::blas2::symv( w2d, b_modes, b_modes);
+    dg::HVec x_plain = dg::evaluate( initial, grid);
+    unsigned number_plain = pcg( A, x_plain, b_modes, v2d, v2d, eps);
+    std::cout << "Number of pcg iterations          "<< number_plain<<"\n";
+    auto relative_residual = [&]( const dg::HVec& x_sol){
+        dg::blas2::symv(  A, x_sol, Ax);
+        dg::blas1::axpby( 1.,b_modes,-1.,Ax, resi);
+        return sqrt( dg::blas2::dot( v2d, resi)/dg::blas2::dot( v2d, b_modes));
+    };
+    double res_plain = relative_residual( x_plain);
+    dg::DeflatedCG<dg::HVec > dcg( copyable_vector, max_iter, 8, 16);
+    unsigned number_defl = 0;
+    double res_defl = 0;
+    for( unsigned k=0; k<3; k++)
+    {
+        //the deflation space is built up in the first and reused in the following solves
+        dg::HVec x_defl = dg::evaluate( initial, grid);
+        number_defl = dcg( A, x_defl, b_modes, v2d, v2d, eps);
+        res_defl = relative_residual( x_defl);
+        std::cout << "Number of deflated pcg iterations "<< number_defl<<" with "<<dcg.get_deflation_number()<<" deflation vectors\n";
+        std::cout << "Relative residual is              "<<res_defl<<" (pcg: "<<res_plain<<")\n";
+    }
+    //after recycling, deflated CG must reach the same residual in fewer iterations
+    if( number_defl >= number_plain || res_defl > 2.*std::max( res_plain, eps))
+    {
+        std::cout << "    FAILED: deflated CG is not faster than pcg\n";
+        return -1;
+    }
+
+    std::cout << "Mixed precision iterative refinement:\n";
+    const dg::RealCartesianGrid2d<float> grid_f( 0, lx, 0, ly,n, Nx, Ny, dg::PER, dg::PER);
+    const dg::fHVec v2d_f = dg::create::inv_weights( grid_f);
+    dg::Elliptic<dg::RealCartesianGrid2d<float>, dg::fHMatrix, dg::fHVec> A_f( grid_f);
+    dg::CG<dg::fHVec > pcg_f( v2d_f, max_iter);
+    dg::IterativeRefinement<dg::HVec, dg::fHVec> refine( copyable_vector, v2d_f, 100);
+    dg::HVec x_ref = dg::evaluate( initial, grid);
+    unsigned number = refine.solve( A, x_ref, b, [&]( const dg::fHVec& r, dg::fHVec& d){
+            return pcg_f( A_f, d, r, v2d_f, 1e-3f, 0.f); }, v2d, 1e-10);
+    std::cout << "Number of outer iterations "<<number<<" ( "<<refine.get_inner_iterations()<<" inner iterations)\n";
+    dg::blas2::symv(  A, x_ref, Ax);
+    dg::blas1::axpby( 1.,b,-1.,Ax, resi);
+    res.d = sqrt( dg::blas2::dot( v2d, resi)/dg::blas2::dot( v2d, b));
+    std::cout << "Relative residual is          " << res.d<<" (should be below 1e-10)"<< std::endl;
+    dg::blas1::axpby( 1.,x_ref,-1.,solution, error);
+    res.d = sqrt(dg::blas2::dot(w2d , error));
+    std::cout << "L2 Norm of Error is           " << res.d<< std::endl;
+
     return 0;
 }
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "blas.h"
+
+/*!@file
+ * Chebyshev iteration and Lanczos eigenvalue estimator
+ */
+
+namespace dg{
+
+/**
+* @brief Preconditioned Chebyshev iteration for solving
+* \f[ Ax=b\f]
+*
+* Given bounds \f$ [\lambda_{\min}, \lambda_{\max}]\f$ on the spectrum of the
+* preconditioned matrix \f$ PA\f$ a fixed number of iterations applies the
+* Chebyshev polynomial that damps all error components in this interval
+* optimally. In contrast to CG the iteration involves no scalar products, which
+* makes it a cheap smoother in multigrid methods (there, \f$\lambda_{\min}\f$ is
+* chosen as a fraction of \f$\lambda_{\max}\f$ such that only the upper part of
+* the spectrum is smoothed).
+*
+* @ingroup invert
+* @note For a fixed number of iterations and a zero initial guess the
+* Chebyshev iteration is a symmetric linear operator in \f$ b\f$ and can thus
+* be used inside a preconditioner for CG
+* @attention The iteration diverges if \f$ \lambda_{\max}\f$ is smaller than the largest eigenvalue of \f$ PA\f$
+* @sa EVE to estimate the largest eigenvalue
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class ChebyshevIteration
+{
+  public:
+    typedef typename TensorTraits<ContainerType>::value_type value_type;//!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    ChebyshevIteration(){}
+    ///@copydoc construct()
+    ChebyshevIteration( const ContainerType& copyable):m_r(copyable), m_d(copyable), m_ax(copyable){}
+    /**
+     * @brief Allocate memory for the method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     */
+    void construct( const ContainerType& copyable) {
+        m_ax = m_d = m_r = copyable;
+    }
+    /**
+     * @brief Apply a fixed number of preconditioned Chebyshev iterations to \f$ Ax=b\f$
+     *
+     * @param A A symmetric, positive definit matrix
+     * @param x Contains an initial value on input and the approximate solution on output.
+     * @param b The right hand side vector. x and b may @b not be the same vector.
+     * @param P The preconditioner to be used
+     * @param min_ev lower bound of the spectrum of \f$ PA\f$ to be damped
+     * @param max_ev upper bound of the spectrum of \f$ PA\f$ (must be larger than the largest eigenvalue)
+     * @param num_iter the number of iterations (number of matrix applications if \c x_is_zero is true)
+     * @param x_is_zero If true the initial value of \c x is ignored and assumed zero, which saves one matrix application
+     * @note Required memops per iteration (\c P is assumed vector):
+             - 7 reads + 3 writes
+             - plus the number of memops for \c A;
+     * @copydoc hide_matrix
+     * @tparam Preconditioner A type for which the blas2::symv(value_type, const Preconditioner&, const ContainerType&, value_type, ContainerType&) function is callable.
+     */
+    template< class MatrixType, class Preconditioner>
+    void solve( MatrixType& A, ContainerType& x, const ContainerType& b, Preconditioner& P, value_type min_ev, value_type max_ev, unsigned num_iter, bool x_is_zero = false)
+    {
+        if( num_iter == 0)
+            return;
+        value_type theta = (max_ev + min_ev)/2., delta = (max_ev - min_ev)/2.;
+        value_type sigma = theta/delta, rho = 1./sigma;
+        if( x_is_zero)
+            dg::blas1::copy( b, m_r);
+        else
+        {
+            dg::blas2::symv( A, x, m_r);
+            dg::blas1::axpby( 1., b, -1., m_r);
+        }
+        dg::blas2::symv( 1./theta, P, m_r, 0., m_d);
+        if( x_is_zero)
+            dg::blas1::copy( m_d, x);
+        else
+            dg::blas1::axpby( 1., m_d, 1., x);
+        for( unsigned k=1; k<num_iter; k++)
+        {
+            dg::blas2::symv( A, m_d, m_ax);
+            dg::blas1::axpby( -1., m_ax, 1., m_r);
+            value_type rho_new = 1./(2.*sigma - rho);
+            dg::blas2::symv( 2.*rho_new/delta, P, m_r, rho_new*rho, m_d);
+            dg::blas1::axpby( 1., m_d, 1., x);
+            rho = rho_new;
+        }
+    }
+  private:
+    ContainerType m_r, m_d, m_ax;
+};
+
+/**
+* @brief Eigenvalue estimator: estimate the largest eigenvalue of the
+* preconditioned matrix \f$ PA\f$
+*
+* The preconditioned conjugate gradient method is run for a few iterations
+* on \f$ Ax=b\f$ with zero initial guess. The coefficients of the CG recurrence define the
+* tridiagonal Lanczos matrix of the Krylov subspace, whose largest eigenvalue (a lower
+* bound and usually an excellent approximation of the largest eigenvalue of
+* \f$ PA\f$) is computed by bisection.
+* @ingroup invert
+* @note The right hand side should contain all (in particular the high frequency) modes,
+* e.g. a vector with random entries
+* @attention beware the sign: a negative definite matrix does @b not work in Conjugate gradient
+* @copydoc hide_ContainerType
+*/
+template< class ContainerType>
+class EVE
+{
+  public:
+    typedef typename TensorTraits<ContainerType>::value_type value_type;//!< value type of the ContainerType class
+    ///@brief Allocate nothing, Call \c construct method before usage
+    EVE(){}
+    ///@copydoc construct()
+    EVE( const ContainerType& copyable, unsigned max_iterations = 20):m_r(copyable), m_p(copyable), m_ap(copyable), m_max_iter(max_iterations){}
+    ///@brief Set the number of Lanczos iterations
+    ///@param new_max New maximum number
+    void set_max( unsigned new_max) {m_max_iter = new_max;}
+    ///@brief Get the current number of Lanczos iterations
+    ///@return the current maximum
+    unsigned get_max() const {return m_max_iter;}
+    /**
+     * @brief Allocate memory for the method
+     *
+     * @param copyable A ContainerType must be copy-constructible from this
+     * @param max_iterations Number of Lanczos iterations to be used
+     */
+    void construct( const ContainerType& copyable, unsigned max_iterations = 20) {
+        m_ap = m_p = m_r = copyable;
+        m_max_iter = max_iterations;
+    }
+    /**
+     * @brief Estimate the largest eigenvalue of \f$ PA\f$
+     *
+     * @param A A symmetric, positive definit matrix
+     * @param b The start vector of the Lanczos iteration
+     * @param P The preconditioner to be used
+     * @return Estimate of the largest eigenvalue
+     * @copydoc hide_matrix
+     * @tparam Preconditioner A type for which the blas2::symv(Preconditioner&, ContainerType&, ContainerType&) function is callable.
+     */
+    template< class MatrixType, class Preconditioner>
+    value_type operator()( MatrixType& A, const ContainerType& b, Preconditioner& P)
+    {
+        std::vector<value_type> diag, offdiag;
+        dg::blas1::copy( b, m_r);
+        dg::blas2::symv( P, m_r, m_p);
+        value_type nrmzr_old = dg::blas1::dot( m_p, m_r);
+        value_type alpha_old = 1., beta_old = 0.;
+        for( unsigned i=0; i<m_max_iter && nrmzr_old > 0; i++)
+        {
+            dg::blas2::symv( A, m_p, m_ap);
+            value_type alpha = nrmzr_old/dg::blas1::dot( m_p, m_ap);
+            dg::blas1::axpby( -alpha, m_ap, 1., m_r);
+            //the Lanczos coefficients in terms of the CG coefficients
+            diag.push_back( 1./alpha + beta_old/alpha_old);
+            if( i>0)
+                offdiag.push_back( sqrt(beta_old)/alpha_old);
+            dg::blas2::symv( P, m_r, m_ap);
+            value_type nrmzr_new = dg::blas1::dot( m_ap, m_r);
+            value_type beta = nrmzr_new/nrmzr_old;
+            dg::blas1::axpby( 1., m_ap, beta, m_p);
+            nrmzr_old = nrmzr_new, alpha_old = alpha, beta_old = beta;
+        }
+        return max_eigenvalue( diag, offdiag);
+    }
+  private:
+    //bisection for the largest eigenvalue of a symmetric tridiagonal matrix
+    value_type max_eigenvalue( const std::vector<value_type>& d, const std::vector<value_type>& e) const
+    {
+        unsigned n = d.size();
+        if( n == 0)
+            return 0;
+        //Gershgorin bounds
+        value_type lower = d[0], upper = d[0];
+        for( unsigned i=0; i<n; i++)
+        {
+            value_type radius = (i>0 ? fabs(e[i-1]) : 0) + (i<n-1 ? fabs( e[i]) : 0);
+            lower = std::min( lower, d[i] - radius);
+            upper = std::max( upper, d[i] + radius);
+        }
+        for( unsigned k=0; k<100 && upper-lower > 1e-12*fabs(upper); k++)
+        {
+            value_type mid = (lower + upper)/2.;
+            //Sturm sequence: count eigenvalues smaller than mid
+            unsigned count = 0;
+            value_type q = d[0] - mid;
+            for( unsigned i=0; i<n; i++)
+            {
+                if( i>0)
+                    q = d[i] - mid - e[i-1]*e[i-1]/q;
+                if( q == 0)
+                    q = 1e-300;
+                if( q < 0)
+                    count++;
+            }
+            if( count == n)
+                upper = mid;
+            else
+                lower = mid;
+        }
+        return upper;
+    }
+    ContainerType m_r, m_p, m_ap;
+    unsigned m_max_iter;
+};
+
+}//namespace dg
@@ -92,7 +92,7 @@
  * @}
  * @defgroup misc Level 0: Miscellaneous additions
  * @{
- *     @defgroup timer Timer class
+ *     @defgroup timer Timer and profiler
  *     @defgroup functions Functions and Functors
  *
  *         The functions are useful mainly in the constructor of Operator objects.
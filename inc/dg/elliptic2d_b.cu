@@ -108,6 +108,73 @@ int main()
     std::cout << " "<<err << "\t"<<res.i<<"\n";
     }
 
+    {
+    dg::Timer t;
+    const unsigned stages = 3;
+    dg::MultigridCG2d<dg::aGeometry2d, dg::DMatrix, dg::DVec > multigrid( grid, stages);
+    const std::vector<dg::DVec> multi_chi = multigrid.project( chi);
+    std::vector<dg::Elliptic<dg::aGeometry2d, dg::DMatrix, dg::DVec> > multi_pol( stages);
+    for(unsigned u=0; u<stages; u++)
+    {
+        multi_pol[u].construct( multigrid.grids()[u].get(), dg::not_normed, dg::centered, jfactor);
+        multi_pol[u].set_chi( multi_chi[u]);
+    }
+    dg::DVec x = dg::evaluate( initial, grid);
+    t.tic();
+    //! [pcg_solve]
+    //estimate the spectrum on all grids (whenever chi changes)
+    multigrid.estimate_eigenvalues( multi_pol);
+    //CG preconditioned by a V-cycle with 5 Chebyshev smoothing steps
+    unsigned number = multigrid.pcg_solve( multi_pol, x, b, eps, 1, 5);
+    //! [pcg_solve]
+    t.toc();
+    std::cout << "V-cycle preconditioned CG: # iterations "<<number<<" took "<< t.diff() <<"s\n";
+    dg::blas1::axpby( 1.,x,-1., solution, error);
+    double err = dg::blas2::dot( w2d, error);
+    err = sqrt( err/norm); res.d = err;
+    std::cout << " "<<err << "\t"<<res.i<<"\n";
+    }
+
+
+    {
+    dg::Timer t;
+    dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> pol_centered( grid, dg::not_normed, dg::centered, jfactor);
+    pol_centered.set_chi( chi);
+    dg::DVec x = dg::evaluate( initial, grid);
+    t.tic();
+    //! [refinement]
+    //the multigrid hierarchy and operators in single precision
+    const dg::RealCartesianGrid2d<float> grid_f( 0, lx, 0, ly, n, Nx, Ny, bcx, bcy);
+    const unsigned stages = 3;
+    dg::MultigridCG2d<dg::aRealGeometry2d<float>, dg::fDMatrix, dg::fDVec > multigrid_f( grid_f, stages);
+    const dg::fDVec chi_f = dg::evaluate( pol, grid_f);
+    const std::vector<dg::fDVec> multi_chi_f = multigrid_f.project( chi_f);
+    std::vector<dg::Elliptic<dg::aRealGeometry2d<float>, dg::fDMatrix, dg::fDVec> > multi_pol_f( stages);
+    for(unsigned u=0; u<stages; u++)
+    {
+        multi_pol_f[u].construct( multigrid_f.grids()[u].get(), dg::not_normed, dg::centered, jfactor);
+        multi_pol_f[u].set_chi( multi_chi_f[u]);
+    }
+    //the inner solver reduces the residual by three orders of magnitude in single precision
+    dg::fDVec rhs_f( chi_f);
+    auto inner = [&]( const dg::fDVec& r, dg::fDVec& d){
+        //pcg_solve multiplies the right hand side with the weights
+        dg::blas2::symv( multi_pol_f[0].inv_weights(), r, rhs_f);
+        return multigrid_f.pcg_solve( multi_pol_f, d, rhs_f, 1e-3f, 1, 5);
+    };
+    //the residual is computed with pol_centered in double precision
+    dg::IterativeRefinement<dg::DVec, dg::fDVec> refine( x, chi_f, 100);
+    dg::DVec rhs( b);
+    dg::blas2::symv( pol_centered.weights(), b, rhs);
+    unsigned number = refine.solve( pol_centered, x, rhs, inner, pol_centered.inv_weights(), eps);
+    //! [refinement]
+    t.toc();
+    std::cout << "Mixed precision refinement: # outer iterations "<<number<<" ( "<<refine.get_inner_iterations()<<" inner iterations) took "<< t.diff() <<"s\n";
+    dg::blas1::axpby( 1.,x,-1., solution, error);
+    double err = dg::blas2::dot( w2d, error);
+    err = sqrt( err/norm); res.d = err;
+    std::cout << " "<<err << "\t"<<res.i<<"\n";
+    }
 
     {
     x = temp;
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <iomanip>
+
+#include "elliptic.h"
+
+//compare the matrix-free symv of Elliptic on the host with the separate application of the matrices
+
+const double lx = M_PI;
+const double ly = 2.*M_PI;
+dg::bc bcx = dg::DIR;
+dg::bc bcy = dg::PER;
+
+double pol( double x, double y) {return 1. + 0.5*sin(x)*sin(y); }
+double function( double x, double y) { return sin( x)*sin(y) + 0.1*cos(3.*y)*x;}
+
+//the same sequence of operations as Elliptic::symv without fusion
+dg::HVec elliptic_generic( const dg::CartesianGrid2d& g, dg::norm no, const dg::HVec* chi, double jfactor, const dg::HVec& x)
+{
+    dg::HMatrix leftx  = dg::create::dx( g, dg::NEU, dg::backward);
+    dg::HMatrix lefty  = dg::create::dy( g, dg::PER, dg::backward);
+    dg::HMatrix rightx = dg::create::dx( g, bcx, dg::forward);
+    dg::HMatrix righty = dg::create::dy( g, bcy, dg::forward);
+    dg::HMatrix jumpX  = dg::create::jumpX( g, bcx);
+    dg::HMatrix jumpY  = dg::create::jumpY( g, bcy);
+    dg::HVec tempx( x), tempy( x), gradx( x), y( x);
+    dg::blas2::gemv( rightx, x, tempx);
+    dg::blas2::gemv( righty, x, tempy);
+    gradx = tempx;
+    if( chi != nullptr)
+    {
+        dg::blas1::pointwiseDot( *chi, tempx, gradx);
+        dg::blas1::pointwiseDot( *chi, tempy, tempy);
+    }
+    dg::blas2::symv( lefty, tempy, y);
+    dg::blas2::symv( -1., leftx, gradx, -1., y);
+    dg::blas2::symv( jfactor, jumpX, x, 1., y);
+    dg::blas2::symv( jfactor, jumpY, x, 1., y);
+    if( no == dg::not_normed)
+        dg::blas2::symv( dg::HVec(dg::create::weights( g)), y, y);
+    return y;
+}
+
+unsigned differences( const dg::HVec& a, const dg::HVec& b)
+{
+    unsigned number = 0;
+    for( unsigned i=0; i<a.size(); i++)
+        if( a[i] != b[i])
+            number++;
+    return number;
+}
+
+int main()
+{
+    std::cout << "This program compares the matrix-free Elliptic::symv on the host with the separate application of the matrices.\n";
+    std::cout << "A test is passed if the number of differing elements is exactly zero!\n";
+    for( unsigned n=1; n<=5; n+=2)
+    {
+        const dg::CartesianGrid2d grid( 0, lx, 0, ly, n, 20, 24, bcx, bcy);
+        std::cout << "Computing on the Grid " <<n<<" x "<<grid.Nx()<<" x "<<grid.Ny() <<std::endl;
+        const dg::HVec x = dg::evaluate( function, grid);
+        const dg::HVec chi = dg::evaluate( pol, grid);
+        dg::HVec y( x);
+
+        dg::Elliptic<dg::CartesianGrid2d, dg::HMatrix, dg::HVec> pol_not_normed( grid, dg::not_normed, dg::forward, 0.5);
+        pol_not_normed.symv( x, y);
+        std::cout << "    not normed, chi = 1 : "<<differences( y, elliptic_generic( grid, dg::not_normed, nullptr, 0.5, x))<<"\n";
+        pol_not_normed.set_chi( chi);
+        pol_not_normed.symv( x, y);
+        std::cout << "    not normed, chi set : "<<differences( y, elliptic_generic( grid, dg::not_normed, &chi, 0.5, x))<<"\n";
+
+        dg::Elliptic<dg::CartesianGrid2d, dg::HMatrix, dg::HVec> pol_normed( grid, dg::normed, dg::forward, 1.);
+        pol_normed.set_chi( chi);
+        pol_normed.symv( x, y);
+        std::cout << "    normed,     chi set : "<<differences( y, elliptic_generic( grid, dg::normed, &chi, 1., x))<<"\n";
+    }
+    return 0;
+}
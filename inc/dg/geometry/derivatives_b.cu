@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 #include <thrust/device_vector.h>
 #include "dg/backend/timer.h"
 #include "dg/blas.h"
@@ -76,6 +77,28 @@ int main()
     dg::blas1::axpby( 1., deri, -1., temp);
     std::cout << "DZ(1):           Distance to true solution: "<<sqrt(dg::blas2::dot(temp, w3d, temp))<<"\n";
     }
+    std::cout << "TEST BATCHED DX and DY \n";
+    {
+    const Vector f0 = dg::evaluate( sinx, g), f1 = dg::evaluate( siny, g), f2 = dg::evaluate( sinz, g);
+    Vector y0( f0), y1( f0), y2( f0);
+    Matrix dx = dg::create::dx( g, dg::forward);
+    Matrix dy = dg::create::dy( g, dg::forward);
+    Matrix m[] = {dx, dy};
+    std::string name[] = {"Dx", "Dy"};
+    for( unsigned i=0; i<2; i++)
+    {
+        t.tic();
+        dg::blas2::symv( m[i], f0, y0);
+        dg::blas2::symv( m[i], f1, y1);
+        dg::blas2::symv( m[i], f2, y2);
+        t.toc();
+        std::cout << "3 single "<<name[i]<<" took "<<t.diff()<<"s\n";
+        t.tic();
+        dg::blas2::symv( m[i], {&f0, &f1, &f2}, {&y0, &y1, &y2});
+        t.toc();
+        std::cout << "1 batched "<<name[i]<<" took "<<t.diff()<<"s\n";
+    }
+    }
     std::cout << "JumpX and JumpY \n";
     {
     const Vector func = dg::evaluate( sinx, g);
@@ -97,5 +120,37 @@ int main()
     t.toc();
     std::cout << "JumpZ took "<<t.diff()<<"s\n";
     }
+    std::cout << "\nBANDWIDTH of the right_size != 1 kernels compared to AXPBY (STREAM convention: 3 memops per element)\n";
+#ifdef DG_SIMD_WIDTH
+    std::cout << "Explicit SIMD width (DG_SIMD_WIDTH) is "<<DG_SIMD_WIDTH<<"\n";
+#endif //DG_SIMD_WIDTH
+    for( unsigned nn=2; nn<6; nn++)
+    {
+    dg::Grid3d gn( 0, lx, 0, lx, 0., lx, nn, Nx, Ny, Nz, bcx, bcy, bcz);
+    const Vector x = dg::evaluate( siny, gn);
+    Vector y( x);
+    double gbytes = (double)x.size()*sizeof(double)/1e9;
+    int multi = 20;
+    dg::blas1::axpby( 1., x, -1., y);//warm up
+    t.tic();
+    for( int i=0; i<multi; i++)
+        dg::blas1::axpby( 1., x, -1., y);
+    t.toc();
+    double stream = 3*gbytes*multi/t.diff();
+    std::cout << "n = "<<nn<<"\n";
+    std::cout << "    AXPBY (roofline)       "<<t.diff()/multi<<"s\t"<<stream<<"GB/s\n";
+    Matrix m[] = { dg::create::dy( gn, dg::forward), dg::create::dy( gn, dg::centered), dg::create::dz( gn, dg::centered)};
+    std::string name[] = {"forward y derivative ", "centered y derivative", "centered z derivative"};
+    for( unsigned u=0; u<3; u++)
+    {
+        dg::blas2::symv( m[u], x, y);//warm up
+        t.tic();
+        for( int i=0; i<multi; i++)
+            dg::blas2::symv( m[u], x, y);
+        t.toc();
+        double bw = 3*gbytes*multi/t.diff();
+        std::cout << "    "<<name[u]<<"  "<<t.diff()/multi<<"s\t"<<bw<<"GB/s\t"<<bw/stream*100.<<"% of roofline\n";
+    }
+    }
     return 0;
 }
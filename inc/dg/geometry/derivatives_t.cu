@@ -49,6 +49,19 @@ int main()
         double norm = sqrt(dg::blas1::dot( w2d, error)); res.d = norm;
         std::cout << "Distance to true solution: "<<norm<<"\t"<<res.i-binary2[i]<<"\n";
     }
+    std::cout << "TEST 2D: batched DX, DY (compared to single symv)\n";
+    for( unsigned i=0; i<2; i++)
+    {
+        Vector single0( f2d), single1( f2d), batch0( f2d), batch1( f2d);
+        dg::blas2::symv( m2[i], f2d, single0);
+        dg::blas2::symv( m2[i], sol2[i], single1);
+        dg::blas2::symv( m2[i], {&f2d, &sol2[i]}, {&batch0, &batch1});
+        dg::blas1::axpby( 1., single0, -1., batch0);
+        dg::blas1::axpby( 1., single1, -1., batch1);
+        double norm = dg::blas1::dot( batch0, batch0) + dg::blas1::dot( batch1, batch1);
+        res.d = norm;
+        std::cout << "Distance to single symv:  "<<norm<<"\t"<<res.i<<"\n";
+    }
     dg::Grid3d g3d( 0,M_PI, 0.1, 2.*M_PI+0.1, M_PI/2.,M_PI, n, Nx, Ny, Nz, bcx, bcy, bcz);
     const Vector w3d = dg::create::weights( g3d);
     Matrix dx3 = dg::create::dx( g3d, dg::forward);
@@ -3,6 +3,7 @@
 #include <cassert>
 #include <cmath>
 #include <thrust/host_vector.h>
+#include <thrust/copy.h>
 #include "dg/backend/config.h"
 #include "grid.h"
 
@@ -37,6 +38,34 @@ thrust::host_vector<real_type> abscissas( const RealGrid1d<real_type>& g)
     return abs;
 }
 }//
+
+namespace detail
+{
+//if the functor has a batch interface f.compute( x, y, v, n) (e.g. dg::geo::aBinaryFunctor) use it,
+//else call f(x,y) point by point
+template<class BinaryOp, class real_type>
+auto evaluate_points( const BinaryOp& f, const real_type* x, const real_type* y, real_type* v, size_t n, int)
+    -> decltype( f.compute( x, y, v, n), void())
+{
+    f.compute( x, y, v, n);
+}
+template<class BinaryOp, class real_type>
+void evaluate_points( const BinaryOp& f, const real_type* x, const real_type* y, real_type* v, size_t n, long)
+{
+    for( size_t i=0; i<n; i++)
+        v[i] = f( x[i], y[i]);
+}
+template<class BinaryOp, class real_type>
+void evaluate_points( const BinaryOp& f, const real_type* x, const real_type* y, real_type* v, size_t n)
+{
+    evaluate_points( f, x, y, v, n, 0);
+}
+//is true if the functor has the batch interface, which implies that it does not depend on the third coordinate
+template<class Op, class real_type>
+auto has_batch_compute( const Op& f, real_type* v, int) -> decltype( f.compute( v, v, v, 0), true) { return true;}
+template<class Op, class real_type>
+bool has_batch_compute( const Op& f, real_type* v, long) { return false;}
+}//namespace detail
 ///@endcond
 
 ///@addtogroup evaluation
@@ -95,12 +124,16 @@ thrust::host_vector<real_type> evaluate( const BinaryOp& f, const aRealTopology2
     thrust::host_vector<real_type> absx = create::abscissas( gx);
     thrust::host_vector<real_type> absy = create::abscissas( gy);
 
-    thrust::host_vector<real_type> v( g.size());
+    thrust::host_vector<real_type> x( g.size()), y( g.size()), v( g.size());
     for( unsigned i=0; i<gy.N(); i++)
         for( unsigned k=0; k<n; k++)
             for( unsigned j=0; j<gx.N(); j++)
                 for( unsigned r=0; r<n; r++)
-                    v[ ((i*n+k)*g.Nx() + j)*n + r] = f( absx[j*n+r], absy[i*n+k]);
+                {
+                    x[ ((i*n+k)*g.Nx() + j)*n + r] = absx[j*n+r];
+                    y[ ((i*n+k)*g.Nx() + j)*n + r] = absy[i*n+k];
+                }
+    detail::evaluate_points( f, x.data(), y.data(), v.data(), g.size());
     return v;
 };
 ///@cond
@@ -135,6 +168,15 @@ thrust::host_vector<real_type> evaluate( const TernaryOp& f, const aRealTopology
     thrust::host_vector<real_type> absz = create::abscissas( gz);
 
     thrust::host_vector<real_type> v( g.size());
+    if( detail::has_batch_compute( f, v.data(), 0))
+    {
+        //the function does not depend on z: evaluate one plane and copy it
+        RealGrid2d<real_type> g2d( g.x0(), g.x1(), g.y0(), g.y1(), g.n(), g.Nx(), g.Ny());
+        thrust::host_vector<real_type> plane = evaluate( f, g2d);
+        for( unsigned s=0; s<gz.N(); s++)
+            thrust::copy( plane.begin(), plane.end(), v.begin() + s*plane.size());
+        return v;
+    }
     for( unsigned s=0; s<gz.N(); s++)
         for( unsigned i=0; i<gy.N(); i++)
             for( unsigned k=0; k<n; k++)
@@ -72,6 +72,13 @@ int main(int argc, char** argv)
     double solution3d = solution2d*(exp(12.)-exp(10))/2.;
     if(rank==0)std::cout << "Correct square norm is    "<<std::setw(6)<<solution3d<<std::endl;
     if(rank==0)std::cout << "Relative 3d error is      "<<(norm3d-solution3d)/solution3d<<"\n";
+    //the asynchronous versions must give the same results
+    dg::DotFuture future2d = dg::blas1::async_dot( w2d, func2d);
+    dg::DotFuture future3d = dg::blas2::async_dot( func3d, w3d, func3d);
+    res.d = future2d.get();
+    if(rank==0)std::cout << "Asynchronous 2D integral  "<<std::setw(6)<<res.d <<"\t" << res.i - 4639875759346476257 << "\n";
+    res.d = future3d.get();
+    if(rank==0)std::cout << "Asynchronous 3D norm      "<<std::setw(6)<<res.d <<"\t" << res.i - 4746764681002108278 << "\n";
     if(rank==0)std::cout << "\nFINISHED! Continue with geometry/derivatives_mpit.cu !\n\n";
 
     MPI_Finalize();
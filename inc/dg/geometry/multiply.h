@@ -21,7 +21,7 @@ namespace tensor
 template<class ContainerType>
 void sqrt( SparseElement<ContainerType>& mu){
     if( mu.isSet())
-        dg::blas1::transform( mu.value(), mu.value(), dg::SQRT<double>());
+        dg::blas1::transform( mu.value(), mu.value(), dg::SQRT<get_value_type<ContainerType>>());
 }
 
 /**
@@ -32,7 +32,7 @@ void sqrt( SparseElement<ContainerType>& mu){
 template<class ContainerType>
 void invert(SparseElement<ContainerType>& mu){
     if(mu.isSet())
-        dg::blas1::transform( mu.value(), mu.value(), dg::INVERT<double>());
+        dg::blas1::transform( mu.value(), mu.value(), dg::INVERT<get_value_type<ContainerType>>());
 }
 
 /**
@@ -3,6 +3,7 @@
 #include "multiply.h"
 #include "base_geometry.h"
 #include "weights.h"
+#include "evaluation.h"
 
 
 namespace dg
@@ -26,8 +27,7 @@ thrust::host_vector<real_type> pullback( const Functor& f, const aRealGeometry2d
 {
     std::vector<thrust::host_vector<real_type> > map = g.map();
     thrust::host_vector<real_type> vec( g.size());
-    for( unsigned i=0; i<g.size(); i++)
-        vec[i] = f( map[0][i], map[1][i]);
+    detail::evaluate_points( f, map[0].data(), map[1].data(), vec.data(), g.size());
     return vec;
 }
 
@@ -38,8 +38,11 @@ thrust::host_vector<real_type> pullback( const Functor& f, const aRealGeometry3d
 {
     std::vector<thrust::host_vector<real_type> > map = g.map();
     thrust::host_vector<real_type> vec( g.size());
-    for( unsigned i=0; i<g.size(); i++)
-        vec[i] = f( map[0][i], map[1][i], map[2][i]);
+    if( detail::has_batch_compute( f, vec.data(), 0))
+        detail::evaluate_points( f, map[0].data(), map[1].data(), vec.data(), g.size());
+    else
+        for( unsigned i=0; i<g.size(); i++)
+            vec[i] = f( map[0][i], map[1][i], map[2][i]);
     return vec;
 }
 
@@ -52,8 +55,7 @@ MPI_Vector<thrust::host_vector<real_type> > pullback( const Functor& f, const aR
 {
     std::vector<MPI_Vector<thrust::host_vector<real_type> > > map = g.map();
     thrust::host_vector<real_type> vec( g.local().size());
-    for( unsigned i=0; i<g.local().size(); i++)
-        vec[i] = f( map[0].data()[i], map[1].data()[i]);
+    detail::evaluate_points( f, map[0].data().data(), map[1].data().data(), vec.data(), g.local().size());
     return MPI_Vector<thrust::host_vector<real_type> >( vec, g.communicator());
 }
 
@@ -64,8 +66,11 @@ MPI_Vector<thrust::host_vector<real_type> > pullback( const Functor& f, const aR
 {
     std::vector<MPI_Vector<thrust::host_vector<real_type> > > map = g.map();
     thrust::host_vector<real_type> vec( g.local().size());
-    for( unsigned i=0; i<g.local().size(); i++)
-        vec[i] = f( map[0].data()[i], map[1].data()[i], map[2].data()[i]);
+    if( detail::has_batch_compute( f, vec.data(), 0))
+        detail::evaluate_points( f, map[0].data().data(), map[1].data().data(), vec.data(), g.local().size());
+    else
+        for( unsigned i=0; i<g.local().size(); i++)
+            vec[i] = f( map[0].data()[i], map[1].data()[i], map[2].data()[i]);
     return MPI_Vector<thrust::host_vector<real_type> >( vec, g.communicator());
 }
 
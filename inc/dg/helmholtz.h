@@ -26,6 +26,7 @@ namespace dg{
 template< class Geometry, class Matrix, class container>
 struct Helmholtz
 {
+    using value_type = get_value_type<container>; //!< value type of the container (\c double or \c float)
     ///@brief empty object ( no memory allocation)
     Helmholtz() {}
     /**
@@ -37,7 +38,7 @@ struct Helmholtz
      * @param jfactor The jfactor used in the Laplace operator (probably 1 is always the best factor but one never knows...)
      * @note The default value of \f$\chi\f$ is one. \c Helmholtz is never normed
      */
-    Helmholtz( const Geometry& g, double alpha = 1., direction dir = dg::forward, double jfactor=1.)
+    Helmholtz( const Geometry& g, value_type alpha = 1., direction dir = dg::forward, value_type jfactor=1.)
     {
         construct( g, alpha, dir, jfactor);
     }
@@ -52,19 +53,19 @@ struct Helmholtz
      * @param jfactor The jfactor used in the Laplace operator (probably 1 is always the best factor but one never knows...)
      * @note The default value of \f$\chi\f$ is one
      */
-    Helmholtz( const Geometry& g, bc bcx, bc bcy, double alpha = 1., direction dir = dg::forward, double jfactor=1.)
+    Helmholtz( const Geometry& g, bc bcx, bc bcy, value_type alpha = 1., direction dir = dg::forward, value_type jfactor=1.)
     {
         construct( g, bcx, bcy, alpha, dir, jfactor);
     }
-    ///@copydoc Helmholtz::Helmholtz(const Geometry&,bc,bc,double,direction,double)
-    void construct( const Geometry& g, bc bcx, bc bcy, double alpha = 1, direction dir = dg::forward, double jfactor = 1.)
+    ///@copydoc Helmholtz::Helmholtz(const Geometry&,bc,bc,value_type,direction,value_type)
+    void construct( const Geometry& g, bc bcx, bc bcy, value_type alpha = 1., direction dir = dg::forward, value_type jfactor = 1.)
     {
         laplaceM_.construct( g, bcx, bcy, dg::normed, dir, jfactor);
         dg::blas1::transfer( dg::evaluate( dg::one, g), temp_);
         alpha_ = alpha;
     }
-    ///@copydoc Helmholtz::Helmholtz(const Geometry&,double,direction,double)
-    void construct( const Geometry& g, double alpha = 1, direction dir = dg::forward, double jfactor = 1.)
+    ///@copydoc Helmholtz::Helmholtz(const Geometry&,value_type,direction,value_type)
+    void construct( const Geometry& g, value_type alpha = 1., direction dir = dg::forward, value_type jfactor = 1.)
     {
         laplaceM_.construct( g, dg::normed, dir, jfactor);
         dg::blas1::transfer( dg::evaluate( dg::one, g), temp_);
@@ -105,13 +106,13 @@ struct Helmholtz
      *
      * @return reference to alpha
      */
-    double& alpha( ){  return alpha_;}
+    value_type& alpha( ){  return alpha_;}
     /**
      * @brief Access alpha
      *
      * @return alpha
      */
-    double alpha( ) const  {return alpha_;}
+    value_type alpha( ) const  {return alpha_;}
     /**
      * @brief Set Chi in the above formula
      *
@@ -132,7 +133,7 @@ struct Helmholtz
     Elliptic<Geometry, Matrix, container> laplaceM_;
     container temp_;
     SparseElement<container> chi_;
-    double alpha_;
+    value_type alpha_;
 };
 
 /**
@@ -153,6 +154,7 @@ struct Helmholtz
 template< class Geometry, class Matrix, class container>
 struct Helmholtz2
 {
+    using value_type = get_value_type<container>; //!< value type of the container (\c double or \c float)
     ///@brief empty object ( no memory allocation)
     Helmholtz2() {}
     /**
@@ -164,7 +166,7 @@ struct Helmholtz2
      * @param jfactor The jfactor used in the Laplace operator (probably 1 is always the best factor but one never knows...)
      * @note The default value of \f$\chi\f$ is one
      */
-    Helmholtz2( const Geometry& g, double alpha = 1., direction dir = dg::forward, double jfactor=1.)
+    Helmholtz2( const Geometry& g, value_type alpha = 1., direction dir = dg::forward, value_type jfactor=1.)
     {
         construct( g, alpha, dir, jfactor);
     }
@@ -179,20 +181,20 @@ struct Helmholtz2
      * @param jfactor The jfactor used in the Laplace operator (probably 1 is always the best factor but one never knows...)
      * @note The default value of \f$\chi\f$ is one
      */
-    Helmholtz2( const Geometry& g, bc bcx, bc bcy, double alpha = 1., direction dir = dg::forward, double jfactor=1.)
+    Helmholtz2( const Geometry& g, bc bcx, bc bcy, value_type alpha = 1., direction dir = dg::forward, value_type jfactor=1.)
     {
               construct( g, bcx, bcy, alpha, dir, jfactor);
     }
-    ///@copydoc Helmholtz2::Helmholtz2(const Geometry&,bc,bc,double,direction,double)
-    void construct( const Geometry& g, bc bcx, bc bcy, double alpha = 1, direction dir = dg::forward, double jfactor = 1.)
+    ///@copydoc Helmholtz2::Helmholtz2(const Geometry&,bc,bc,value_type,direction,value_type)
+    void construct( const Geometry& g, bc bcx, bc bcy, value_type alpha = 1., direction dir = dg::forward, value_type jfactor = 1.)
     {
         laplaceM_.construct( g, bcx, bcy, dg::normed, dir, jfactor);
         dg::blas1::transfer( dg::evaluate( dg::one, g), temp1_);
         dg::blas1::transfer( dg::evaluate( dg::one, g), temp2_);
         alpha_ = alpha;
     }
-    ///@copydoc Helmholtz2::Helmholtz2(const Geometry&,double,direction,double)
-    void construct( const Geometry& g, double alpha = 1, direction dir = dg::forward, double jfactor = 1.)
+    ///@copydoc Helmholtz2::Helmholtz2(const Geometry&,value_type,direction,value_type)
+    void construct( const Geometry& g, value_type alpha = 1., direction dir = dg::forward, value_type jfactor = 1.)
     {
         laplaceM_.construct( g, dg::normed, dir, jfactor);
         dg::blas1::transfer( dg::evaluate( dg::one, g), temp1_);
@@ -237,13 +239,13 @@ struct Helmholtz2
      *
      * @return reference to alpha
      */
-    double& alpha( ){  return alpha_;}
+    value_type& alpha( ){  return alpha_;}
     /**
      * @brief Access alpha
      *
      * @return alpha
      */
-    double alpha( ) const  {return alpha_;}
+    value_type alpha( ) const  {return alpha_;}
     /**
      * @brief Set Chi in the above formula
      *
@@ -264,7 +266,7 @@ struct Helmholtz2
     Elliptic<Geometry, Matrix, container> laplaceM_;
     container temp1_, temp2_;
     SparseElement<container> chi_;
-    double alpha_;
+    value_type alpha_;
 };
 ///@cond
 template< class G, class M, class V>
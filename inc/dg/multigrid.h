@@ -6,9 +6,8 @@
 #include "geometry/interpolation.h"
 #include "blas.h"
 #include "cg.h"
-#ifdef DG_BENCHMARK
-#include "backend/timer.h"
-#endif //DG_BENCHMARK
+#include "chebyshev.h"
+#include "backend/profiler.h"
 #ifdef MPI_VERSION
 #include "geometry/mpi_projection.h"
 #endif
@@ -16,6 +15,33 @@
 namespace dg
 {
 
+///@cond
+namespace detail{
+//one multigrid cycle with zero initial guess as a preconditioner for CG
+template<class MultigridType, class SymmetricOp>
+struct MultigridCycle
+{
+    MultigridCycle( MultigridType& mg, std::vector<SymmetricOp>& op, unsigned gamma, unsigned nu_pre, unsigned nu_post): m_mg(mg), m_op(op), m_gamma(gamma), m_nu_pre(nu_pre), m_nu_post(nu_post){}
+    template<class ContainerType>
+    void symv( const ContainerType& r, ContainerType& z)
+    {
+        dg::blas1::scal( z, 0.);
+        m_mg.cycle( m_op, r, z, m_gamma, m_nu_pre, m_nu_post, true);
+    }
+    private:
+    MultigridType& m_mg;
+    std::vector<SymmetricOp>& m_op;
+    unsigned m_gamma, m_nu_pre, m_nu_post;
+};
+}//namespace detail
+template<class M, class O>
+struct TensorTraits< detail::MultigridCycle<M,O> >
+{
+    using value_type  = get_value_type<O>;
+    using tensor_category = SelfMadeMatrixTag;
+};
+///@endcond
+
 /**
 * @brief Solves the Equation \f[ \hat O \phi = W \cdot \rho \f]
 *
@@ -24,6 +50,9 @@ namespace dg
 *
 * @snippet elliptic2d_b.cu multigrid
 * We use conjugate gradient (CG) at each stage and refine the grids in the first two dimensions (2d / x and y)
+*
+* Alternatively, \c pcg_solve uses a V- or W-cycle with Chebyshev smoothing as a preconditioner for CG on the original grid:
+* @snippet elliptic2d_b.cu pcg_solve
  * @note A note on weights, inverse weights and preconditioning.
  * A normalized DG-discretized derivative or operator is normally not symmetric.
  * The diagonal coefficient matrix that is used to make the operator
@@ -41,6 +70,7 @@ namespace dg
 template< class Geometry, class Matrix, class container>
 struct MultigridCG2d
 {
+    using value_type = get_value_type<container>; //!< value type of the container (\c double or \c float)
     /**
      * @brief Construct the grids and the interpolation/projection operators
      *
@@ -56,6 +86,8 @@ struct MultigridCG2d
 
 		grids_.resize(stages);
         cg_.resize(stages);
+        for( unsigned u=0; u<stages; u++)
+            stage_names_.push_back( "multigrid_stage"+std::to_string(u));
 
         grids_[0].reset( grid);
         //grids_[0].get().display();
@@ -85,11 +117,14 @@ struct MultigridCG2d
         x_ = project(x0);
         m_r = x_,
 		b_ = x_;
+        cheby_.resize( stages);
+        for( unsigned u=0; u<stages; u++)
+            cheby_[u].construct( x_[u]);
         set_scheme(scheme_type);
     }
 
 	template<class SymmetricOp>
-	std::vector<unsigned> solve(/*const*/ std::vector<SymmetricOp>& op, container& x, const container& b, const double eps)
+	std::vector<unsigned> solve(/*const*/ std::vector<SymmetricOp>& op, container& x, const container& b, const value_type eps)
 	{
         //project initial guess down to coarse grid
         project(x, x_);
@@ -159,10 +194,11 @@ struct MultigridCG2d
      * @param b The right hand side (will be multiplied by \c weights)
      * @param eps the accuracy: iteration stops if \f$ ||b - Ax|| < \epsilon( ||b|| + 1) \f$
      * @return the number of iterations in each of the stages beginning with the finest grid
-     * @note If the Macro \c DG_BENCHMARK is defined this function will write timings to \c std::cout
+     * @note Every stage is recorded as region "multigrid_stage<u>" in \c dg::profiler(). The byte estimate counts the 15 memops per CG iteration (not the memops of the operator).
+     * If the Macro \c DG_BENCHMARK is defined this function will write timings to \c std::cout
     */
     template<class SymmetricOp>
-    std::vector<unsigned> direct_solve( std::vector<SymmetricOp>& op, container&  x, const container& b, double eps)
+    std::vector<unsigned> direct_solve( std::vector<SymmetricOp>& op, container&  x, const container& b, value_type eps)
     {
         dg::blas2::symv(op[0].weights(), b, b_[0]);
         // compute residual r = Wb - A x
@@ -172,52 +208,151 @@ struct MultigridCG2d
         for( unsigned u=0; u<stages_-1; u++)
             dg::blas2::gemv( interT_[u], m_r[u], m_r[u+1]);
         std::vector<unsigned> number(stages_);
-#ifdef DG_BENCHMARK
-        Timer t;
-#endif //DG_BENCHMARK
 
         dg::blas1::scal( x_[stages_-1], 0.0);
         //now solve residual equations
 		for( unsigned u=stages_-1; u>0; u--)
         {
-#ifdef DG_BENCHMARK
-            t.tic();
-#endif //DG_BENCHMARK
+            ProfileScope scope( stage_names_[u].c_str());
             cg_[u].set_max(grids_[u].get().size());
             number[u] = cg_[u]( op[u], x_[u], m_r[u], op[u].precond(), op[u].inv_weights(), eps/2, 1.);
             dg::blas2::symv( inter_[u-1], x_[u], x_[u-1]);
+            scope.add_iterations( number[u]);
+            scope.add_bytes( 15.*number[u]*container_bytes( x_[u])); //without the memops of op
 #ifdef DG_BENCHMARK
-            t.toc();
 #ifdef MPI_VERSION
             int rank;
             MPI_Comm_rank(MPI_COMM_WORLD, &rank);
             if(rank==0)
 #endif //MPI
-            std::cout << "stage: " << u << ", iter: " << number[u] << ", took "<<t.diff()<<"s\n";
+            std::cout << "stage: " << u << ", iter: " << number[u] << ", took "<<scope.elapsed()<<"s\n";
 #endif //DG_BENCHMARK
 
         }
-#ifdef DG_BENCHMARK
-        t.tic();
-#endif //DG_BENCHMARK
+        ProfileScope scope( stage_names_[0].c_str());
 
         //update initial guess
         dg::blas1::axpby( 1., x_[0], 1., x);
         cg_[0].set_max(grids_[0].get().size());
         number[0] = cg_[0]( op[0], x, b_[0], op[0].precond(), op[0].inv_weights(), eps);
+        scope.add_iterations( number[0]);
+        scope.add_bytes( 15.*number[0]*container_bytes( x));
 #ifdef DG_BENCHMARK
-        t.toc();
 #ifdef MPI_VERSION
         int rank;
         MPI_Comm_rank(MPI_COMM_WORLD, &rank);
         if(rank==0)
 #endif //MPI
-        std::cout << "stage: " << 0 << ", iter: " << number[0] << ", took "<<t.diff()<<"s\n";
+        std::cout << "stage: " << 0 << ", iter: " << number[0] << ", took "<<scope.elapsed()<<"s\n";
 #endif //DG_BENCHMARK
 
         return number;
     }
 
+    /**
+     * @brief Estimate the largest eigenvalue of the preconditioned operator on every stage
+     *
+     * The estimates are needed by the Chebyshev smoother in \c cycle and \c pcg_solve.
+     * Each estimate takes \c num_lanczos applications of the operator on the respective stage.
+     * The estimates have to be renewed whenever the operators change significantly.
+     * @copydoc hide_symmetric_op
+     * @param op Index 0 is the \c SymmetricOp on the original grid, 1 on the half grid, 2 on the quarter grid, ...
+     * @param num_lanczos number of Lanczos iterations per stage
+     * @return the estimated largest eigenvalues of \c op[u].precond()*op[u] (beginning with the finest grid)
+     */
+    template<class SymmetricOp>
+    const std::vector<value_type>& estimate_eigenvalues( std::vector<SymmetricOp>& op, unsigned num_lanczos = 20)
+    {
+        ev_.resize( stages_);
+        //a pseudo-random start vector contains all modes
+        auto noise = []( double x, double y){
+            double v = sin( 12.9898*x + 78.233*y)*43758.5453;
+            return v - floor(v) - 0.5;
+        };
+        for( unsigned u=0; u<stages_; u++)
+        {
+            dg::blas1::transfer( dg::evaluate( noise, grids_[u].get()), b_[u]);
+            EVE<container> eve( x_[u], num_lanczos);
+            ev_[u] = eve( op[u], b_[u], op[u].precond());
+        }
+        return ev_;
+    }
+
+    /**
+     * @brief Apply one multigrid cycle to \f$ \hat O x = b\f$
+     *
+     * On every stage but the coarsest the cycle smoothes the error with \c nu_pre
+     * Chebyshev iterations, recurses \c gamma times into the next coarser stage for the
+     * residual equation, interpolates the correction and smoothes with \c nu_post Chebyshev iterations.
+     * The residual equation on the coarsest grid is solved with CG to a relative accuracy of \f$ 10^{-10}\f$
+     * such that the cycle is (to that accuracy) a linear operator and can be used as a preconditioner in CG.
+     * The Chebyshev smoothers damp the spectrum in \f$ [ 0.1\lambda_{\max}, 1.1\lambda_{\max}]\f$.
+     * @copydoc hide_symmetric_op
+     * @param op Index 0 is the \c SymmetricOp on the original grid, 1 on the half grid, 2 on the quarter grid, ...
+     * @param b The right hand side (used as is i.e. @b not multiplied by \c weights)
+     * @param x (read/write) contains initial guess on input and the result on output
+     * @param gamma 1 for a V-cycle, 2 for a W-cycle (see note in \c pcg_solve)
+     * @param nu_pre number of pre-smoothing steps
+     * @param nu_post number of post-smoothing steps
+     * @param x_is_zero If true the initial guess \c x is assumed zero, which saves the residual computation in the first pre-smoothing step
+     * @note With a zero initial guess and \c nu_pre==nu_post the cycle is a symmetric linear operator
+     * @attention \c estimate_eigenvalues must be called beforehand
+     */
+    template<class SymmetricOp>
+    void cycle( std::vector<SymmetricOp>& op, const container& b, container& x, unsigned gamma = 1, unsigned nu_pre = 5, unsigned nu_post = 5, bool x_is_zero = false)
+    {
+        if( ev_.size() != stages_)
+            throw Error( Message(_ping_)<<" Eigenvalues must be estimated before a multigrid cycle!");
+        dg::blas1::copy( b, b_[0]);
+        dg::blas1::copy( x, x_[0]);
+        do_cycle( op, 0, gamma, nu_pre, nu_post, x_is_zero);
+        dg::blas1::copy( x_[0], x);
+    }
+
+    /**
+     * @brief Solve with CG on the original grid preconditioned by one multigrid cycle
+     *
+     * The iteration count grows only weakly with the resolution.
+     * If no eigenvalue estimates exist, \c estimate_eigenvalues is called.
+     * @note A V-cycle with about five smoothing steps is usually the fastest choice.
+     * Since the coarse grid operators are rediscretized (and not Galerkin products) a W-cycle,
+     * which iterates the coarse grid cycles, is efficient only for smooth coefficients.
+     * For strongly varying coefficients (e.g. \f$\chi\f$ close to zero) the plain CG may be faster.
+     * @copydoc hide_symmetric_op
+     * @param op Index 0 is the \c SymmetricOp on the original grid, 1 on the half grid, 2 on the quarter grid, ...
+     * @param x (read/write) contains initial guess on input and the solution on output
+     * @param b The right hand side (will be multiplied by \c weights)
+     * @param eps the accuracy: iteration stops if \f$ ||b - Ax|| < \epsilon( ||b|| + 1) \f$
+     * @param gamma 1 for a V-cycle, 2 for a W-cycle
+     * @param nu number of pre- and post-smoothing steps
+     * @return the number of outer CG iterations
+     * @note The call is recorded as region "multigrid_pcg" in \c dg::profiler(). The byte estimate counts the 15 memops per outer CG iteration (not the memops of the operator and the cycles).
+     * If the Macro \c DG_BENCHMARK is defined this function will write timings to \c std::cout
+     */
+    template<class SymmetricOp>
+    unsigned pcg_solve( std::vector<SymmetricOp>& op, container& x, const container& b, value_type eps, unsigned gamma = 1, unsigned nu = 5)
+    {
+        if( ev_.size() != stages_)
+            estimate_eigenvalues( op);
+        ProfileScope scope( "multigrid_pcg");
+        container rhs( b);
+        dg::blas2::symv( op[0].weights(), b, rhs);
+        detail::MultigridCycle<MultigridCG2d, SymmetricOp> precond( *this, op, gamma, nu, nu);
+        cg_[0].set_max(grids_[0].get().size());
+        unsigned number = cg_[0]( op[0], x, rhs, precond, op[0].inv_weights(), eps);
+        scope.add_iterations( number);
+        scope.add_bytes( 15.*number*container_bytes( x)); //without the memops of op and the cycles
+#ifdef DG_BENCHMARK
+#ifdef MPI_VERSION
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if(rank==0)
+#endif //MPI
+        std::cout << "# outer iterations: " << number << ", took "<<scope.elapsed()<<"s\n";
+#endif //DG_BENCHMARK
+        return number;
+    }
+
     /**
     * @brief Project vector to all involved grids
     * @param src the input vector (may alias first element of out)
@@ -257,6 +392,30 @@ struct MultigridCG2d
 
 private:
 
+    template<class SymmetricOp>
+    void do_cycle( std::vector<SymmetricOp>& op, unsigned u, unsigned gamma, unsigned nu_pre, unsigned nu_post, bool x_is_zero)
+    {
+        if( u == stages_-1)
+        {
+            //the coarse solve must be (nearly) exact, else the cycle is a nonlinear
+            //operator and the outer CG loses its convergence guarantee
+            cg_[u].set_max(grids_[u].get().size());
+            cg_[u]( op[u], x_[u], b_[u], op[u].precond(), op[u].inv_weights(), 1e-10, 0.);
+            return;
+        }
+        cheby_[u].solve( op[u], x_[u], b_[u], op[u].precond(), 0.1*ev_[u], 1.1*ev_[u], nu_pre, x_is_zero);
+        // compute residual r = b - A x and restrict it to the coarser grid
+        dg::blas2::symv(op[u], x_[u], m_r[u]);
+        dg::blas1::axpby( 1., b_[u], -1., m_r[u]);
+        dg::blas2::symv( interT_[u], m_r[u], b_[u+1]);
+        dg::blas1::scal( x_[u+1], 0.);
+        for( unsigned g=0; g<gamma; g++) //only the first recursion starts from zero
+            do_cycle( op, u+1, gamma, nu_pre, nu_post, g==0);
+        // correct the solution vector
+        dg::blas2::symv( 1., inter_[u], x_[u+1], 1., x_[u]);
+        cheby_[u].solve( op[u], x_[u], b_[u], op[u].precond(), 0.1*ev_[u], 1.1*ev_[u], nu_post);
+    }
+
 	void set_scheme(const int scheme_type)
 	{
         assert(scheme_type <= 1 && scheme_type >= 0);
@@ -332,7 +491,10 @@ private:
     std::vector< MultiMatrix<Matrix, container> >  interT_;
     std::vector< MultiMatrix<Matrix, container> >  project_;
     std::vector< CG<container> > cg_;
+    std::vector< ChebyshevIteration<container> > cheby_;
     std::vector< container> x_, m_r, b_;
+    std::vector<value_type> ev_;
+    std::vector<std::string> stage_names_; //region names in dg::profiler()
 
     struct stepinfo
     {
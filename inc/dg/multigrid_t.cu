@@ -0,0 +1,74 @@
+#include <iostream>
+#include <iomanip>
+
+#include "blas.h"
+#include "elliptic.h"
+#include "multigrid.h"
+
+const double lx = M_PI;
+const double ly = 2.*M_PI;
+dg::bc bcx = dg::DIR;
+dg::bc bcy = dg::PER;
+
+double initial( double x, double y) {return 0.;}
+double amp = 0.9;
+double pol( double x, double y) {return 1. + amp*sin(x)*sin(y); } //must be strictly positive
+double rhs( double x, double y) { return 2.*sin(x)*sin(y)*(amp*sin(x)*sin(y)+1)-amp*sin(x)*sin(x)*cos(y)*cos(y)-amp*cos(x)*cos(x)*sin(y)*sin(y);}
+double sol(double x, double y)  { return sin( x)*sin(y);}
+//a second right hand side with all modes for the symmetry test
+double noise( double x, double y) { double v = sin( 7.1*x + 3.3*y)*437.5; return v - floor(v) - 0.5;}
+
+int main()
+{
+    std::cout << "Test the multigrid cycle preconditioned CG in multigrid.h\n";
+    const unsigned n = 3, stages = 3;
+    const double eps = 1e-8;
+    std::cout << std::scientific << std::setprecision(2);
+    for( unsigned Nx = 32; Nx <= 64; Nx*=2)
+    {
+        dg::CartesianGrid2d grid( 0, lx, 0, ly, n, Nx, Nx, bcx, bcy);
+        std::cout << "Computation on: "<< n <<" x "<< Nx <<" x "<< Nx << "\n";
+        const dg::DVec w2d = dg::create::weights( grid);
+        const dg::DVec solution = dg::evaluate( sol, grid);
+        const double norm = dg::blas2::dot( w2d, solution);
+        const dg::DVec b = dg::evaluate( rhs, grid);
+        const dg::DVec chi = dg::evaluate( pol, grid);
+
+        dg::MultigridCG2d<dg::aGeometry2d, dg::DMatrix, dg::DVec > multigrid( grid, stages);
+        const std::vector<dg::DVec> multi_chi = multigrid.project( chi);
+        std::vector<dg::Elliptic<dg::aGeometry2d, dg::DMatrix, dg::DVec> > multi_pol( stages);
+        for(unsigned u=0; u<stages; u++)
+        {
+            multi_pol[u].construct( multigrid.grids()[u].get(), dg::not_normed, dg::centered);
+            multi_pol[u].set_chi( multi_chi[u]);
+        }
+        multigrid.estimate_eigenvalues( multi_pol);
+
+        //the cycle with zero initial guess must be a symmetric operator
+        const dg::DVec r1 = dg::evaluate( rhs, grid), r2 = dg::evaluate( noise, grid);
+        dg::DVec z1( r1), z2( r2);
+        dg::blas1::scal( z1, 0.), dg::blas1::scal( z2, 0.);
+        multigrid.cycle( multi_pol, r1, z1);
+        multigrid.cycle( multi_pol, r2, z2);
+        double r1z2 = dg::blas1::dot( r1, z2), r2z1 = dg::blas1::dot( r2, z1);
+        std::cout << "    Relative asymmetry of the cycle "<< fabs( r1z2-r2z1)/fabs( r1z2)<<" (should be small)\n";
+        //skipping the first residual must not change the result
+        dg::DVec z3( r1);
+        dg::blas1::scal( z3, 0.);
+        multigrid.cycle( multi_pol, r1, z3, 1, 5, 5, true);
+        dg::blas1::axpby( 1., z1, -1., z3);
+        std::cout << "    Difference of the cycle with x_is_zero "<< sqrt( dg::blas1::dot( z3, z3)/dg::blas1::dot( z1, z1))<<" (should be small)\n";
+
+        dg::DVec x = dg::evaluate( initial, grid);
+        unsigned number = multigrid.pcg_solve( multi_pol, x, b, eps);
+        dg::DVec error( solution);
+        dg::blas1::axpby( 1., x, -1., error);
+        double err = sqrt( dg::blas2::dot( w2d, error)/norm);
+        std::cout << "    V-cycle preconditioned CG: # iterations "<<number
+                  <<" (should be small and hardly grow with resolution)\n";
+        std::cout << "    Relative error to solution "<<err<<" (should be small)\n";
+        if( number == multigrid.max_iter())
+            std::cout << "    FAILED: no convergence\n";
+    }
+    return 0;
+}
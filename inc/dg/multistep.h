@@ -111,6 +111,36 @@ struct AB
     */
     template< class RHS>
     void step( RHS& f, real_type& t, ContainerType& u);
+    /**
+     * @brief Write the current time, timestep and history into a checkpoint
+     *
+     * Together with \c load_state an integration can be continued bit-for-bit
+     * without calling \c init again
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        chk.put( name+"_t", (double)tu_), chk.put( name+"_dt", (double)dt_);
+        chk.put( name+"_u", u_);
+        for( unsigned i=0; i<k; i++)
+            chk.put( name+"_f"+std::to_string(i), f_[i]);
+    }
+    /**
+     * @brief Restore time, timestep and history from a checkpoint (replaces \c init)
+     * @copydoc hide_checkpoint
+     * @note the state of the rhs functor is not part of the checkpoint
+     */
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        double t, dt;
+        chk.get( name+"_t", t), chk.get( name+"_dt", dt);
+        tu_ = t, dt_ = dt;
+        chk.get( name+"_u", u_);
+        for( unsigned i=0; i<k; i++)
+            chk.get( name+"_f"+std::to_string(i), f_[i]);
+    }
   private:
     real_type tu_, dt_;
     std::array<ContainerType,k> f_;
@@ -181,6 +211,20 @@ struct AB<1, ContainerType>
         t = t_ = t_ + dt_; //and time
         f( t_, u_, f_); //and update rhs
     }
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        chk.put( name+"_t", (double)t_), chk.put( name+"_dt", (double)dt_);
+        chk.put( name+"_u", u_), chk.put( name+"_f0", f_);
+    }
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        double t, dt;
+        chk.get( name+"_t", t), chk.get( name+"_dt", dt);
+        t_ = t, dt_ = dt;
+        chk.get( name+"_u", u_), chk.get( name+"_f0", f_);
+    }
     private:
     real_type t_, dt_;
     ContainerType u_, f_;
@@ -310,10 +354,47 @@ struct Karniadakis
     * @param t (write-only), contains timestep corresponding to \c u on output
     * @param u (write-only), contains next step of time-integration on output
      * @note the implementation is such that on output the last call to the explicit part \c exp is at the new \c (t,u). This might be interesting if the call to \c exp changes its state.
+     * @note The implicit solve and the call to \c exp are recorded as regions "karniadakis_implicit" and "karniadakis_explicit" in \c dg::profiler();
+     * the implicit region carries the bytes of the 15 memops per CG iteration (not the memops of \c imp), the explicit region only the wall time
     */
     template< class Explicit, class Implicit>
     void step( Explicit& exp, Implicit& imp, real_type& t, ContainerType& u);
 
+    /**
+     * @brief Write the current time, timestep and the history of the last three steps into a checkpoint
+     *
+     * Together with \c load_state an integration can be continued bit-for-bit
+     * without calling \c init again
+     * @copydoc hide_checkpoint
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        chk.put( name+"_t", (double)t_), chk.put( name+"_dt", (double)dt_);
+        for( unsigned i=0; i<3; i++)
+        {
+            chk.put( name+"_u"+std::to_string(i), u_[i]);
+            chk.put( name+"_f"+std::to_string(i), f_[i]);
+        }
+    }
+    /**
+     * @brief Restore time, timestep and history from a checkpoint (replaces \c init)
+     * @copydoc hide_checkpoint
+     * @note the state of the explicit and implicit functors is not part of the checkpoint
+     */
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        double t, dt;
+        chk.get( name+"_t", t), chk.get( name+"_dt", dt);
+        t_ = t, dt_ = dt;
+        for( unsigned i=0; i<3; i++)
+        {
+            chk.get( name+"_u"+std::to_string(i), u_[i]);
+            chk.get( name+"_f"+std::to_string(i), f_[i]);
+        }
+    }
+
   private:
     std::array<ContainerType,3> u_, f_;
     CG< ContainerType> pcg;
@@ -347,39 +428,42 @@ template<class ContainerType>
 template< class RHS, class Diffusion>
 void Karniadakis<ContainerType>::step( RHS& f, Diffusion& diff, real_type& t, ContainerType& u)
 {
-    blas1::axpbypgz( dt_*b[0], f_[0], dt_*b[1], f_[1], dt_*b[2], f_[2]);
-    blas1::axpbypgz( a[0], u_[0], a[1], u_[1], a[2], u_[2]);
+    //compute the explicit part and extrapolate previous solutions in a single pass:
+    //f_[2] = dt(b0 f_[0] + b1 f_[1] + b2 f_[2]), u_[2] = a0 u_[0] + a1 u_[1] + a2 u_[2] + f_[2] and u = 2u_[0] - u_[1]
+    real_type alpha[2] = {2., -1.};
+    //real_type alpha[2] = {1., 0.};
+    blas1::subroutine( blas1::fuse(
+        blas1::on<0,1,2>( dg::Axpbypgz<real_type>( dt_*b[0], dt_*b[1], dt_*b[2])),
+        blas1::on<3,4,5>( dg::Axpbypgz<real_type>( a[0], a[1], a[2])),
+        blas1::on<2,5>( dg::Axpby<real_type>( 1., 1.)),
+        blas1::on<3,4,6>( dg::Axpbypgz<real_type>( alpha[0], alpha[1], 0.))),
+        f_[0], f_[1], f_[2], u_[0], u_[1], u_[2], u);
     //permute f_[2], u_[2]  to be the new f_[0], u_[0]
     for( unsigned i=2; i>0; i--)
     {
         f_[i-1].swap( f_[i]);
         u_[i-1].swap( u_[i]);
     }
-    blas1::axpby( 1., f_[0], 1., u_[0]);
     //compute implicit part
-    real_type alpha[2] = {2., -1.};
-    //real_type alpha[2] = {1., 0.};
-    blas1::axpby( alpha[0], u_[1], alpha[1],  u_[2], u); //extrapolate previous solutions
     blas2::symv( diff.weights(), u_[0], u_[0]);
     t = t_ = t_+ dt_;
     detail::Implicit<Diffusion, ContainerType> implicit( -dt_*6./11., t, diff);
+    {
+        ProfileScope scope( "karniadakis_implicit");
+        unsigned number = pcg( implicit, u, u_[0], diff.precond(), diff.inv_weights(), eps_);
+        scope.add_iterations( number);
+        scope.add_bytes( 15.*number*container_bytes( u)); //without the memops of diff
 #ifdef DG_BENCHMARK
 #ifdef MPI_VERSION
-    int rank;
-    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-#endif//MPI
-    Timer ti;
-    ti.tic();
-    unsigned number = pcg( implicit, u, u_[0], diff.precond(), diff.inv_weights(), eps_);
-    ti.toc();
-#ifdef MPI_VERSION
-    if(rank==0)
+        int rank;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        if(rank==0)
 #endif//MPI
-    std::cout << "# of pcg iterations for timestep: "<<number<<"/"<<pcg.get_max()<<" took "<<ti.diff()<<"s\n";
-#else
-    pcg( implicit, u, u_[0], diff.precond(), diff.inv_weights(), eps_);
+        std::cout << "# of pcg iterations for timestep: "<<number<<"/"<<pcg.get_max()<<" took "<<scope.elapsed()<<"s\n";
 #endif //BENCHMARK
+    }
     blas1::copy( u, u_[0]); //store result
+    ProfileScope scope( "karniadakis_explicit");
     f(t_, u_[0], f_[0]); //call f on new point
 }
 ///@endcond
@@ -527,4 +611,120 @@ struct SIRK
     real_type eps_;
 };
 
+/**
+ * @brief Additive Runge Kutta method ARK3(2)4L[2]SA after Kennedy and Carpenter (Appl. Num. Math. 44, 2003) with embedded error estimate
+ *
+The method reads
+\f[
+    \vec v^{n+1} = \vec v^n + \Delta t\sum_{i=0}^3 b_i \left(\vec E_i + \vec I_i\right) \\
+    \vec \delta^{n+1} = \Delta t\sum_{i=0}^3 (b_i-\tilde b_i) \left(\vec E_i + \vec I_i\right) \\
+    \vec V_i = \vec v^n + \Delta t\sum_{j=0}^{i-1} \left(a^E_{ij}\vec E_j + a^I_{ij}\vec I_j\right) + \Delta t\gamma \vec I_i
+\f]
+with \f$ \vec E_i = \vec E(t^n + c_i\Delta t, \vec V_i)\f$ and \f$ \vec I_i = \vec I(t^n + c_i\Delta t, \vec V_i)\f$.
+The explicit part is third order accurate, the implicit part is L-stable and
+the embedded second order method gives an estimate of the local error, which
+is used by the \c Adaptive class to control the timestep.
+This is the adaptive counterpart of the \c Karniadakis multistep method (which needs a constant timestep).
+We solve the three implicit stages by a conjugate gradient method, which works as long
+as the implicit part remains symmetric and linear.
+ * @ingroup time
+ * @copydoc hide_ContainerType
+ * @sa Adaptive
+ */
+template <class ContainerType>
+struct ARK
+{
+    using real_type = get_value_type<ContainerType>;
+    using container_type = ContainerType;
+    ///@copydoc RK_opt::RK_opt()
+    ARK(){}
+    ///@copydoc Karniadakis::construct()
+    ARK(const ContainerType& copyable, unsigned max_iter, real_type eps){
+        construct( copyable, max_iter, eps);
+    }
+    ///@copydoc Karniadakis::construct()
+    void construct(const ContainerType& copyable, unsigned max_iter, real_type eps)
+    {
+        m_kE.fill( copyable), m_kI.fill( copyable);
+        m_rhs = copyable;
+        pcg.construct( copyable, max_iter);
+        eps_ = eps;
+    }
+    ///@copydoc EmbeddedRK::copyable()
+    const ContainerType& copyable() const{ return m_rhs;}
+    ///@copydoc EmbeddedRK::order()
+    unsigned order() const{ return 3;}
+    ///@copydoc EmbeddedRK::embedded_order()
+    unsigned embedded_order() const{ return 2;}
+    /**
+     * @brief integrate one step and estimate the error
+     *
+     * @copydoc hide_explicit_implicit
+     * @param t0 start time
+     * @param u0 start point at \c t0
+     * @param t1 (write only) end time (equals \c t0+dt on output, may alias t0)
+     * @param u1 (write only) contains result at \c t1 on output (may alias u0)
+     * @param dt timestep
+     * @param delta (write only) contains the difference between the third and the embedded second order solution on output
+     */
+    template <class Explicit, class Implicit>
+    void step( Explicit& exp, Implicit& imp, real_type t0, const ContainerType& u0, real_type& t1, ContainerType& u1, real_type dt, ContainerType& delta)
+    {
+        exp(t0, u0, m_kE[0]);
+        imp(t0, u0, m_kI[0]);
+        detail::Implicit<Implicit, ContainerType> implicit( -dt*m_rk.gamma, t0, imp);
+        for( unsigned i=1; i<4; i++)
+        {
+            //the explicit part of the stage is the initial guess for cg
+            dg::blas1::copy( u0, delta);
+            for( unsigned j=0; j<i; j++)
+                dg::blas1::axpbypgz( dt*m_rk.aE[i][j], m_kE[j], dt*m_rk.aI[i][j], m_kI[j], 1., delta);
+            real_type ti = t0 + m_rk.c[i]*dt;
+            implicit.time() = ti;
+            blas2::symv( imp.weights(), delta, m_rhs);
+            pcg( implicit, delta, m_rhs, imp.precond(), imp.inv_weights(), eps_);
+            exp(ti, delta, m_kE[i]);
+            imp(ti, delta, m_kI[i]);
+        }
+        //sum up results (u1 may alias u0)
+        dg::blas1::axpbypgz( dt*(m_rk.b[0]-m_rk.bt[0]), m_kE[0], dt*(m_rk.b[0]-m_rk.bt[0]), m_kI[0], 0., delta);
+        for( unsigned i=1; i<4; i++)
+            dg::blas1::axpbypgz( dt*(m_rk.b[i]-m_rk.bt[i]), m_kE[i], dt*(m_rk.b[i]-m_rk.bt[i]), m_kI[i], 1., delta);
+        dg::blas1::copy( u0, u1);
+        for( unsigned i=0; i<4; i++)
+            dg::blas1::axpbypgz( dt*m_rk.b[i], m_kE[i], dt*m_rk.b[i], m_kI[i], 1., u1);
+        t1 = t0 + dt;
+    }
+    private:
+    struct ark_coeff{
+    const real_type gamma = 1767732205903./4055673282236.;
+    const real_type aE[4][4] = {
+        {0,0,0,0},
+        {1767732205903./2027836641118.,0,0,0},
+        {5535828885825./10492691773637., 788022342437./10882634858940.,0,0},
+        {6485989280629./16251701735622., -4246266847089./9704473918619., 10755448449292./10357097424841.,0}
+    };
+    const real_type aI[4][4] = {
+        {0,0,0,0},
+        {1767732205903./4055673282236.,0,0,0},
+        {2746238789719./10658868560708., -640167445237./6845629431997.,0,0},
+        {1471266399579./7840856788654., -4482444167858./7529755066697., 11266239266428./11593286722821.,0}
+    };
+    const real_type b[4] = {
+        1471266399579./7840856788654., -4482444167858./7529755066697., 11266239266428./11593286722821., 1767732205903./4055673282236.
+    };
+    const real_type bt[4] = {
+        2756255671327./12835298489170., -10771552573575./22201958757719., 9247589265047./10645013368117., 2193209047091./5459859503100.
+    };
+    const real_type c[4] = {
+        0, 1767732205903./2027836641118., 3./5., 1.
+    };
+    };
+    std::array<ContainerType,4> m_kE, m_kI;
+    ContainerType m_rhs;
+    ark_coeff m_rk;
+    CG<ContainerType> pcg;
+    real_type eps_;
+};
+
 } //namespace dg
@@ -3,6 +3,7 @@
 
 #undef DG_DEBUG
 #include "multistep.h"
+#include "adaptive.h"
 #include "elliptic.h"
 
 //![function]
@@ -205,5 +206,24 @@ int main()
     dg::blas1::axpby( -1., sol, 1., y0);
     res.d = sqrt(dg::blas2::dot( w2d, y0)/norm_sol);
     std::cout << "Relative error adaptive sirk: "<< res.d<<"\t"<<res.i<<std::endl;
+    dg::ARK< dg::DVec > ark( y0, y0.size(), eps);
+    dg::DVec delta( y0);
+    time = 0., y0 = init;
+    for( unsigned i=0; i<NT; i++)
+        ark.step( exp, imp, time, y0, time, y0, dt, delta); //inplace step
+    dg::blas1::axpby( -1., sol, 1., y0);
+    res.d = sqrt(dg::blas2::dot( w2d, y0)/norm_sol);
+    std::cout << "Relative error ARK         is "<< res.d<<"\t"<<res.i<<std::endl;
+    //![adaptive]
+    //construct adaptive time stepper (the ARK parameters are forwarded)
+    dg::Adaptive< dg::ARK< dg::DVec> > adaptive( y0, y0.size(), eps);
+    time = 0., y0 = init;
+    double dt_adapt = dt; //first guess, contains the recommended timestep on output
+    //integrate from 0 to T with relative tolerance 1e-6 and absolute tolerance 1e-8
+    adaptive.integrate( exp, imp, time, y0, T, y0, dt_adapt, 1e-6, 1e-8);
+    //![adaptive]
+    dg::blas1::axpby( -1., sol, 1., y0);
+    res.d = sqrt(dg::blas2::dot( w2d, y0)/norm_sol);
+    std::cout << "Relative error adaptive ARK is "<< res.d<<" with "<<adaptive.nsteps()<<" steps and "<<adaptive.nrejected()<<" rejected"<<std::endl;
     return 0;
 }
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <iomanip>
+#ifdef _OPENMP
+#include <omp.h>
+#endif //_OPENMP
+
+#include "backend/timer.h"
+#include "blas.h"
+#include "elliptic.h"
+#include "arakawa.h"
+
+const double lx = 2.*M_PI;
+const double ly = 2.*M_PI;
+double initial( double x, double y) {return sin(x)*sin(y) + 0.1*cos(2.*x)*sin(3.*y);}
+
+using Vector = dg::DVec;
+using Matrix = dg::DMatrix;
+
+//a typical 2d right hand side: all containers are members such that it can run in a parallel region
+struct Rhs
+{
+    Rhs( const dg::CartesianGrid2d& g, double nu):
+        m_lap( g, dg::not_normed, dg::centered), m_arakawa( g),
+        m_v2d( dg::transfer<Vector>(dg::create::inv_weights(g))), m_w2d( dg::transfer<Vector>(dg::create::weights(g))),
+        m_phi( m_v2d), m_omega( m_v2d), m_nu( nu) {}
+    void operator()( double t, const Vector& y, Vector& yp)
+    {
+        dg::blas2::symv( m_lap, y, m_omega);
+        dg::blas2::symv( m_v2d, m_omega, m_omega); //omega = -Delta y
+        dg::blas1::axpby( 1., y, 0.5, m_omega, m_phi);
+        m_arakawa( y, m_phi, yp);
+        dg::blas1::axpby( -m_nu, m_omega, -1., yp);
+        dg::blas1::pointwiseDot( -m_nu, y, m_phi, 1., yp);
+        double energy = dg::blas2::dot( y, m_w2d, m_phi); //same on all threads
+        #pragma omp master
+        m_energy = energy;
+    }
+    double energy() const {return m_energy;}
+  private:
+    dg::Elliptic<dg::CartesianGrid2d, Matrix, Vector> m_lap;
+    dg::ArakawaX<dg::CartesianGrid2d, Matrix, Vector> m_arakawa;
+    Vector m_v2d, m_w2d, m_phi, m_omega;
+    double m_nu, m_energy;
+};
+
+int main()
+{
+    std::cout << "This program compares the evaluation of a right hand side in which every library call forks and joins its own team of threads to the evaluation inside one persistent parallel region (dg::parallel_region)\n";
+#ifdef _OPENMP
+    std::cout << "Number of threads "<<omp_get_max_threads()<<"\n";
+#endif //_OPENMP
+    unsigned n, multi;
+    std::cout << "Type n (3) and number of repetitions (1000)\n";
+    std::cin >> n >> multi;
+    std::cout << std::setw(8)<<"Nx=Ny"<<std::setw(16)<<"fork/join [ms]"<<std::setw(16)<<"region [ms]"<<std::setw(12)<<"speedup"<<"    difference\n";
+    for( unsigned N = 16; N <= 256; N*=2)
+    {
+        dg::CartesianGrid2d grid( 0, lx, 0, ly, n, N, N, dg::PER, dg::PER);
+        const Vector y = dg::transfer<Vector>(dg::evaluate( initial, grid));
+        Vector yp_fork( y), yp_region( y);
+        Rhs rhs( grid, 1e-3);
+        rhs( 0., y, yp_fork); //warm up
+        dg::Timer t;
+        t.tic();
+        for( unsigned i=0; i<multi; i++)
+            rhs( 0., y, yp_fork);
+        t.toc();
+        double fork = t.diff()/(double)multi;
+        double energy_fork = rhs.energy();
+        t.tic();
+        //! [parallel_region]
+        dg::parallel_region( [&](){
+            for( unsigned i=0; i<multi; i++)
+                rhs( 0., y, yp_region);
+        });
+        //! [parallel_region]
+        t.toc();
+        double region = t.diff()/(double)multi;
+        dg::blas1::axpby( 1., yp_fork, -1., yp_region);
+        double diff = sqrt( dg::blas1::dot( yp_region, yp_region)) + fabs( rhs.energy() - energy_fork);
+        std::cout << std::setw(8)<<N<<std::setw(16)<<fork*1e3<<std::setw(16)<<region*1e3<<std::setw(12)<<fork/region<<"    "<<diff<<" (should be 0)\n";
+    }
+    return 0;
+}
@@ -39,6 +39,22 @@ struct rk_coeff;
  */
 template< size_t s, class real_type>
 struct rk_classic;
+/*! @brief coefficients for embedded explicit RK methods
+ *
+ * The coefficients are in the classical form with weights \c b of the method of order \c order and
+ * weights \c bt of the embedded method of order \c embedded_order.
+ * Currently \c bogacki_shampine (3(2), 4 stages), \c cash_karp (5(4), 6 stages)
+ * and \c dormand_prince (5(4), 7 stages) are available.
+ * If \c fsal is true, the last stage is evaluated at the new solution (first same as last).
+ */
+template<class real_type>
+struct bogacki_shampine;
+///@copydoc bogacki_shampine
+template<class real_type>
+struct cash_karp;
+///@copydoc bogacki_shampine
+template<class real_type>
+struct dormand_prince;
 ///@cond
 /*
 template<>
@@ -303,6 +319,64 @@ const real_type b[17] = {
 0.0333333333333333333333333333333333333333333333333333333333333
 };
 };
+
+//////////////////embedded pairs/////////////////
+template<class real_type>
+struct bogacki_shampine{
+static constexpr unsigned stages = 4, order = 3, embedded_order = 2;
+static constexpr bool fsal = true;
+const real_type a[4][4] = {
+    {0,0,0,0},
+    {1./2.,0,0,0},
+    {0,3./4.,0,0},
+    {2./9.,1./3.,4./9.,0}
+};
+const real_type b[4] = {
+    2./9.,1./3.,4./9.,0
+};
+const real_type bt[4] = {
+    7./24.,1./4.,1./3.,1./8.
+};
+};
+template<class real_type>
+struct cash_karp{
+static constexpr unsigned stages = 6, order = 5, embedded_order = 4;
+static constexpr bool fsal = false;
+const real_type a[6][6] = {
+    {0,0,0,0,0,0},
+    {1./5.,0,0,0,0,0},
+    {3./40.,9./40.,0,0,0,0},
+    {3./10.,-9./10.,6./5.,0,0,0},
+    {-11./54.,5./2.,-70./27.,35./27.,0,0},
+    {1631./55296.,175./512.,575./13824.,44275./110592.,253./4096.,0}
+};
+const real_type b[6] = {
+    37./378.,0,250./621.,125./594.,0,512./1771.
+};
+const real_type bt[6] = {
+    2825./27648.,0,18575./48384.,13525./55296.,277./14336.,1./4.
+};
+};
+template<class real_type>
+struct dormand_prince{
+static constexpr unsigned stages = 7, order = 5, embedded_order = 4;
+static constexpr bool fsal = true;
+const real_type a[7][7] = {
+    {0,0,0,0,0,0,0},
+    {1./5.,0,0,0,0,0,0},
+    {3./40.,9./40.,0,0,0,0,0},
+    {44./45.,-56./15.,32./9.,0,0,0,0},
+    {19372./6561.,-25360./2187.,64448./6561.,-212./729.,0,0,0},
+    {9017./3168.,-355./33.,46732./5247.,49./176.,-5103./18656.,0,0},
+    {35./384.,0,500./1113.,125./192.,-2187./6784.,11./84.,0}
+};
+const real_type b[7] = {
+    35./384.,0,500./1113.,125./192.,-2187./6784.,11./84.,0
+};
+const real_type bt[7] = {
+    5179./57600.,0,7571./16695.,393./640.,-92097./339200.,187./2100.,1./40.
+};
+};
 ///@endcond
 
  /** @class hide_rhs
@@ -500,6 +574,109 @@ void RK<s, ContainerType>::step( RHS& f, real_type t0, const ContainerType& u0,
     t1 = t0 + dt;
 }
 
+/**
+* @brief Struct for embedded Runge-Kutta explicit time-integration
+* \f[
+ \begin{align}
+    u^{n+1} = u^{n} + \Delta t\sum_{j=1}^s b_j k_j \\
+    \delta^{n+1} = \Delta t\sum_{j=1}^s (b_j-\tilde b_j) k_j \\
+    k_j = f\left( u^n + \Delta t \sum_{l=1}^j a_{jl} k_l\right)
+ \end{align}
+\f]
+*
+* @ingroup time
+*
+* Computes a step of the higher order method together with an estimate of its local error,
+* which is used by the \c Adaptive class to control the timestep.
+* For tableaus with the first same as last property the last stage of a step
+* is reused as the first stage of the next step if the next step starts at the end time of the previous one.
+* @tparam Tableau one of \c bogacki_shampine, \c cash_karp or \c dormand_prince
+* @copydoc hide_ContainerType
+* @sa Adaptive
+*/
+template< template<class> class Tableau, class ContainerType>
+struct EmbeddedRK
+{
+    using real_type = get_value_type<ContainerType>;
+    using container_type = ContainerType;
+    ///@copydoc RK_opt::RK_opt()
+    EmbeddedRK(){}
+    ///@copydoc RK_opt::construct(const ContainerType&)
+    EmbeddedRK( const ContainerType& copyable){
+        construct( copyable);
+    }
+    ///@copydoc RK_opt::construct(const ContainerType&)
+    void construct( const ContainerType& copyable){
+        k_.fill(copyable);
+        u_ = copyable;
+        m_fsal = false;
+    }
+    ///@brief Return an object of same size as the object used for construction
+    const ContainerType& copyable() const{ return u_;}
+    ///@brief Order of the method
+    unsigned order() const{ return Tableau<real_type>::order;}
+    ///@brief Order of the embedded method
+    unsigned embedded_order() const{ return Tableau<real_type>::embedded_order;}
+    ///@brief Evaluate the first stage in the next step even if it starts at the end of the previous one (use when \c u was changed in between)
+    void ignore_fsal(){ m_fsal = false;}
+    /**
+    * @brief Advance one step and estimate the error
+    *
+    * @copydoc hide_rhs
+    * @param rhs right hand side subroutine
+    * @param t0 start time
+    * @param u0 value at \c t0
+    * @param t1 (write only) end time ( equals \c t0+dt on output, may alias \c t0)
+    * @param u1 (write only) contains result on output (may alias u0)
+    * @param dt timestep
+    * @param delta (write only) contains the difference between the higher and the embedded lower order solution on output
+    */
+    template<class RHS>
+    void step( RHS& rhs, real_type t0, const ContainerType& u0, real_type& t1, ContainerType& u1, real_type dt, ContainerType& delta);
+  private:
+    static constexpr unsigned s = Tableau<real_type>::stages;
+    std::array<ContainerType,s> k_;
+    ContainerType u_;
+    Tableau<real_type> m_rk;
+    real_type m_t1;
+    bool m_fsal = false;
+};
+
+///@cond
+template< template<class> class Tableau, class ContainerType>
+template< class RHS>
+void EmbeddedRK<Tableau, ContainerType>::step( RHS& f, real_type t0, const ContainerType& u0, real_type& t1, ContainerType& u1, real_type dt, ContainerType& delta)
+{
+    if( m_fsal && t0 == m_t1)
+        k_[0].swap( k_[s-1]); //last stage of previous step is f(t0,u0)
+    else
+        f(t0, u0, k_[0]); //compute k_0
+    for( unsigned i=1; i<s; i++) //compute k_i
+    {
+        blas1::axpby( 1., u0, dt*m_rk.a[i][0],k_[0], u_); //l=0
+        real_type tu = DG_FMA( dt,m_rk.a[i][0],t0); //l=0
+        for( unsigned l=1; l<i; l++)
+        {
+            if( m_rk.a[i][l] != 0)
+                blas1::axpby( dt*m_rk.a[i][l], k_[l],1., u_);
+            tu = DG_FMA(dt,m_rk.a[i][l],tu);
+        }
+        f( tu, u_, k_[i]);
+    }
+    //Now add everything up to delta and u1 (u1 may alias u0)
+    blas1::axpby( dt*(m_rk.b[0]-m_rk.bt[0]), k_[0], dt*(m_rk.b[1]-m_rk.bt[1]), k_[1], delta);
+    for( unsigned i=2; i<s; i++)
+        if( m_rk.b[i] != m_rk.bt[i])
+            blas1::axpby( dt*(m_rk.b[i]-m_rk.bt[i]), k_[i],1., delta);
+    blas1::axpby( 1., u0, dt*m_rk.b[0], k_[0], u1);
+    for( unsigned i=1; i<s; i++)
+        if( m_rk.b[i] != 0)
+            blas1::axpby( dt*m_rk.b[i], k_[i],1., u1);
+    t1 = m_t1 = t0 + dt;
+    m_fsal = Tableau<real_type>::fsal;
+}
+///@endcond
+
 ///@addtogroup time
 ///@{
 
@@ -534,6 +711,7 @@ void stepperRK(RHS& rhs, get_value_type<ContainerType>  t_begin, const Container
  * @brief Integrates the differential equation using a stage s Runge-Kutta scheme, a rudimentary stepsize-control and monitoring the sanity of integration
  *
  * Doubles the number of timesteps until the desired accuracy is reached
+ * @note Each doubling restarts the integration from \c begin; \c integrateERK reaches a given accuracy in a single pass
  *
  * @tparam s Order of the method (1, 2, 3, 4, 6, 17)
  * @copydoc hide_rhs
@@ -551,6 +729,8 @@ void stepperRK(RHS& rhs, get_value_type<ContainerType>  t_begin, const Container
  * @param eps_abs desired accuracy in the error function between \c end and \c end_old
  * @param NT_init initial number of steps
  * @return number of iterations if converged, -1 and a warning to \c std::cerr when \c isnan appears, -2 if failed to reach \c eps_abs
+
+ * @sa integrateERK
  */
 template<unsigned s, class RHS, class ContainerType>
 int integrateRK(RHS& rhs, get_value_type<ContainerType> t_begin, const ContainerType& begin, get_value_type<ContainerType> t_end, ContainerType& end, get_value_type<ContainerType> eps_abs, unsigned NT_init = 2 )
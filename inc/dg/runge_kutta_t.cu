@@ -9,6 +9,7 @@
 #include "geometry/evaluation.h"
 #include "arakawa.h"
 #include "runge_kutta.h"
+#include "adaptive.h"
 
 
 //![function]
@@ -106,6 +107,63 @@ int main()
         rk_opt4.step( functor, t, u1, t, u1, dt); //step inplace
     dg::blas1::axpby( 1., sol, -1., u1);
     std::cout << "Norm of error in RK_opt<4> is "<<sqrt(dg::blas1::dot( u1, u1))<<"\n";
+    std::array<double,2> delta(u);
+    dg::EmbeddedRK<dg::bogacki_shampine, std::array<double,2> > bs(u);
+    u1 = u;
+    t=t_start;
+    for( unsigned i=0; i<N; i++)
+        bs.step( functor, t, u1, t, u1, dt, delta); //step inplace
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in Bogacki-Shampine is "<<sqrt(dg::blas1::dot( u1, u1))<<"\n";
+    dg::EmbeddedRK<dg::cash_karp, std::array<double,2> > ck(u);
+    u1 = u;
+    t=t_start;
+    for( unsigned i=0; i<N; i++)
+        ck.step( functor, t, u1, t, u1, dt, delta); //step inplace
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in Cash-Karp       is "<<sqrt(dg::blas1::dot( u1, u1))<<"\n";
+    dg::EmbeddedRK<dg::dormand_prince, std::array<double,2> > dp(u);
+    u1 = u;
+    t=t_start;
+    for( unsigned i=0; i<N; i++)
+        dp.step( functor, t, u1, t, u1, dt, delta); //step inplace
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in Dormand-Prince  is "<<sqrt(dg::blas1::dot( u1, u1))<<"\n";
+    std::cout << "Adaptive timestepping with rtol = 1e-8, atol = 1e-10\n";
+    dg::Adaptive<dg::EmbeddedRK<dg::bogacki_shampine, std::array<double,2> > > adapt_bs(u);
+    dg::Adaptive<dg::EmbeddedRK<dg::cash_karp, std::array<double,2> > > adapt_ck(u);
+    dg::Adaptive<dg::EmbeddedRK<dg::dormand_prince, std::array<double,2> > > adapt_dp(u);
+    double dt_adapt = dt;
+    adapt_bs.integrate( functor, t_start, u, t_end, u1, dt_adapt, 1e-8, 1e-10);
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in adaptive Bogacki-Shampine is "<<sqrt(dg::blas1::dot( u1, u1))<<" with "<<adapt_bs.nsteps()<<" steps and "<<adapt_bs.nrejected()<<" rejected\n";
+    dt_adapt = dt;
+    adapt_ck.integrate( functor, t_start, u, t_end, u1, dt_adapt, 1e-8, 1e-10);
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in adaptive Cash-Karp       is "<<sqrt(dg::blas1::dot( u1, u1))<<" with "<<adapt_ck.nsteps()<<" steps and "<<adapt_ck.nrejected()<<" rejected\n";
+    dt_adapt = dt;
+    adapt_dp.integrate( functor, t_start, u, t_end, u1, dt_adapt, 1e-8, 1e-10);
+    dg::blas1::axpby( 1., sol, -1., u1);
+    std::cout << "Norm of error in adaptive Dormand-Prince  is "<<sqrt(dg::blas1::dot( u1, u1))<<" with "<<adapt_dp.nsteps()<<" steps and "<<adapt_dp.nrejected()<<" rejected\n";
+    //the tolerance bounds the local error, so the global error is at most the sum over all steps
+    int steps = dg::integrateERK<dg::dormand_prince>( functor, t_start, u, t_end, u1, 1e-10);
+    dg::blas1::axpby( 1., sol, -1., u1);
+    double error = sqrt(dg::blas1::dot( u1, u1));
+    std::cout << "Norm of error in integrateERK            is "<<error<<" with "<<steps<<" steps\n";
+    if( steps <= 0 || error > steps*1e-10)
+    {
+        std::cout << "    FAILED: error larger than "<<steps*1e-10<<"\n";
+        return -1;
+    }
+    steps = dg::integrateERK<dg::dormand_prince>( functor, t_end, sol, t_start, u1, 1e-10);
+    dg::blas1::axpby( 1., u, -1., u1);
+    error = sqrt(dg::blas1::dot( u1, u1));
+    std::cout << "Norm of error in backward integrateERK   is "<<error<<" with "<<steps<<" steps\n";
+    if( steps <= 0 || error > steps*1e-10)
+    {
+        std::cout << "    FAILED: error larger than "<<steps*1e-10<<"\n";
+        return -1;
+    }
 
     return 0;
 }
@@ -169,6 +169,65 @@ DG_DEVICE
     private:
     T m_a, m_b;
 };
+
+namespace detail{
+//select the I-th argument of a parameter pack
+template<unsigned I>
+struct Select
+{
+    template<class T, class ...Ts>
+DG_DEVICE
+    static auto get( T&&, Ts&&... xs) -> decltype( Select<I-1>::get( static_cast<Ts&&>(xs)...)){
+        return Select<I-1>::get( static_cast<Ts&&>(xs)...);
+    }
+};
+template<>
+struct Select<0>
+{
+    template<class T, class ...Ts>
+DG_DEVICE
+    static T&& get( T&& x, Ts&&...){
+        return static_cast<T&&>(x);
+    }
+};
+}//namespace detail
+
+//call a subroutine with the arguments Is... of the fused subroutine
+template<class Subroutine, unsigned ...Is>
+struct SubroutineOn
+{
+    SubroutineOn( Subroutine f): m_f(f){}
+    template<class ...Ts>
+DG_DEVICE
+    void operator()( Ts&&... xs){
+        m_f( detail::Select<Is>::get( xs...)...);
+    }
+    private:
+    Subroutine m_f;
+};
+
+//call all subroutines one after the other on the same elements
+template<class ...Subroutines>
+struct Fused
+{
+    template<class ...Ts>
+DG_DEVICE
+    void operator()( Ts&&...){}
+};
+template<class Subroutine, class ...Subroutines>
+struct Fused<Subroutine, Subroutines...>
+{
+    Fused( Subroutine f, Subroutines... fs): m_f(f), m_fs(fs...){}
+    template<class ...Ts>
+DG_DEVICE
+    void operator()( Ts&&... xs){
+        m_f( xs...);
+        m_fs( xs...);
+    }
+    private:
+    Subroutine m_f;
+    Fused<Subroutines...> m_fs;
+};
 ///@endcond
 
 
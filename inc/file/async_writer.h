@@ -0,0 +1,287 @@
+#pragma once
+
+#include <map>
+#include <utility>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <netcdf.h>
+#include "thrust/host_vector.h"
+#include "thrust/copy.h"
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+#include "thrust/system/cuda/experimental/pinned_allocator.h"
+#endif
+
+#include "nc_utilities.h"
+#include "nc_output.h"
+
+/*!@file
+ *
+ * Contains the AsyncWriter class that writes to a netcdf file on a background thread
+ */
+
+namespace file
+{
+
+///@cond
+namespace detail
+{
+#if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
+//page-locked memory makes the device to host transfer fast
+using PinnedHVec = thrust::host_vector<double, thrust::cuda::experimental::pinned_allocator<double> >;
+#else
+using PinnedHVec = thrust::host_vector<double>;
+#endif
+//the netcdf library is not thread-safe: background threads serialize their netcdf calls with this mutex
+inline std::mutex& netcdf_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+}//namespace detail
+///@endcond
+
+/**
+ * @brief Asynchronous, double buffered output to an open netcdf file
+ *
+ * All netcdf calls on the file are done on a background thread such that
+ * the time loop continues while the data is written to disk. The file stays open
+ * during the whole simulation.
+ * - fields written with \c put_vara are copied into one of two
+ *   (page-locked if the device is a gpu) host buffers of the variable and
+ *   queued for writing. A third write to the same variable waits until the first one is on disk.
+ * - scalar time series written with \c put_var1 are collected and written in
+ *   batches of consecutive values
+ *
+ * @code
+    file::NC_Error_Handle err;
+    int ncid;
+    err = nc_create( "out.nc", NC_NETCDF4|NC_CLOBBER, &ncid);
+    //... define dimensions and variables
+    err = nc_enddef( ncid);
+    file::AsyncWriter writer( ncid);
+    for( unsigned i=0; i<maxout; i++)
+    {
+        //... integrate in time
+        writer.put_var1( energyID, i, energy);
+        start[0] = i;
+        writer.put_vara( fieldID, start, count, field); //field may live on the device
+    }
+    writer.flush();
+    err = nc_close( ncid);
+ * @endcode
+ * @attention the file must be in data mode and no other netcdf function may be
+ * called on the file while the writer has pending writes (call \c flush() before).
+ * Errors of the background thread are thrown as \c NC_Error in the next call to a member function.
+ * @note the netcdf library is not thread-safe: the background threads of all
+ * \c AsyncWriter and \c RecordReader objects serialize their netcdf calls, but
+ * the calling thread must not use netcdf while any of them has pending work
+ */
+struct AsyncWriter
+{
+    /**
+     * @brief Start the background thread
+     *
+     * @param ncid file ID (the file must be open and in data mode)
+     * @param batch number of consecutive scalar values collected before they are written
+     */
+    AsyncWriter( int ncid, unsigned batch = 64): m_ncid( ncid), m_batch( batch)
+    {
+        m_thread = std::thread( &AsyncWriter::work, this);
+    }
+    AsyncWriter( const AsyncWriter&) = delete;
+    AsyncWriter& operator=( const AsyncWriter&) = delete;
+    /**
+     * @brief Write all pending data and stop the background thread
+     *
+     * Errors are not reported, call \c flush() before to catch them.
+     * @note does not close the file
+     */
+    ~AsyncWriter()
+    {
+        try{ queue_scalars();}catch( NC_Error&){}
+        {
+            std::unique_lock<std::mutex> lock( m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+
+    /**
+     * @brief Queue a hyperslab of a variable for writing (equivalent to \c nc_put_vara_double)
+     *
+     * The data is copied into a host buffer before the function returns, i.e.
+     * \c data can be changed immediately afterwards.
+     * @tparam ContainerType a host or device vector of doubles
+     * @param varID variable ID
+     * @param start start index for each dimension of the variable
+     * @param count number of values in each dimension (the product must equal \c data.size())
+     * @param data the values
+     * @param bits number of kept mantissa bits in \c file::quantize (0: lossless)
+     */
+    template<class ContainerType>
+    void put_vara( int varID, const size_t* start, const size_t* count, const ContainerType& data, unsigned bits = 0)
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        check_error();
+        if( m_ndims.count( varID) == 0)
+        {
+            //the background thread must not use netcdf at the same time
+            m_cond.wait( lock, [this]{ return m_jobs.empty() && !m_busy;});
+            int ndims;
+            NC_Error_Handle err;
+            std::lock_guard<std::mutex> nc_lock( detail::netcdf_mutex());
+            err = nc_inq_varndims( m_ncid, varID, &ndims);
+            m_ndims[varID] = ndims;
+            m_buffers[varID].resize( 2);
+            m_free[varID] = std::vector<bool>( 2, true);
+        }
+        std::vector<bool>& free = m_free[varID];
+        //double buffering: wait until one of the buffers is written
+        m_cond.wait( lock, [&]{ return free[0] || free[1] || m_error;});
+        check_error();
+        unsigned slot = free[0] ? 0 : 1;
+        free[slot] = false;
+        detail::PinnedHVec& buffer = m_buffers[varID][slot];
+        lock.unlock();
+        buffer.resize( data.size());
+        thrust::copy( data.begin(), data.end(), buffer.begin());
+        quantize( thrust::raw_pointer_cast( buffer.data()), buffer.size(), bits);
+        lock.lock();
+        Job job;
+        job.varID = varID, job.slot = slot;
+        job.start.assign( start, start+m_ndims[varID]);
+        job.count.assign( count, count+m_ndims[varID]);
+        m_jobs.push_back( job);
+        lock.unlock();
+        m_cond.notify_all();
+    }
+
+    /**
+     * @brief Queue a single value of a one-dimensional variable (equivalent to \c nc_put_var1_double)
+     *
+     * Consecutive values of a variable are collected and written in one call
+     * once \c batch values are available.
+     * @param varID variable ID (the variable must be one-dimensional, e.g. a time series)
+     * @param index the index of the value
+     * @param value the value
+     */
+    void put_var1( int varID, size_t index, double value)
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        check_error();
+        Series& s = m_series[varID];
+        if( !s.values.empty() && index != s.start + s.values.size())
+            queue_series( varID, s);
+        if( s.values.empty())
+            s.start = index;
+        s.values.push_back( value);
+        if( s.values.size() >= m_batch)
+            queue_series( varID, s);
+        lock.unlock();
+        m_cond.notify_all();
+    }
+
+    /**
+     * @brief Queue all collected scalar values and wait until all data is written
+     *
+     * Afterwards it is safe to call netcdf functions on the file, e.g. \c nc_close
+     * @note the data is not necessarily on disk yet (use \c nc_sync for that)
+     */
+    void flush()
+    {
+        queue_scalars();
+        std::unique_lock<std::mutex> lock( m_mutex);
+        m_cond.wait( lock, [this]{ return m_jobs.empty() && !m_busy;});
+        check_error();
+    }
+
+    private:
+    struct Job
+    {
+        int varID;
+        unsigned slot; //buffer of the field
+        std::vector<size_t> start, count;
+        std::vector<double> values; //scalar values instead of the field if not empty
+    };
+    struct Series
+    {
+        size_t start = 0;
+        std::vector<double> values;
+    };
+    //m_mutex must be locked
+    void check_error()
+    {
+        if( m_error)
+        {
+            int error = m_error;
+            m_error = 0;
+            throw NC_Error( error);
+        }
+    }
+    //m_mutex must be locked
+    void queue_series( int varID, Series& s)
+    {
+        Job job;
+        job.varID = varID, job.slot = 0;
+        job.start.assign( 1, s.start);
+        job.count.assign( 1, s.values.size());
+        job.values.swap( s.values);
+        m_jobs.push_back( job);
+    }
+    void queue_scalars()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        check_error();
+        for( auto& s : m_series)
+            if( !s.second.values.empty())
+                queue_series( s.first, s.second);
+        lock.unlock();
+        m_cond.notify_all();
+    }
+    void work()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        while( true)
+        {
+            m_cond.wait( lock, [this]{ return m_stop || !m_jobs.empty();});
+            if( m_jobs.empty())
+                return; //m_stop
+            Job job = std::move( m_jobs.front());
+            m_jobs.pop_front();
+            m_busy = true;
+            const double* data = job.values.empty() ?
+                thrust::raw_pointer_cast( m_buffers[job.varID][job.slot].data()) : job.values.data();
+            lock.unlock();
+            int error;
+            {
+                std::lock_guard<std::mutex> nc_lock( detail::netcdf_mutex());
+                error = nc_put_vara_double( m_ncid, job.varID, job.start.data(), job.count.data(), data);
+            }
+            lock.lock();
+            if( job.values.empty())
+                m_free[job.varID][job.slot] = true;
+            if( error && !m_error)
+                m_error = error;
+            m_busy = false;
+            m_cond.notify_all();
+        }
+    }
+    int m_ncid;
+    unsigned m_batch;
+    std::map<int, int> m_ndims;
+    std::map<int, std::vector<detail::PinnedHVec> > m_buffers;
+    std::map<int, std::vector<bool> > m_free;
+    std::map<int, Series> m_series;
+    std::deque<Job> m_jobs;
+    bool m_busy = false, m_stop = false;
+    int m_error = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+};
+
+}//namespace file
@@ -0,0 +1,64 @@
+#include <iostream>
+#include <string>
+#include <netcdf.h>
+#include <cmath>
+
+#include "dg/algorithm.h"
+#include "async_writer.h"
+
+double function( double x, double y, double z){return sin(x)*sin(y)*cos(z);}
+
+int main()
+{
+    std::cout << "WRITE A TIMEDEPENDENT SCALAR AND SCALAR FIELD ASYNCHRONOUSLY TO A NETCDF4 FILE\n";
+    double Tmax=2.*M_PI;
+    unsigned NT = 10;
+    double h = Tmax/NT;
+    dg::Grid3d g( 0, 2.*M_PI, 0, 2.*M_PI, 0, 2.*M_PI, 3, 10, 10, 20);
+    const dg::DVec field = dg::evaluate( function, g);
+    dg::DVec data( field);
+    int ncid;
+    file::NC_Error_Handle err;
+    err = nc_create( "async.nc", NC_NETCDF4|NC_CLOBBER, &ncid);
+    int dim_ids[4], tvarID;
+    err = file::define_dimensions( ncid, dim_ids, &tvarID, g);
+    int energyID, scalarID;
+    err = nc_def_var( ncid, "energy", NC_DOUBLE, 1, dim_ids, &energyID);
+    err = nc_def_var( ncid, "scalar", NC_DOUBLE, 4, dim_ids, &scalarID);
+    err = nc_enddef( ncid);
+    size_t count[4] = {1, g.Nz(), g.n()*g.Ny(), g.n()*g.Nx()};
+    size_t start[4] = {0, 0, 0, 0};
+    {
+        file::AsyncWriter writer( ncid, 4);
+        for(unsigned i=0; i<=NT; i++)
+        {
+            double time = i*h;
+            start[0] = i;
+            dg::blas1::axpby( cos( time), field, 0., data);
+            writer.put_var1( energyID, i, dg::blas1::dot( data, data));
+            writer.put_vara( scalarID, start, count, data);
+            writer.put_var1( tvarID, i, time);
+            //the writer holds its own copy
+            dg::blas1::scal( data, 0.);
+        }
+        writer.flush();
+    }
+    std::cout << "READ BACK AND COMPARE\n";
+    thrust::host_vector<double> read( field.size()), energies( NT+1);
+    size_t Ecount = NT+1, Estart = 0;
+    err = nc_get_vara_double( ncid, energyID, &Estart, &Ecount, energies.data());
+    double error = 0;
+    for(unsigned i=0; i<=NT; i++)
+    {
+        start[0] = i;
+        err = nc_get_vara_double( ncid, scalarID, start, count, read.data());
+        dg::HVec solution = field;
+        dg::blas1::scal( solution, cos( i*h));
+        dg::blas1::axpby( 1., solution, -1., read);
+        error += dg::blas1::dot( read, read);
+        error += fabs( energies[i] - dg::blas1::dot( solution, solution));
+    }
+    std::cout << "Error "<<error<<" (must be 0)\n";
+    err = nc_close(ncid);
+    return 0;
+}
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <netcdf.h>
+#ifdef MPI_VERSION
+#include <mpi.h>
+#include <netcdf_par.h>
+#endif //MPI_VERSION
+#include "thrust/host_vector.h"
+#include "thrust/copy.h"
+
+#include "dg/backend/exceptions.h"
+#ifdef MPI_VERSION
+#include "dg/backend/mpi_vector.h"
+#endif //MPI_VERSION
+#include "nc_utilities.h"
+
+/*!@file
+ *
+ * Contains the Checkpoint class to save and restore the full state of a simulation
+ */
+
+namespace file
+{
+
+/**
+ * @brief A netcdf file that holds the full resolution state of a simulation
+ *
+ * Vectors are stored as one-dimensional double variables and scalars as global attributes
+ * such that a restarted simulation continues bit-for-bit.
+ * The time steppers and solvers of the dg library write their internal state with
+ * their \c save_state and \c load_state members:
+ * @code
+    //at the end of a run
+    {
+        file::Checkpoint chk( "restart.nc", NC_CLOBBER);
+        chk.put( "time", time);
+        chk.put( "y0", y0);
+        karniadakis.save_state( chk, "karniadakis");
+    } //file is closed here
+    //at the beginning of the next run
+    {
+        file::Checkpoint chk( "restart.nc", NC_NOWRITE);
+        chk.get( "time", time);
+        chk.get( "y0", y0);
+        karniadakis.load_state( chk, "karniadakis");
+    }
+ * @endcode
+ * A \c std::vector of vectors is stored element by element (with names \c name_0, \c name_1, ...),
+ * vectors on the device are transferred to the host.
+ * In the MPI version all processes of the communicator write their part of a vector into one
+ * file using parallel netcdf. The same number of processes must be used for reading.
+ * @note the file is written under the name \c filename.tmp and renamed when it is closed
+ * such that a run that is killed while writing never destroys the previous checkpoint
+ * @attention all values must be put or got in the same order on all processes
+ * @attention the netcdf library is not thread-safe: call \c flush() on all \c file::AsyncWriter
+ * objects before a Checkpoint is opened
+ */
+struct Checkpoint
+{
+    /**
+     * @brief Open a checkpoint file
+     *
+     * @param filename name of the file
+     * @param mode \c NC_CLOBBER creates a new file (an existing file is overwritten when closed),
+     * \c NC_NOWRITE opens an existing file for reading
+     */
+    Checkpoint( std::string filename, int mode): m_filename( filename), m_write( mode != NC_NOWRITE)
+    {
+        NC_Error_Handle err;
+        if( m_write)
+        {
+            err = nc_create( (m_filename+".tmp").data(), NC_NETCDF4|NC_CLOBBER, &m_ncid);
+            err = nc_enddef( m_ncid); //every put switches to define mode and back
+        }
+        else
+            err = nc_open( m_filename.data(), NC_NOWRITE, &m_ncid);
+        m_open = true;
+    }
+#ifdef MPI_VERSION
+    /**
+     * @brief Open a checkpoint file that is shared by all processes in \c comm (collective call)
+     *
+     * @param filename name of the file
+     * @param mode \c NC_CLOBBER creates a new file (an existing file is overwritten when closed),
+     * \c NC_NOWRITE opens an existing file for reading
+     * @param comm all processes of the communicator must take part in all subsequent calls
+     */
+    Checkpoint( std::string filename, int mode, MPI_Comm comm): m_filename( filename), m_write( mode != NC_NOWRITE), m_comm( comm)
+    {
+        NC_Error_Handle err;
+        if( m_write)
+        {
+            err = nc_create_par( (m_filename+".tmp").data(), NC_NETCDF4|NC_MPIIO|NC_CLOBBER, m_comm, MPI_INFO_NULL, &m_ncid);
+            err = nc_enddef( m_ncid);
+        }
+        else
+            err = nc_open_par( m_filename.data(), NC_NOWRITE|NC_MPIIO, m_comm, MPI_INFO_NULL, &m_ncid);
+        m_open = true;
+    }
+#endif //MPI_VERSION
+    Checkpoint( const Checkpoint&) = delete;
+    Checkpoint& operator=( const Checkpoint&) = delete;
+    ///@brief Close the file (errors are ignored, call \c close() to catch them)
+    ~Checkpoint()
+    {
+        try{ close();}catch( std::exception&){}
+    }
+    /**
+     * @brief Close the file and move the written file to its final name
+     * @note is called by the destructor
+     */
+    void close()
+    {
+        if( !m_open)
+            return;
+        m_open = false;
+        NC_Error_Handle err;
+        err = nc_close( m_ncid);
+        if( !m_write)
+            return;
+        int rank = 0;
+#ifdef MPI_VERSION
+        if( m_comm != MPI_COMM_NULL)
+        {
+            MPI_Barrier( m_comm);
+            MPI_Comm_rank( m_comm, &rank);
+        }
+#endif //MPI_VERSION
+        if( rank == 0 && std::rename( (m_filename+".tmp").data(), m_filename.data()) != 0)
+            throw dg::Error( dg::Message(_ping_)<<"Could not rename "<<m_filename<<".tmp to "<<m_filename);
+#ifdef MPI_VERSION
+        if( m_comm != MPI_COMM_NULL)
+            MPI_Barrier( m_comm);
+#endif //MPI_VERSION
+    }
+
+    /**
+     * @brief Store a scalar
+     * @param name unique name
+     * @param value the value
+     */
+    void put( std::string name, double value)
+    {
+        NC_Error_Handle err;
+        err = nc_redef( m_ncid);
+        err = nc_put_att_double( m_ncid, NC_GLOBAL, name.data(), NC_DOUBLE, 1, &value);
+        err = nc_enddef( m_ncid);
+    }
+    /**
+     * @brief Store a vector of vectors element by element
+     * @param name unique name
+     * @param v the values
+     */
+    template<class ContainerType>
+    void put( std::string name, const std::vector<ContainerType>& v)
+    {
+        put( name+"_size", (double)v.size());
+        for( unsigned i=0; i<v.size(); i++)
+            put( name+"_"+std::to_string(i), v[i]);
+    }
+    /**
+     * @brief Store a host or device vector
+     * @param name unique name
+     * @param v the values
+     */
+    template<class ContainerType>
+    void put( std::string name, const ContainerType& v)
+    {
+        thrust::host_vector<double> buffer( v.size());
+        thrust::copy( v.begin(), v.end(), buffer.begin());
+        size_t start = 0, size = buffer.size();
+        global_range( size, start);
+        int dimID, varID;
+        NC_Error_Handle err;
+        err = nc_redef( m_ncid);
+        err = nc_def_dim( m_ncid, (name+"_dim").data(), size, &dimID);
+        err = nc_def_var( m_ncid, name.data(), NC_DOUBLE, 1, &dimID, &varID);
+        err = nc_enddef( m_ncid);
+        collective( varID);
+        size_t count = buffer.size();
+        err = nc_put_vara_double( m_ncid, varID, &start, &count, buffer.data());
+    }
+#ifdef MPI_VERSION
+    /**
+     * @brief Store the local parts of an MPI vector in one variable
+     * @param name unique name
+     * @param v the values
+     */
+    template<class ContainerType>
+    void put( std::string name, const dg::MPI_Vector<ContainerType>& v)
+    {
+        put( name, v.data());
+    }
+#endif //MPI_VERSION
+
+    /**
+     * @brief Read a scalar
+     * @param name name of the stored value
+     * @param value (write only) the value on output
+     */
+    void get( std::string name, double& value) const
+    {
+        NC_Error_Handle err;
+        err = nc_get_att_double( m_ncid, NC_GLOBAL, name.data(), &value);
+    }
+    /**
+     * @brief Read a vector of vectors
+     * @param name name of the stored value
+     * @param v (write only) the values on output, the number and the sizes of the elements must match the stored ones
+     */
+    template<class ContainerType>
+    void get( std::string name, std::vector<ContainerType>& v) const
+    {
+        double size;
+        get( name+"_size", size);
+        if( (unsigned)size != v.size())
+            throw dg::Error( dg::Message(_ping_)<<"Checkpoint "<<name<<" has "<<(unsigned)size<<" elements but "<<v.size()<<" are requested!");
+        for( unsigned i=0; i<v.size(); i++)
+            get( name+"_"+std::to_string(i), v[i]);
+    }
+    /**
+     * @brief Read a host or device vector
+     * @param name name of the stored value
+     * @param v (write only) the values on output, the size must match the stored one
+     */
+    template<class ContainerType>
+    void get( std::string name, ContainerType& v) const
+    {
+        size_t start = 0, size = v.size();
+        global_range( size, start);
+        int varID, dimID;
+        size_t stored;
+        NC_Error_Handle err;
+        err = nc_inq_varid( m_ncid, name.data(), &varID);
+        err = nc_inq_vardimid( m_ncid, varID, &dimID);
+        err = nc_inq_dimlen( m_ncid, dimID, &stored);
+        if( stored != size)
+            throw dg::Error( dg::Message(_ping_)<<"Checkpoint "<<name<<" has size "<<stored<<" but "<<size<<" is requested!");
+        collective( varID);
+        size_t count = v.size();
+        thrust::host_vector<double> buffer( count);
+        err = nc_get_vara_double( m_ncid, varID, &start, &count, buffer.data());
+        thrust::copy( buffer.begin(), buffer.end(), v.begin());
+    }
+#ifdef MPI_VERSION
+    /**
+     * @brief Read the local parts of an MPI vector
+     * @param name name of the stored value
+     * @param v (write only) the values on output, the global size must match the stored one
+     */
+    template<class ContainerType>
+    void get( std::string name, dg::MPI_Vector<ContainerType>& v) const
+    {
+        get( name, v.data());
+    }
+#endif //MPI_VERSION
+
+    private:
+    //size: local size on input, global size on output; start: offset of the local part on output
+    void global_range( size_t& size, size_t& start) const
+    {
+        start = 0;
+#ifdef MPI_VERSION
+        if( m_comm != MPI_COMM_NULL)
+        {
+            unsigned long local = size, offset = 0, global = 0;
+            int rank;
+            MPI_Comm_rank( m_comm, &rank);
+            MPI_Exscan( &local, &offset, 1, MPI_UNSIGNED_LONG, MPI_SUM, m_comm);
+            MPI_Allreduce( &local, &global, 1, MPI_UNSIGNED_LONG, MPI_SUM, m_comm);
+            start = rank == 0 ? 0 : offset, size = global;
+        }
+#endif //MPI_VERSION
+    }
+    void collective( int varID) const
+    {
+#ifdef MPI_VERSION
+        if( m_comm != MPI_COMM_NULL)
+        {
+            NC_Error_Handle err;
+            err = nc_var_par_access( m_ncid, varID, NC_COLLECTIVE);
+        }
+#endif //MPI_VERSION
+    }
+    std::string m_filename;
+    bool m_write, m_open = false;
+    int m_ncid;
+#ifdef MPI_VERSION
+    MPI_Comm m_comm = MPI_COMM_NULL;
+#endif //MPI_VERSION
+};
+
+}//namespace file
@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+#include <netcdf.h>
+#include <cmath>
+
+#include "dg/algorithm.h"
+#include "checkpoint.h"
+
+//dT/dt = nu Delta T + S
+struct Explicit
+{
+    Explicit( const dg::Grid2d& g): m_source( dg::evaluate( [](double x, double y){ return sin(x)*sin(y);}, g)){}
+    void operator()( double t, const dg::DVec& T, dg::DVec& Tp) {
+        dg::blas1::axpby( cos(t), m_source, 0., Tp);
+    }
+    private:
+    const dg::DVec m_source;
+};
+struct Implicit
+{
+    Implicit( const dg::Grid2d& g, double nu): m_nu( nu),
+        m_w2d( dg::create::weights(g)), m_v2d( dg::create::inv_weights(g)),
+        m_laplaceM( g, dg::normed) { }
+    void operator()( double t, const dg::DVec& T, dg::DVec& Tp)
+    {
+        dg::blas2::gemv( m_laplaceM, T, Tp);
+        dg::blas1::scal( Tp, -m_nu);
+    }
+    const dg::DVec& inv_weights(){return m_v2d;}
+    const dg::DVec& weights(){return m_w2d;}
+    const dg::DVec& precond(){return m_v2d;}
+  private:
+    double m_nu;
+    const dg::DVec m_w2d, m_v2d;
+    dg::Elliptic<dg::CartesianGrid2d, dg::DMatrix, dg::DVec> m_laplaceM;
+};
+
+int main()
+{
+    std::cout << "TEST BIT-FOR-BIT RESTART OF KARNIADAKIS AND EXTRAPOLATION FROM A CHECKPOINT\n";
+    const dg::Grid2d grid( 0, 2.*M_PI, 0, 2.*M_PI, 3, 20, 20, dg::PER, dg::PER);
+    Explicit exp( grid);
+    Implicit imp( grid, 0.01);
+    const dg::DVec init = dg::evaluate( [](double x, double y){ return sin(x)*sin(y);}, grid);
+    const unsigned NT = 20;
+    const double dt = 0.01;
+    //reference: one uninterrupted run
+    dg::DVec y0( init);
+    double time = 0;
+    dg::Karniadakis<dg::DVec> karniadakis( y0, y0.size(), 1e-10);
+    dg::Extrapolation<dg::DVec> extra( 3, y0);
+    karniadakis.init( exp, imp, time, y0, dt);
+    for( unsigned i=0; i<NT; i++)
+    {
+        karniadakis.step( exp, imp, time, y0);
+        extra.update( y0);
+        if( i == NT/2-1)
+        {
+            file::Checkpoint chk( "checkpoint.nc", NC_CLOBBER);
+            chk.put( "time", time);
+            chk.put( "y0", std::vector<dg::DVec>( 1, y0));
+            karniadakis.save_state( chk, "karniadakis");
+            extra.save_state( chk, "extrapolation");
+        }
+    }
+    dg::DVec reference( y0), extrapolated( y0);
+    extra.extrapolate( reference);
+    //restart from the checkpoint with fresh objects
+    std::vector<dg::DVec> y1( 1, init);
+    dg::Karniadakis<dg::DVec> restarted( y0, y0.size(), 1e-10);
+    dg::Extrapolation<dg::DVec> extra1( 2, y0);
+    {
+        file::Checkpoint chk( "checkpoint.nc", NC_NOWRITE);
+        chk.get( "time", time);
+        chk.get( "y0", y1);
+        restarted.load_state( chk, "karniadakis");
+        extra1.load_state( chk, "extrapolation");
+    }
+    for( unsigned i=NT/2; i<NT; i++)
+    {
+        restarted.step( exp, imp, time, y1[0]);
+        extra1.update( y1[0]);
+    }
+    extra1.extrapolate( extrapolated);
+    dg::blas1::axpby( 1., y0, -1., y1[0]);
+    dg::blas1::axpby( 1., reference, -1., extrapolated);
+    std::cout << "Difference after restart      "<<sqrt( dg::blas1::dot( y1[0], y1[0]))<<" (must be 0)\n";
+    std::cout << "Difference in extrapolation   "<<sqrt( dg::blas1::dot( extrapolated, extrapolated))<<" (must be 0)\n";
+    std::remove( "checkpoint.nc");
+    return 0;
+}
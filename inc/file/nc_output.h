@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <netcdf.h>
+#include "thrust/host_vector.h"
+#include "thrust/copy.h"
+
+#include "nc_utilities.h"
+
+/*!@file
+ *
+ * Contains the storage options of output variables: chunking, compression and precision
+ */
+
+namespace file
+{
+
+/**
+ * @brief Storage options of an output variable
+ *
+ * All options are applied by the netcdf-4/HDF5 library except the quantisation,
+ * which rounds the values before they are handed to netcdf (see \c file::quantize).
+ * Quantisation alone does not reduce the file size, it makes the
+ * deflate filter effective on otherwise incompressible floating point data.
+ * @code
+file::VariableOptions opt;
+opt.deflate = 1, opt.shuffle = true; //lossless
+opt.bits = 12; //lossy: keep 12 mantissa bits (relative error below 2^-13)
+opt.single_precision = true; //store as float
+opt.chunks = {1, g.Nz(), g.n()*g.Ny(), g.n()*g.Nx()}; //one time slice per chunk
+int varID;
+err = file::define_variable( ncid, "electrons", 4, dimids, &varID, opt);
+ * @endcode
+ * @note compression in a file opened with \c nc_create_par requires \c NC_COLLECTIVE access
+ * to the variable (netcdf >= 4.7.4 with HDF5 >= 1.10.3)
+ */
+struct VariableOptions
+{
+    std::vector<size_t> chunks; //!< chunk size in every dimension of the variable (empty: netcdf default)
+    int deflate = 0; //!< deflate level from 0 (no compression) to 9
+    bool shuffle = false; //!< apply the byte shuffle filter before deflating (improves the compression of floating point data)
+    unsigned bits = 0; //!< number of kept mantissa bits in \c file::quantize (0: no quantisation)
+    bool single_precision = false; //!< store the variable as \c NC_FLOAT instead of \c NC_DOUBLE
+};
+
+/**
+ * @brief Round to a given number of mantissa bits
+ *
+ * The trailing mantissa bits of every value are rounded to zero (round to nearest,
+ * ties away from zero), such that the relative error is at most \f$ 2^{-bits-1}\f$.
+ * The resulting long runs of zero bits are compressed well by the deflate filter.
+ * @param data values to quantise (read/write)
+ * @param size number of values
+ * @param bits number of kept mantissa bits (if 0 or larger than 51 nothing happens)
+ * @note \c NaN and \c Inf values are not changed
+ */
+void quantize( double* data, size_t size, unsigned bits)
+{
+    if( bits == 0 || bits > 51)
+        return;
+    const unsigned drop = 52 - bits;
+    const uint64_t half = uint64_t(1) << (drop-1);
+    const uint64_t mask = ~((uint64_t(1) << drop) - 1);
+    const uint64_t exponent = uint64_t(0x7ff) << 52;
+    for( size_t i=0; i<size; i++)
+    {
+        uint64_t u;
+        std::memcpy( &u, &data[i], sizeof(double));
+        if( (u & exponent) == exponent) //NaN or Inf
+            continue;
+        u = (u + half) & mask;
+        std::memcpy( &data[i], &u, sizeof(double));
+    }
+}
+
+/**
+ * @brief Define a variable with the given storage options
+ *
+ * @param ncid file ID (must be a netcdf-4 file in define mode)
+ * @param name Name of the variable
+ * @param ndims number of dimensions
+ * @param dimids dimension IDs (size \c ndims)
+ * @param varID (write only) variable ID
+ * @param opt storage options (\c opt.chunks must be empty or of size \c ndims)
+ *
+ * @return netcdf error code if any
+ */
+int define_variable( int ncid, const char* name, int ndims, const int* dimids, int* varID, const VariableOptions& opt = VariableOptions())
+{
+    int retval;
+    nc_type type = opt.single_precision ? NC_FLOAT : NC_DOUBLE;
+    if( (retval = nc_def_var( ncid, name, type, ndims, dimids, varID))){ return retval;}
+    if( !opt.chunks.empty() && (int)opt.chunks.size() == ndims)
+        if( (retval = nc_def_var_chunking( ncid, *varID, NC_CHUNKED, opt.chunks.data()))){ return retval;}
+    if( opt.deflate > 0 || opt.shuffle)
+        if( (retval = nc_def_var_deflate( ncid, *varID, opt.shuffle ? 1 : 0, opt.deflate > 0 ? 1 : 0, opt.deflate))){ return retval;}
+    return retval;
+}
+
+/**
+ * @brief Write a hyperslab of a host or device vector (quantised if requested)
+ *
+ * Equivalent to \c nc_put_vara_double after a transfer to the host and \c file::quantize.
+ * The conversion to \c float of a \c single_precision variable is done by netcdf.
+ * @tparam ContainerType a host or device vector of doubles
+ * @param ncid file ID
+ * @param varID variable ID
+ * @param start start index for each dimension of the variable
+ * @param count number of values in each dimension (the product must equal \c data.size())
+ * @param data the values
+ * @param bits number of kept mantissa bits (should be the same as in the definition of the variable)
+ *
+ * @return netcdf error code if any
+ */
+template<class ContainerType>
+int put_vara( int ncid, int varID, const size_t* start, const size_t* count, const ContainerType& data, unsigned bits = 0)
+{
+    thrust::host_vector<double> buffer( data.size());
+    thrust::copy( data.begin(), data.end(), buffer.begin());
+    quantize( buffer.data(), buffer.size(), bits);
+    return nc_put_vara_double( ncid, varID, start, count, buffer.data());
+}
+
+}//namespace file
@@ -0,0 +1,48 @@
+#include <iostream>
+#include <string>
+#include <netcdf.h>
+#include <cmath>
+
+#include "dg/algorithm.h"
+#include "nc_output.h"
+
+double function( double x, double y, double z){return sin(x)*sin(y)*cos(z);}
+
+int main()
+{
+    std::cout << "WRITE A COMPRESSED AND QUANTISED FIELD IN SINGLE PRECISION TO A NETCDF4 FILE\n";
+    dg::Grid3d g( 0, 2.*M_PI, 0, 2.*M_PI, 0, 2.*M_PI, 3, 10, 10, 20);
+    const dg::DVec field = dg::evaluate( function, g);
+    int ncid;
+    file::NC_Error_Handle err;
+    err = nc_create( "output.nc", NC_NETCDF4|NC_CLOBBER, &ncid);
+    int dim_ids[4], tvarID;
+    err = file::define_dimensions( ncid, dim_ids, &tvarID, g);
+    file::VariableOptions lossless, lossy;
+    lossless.deflate = 1, lossless.shuffle = true;
+    lossless.chunks = {1, g.Nz(), g.n()*g.Ny(), g.n()*g.Nx()};
+    lossy = lossless;
+    lossy.bits = 10, lossy.single_precision = true;
+    int losslessID, lossyID;
+    err = file::define_variable( ncid, "lossless", 4, dim_ids, &losslessID, lossless);
+    err = file::define_variable( ncid, "lossy", 4, dim_ids, &lossyID, lossy);
+    err = nc_enddef( ncid);
+    size_t count[4] = {1, g.Nz(), g.n()*g.Ny(), g.n()*g.Nx()};
+    size_t start[4] = {0, 0, 0, 0};
+    err = file::put_vara( ncid, losslessID, start, count, field);
+    err = file::put_vara( ncid, lossyID, start, count, field, lossy.bits);
+    err = nc_close( ncid);
+
+    err = nc_open( "output.nc", NC_NOWRITE, &ncid);
+    dg::HVec result( field.size()), reference( field);
+    err = nc_get_vara_double( ncid, losslessID, start, count, result.data());
+    dg::blas1::axpby( 1., reference, -1., result);
+    std::cout << "Lossless error is "<<sqrt( dg::blas1::dot( result, result))<<" (should be 0)\n";
+    err = nc_get_vara_double( ncid, lossyID, start, count, result.data());
+    double max_error = 0;
+    for( unsigned i=0; i<result.size(); i++)
+        max_error = std::max( max_error, fabs( result[i]-reference[i])/std::max( fabs(reference[i]), 1e-30));
+    std::cout << "Relative lossy error is "<<max_error<<" (should be below "<<pow(2.,-11)<<")\n";
+    err = nc_close( ncid);
+    return 0;
+}
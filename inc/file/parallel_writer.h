@@ -0,0 +1,395 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <mpi.h>
+#include <netcdf.h>
+#include <netcdf_par.h>
+#include "thrust/host_vector.h"
+#include "thrust/copy.h"
+
+#include "nc_output.h"
+
+/*!@file
+ *
+ * Contains the ParallelWriter class that aggregates the output of many processes on few writing processes
+ */
+
+namespace file
+{
+
+/**
+ * @brief A netcdf file written in parallel by a subset of the processes of a communicator
+ *
+ * Instead of every process writing its small hyperslab the data is aggregated in two levels:
+ *  -# all processes on a node (\c MPI_COMM_TYPE_SHARED) gather their hyperslabs on the first process of the node
+ *  -# the first processes of \c nodes_per_writer consecutive nodes gather the node data on a writing process
+ *  .
+ * Only the writing processes open the file (with \c nc_create_par) and write large
+ * hyperslabs with collective access; hyperslabs that tile a box are merged
+ * into one write. Together with the compression options in \c file::VariableOptions
+ * (which require collective access) this reduces the load on a shared file system.
+ * Process 0 of the communicator is always a writing process.
+ * @code
+file::ParallelWriter writer( "out.nc", comm, 1);
+int dimids[4], tvarID = 0;
+if( writer.is_writer())
+    err = file::define_dimensions( writer.ncid(), dimids, &tvarID, grid.global());
+file::VariableOptions opt;
+opt.deflate = 1, opt.shuffle = true, opt.single_precision = true;
+int fieldID = writer.def_var( "field", 4, dimids, opt);
+tvarID = writer.register_var( tvarID); //make the time variable known to all processes
+writer.enddef();
+for( unsigned i=0; i<maxout; i++)
+{
+    //... each process computes its local part and its start and count
+    start[0] = i;
+    writer.put_vara( fieldID, start, count, field.data());
+    writer.put_var1( tvarID, i, time);
+}
+writer.close();
+ * @endcode
+ * @note all member functions are collective calls on the communicator, but only the writing processes
+ * may call netcdf functions with \c ncid()
+ * @attention the hyperslabs of the processes must not overlap
+ */
+struct ParallelWriter
+{
+    /**
+     * @brief Create or open the file and the aggregation communicators (collective call)
+     *
+     * @param filename name of the file
+     * @param comm all processes of the communicator take part in all subsequent calls
+     * @param nodes_per_writer number of nodes that aggregate their output on one writing process
+     * @param mode \c NC_CLOBBER creates the file (overwritten if it exists),
+     * \c NC_WRITE opens an existing file in data mode (e.g. to continue a restarted simulation,
+     * the variables are then made known with \c inq_var)
+     */
+    ParallelWriter( std::string filename, MPI_Comm comm, unsigned nodes_per_writer = 1, int mode = NC_CLOBBER): m_comm( comm)
+    {
+        int rank;
+        MPI_Comm_rank( comm, &rank);
+        MPI_Comm_split_type( comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &m_node);
+        int node_rank;
+        MPI_Comm_rank( m_node, &node_rank);
+        MPI_Comm leaders;
+        MPI_Comm_split( comm, node_rank == 0 ? 0 : MPI_UNDEFINED, rank, &leaders);
+        int group_rank = 1;
+        if( leaders != MPI_COMM_NULL)
+        {
+            int leader_rank;
+            MPI_Comm_rank( leaders, &leader_rank);
+            int group = leader_rank/std::max( nodes_per_writer, 1u);
+            MPI_Comm_split( leaders, group, leader_rank, &m_group);
+            MPI_Comm_rank( m_group, &group_rank);
+            MPI_Comm_split( leaders, group_rank == 0 ? 0 : MPI_UNDEFINED, leader_rank, &m_writers);
+            MPI_Comm_free( &leaders);
+        }
+        m_writer = (group_rank == 0);
+        if( m_writer)
+        {
+            NC_Error_Handle err;
+            if( mode == NC_WRITE)
+                err = nc_open_par( filename.data(), NC_WRITE|NC_MPIIO, m_writers, MPI_INFO_NULL, &m_ncid);
+            else
+                err = nc_create_par( filename.data(), NC_NETCDF4|NC_MPIIO|NC_CLOBBER, m_writers, MPI_INFO_NULL, &m_ncid);
+        }
+        m_open = true;
+    }
+    ParallelWriter( const ParallelWriter&) = delete;
+    ParallelWriter& operator=( const ParallelWriter&) = delete;
+    /**
+     * @brief Close the file and free the communicators if \c close() was not called (errors are ignored)
+     * @attention MPI must not be finalized before, i.e. either call \c close() before \c MPI_Finalize
+     * or let the writer go out of scope before
+     */
+    ~ParallelWriter()
+    {
+        int finalized;
+        MPI_Finalized( &finalized);
+        if( finalized)
+            return;
+        try{ close();}catch( std::exception&){}
+    }
+    /**
+     * @brief Close the file and free the aggregation communicators (collective call)
+     *
+     * Afterwards no other member function may be called.
+     * @note is called by the destructor
+     */
+    void close()
+    {
+        if( !m_open)
+            return;
+        m_open = false;
+        int retval = NC_NOERR;
+        if( m_writer)
+            retval = nc_close( m_ncid); //before its communicator is freed
+        if( m_node != MPI_COMM_NULL) MPI_Comm_free( &m_node);
+        if( m_group != MPI_COMM_NULL) MPI_Comm_free( &m_group);
+        if( m_writers != MPI_COMM_NULL) MPI_Comm_free( &m_writers);
+        NC_Error_Handle err;
+        err = retval;
+    }
+    ///@brief Is this process one of the writing processes
+    bool is_writer() const { return m_writer;}
+    ///@brief The file ID (only valid on the writing processes)
+    int ncid() const { return m_ncid;}
+
+    /**
+     * @brief Define a variable with the given options (collective call)
+     *
+     * The writing processes call \c file::define_variable and set collective access.
+     * @param name Name of the variable
+     * @param ndims number of dimensions
+     * @param dimids dimension IDs (size \c ndims, only accessed on the writing processes)
+     * @param opt storage options
+     * @return variable ID on all processes
+     */
+    int def_var( const char* name, int ndims, const int* dimids, const VariableOptions& opt = VariableOptions())
+    {
+        int varID = 0;
+        if( m_writer)
+        {
+            NC_Error_Handle err;
+            err = define_variable( m_ncid, name, ndims, dimids, &varID, opt);
+            err = nc_var_par_access( m_ncid, varID, NC_COLLECTIVE);
+        }
+        MPI_Bcast( &varID, 1, MPI_INT, 0, m_comm);
+        m_vars[varID] = Variable{ ndims, opt.bits};
+        return varID;
+    }
+    /**
+     * @brief Make a variable defined by the writing processes known to all processes (collective call)
+     *
+     * e.g. the time variable of \c file::define_dimensions; sets collective access.
+     * @param varID variable ID (only accessed on process 0)
+     * @return variable ID on all processes
+     */
+    int register_var( int varID)
+    {
+        int ndims = 0;
+        if( m_writer)
+        {
+            NC_Error_Handle err;
+            err = nc_inq_varndims( m_ncid, varID, &ndims);
+            err = nc_var_par_access( m_ncid, varID, NC_COLLECTIVE);
+        }
+        int buffer[2] = {varID, ndims};
+        MPI_Bcast( buffer, 2, MPI_INT, 0, m_comm);
+        m_vars[buffer[0]] = Variable{ buffer[1], 0};
+        return buffer[0];
+    }
+    /**
+     * @brief Make a variable of an existing file known to all processes (collective call)
+     *
+     * The counterpart of \c def_var for a file opened with \c NC_WRITE; sets collective access.
+     * @param name Name of the variable
+     * @param opt only \c opt.bits is used (to quantise the values as in \c def_var)
+     * @return variable ID on all processes
+     */
+    int inq_var( const char* name, const VariableOptions& opt = VariableOptions())
+    {
+        int buffer[2] = {0, 0};
+        if( m_writer)
+        {
+            NC_Error_Handle err;
+            err = nc_inq_varid( m_ncid, name, &buffer[0]);
+            err = nc_inq_varndims( m_ncid, buffer[0], &buffer[1]);
+            err = nc_var_par_access( m_ncid, buffer[0], NC_COLLECTIVE);
+        }
+        MPI_Bcast( buffer, 2, MPI_INT, 0, m_comm);
+        m_vars[buffer[0]] = Variable{ buffer[1], opt.bits};
+        return buffer[0];
+    }
+    ///@brief Leave define mode (collective call)
+    void enddef()
+    {
+        if( m_writer)
+        {
+            NC_Error_Handle err;
+            err = nc_enddef( m_ncid);
+        }
+    }
+
+    /**
+     * @brief Write the local hyperslab of every process (collective call)
+     *
+     * The hyperslabs are gathered on the writing processes and written with as few
+     * \c nc_put_vara_double calls as possible. The values are quantised (on each process
+     * before sending) if requested in the variable definition.
+     * @tparam ContainerType a host or device vector of doubles
+     * @param varID variable ID as returned by \c def_var
+     * @param start start index for each dimension of the variable (of this process)
+     * @param count number of values in each dimension (the product must equal \c data.size())
+     * @param data the local values
+     */
+    template<class ContainerType>
+    void put_vara( int varID, const size_t* start, const size_t* count, const ContainerType& data)
+    {
+        const Variable& var = m_vars.at( varID);
+        const int nd = var.ndims;
+        m_send.resize( data.size());
+        thrust::copy( data.begin(), data.end(), m_send.begin());
+        quantize( m_send.data(), m_send.size(), var.bits);
+        //the hyperslab of this process
+        std::vector<unsigned long> slab( 2*nd);
+        for( int d=0; d<nd; d++)
+            slab[d] = start[d], slab[nd+d] = count[d];
+        //level 1: gather on the first process of the node
+        std::vector<unsigned long> node_slabs;
+        thrust::host_vector<double> node_data;
+        gather( m_node, slab, m_send, node_slabs, node_data);
+        //level 2: gather on the writing process
+        std::vector<unsigned long> slabs;
+        if( m_group != MPI_COMM_NULL)
+            gather( m_group, node_slabs, node_data, slabs, m_recv);
+        if( m_writer)
+            write( varID, nd, slabs, m_recv);
+    }
+    /**
+     * @brief Write a single value of a one-dimensional variable (collective call)
+     *
+     * @param varID variable ID as returned by \c def_var (e.g. a time series)
+     * @param index the index of the value
+     * @param value the value (only the value of process 0 is written)
+     */
+    void put_var1( int varID, size_t index, double value)
+    {
+        if( !m_writer)
+            return;
+        int rank;
+        MPI_Comm_rank( m_writers, &rank);
+        size_t count = rank == 0 ? 1 : 0;
+        NC_Error_Handle err;
+        err = nc_put_vara_double( m_ncid, varID, &index, &count, &value);
+    }
+
+    private:
+    struct Variable
+    {
+        int ndims;
+        unsigned bits;
+    };
+    //gather the hyperslabs and values of all processes in comm on process 0 of comm
+    void gather( MPI_Comm comm, const std::vector<unsigned long>& slabs, const thrust::host_vector<double>& values,
+        std::vector<unsigned long>& all_slabs, thrust::host_vector<double>& all_values) const
+    {
+        int rank, size;
+        MPI_Comm_rank( comm, &rank);
+        MPI_Comm_size( comm, &size);
+        int sizes[2] = { (int)slabs.size(), (int)values.size()};
+        std::vector<int> all_sizes( 2*size);
+        MPI_Gather( sizes, 2, MPI_INT, all_sizes.data(), 2, MPI_INT, 0, comm);
+        std::vector<int> slab_counts( size), slab_displs( size, 0), value_counts( size), value_displs( size, 0);
+        for( int i=0; i<size; i++)
+        {
+            slab_counts[i] = all_sizes[2*i], value_counts[i] = all_sizes[2*i+1];
+            if( i>0)
+            {
+                slab_displs[i] = slab_displs[i-1]+slab_counts[i-1];
+                value_displs[i] = value_displs[i-1]+value_counts[i-1];
+            }
+        }
+        if( rank == 0)
+        {
+            all_slabs.resize( slab_displs[size-1]+slab_counts[size-1]);
+            all_values.resize( value_displs[size-1]+value_counts[size-1]);
+        }
+        MPI_Gatherv( slabs.data(), sizes[0], MPI_UNSIGNED_LONG, all_slabs.data(),
+            slab_counts.data(), slab_displs.data(), MPI_UNSIGNED_LONG, 0, comm);
+        MPI_Gatherv( values.data(), sizes[1], MPI_DOUBLE, all_values.data(),
+            value_counts.data(), value_displs.data(), MPI_DOUBLE, 0, comm);
+    }
+    //write the gathered hyperslabs, merged into one if they tile their bounding box
+    void write( int varID, int nd, const std::vector<unsigned long>& slabs, const thrust::host_vector<double>& values)
+    {
+        const unsigned num = slabs.size()/(2*nd);
+        std::vector<size_t> lower( nd, (size_t)-1), upper( nd, 0);
+        size_t volume = 0;
+        for( unsigned k=0; k<num; k++)
+        {
+            const unsigned long* s = &slabs[2*nd*k];
+            size_t v = 1;
+            for( int d=0; d<nd; d++)
+            {
+                lower[d] = std::min<size_t>( lower[d], s[d]);
+                upper[d] = std::max<size_t>( upper[d], s[d]+s[nd+d]);
+                v *= s[nd+d];
+            }
+            volume += v;
+        }
+        size_t box = 1;
+        for( int d=0; d<nd; d++)
+            box *= upper[d]-lower[d];
+        std::vector<size_t> start( nd), count( nd);
+        NC_Error_Handle err;
+        unsigned calls = 0;
+        if( num > 0 && box == volume)
+        {
+            //the hyperslabs tile the box: assemble and write once
+            m_box.resize( box);
+            size_t offset = 0;
+            for( unsigned k=0; k<num; k++)
+            {
+                const unsigned long* s = &slabs[2*nd*k];
+                size_t lines = 1;
+                for( int d=0; d<nd-1; d++)
+                    lines *= s[nd+d];
+                for( size_t l=0; l<lines; l++)
+                {
+                    //position of the line in the box (row major)
+                    size_t rest = l, pos = 0, stride = 1;
+                    for( int d=nd-1; d>=0; d--)
+                    {
+                        size_t idx = s[d]-lower[d];
+                        if( d < nd-1)
+                        {
+                            idx += rest % s[nd+d];
+                            rest /= s[nd+d];
+                        }
+                        pos += idx*stride;
+                        stride *= upper[d]-lower[d];
+                    }
+                    std::copy( values.begin()+offset, values.begin()+offset+s[2*nd-1], m_box.begin()+pos);
+                    offset += s[2*nd-1];
+                }
+            }
+            for( int d=0; d<nd; d++)
+                start[d] = lower[d], count[d] = upper[d]-lower[d];
+            err = nc_put_vara_double( m_ncid, varID, start.data(), count.data(), m_box.data());
+            calls = 1;
+        }
+        else
+        {
+            size_t offset = 0;
+            for( unsigned k=0; k<num; k++)
+            {
+                const unsigned long* s = &slabs[2*nd*k];
+                size_t v = 1;
+                for( int d=0; d<nd; d++)
+                    start[d] = s[d], count[d] = s[nd+d], v *= count[d];
+                err = nc_put_vara_double( m_ncid, varID, start.data(), count.data(), values.data()+offset);
+                offset += v;
+            }
+            calls = num;
+        }
+        //collective access: all writers must make the same number of calls
+        unsigned max_calls = 0;
+        MPI_Allreduce( &calls, &max_calls, 1, MPI_UNSIGNED, MPI_MAX, m_writers);
+        std::fill( start.begin(), start.end(), 0);
+        std::fill( count.begin(), count.end(), 0);
+        double dummy = 0;
+        for( unsigned k=calls; k<max_calls; k++)
+            err = nc_put_vara_double( m_ncid, varID, start.data(), count.data(), &dummy);
+    }
+    MPI_Comm m_comm, m_node = MPI_COMM_NULL, m_group = MPI_COMM_NULL, m_writers = MPI_COMM_NULL;
+    bool m_writer = false, m_open = false;
+    int m_ncid = 0;
+    std::map<int, Variable> m_vars;
+    thrust::host_vector<double> m_send, m_recv, m_box;
+};
+
+}//namespace file
@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include <mpi.h>
+#include <netcdf_par.h>
+#include <cmath>
+
+#include "dg/algorithm.h"
+#include "parallel_writer.h"
+
+double function( double x, double y, double z){return sin(x)*sin(y)*cos(z);}
+
+int main(int argc, char* argv[])
+{
+    MPI_Init( &argc, &argv);
+    int rank, size;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank);
+    MPI_Comm_size( MPI_COMM_WORLD, &size);
+    if( size != 4){ std::cerr << "Please run with 4 processes!\n"; return -1;}
+    if(rank==0) std::cout << "WRITE A FIELD WITH AGGREGATION ON FEW WRITING PROCESSES AND READ IT BACK\n";
+    double NT = 4;
+    dg::Grid3d g( 0, 2.*M_PI, 0, 2.*M_PI, 0, 2.*M_PI, 3, 10, 10, 20);
+    thrust::host_vector<double> data = dg::evaluate( function, g);
+    //each process holds two quarters of the domain in z and half of the domain in x
+    size_t count[4] = {1, g.Nz()/2, g.Ny()*g.n(), g.Nx()*g.n()/2};
+    size_t start[4] = {0, (rank/2)*count[1], 0, (rank%2)*count[3]};
+    thrust::host_vector<double> local( count[1]*count[2]*count[3]);
+    for( unsigned k=0; k<count[1]; k++)
+    for( unsigned j=0; j<count[2]; j++)
+    for( unsigned i=0; i<count[3]; i++)
+        local[(k*count[2]+j)*count[3]+i] = data[((start[1]+k)*count[2]+j)*g.n()*g.Nx()+start[3]+i];
+    {
+        file::ParallelWriter writer( "parallel.nc", MPI_COMM_WORLD, 1);
+        int dimids[4], tvarID = 0;
+        file::NC_Error_Handle err;
+        if( writer.is_writer())
+            err = file::define_dimensions( writer.ncid(), dimids, &tvarID, g);
+        file::VariableOptions opt;
+        opt.deflate = 1, opt.shuffle = true;
+        int dataID = writer.def_var( "data", 4, dimids, opt);
+        tvarID = writer.register_var( tvarID);
+        writer.enddef();
+        for( unsigned i=0; i<NT; i++)
+        {
+            start[0] = i;
+            writer.put_vara( dataID, start, count, local);
+            writer.put_var1( tvarID, i, (double)i);
+        }
+        writer.close();
+    }
+    {
+        //reopen the file and append one more record (as a restarted simulation does)
+        file::ParallelWriter writer( "parallel.nc", MPI_COMM_WORLD, 1, NC_WRITE);
+        int dataID = writer.inq_var( "data");
+        int tvarID = writer.inq_var( "time");
+        start[0] = NT;
+        writer.put_vara( dataID, start, count, local);
+        writer.put_var1( tvarID, NT, NT);
+        writer.close();
+    }
+    if( rank == 0)
+    {
+        int ncid, dataID;
+        file::NC_Error_Handle err;
+        err = nc_open( "parallel.nc", NC_NOWRITE, &ncid);
+        err = nc_inq_varid( ncid, "data", &dataID);
+        size_t count[4] = {1, g.Nz(), g.n()*g.Ny(), g.n()*g.Nx()};
+        size_t start[4] = {(size_t)NT, 0, 0, 0};
+        thrust::host_vector<double> result( data.size());
+        err = nc_get_vara_double( ncid, dataID, start, count, result.data());
+        dg::blas1::axpby( 1., data, -1., result);
+        std::cout << "Difference to appended field is "<<sqrt( dg::blas1::dot( result, result))<<" (should be 0)\n";
+        err = nc_close( ncid);
+    }
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <netcdf.h>
+#include "thrust/host_vector.h"
+
+#include "dg/backend/exceptions.h"
+#include "nc_utilities.h"
+#include "async_writer.h"
+
+/*!@file
+ *
+ * Contains the RecordReader class that reads the records of a netcdf file ahead on a background thread
+ * and the for_each_record function that processes the records in parallel
+ */
+
+namespace file
+{
+
+/**
+ * @brief Read the records of variables of an open netcdf file ahead of time
+ *
+ * A record is the hyperslab of a variable at one index of its first (usually
+ * the unlimited time) dimension. After \c schedule() a background thread reads the
+ * scheduled records of all variables in order and keeps up to \c depth of them
+ * in memory, such that the analysis of one record overlaps with reading the next.
+ * The file is opened only once by the caller and stays open.
+ *
+ * @code
+    file::NC_Error_Handle err;
+    int ncid;
+    err = nc_open( "in.nc", NC_NOWRITE, &ncid);
+    file::RecordReader reader( ncid, {"electrons", "potential"});
+    reader.schedule( 0, reader.size());
+    for( unsigned i=0; i<reader.size(); i++)
+    {
+        std::vector<thrust::host_vector<double> > record = reader.take( i);
+        //... record[0] contains the electrons, record[1] the potential at index i
+    }
+    err = nc_close( ncid);
+ * @endcode
+ * In an MPI program each rank may process every size-th record:
+ * \c reader.schedule( rank, reader.size(), size)
+ * @attention No other netcdf function may be called on the file while records are pending.
+ * Errors of the background thread are thrown as \c NC_Error in \c take().
+ * @note the netcdf library is not thread-safe: the background threads of all
+ * \c RecordReader and \c AsyncWriter objects serialize their netcdf calls
+ */
+struct RecordReader
+{
+    /**
+     * @brief Inquire the variables and start the (idle) background thread
+     *
+     * @param ncid file ID (the file must be open and in data mode)
+     * @param names names of the variables to read (all must have the same first dimension)
+     * @param depth maximum number of records kept in memory
+     */
+    RecordReader( int ncid, const std::vector<std::string>& names, unsigned depth = 2):
+        m_ncid( ncid), m_depth( depth > 0 ? depth : 1)
+    {
+        NC_Error_Handle err;
+        m_varIDs.resize( names.size());
+        m_counts.resize( names.size());
+        m_sizes.resize( names.size());
+        std::lock_guard<std::mutex> nc_lock( detail::netcdf_mutex());
+        for( unsigned k=0; k<names.size(); k++)
+        {
+            int ndims;
+            err = nc_inq_varid( ncid, names[k].data(), &m_varIDs[k]);
+            err = nc_inq_varndims( ncid, m_varIDs[k], &ndims);
+            std::vector<int> dimIDs( ndims);
+            err = nc_inq_vardimid( ncid, m_varIDs[k], dimIDs.data());
+            m_counts[k].assign( ndims, 1);
+            m_sizes[k] = 1;
+            for( int d=1; d<ndims; d++)
+            {
+                err = nc_inq_dimlen( ncid, dimIDs[d], &m_counts[k][d]);
+                m_sizes[k] *= m_counts[k][d];
+            }
+            if( k == 0)
+                err = nc_inq_dimlen( ncid, dimIDs[0], &m_size);
+        }
+        m_thread = std::thread( &RecordReader::work, this);
+    }
+    RecordReader( const RecordReader&) = delete;
+    RecordReader& operator=( const RecordReader&) = delete;
+    ///@brief Stop the background thread (pending records are discarded)
+    ~RecordReader()
+    {
+        {
+            std::unique_lock<std::mutex> lock( m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+
+    ///@brief Number of records in the file (length of the first dimension of the first variable)
+    size_t size() const{ return m_size;}
+    /**
+     * @brief Number of values in one record of a variable
+     * @param k index of the variable in \c names
+     * @return product of all but the first dimension lengths
+     */
+    size_t record_size( unsigned k) const{ return m_sizes[k];}
+
+    /**
+     * @brief Start reading the records \c begin, \c begin+step, ... below \c end
+     *
+     * Records of a previous schedule that were not taken are discarded.
+     * @param begin first record
+     * @param end one past the last record (is clipped to \c size())
+     * @param step distance between records (must be >0)
+     */
+    void schedule( size_t begin, size_t end, size_t step = 1)
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        //wait until the record being read is done
+        m_cond.wait( lock, [this]{ return !m_busy;});
+        m_ready.clear();
+        m_taken.clear();
+        m_begin = m_next = begin, m_end = std::min( end, m_size), m_step = step;
+        lock.unlock();
+        m_cond.notify_all();
+    }
+
+    /**
+     * @brief Wait until a scheduled record is read and hand it over
+     *
+     * Each record can be taken only once. Records should be taken roughly in
+     * the scheduled order because only \c depth records are read ahead.
+     * @param i index of the record (must be scheduled)
+     * @return the record of each variable in the order of \c names
+     * @throw dg::Error if \c i is not scheduled (e.g. <tt> i >= size() </tt>) or was already taken
+     * @note thread-safe
+     */
+    std::vector<thrust::host_vector<double> > take( size_t i)
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        //otherwise we would wait forever
+        if( i < m_begin || i >= m_end || (i-m_begin)%m_step != 0)
+            throw dg::Error( dg::Message(_ping_)<<"Record "<<i<<" is not scheduled (begin "<<m_begin<<", end "<<m_end<<", step "<<m_step<<")!");
+        if( !m_taken.insert( i).second)
+            throw dg::Error( dg::Message(_ping_)<<"Record "<<i<<" was already taken!");
+        m_cond.wait( lock, [&]{ return m_ready.count( i) || m_error;});
+        if( m_error)
+            throw NC_Error( m_error);
+        std::vector<thrust::host_vector<double> > record;
+        record.swap( m_ready[i]);
+        m_ready.erase( i);
+        lock.unlock();
+        m_cond.notify_all();
+        return record;
+    }
+
+    private:
+    void work()
+    {
+        std::unique_lock<std::mutex> lock( m_mutex);
+        while( true)
+        {
+            m_cond.wait( lock, [this]{ return m_stop ||
+                ( m_next < m_end && m_ready.size() < m_depth && !m_error);});
+            if( m_stop)
+                return;
+            size_t i = m_next;
+            m_next += m_step;
+            m_busy = true;
+            lock.unlock();
+            std::vector<thrust::host_vector<double> > record( m_varIDs.size());
+            int error = 0;
+            for( unsigned k=0; k<m_varIDs.size() && !error; k++)
+            {
+                record[k].resize( m_sizes[k]);
+                std::vector<size_t> start( m_counts[k].size(), 0);
+                start[0] = i;
+                std::lock_guard<std::mutex> nc_lock( detail::netcdf_mutex());
+                error = nc_get_vara_double( m_ncid, m_varIDs[k], start.data(),
+                    m_counts[k].data(), thrust::raw_pointer_cast( record[k].data()));
+            }
+            lock.lock();
+            if( error)
+                m_error = error;
+            else
+                m_ready[i].swap( record);
+            m_busy = false;
+            m_cond.notify_all();
+        }
+    }
+    int m_ncid;
+    unsigned m_depth;
+    size_t m_size = 0;
+    std::vector<int> m_varIDs;
+    std::vector<std::vector<size_t> > m_counts;
+    std::vector<size_t> m_sizes;
+    std::map<size_t, std::vector<thrust::host_vector<double> > > m_ready;
+    std::set<size_t> m_taken;
+    size_t m_begin = 0, m_next = 0, m_end = 0, m_step = 1;
+    bool m_busy = false, m_stop = false;
+    int m_error = 0;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+};
+
+/**
+ * @brief Process the records \c begin, \c begin+step, ... below \c end in parallel
+ *
+ * The records are read ahead by \c reader and distributed among the OpenMP threads.
+ * Use this for analyses where each record is independent of the others;
+ * write the results with a \c file::AsyncWriter, which is safe to call from all threads.
+ * @code
+    file::RecordReader reader( ncid, {"electrons"}, 2*omp_get_max_threads());
+    file::for_each_record( reader, 0, reader.size(), 1,
+        [&]( size_t i, std::vector<thrust::host_vector<double> >& record){
+            writer.put_var1( massID, i, dg::blas1::dot( w2d, record[0]));
+        });
+ * @endcode
+ * @tparam Function callable as <tt> f( size_t i, std::vector<thrust::host_vector<double> >& record) </tt>
+ * @param reader the records are scheduled in \c reader (should have a \c depth of at least the number of threads)
+ * @param begin first record
+ * @param end one past the last record (is clipped to \c reader.size())
+ * @param step distance between records (must be >0)
+ * @param f called once for every record; must be thread-safe
+ * @note the first exception thrown by \c f or \c reader is rethrown after all threads finished
+ * @attention \c f runs inside an <tt> omp parallel for </tt>. It may only use serial (host) containers
+ * like \c thrust::host_vector (\c dg::HVec) or no library calls at all: \c dg::OmpTag library calls
+ * (e.g. on \c dg::DVec with the OpenMP backend) use orphaned worksharing with team barriers and deadlock inside the loop.
+ */
+template<class Function>
+void for_each_record( RecordReader& reader, size_t begin, size_t end, size_t step, Function f)
+{
+    end = std::min( end, reader.size());
+    reader.schedule( begin, end, step);
+    const int number = end > begin ? (int)(( end - begin + step - 1)/step) : 0;
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    #pragma omp parallel for schedule( dynamic, 1)
+    for( int k=0; k<number; k++)
+    {
+        size_t i = begin + k*step;
+        try{
+            std::vector<thrust::host_vector<double> > record = reader.take( i);
+            f( i, record);
+        }
+        catch( ...)
+        {
+            std::lock_guard<std::mutex> lock( error_mutex);
+            if( !error)
+                error = std::current_exception();
+        }
+    }
+    if( error)
+        std::rethrow_exception( error);
+}
+
+}//namespace file
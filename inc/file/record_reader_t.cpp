@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+#include <netcdf.h>
+#include <cmath>
+
+#include "dg/algorithm.h"
+#include "record_reader.h"
+
+double function( double x, double y){return sin(x)*sin(y);}
+
+int main()
+{
+    std::cout << "WRITE A TIMEDEPENDENT FIELD TO A NETCDF4 FILE\n";
+    unsigned NT = 10;
+    dg::Grid2d g( 0, 2.*M_PI, 0, 2.*M_PI, 3, 20, 20);
+    const dg::HVec field = dg::evaluate( function, g);
+    const dg::HVec w2d = dg::create::weights( g);
+    int ncid;
+    file::NC_Error_Handle err;
+    err = nc_create( "records.nc", NC_NETCDF4|NC_CLOBBER, &ncid);
+    int dim_ids[3], tvarID;
+    err = file::define_dimensions( ncid, dim_ids, &tvarID, g);
+    int fieldID, normID;
+    err = nc_def_var( ncid, "field", NC_DOUBLE, 3, dim_ids, &fieldID);
+    err = nc_def_var( ncid, "norm", NC_DOUBLE, 1, dim_ids, &normID);
+    err = nc_enddef( ncid);
+    size_t count[3] = {1, g.n()*g.Ny(), g.n()*g.Nx()};
+    size_t start[3] = {0, 0, 0};
+    dg::HVec data( field);
+    for(unsigned i=0; i<=NT; i++)
+    {
+        start[0] = i;
+        dg::blas1::axpby( (double)i, field, 0., data);
+        err = nc_put_vara_double( ncid, fieldID, start, count, data.data());
+        double time = i;
+        err = nc_put_vara_double( ncid, tvarID, start, count, &time);
+    }
+    std::cout << "READ AHEAD SEQUENTIALLY AND COMPARE\n";
+    double error = 0;
+    {
+        file::RecordReader reader( ncid, {"field", "time"});
+        std::cout << "Number of records "<<reader.size()<<" (must be "<<NT+1<<")\n";
+        reader.schedule( 0, reader.size());
+        for( unsigned i=0; i<reader.size(); i++)
+        {
+            std::vector<dg::HVec> record = reader.take( i);
+            dg::blas1::axpby( (double)i, field, -1., record[0]);
+            error += dg::blas1::dot( record[0], record[0]) + fabs( record[1][0] - (double)i);
+        }
+    }
+    std::cout << "Error "<<error<<" (must be 0)\n";
+    std::cout << "TAKE RECORDS THAT ARE NOT SCHEDULED\n";
+    {
+        file::RecordReader reader( ncid, {"field"});
+        reader.schedule( 0, NT+5, 2);
+        unsigned thrown = 0;
+        const size_t wrong[] = { 1, NT+2};
+        for( size_t i : wrong)
+        {
+            try{ reader.take( i);}
+            catch( dg::Error&){ thrown++;}
+        }
+        reader.take( 0);
+        try{ reader.take( 0);}
+        catch( dg::Error&){ thrown++;}
+        std::cout << "Number of errors "<<thrown<<" (must be 3)\n";
+    }
+    std::cout << "PROCESS EVERY SECOND RECORD IN PARALLEL AND WRITE ASYNCHRONOUSLY\n";
+    {
+        file::RecordReader reader( ncid, {"field"}, 4);
+        file::AsyncWriter writer( ncid);
+        file::for_each_record( reader, 0, reader.size(), 2,
+            [&]( size_t i, std::vector<dg::HVec>& record){
+                //only serial dg::HVec library calls inside the parallel loop
+                writer.put_var1( normID, i, dg::blas2::dot( record[0], w2d, record[0]));
+            });
+        writer.flush();
+    }
+    error = 0;
+    const double norm = dg::blas2::dot( field, w2d, field);
+    for( unsigned i=0; i<=NT; i+=2)
+    {
+        size_t index = i;
+        double value;
+        err = nc_get_var1_double( ncid, normID, &index, &value);
+        error += fabs( value - (double)(i*i)*norm);
+    }
+    std::cout << "Error "<<error<<" (must be 0)\n";
+    err = nc_close(ncid);
+    return 0;
+}
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
 #include <thrust/host_vector.h>
+#include <cusp/coo_matrix.h>
 #include "dg/geometry/weights.h"
 #include "magnetic_field.h"
 
@@ -87,11 +90,74 @@ struct Alpha
     TokamakMagneticField c_;
 };
 
+///@cond
+namespace detail
+{
+//the width of the delta function used in FluxSurfaceAverage
+inline double fsa_epsilon( const dg::Grid2d& g2d, const TokamakMagneticField& c)
+{
+    thrust::host_vector<double> psipRog2d  = dg::evaluate( c.psipR(), g2d);
+    thrust::host_vector<double> psipZog2d  = dg::evaluate( c.psipZ(), g2d);
+    double psipRmax = (double)thrust::reduce( psipRog2d.begin(), psipRog2d.end(), 0., thrust::maximum<double>()  );
+    double psipZmax = (double)thrust::reduce( psipZog2d.begin(), psipZog2d.end(), 0., thrust::maximum<double>()  );
+    return fabs(psipZmax/g2d.Ny()/g2d.n() +psipRmax/g2d.Nx()/g2d.n());
+}
+
+inline cusp::coo_matrix<int, double, cusp::host_memory> flux_surface_matrix( const dg::Grid2d& g2d, const TokamakMagneticField& c, const thrust::host_vector<double>& psi, double epsilon, double cutoff, bool normalize)
+{
+    if( epsilon <= 0)
+        epsilon = fsa_epsilon( g2d, c);
+    const thrust::host_vector<double> psip = dg::evaluate( c.psip(), g2d);
+    const thrust::host_vector<double> psipR = dg::evaluate( c.psipR(), g2d);
+    const thrust::host_vector<double> psipZ = dg::evaluate( c.psipZ(), g2d);
+    const thrust::host_vector<double> w2d = dg::create::weights( g2d);
+    //sort the grid points by psi such that the support of every row is a contiguous range
+    std::vector<unsigned> idx( g2d.size());
+    for( unsigned j=0; j<idx.size(); j++)
+        idx[j] = j;
+    std::sort( idx.begin(), idx.end(), [&]( unsigned a, unsigned b){ return psip[a] < psip[b];});
+    std::vector<double> sorted( idx.size());
+    for( unsigned j=0; j<idx.size(); j++)
+        sorted[j] = psip[idx[j]];
+    const double width = cutoff*sqrt(epsilon);
+    std::vector<int> rows, cols;
+    std::vector<double> values;
+    for( unsigned i=0; i<psi.size(); i++)
+    {
+        auto first = std::lower_bound( sorted.begin(), sorted.end(), psi[i]-width);
+        auto last  = std::upper_bound( sorted.begin(), sorted.end(), psi[i]+width);
+        std::vector<unsigned> band( idx.begin() + (first - sorted.begin()), idx.begin() + (last - sorted.begin()));
+        std::sort( band.begin(), band.end());
+        //same expression as in DeltaFunction
+        double sum = 0;
+        unsigned begin = values.size();
+        for( unsigned j : band)
+        {
+            double v = w2d[j]/sqrt(2.*M_PI*epsilon)*
+                exp(-( (psip[j]-psi[i])* (psip[j]-psi[i]))/2./epsilon)*sqrt(psipR[j]*psipR[j] +psipZ[j]*psipZ[j]);
+            rows.push_back( i), cols.push_back( j), values.push_back( v);
+            sum += v;
+        }
+        if( normalize && sum != 0)
+            for( unsigned k=begin; k<values.size(); k++)
+                values[k] /= sum;
+    }
+    cusp::coo_matrix<int, double, cusp::host_memory> A( psi.size(), g2d.size(), values.size());
+    A.row_indices = cusp::array1d<int, cusp::host_memory>( rows.begin(), rows.end());
+    A.column_indices = cusp::array1d<int, cusp::host_memory>( cols.begin(), cols.end());
+    A.values = cusp::array1d<double, cusp::host_memory>( values.begin(), values.end());
+    return A;
+}
+}//namespace detail
+///@endcond
+
 /**
  * @brief Flux surface average over quantity
  \f[ \langle f\rangle(\psi_0) = \frac{1}{A} \int dV \delta(\psi_p(R,Z)-\psi_0) |\nabla\psi_p|f(R,Z) \f]
 
  with \f$ A = \int dV \delta(\psi_p(R,Z)-\psi_0)|\nabla\psi_p|\f$
+ * @note Every call evaluates the delta function on the whole grid; to average fields on many \f$\psi_p\f$ values
+ * or many fields use the matrix of \c dg::geo::create::flux_surface_average
  * @copydoc hide_container
  * @ingroup misc_geo
  */
@@ -111,15 +177,8 @@ struct FluxSurfaceAverage
     w2d_ ( dg::create::weights( g2d_)),
     oneongrid_(dg::evaluate(dg::one,g2d_))
     {
-        thrust::host_vector<double> psipRog2d  = dg::evaluate( c.psipR(), g2d_);
-        thrust::host_vector<double> psipZog2d  = dg::evaluate( c.psipZ(), g2d_);
-        double psipRmax = (double)thrust::reduce( psipRog2d.begin(), psipRog2d.end(),  0.,     thrust::maximum<double>()  );
-        //double psipRmin = (double)thrust::reduce( psipRog2d.begin(), psipRog2d.end(),  psipRmax,thrust::minimum<double>()  );
-        double psipZmax = (double)thrust::reduce( psipZog2d.begin(), psipZog2d.end(), 0.,      thrust::maximum<double>()  );
-        //double psipZmin = (double)thrust::reduce( psipZog2d.begin(), psipZog2d.end(), psipZmax,thrust::minimum<double>()  );
-        double deltapsi = fabs(psipZmax/g2d_.Ny()/g2d_.n() +psipRmax/g2d_.Nx()/g2d_.n());
         //deltaf_.setepsilon(deltapsi/4.);
-        deltaf_.setepsilon(deltapsi); //macht weniger Zacken
+        deltaf_.setepsilon( detail::fsa_epsilon( g2d_, c)); //macht weniger Zacken
     }
     /**
      * @brief Calculate the Flux Surface Average
@@ -147,6 +206,8 @@ struct FluxSurfaceAverage
  * \f[ q(\psi_0) = \frac{1}{2\pi} \int dV |\nabla\psi_p| \delta(\psi_p-\psi_0) \alpha( R,Z) \f]
 
 where \f$ \alpha\f$ is the dg::geo::Alpha functor.
+ * @note Every call evaluates the delta function on the whole grid; for many \f$\psi_p\f$ values
+ * use the matrix of \c dg::geo::create::flux_surface_integral
  * @copydoc hide_container
  * @ingroup misc_geo
  *
@@ -198,6 +259,57 @@ struct SafetyFactor
     const container oneongrid_;
 };
 
+
+namespace create
+{
+/**
+ * @brief Create the sparse matrix that computes the flux surface average of a field on all points of a \f$\psi_p\f$ grid
+ *
+ * Each row contains the weights of \c dg::geo::FluxSurfaceAverage for one value \f$ \psi_i\f$
+ \f[ A_{ij} = \frac{w_j |\nabla\psi_p|_j\delta_\varepsilon(\psi_{p,j} - \psi_i)}{\sum_k w_k |\nabla\psi_p|_k\delta_\varepsilon(\psi_{p,k} - \psi_i)} \f]
+ * where the Gaussian \f$\delta_\varepsilon\f$ (cf. \c dg::geo::DeltaFunction) is cut off
+ * at \c cutoff standard deviations. The matrix is constructed once, in \f$ O(N_{2d}\log N_{2d} + N_\psi N_{band})\f$
+ * operations, after which the average of any field is a single sparse matrix-vector product
+ * instead of \f$ N_\psi\f$ evaluations of the delta function on the whole grid.
+@code
+dg::IDMatrix fsa = dg::geo::create::flux_surface_average( g2d, c, g1d);
+dg::blas2::symv( fsa, field2d, profile1d); //for every field and time step
+@endcode
+ * @param g2d the grid of the fields
+ * @param c contains psip, psipR and psipZ
+ * @param g1d the grid of \f$\psi_p\f$ values (the rows correspond to \c dg::evaluate(dg::cooX1d, g1d))
+ * @param epsilon the variance \f$\varepsilon\f$ of the Gaussian (if 0, the same value as in \c dg::geo::FluxSurfaceAverage is chosen)
+ * @param cutoff the number of standard deviations after which the Gaussian is set to zero
+ * @return a host matrix of size \c g1d.size() times \c g2d.size() (convertible to \c dg::IDMatrix)
+ * @note Rows whose \f$\psi\f$ value is not met by any grid point are zero
+ * @ingroup misc_geo
+ */
+inline cusp::coo_matrix<int, double, cusp::host_memory> flux_surface_average( const dg::Grid2d& g2d, const TokamakMagneticField& c, const dg::Grid1d& g1d, double epsilon = 0., double cutoff = 6.)
+{
+    return detail::flux_surface_matrix( g2d, c, dg::evaluate( dg::cooX1d, g1d), epsilon, cutoff, true);
+}
+
+/**
+ * @brief Create the sparse matrix that integrates a field over the flux surfaces of a \f$\psi_p\f$ grid
+ *
+ * Same as \c flux_surface_average without the normalization, i.e.
+ \f[ A_{ij} = w_j |\nabla\psi_p|_j\delta_\varepsilon(\psi_{p,j} - \psi_i) \f]
+ * e.g. the safety factor of \c dg::geo::SafetyFactor is obtained by applying
+ * the matrix to \c dg::geo::Alpha and dividing by \f$ 2\pi\f$
+ * @param g2d the grid of the fields
+ * @param c contains psip, psipR and psipZ
+ * @param g1d the grid of \f$\psi_p\f$ values
+ * @param epsilon the variance \f$\varepsilon\f$ of the Gaussian (if 0, the same value as in \c dg::geo::FluxSurfaceAverage is chosen)
+ * @param cutoff the number of standard deviations after which the Gaussian is set to zero
+ * @return a host matrix of size \c g1d.size() times \c g2d.size() (convertible to \c dg::IDMatrix)
+ * @ingroup misc_geo
+ */
+inline cusp::coo_matrix<int, double, cusp::host_memory> flux_surface_integral( const dg::Grid2d& g2d, const TokamakMagneticField& c, const dg::Grid1d& g1d, double epsilon = 0., double cutoff = 6.)
+{
+    return detail::flux_surface_matrix( g2d, c, dg::evaluate( dg::cooX1d, g1d), epsilon, cutoff, false);
+}
+}//namespace create
+
 }//namespace geo
 
 }//namespace dg
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+#include "json/json.h"
+
+#include "dg/algorithm.h"
+
+#include "solovev.h"
+#include "average.h"
+
+int main( int argc, char* argv[])
+{
+    Json::Value js;
+    if( argc==1)
+    {
+        std::ifstream is("geometry_params_Xpoint.js");
+        is >> js;
+    }
+    else
+    {
+        std::ifstream is(argv[1]);
+        is >> js;
+    }
+    dg::geo::solovev::Parameters gp(js);
+    dg::geo::TokamakMagneticField c = dg::geo::createSolovevField( gp);
+    std::cout << "Type n(3), Nx(100), Ny(100), Npsi(50)\n";
+    unsigned n, Nx, Ny, Npsi;
+    std::cin >> n>> Nx>>Ny>>Npsi;
+    const double Rmin=gp.R_0-1.2*gp.a, Rmax=gp.R_0+1.2*gp.a;
+    const double Zmin=-1.2*gp.a*gp.elongation, Zmax=1.2*gp.a*gp.elongation;
+    dg::Grid2d g2d( Rmin,Rmax, Zmin,Zmax, n, Nx, Ny);
+    const dg::HVec psipog2d = dg::evaluate( c.psip(), g2d);
+    double psipmin = *thrust::min_element( psipog2d.begin(), psipog2d.end());
+    dg::Grid1d g1d( psipmin, 0., 3, Npsi, dg::NEU);
+
+    const dg::HVec field = dg::evaluate( c.ipol(), g2d);
+    dg::Timer t;
+    t.tic();
+    dg::geo::FluxSurfaceAverage<dg::HVec> fsa( g2d, c, field);
+    const dg::HVec reference = dg::evaluate( fsa, g1d);
+    t.toc();
+    std::cout << "FluxSurfaceAverage took           "<<t.diff()<<"s\n";
+    t.tic();
+    dg::IHMatrix matrix = dg::geo::create::flux_surface_average( g2d, c, g1d);
+    t.toc();
+    std::cout << "Construction of the matrix took   "<<t.diff()<<"s ("<<matrix.num_entries<<" entries)\n";
+    dg::HVec result( reference);
+    t.tic();
+    dg::blas2::gemv( matrix, field, result);
+    t.toc();
+    std::cout << "Application of the matrix took    "<<t.diff()<<"s\n";
+    dg::blas1::axpby( 1., reference, -1., result);
+    std::cout << "Max difference to FluxSurfaceAverage "<<std::setprecision(3)
+              << fabs(*thrust::max_element( result.begin(), result.end(),
+                    []( double a, double b){ return fabs(a)<fabs(b);}))
+              << " (should be small)\n";
+    //the average of a flux function is the function itself
+    const dg::HVec psi2d = psipog2d, psi1d = dg::evaluate( dg::cooX1d, g1d);
+    dg::blas2::gemv( matrix, psi2d, result);
+    dg::blas1::axpby( 1., psi1d, -1., result);
+    std::cout << "Max error of <psi>-psi            "
+              << fabs(*thrust::max_element( result.begin()+g1d.n(), result.end()-g1d.n(),
+                    []( double a, double b){ return fabs(a)<fabs(b);}))
+              << " (should be small)\n";
+    return 0;
+}
@@ -63,6 +63,18 @@ int main(int argc, char* argv[])
     ds( function, derivative);
     norm = dg::blas2::dot(vol3d, derivative);
     if(rank==0)std::cout << "Norm Centered Derivative "<<sqrt( norm)<<" (compare with that of ds_t)\n";
+    if(rank==0)std::cout << "TEST FIELDALIGNED CACHE\n";
+    dg::geo::Fieldaligned<dg::aProductMPIGeometry3d,dg::MIDMatrix,dg::MDVec>  writeFA( bhat, g3d, dg::NEU, dg::NEU, dg::geo::NoLimiter(), 1e-8, 10, 10, true, true, true, -1, "ds_mpit.cache");
+    dg::geo::Fieldaligned<dg::aProductMPIGeometry3d,dg::MIDMatrix,dg::MDVec>  readFA( bhat, g3d, dg::NEU, dg::NEU, dg::geo::NoLimiter(), 1e-8, 10, 10, true, true, true, -1, "ds_mpit.cache");
+    dg::MDVec written( function), read( function);
+    writeFA( dg::geo::einsPlus, function, written);
+    readFA( dg::geo::einsPlus, function, read);
+    dg::blas1::axpby( 1., written, -1., read);
+    norm = dg::blas1::dot( read, read);
+    if(rank==0)std::cout << "Difference in plus interpolation "<<sqrt( norm)<<" (must be 0)\n";
+    std::stringstream cache;
+    cache << "ds_mpit.cache." << rank;
+    std::remove( cache.str().c_str());
     MPI_Finalize();
     return 0;
 }
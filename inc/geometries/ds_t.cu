@@ -72,6 +72,25 @@ int main(int argc, char * argv[])
     ds( function, derivative);
     norm = dg::blas2::dot(vol3d, derivative);
     std::cout << "Norm Centered Derivative "<<sqrt( norm)<<" (compare with that of ds_mpit)\n";
+    ///##########################################################///
+    std::cout << "TEST FIELDALIGNED CACHE\n";
+    dg::Timer t;
+    t.tic();
+    dg::geo::Fieldaligned<dg::aProductGeometry3d,dg::IDMatrix,dg::DVec>  writeFA( bhat, g3d, dg::NEU, dg::NEU, dg::geo::NoLimiter(), 1e-8, mx, my, true,true,true, -1, "ds_t.cache");
+    t.toc();
+    std::cout << "Construction and writing cache took "<<t.diff()<<"s\n";
+    t.tic();
+    dg::geo::Fieldaligned<dg::aProductGeometry3d,dg::IDMatrix,dg::DVec>  readFA( bhat, g3d, dg::NEU, dg::NEU, dg::geo::NoLimiter(), 1e-8, mx, my, true,true,true, -1, "ds_t.cache");
+    t.toc();
+    std::cout << "Construction from cache took         "<<t.diff()<<"s\n";
+    dg::DVec written( function), read( function);
+    writeFA( dg::geo::einsPlus, function, written);
+    readFA( dg::geo::einsPlus, function, read);
+    dg::blas1::axpby( 1., written, -1., read);
+    dg::blas1::axpby( 1., writeFA.hz_inv(), -1., readFA.hz_inv(), written);
+    std::cout << "Difference in plus interpolation "<<sqrt( dg::blas1::dot( read, read))<<" (must be 0)\n";
+    std::cout << "Difference in hz                 "<<sqrt( dg::blas1::dot( written, written))<<" (must be 0)\n";
+    std::remove( "ds_t.cache");
 
     return 0;
 }
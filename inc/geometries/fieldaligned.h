@@ -14,9 +14,11 @@
 #include "dg/functors.h"
 #include "dg/nullstelle.h"
 #include "dg/runge_kutta.h"
+#include "dg/adaptive.h"
 #include "magnetic_field.h"
 #include "fluxfunctions.h"
 #include "curvilinear.h"
+#include "fieldaligned_cache.h"
 
 namespace dg{
 namespace geo{
@@ -167,7 +169,7 @@ void interpolate_and_clip( const dg::IHMatrix& interpolate, const dg::aTopology2
 
 /**
  * @brief Integrate a field line to find whether the result lies inside or outside of the box
- * @tparam Field Must be usable in the integrateRK() functions
+ * @tparam Field Must be usable in the integrateERK() functions
  * @tparam Topology must provide 2d contains function
  */
 template < class Field, class Topology>
@@ -178,7 +180,7 @@ struct BoxIntegrator
      *
      * @param field field must overload operator() with dg::HVec for three entries
      * @param g The 2d or 3d grid
-     * @param eps the accuracy of the runge kutta integrator
+     * @param eps the accuracy of each step of the runge kutta integrator (local error, s. \c dg::integrateERK)
      */
     BoxIntegrator( const Field& field, const Topology& g, double eps): m_field(field), m_g(g), m_coords0(3), m_coords1(3), m_deltaPhi0(0), m_eps(eps) {}
     /**
@@ -199,7 +201,8 @@ struct BoxIntegrator
     double operator()( double deltaPhi)
     {
         double delta = deltaPhi - m_deltaPhi0;
-        dg::integrateRK<4>( m_field, 0., m_coords0, delta, m_coords1, m_eps, 2);
+        //m_eps bounds the local error of each step
+        dg::integrateERK<dg::dormand_prince>( m_field, 0., m_coords0, delta, m_coords1, m_eps);
         m_deltaPhi0 = deltaPhi;
         m_coords0 = m_coords1;
         if( !m_g.contains( m_coords1[0], m_coords1[1]) ) return -1;
@@ -216,14 +219,14 @@ struct BoxIntegrator
 /**
  * @brief Integrate one field line in a given box
  *
- * @tparam Field Must be usable in the integrateRK function
+ * @tparam Field Must be usable in the integrateERK function
  * @tparam Topology must provide 2d contains and shift_topologic function
  * @param field The field to use
  * @param grid instance of the Grid class
  * @param coords0 The initial condition
  * @param coords1 The resulting points (write only) guaranteed to lie inside the grid
  * @param phi1 The angle (read/write) contains maximum phi on input and resulting phi on output
- * @param eps error
+ * @param eps accuracy of each step of the field line integration (local error, s. \c dg::integrateERK) and of the bisection
  */
 template< class Field, class Topology>
 void boxintegrator( const Field& field, const Topology& grid,
@@ -231,7 +234,8 @@ void boxintegrator( const Field& field, const Topology& grid,
         thrust::host_vector<double>& coords1,
         double& phi1, double eps)
 {
-    dg::integrateRK<6>( field, 0., coords0, phi1, coords1, eps, 2); //integration
+    //eps bounds the local error of each step (also below)
+    dg::integrateERK<dg::dormand_prince>( field, 0., coords0, phi1, coords1, eps); //integration
     double R = coords1[0], Z=coords1[1];
     //First, catch periodic domain
     grid.shift_topologic( coords0[0], coords0[1], R, Z);
@@ -245,14 +249,14 @@ void boxintegrator( const Field& field, const Topology& grid,
             double dPhiMin = 0, dPhiMax = phi1;
             dg::bisection1d( boxy, dPhiMin, dPhiMax,eps); //suche 0 stelle
             phi1 = (dPhiMin+dPhiMax)/2.;
-            dg::integrateRK<4>( field, 0., coords0, dPhiMax, coords1, eps); //integriere bis über 0 stelle raus damit unten Wert neu gesetzt wird
+            dg::integrateERK<dg::dormand_prince>( field, 0., coords0, dPhiMax, coords1, eps); //integriere bis über 0 stelle raus damit unten Wert neu gesetzt wird
         }
         else // phi1 < 0
         {
             double dPhiMin = phi1, dPhiMax = 0;
             dg::bisection1d( boxy, dPhiMin, dPhiMax,eps);
             phi1 = (dPhiMin+dPhiMax)/2.;
-            dg::integrateRK<4>( field, 0., coords0, dPhiMin, coords1, eps);
+            dg::integrateERK<dg::dormand_prince>( field, 0., coords0, dPhiMin, coords1, eps);
         }
         detail::clip_to_boundary( coords1, grid);
         //now assume the rest is purely toroidal
@@ -264,33 +268,35 @@ void boxintegrator( const Field& field, const Topology& grid,
     }
 }
 
-//used in constructor of Fieldaligned
-void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg::aGeometry2d& grid_field, const dg::aTopology2d& grid_evaluate, std::vector<thrust::host_vector<double> >& yp_result, std::vector<thrust::host_vector<double> >& ym_result , double deltaPhi, double eps)
+//integrate the fieldlines starting at the points with indices [begin,end) of grid_evaluate
+//in both directions; the other entries of yp_result and ym_result contain the starting points
+//the points are distributed among OpenMP threads
+void integrate_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg::aGeometry2d& grid_field, const dg::aTopology2d& grid_evaluate, std::vector<thrust::host_vector<double> >& yp_result, std::vector<thrust::host_vector<double> >& ym_result , double deltaPhi, double eps, unsigned begin, unsigned end)
 {
     //grid_field contains the global geometry for the field and the boundaries
     //grid_evaluate contains the points to actually integrate
     std::vector<thrust::host_vector<double> > y( 3, dg::evaluate( dg::cooX2d, grid_evaluate)); //x
     y[1] = dg::evaluate( dg::cooY2d, grid_evaluate); //y
     y[2] = dg::evaluate( dg::zero,   grid_evaluate); //s
-    std::vector<thrust::host_vector<double> > yp( 3, y[0]), ym(yp);
+    std::vector<thrust::host_vector<double> > yp( y), ym(y);
     //construct field on high polynomial grid, then integrate it
     dg::geo::detail::DSField field( vec, grid_field);
     //field in case of cartesian grid
     dg::geo::detail::DSFieldCylindrical cyl_field(vec, (dg::Grid2d)grid_field);
-    unsigned size = grid_evaluate.size();
-    for( unsigned i=0; i<size; i++)
+    const bool cartesian = dynamic_cast<const dg::CartesianGrid2d*>( &grid_field);
+    //the integration time varies strongly among the points (bisection at the boundaries)
+    #pragma omp parallel for schedule( dynamic, 16)
+    for( int i=(int)begin; i<(int)end; i++)
     {
         thrust::host_vector<double> coords(3), coordsP(3), coordsM(3);
         coords[0] = y[0][i], coords[1] = y[1][i], coords[2] = y[2][i]; //x,y,s
         double phi1 = deltaPhi;
-        if( dynamic_cast<const dg::CartesianGrid2d*>( &grid_field))
-        {
+        if( cartesian)
             boxintegrator( cyl_field, grid_field, coords, coordsP, phi1, eps);
-        }
         else
             boxintegrator( field, grid_field, coords, coordsP, phi1, eps);
         phi1 =  - deltaPhi;
-        if( dynamic_cast<const dg::CartesianGrid2d*>( &grid_field))
+        if( cartesian)
             boxintegrator( cyl_field, grid_field, coords, coordsM, phi1, eps);
         else
             boxintegrator( field, grid_field, coords, coordsM, phi1, eps);
@@ -301,6 +307,12 @@ void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg:
     ym_result=ym;
 }
 
+//used in constructor of Fieldaligned
+void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg::aGeometry2d& grid_field, const dg::aTopology2d& grid_evaluate, std::vector<thrust::host_vector<double> >& yp_result, std::vector<thrust::host_vector<double> >& ym_result , double deltaPhi, double eps)
+{
+    integrate_fieldlines2d( vec, grid_field, grid_evaluate, yp_result, ym_result, deltaPhi, eps, 0, grid_evaluate.size());
+}
+
 }//namespace detail
 ///@endcond
 
@@ -325,6 +337,11 @@ void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg:
     * @param integrateAll indicates, that all fieldlines of the fine grid should be integrated instead of interpolating it from the coarse grid.
     *  Should be true if the streamlines of the vector field cross the domain boudary.
     * @param deltaPhi Is either <0 (then it's ignored), or may differ from \c grid.hz() if \c grid.Nz() == 1, then \c deltaPhi is taken instead of \c grid.hz()
+    * @param cache Name of a binary cache file (empty means no cache). If the file exists and was
+        generated with the same vector field, grid and numerical parameters, the interpolation matrices and
+        the distances between the planes are read from it instead of integrating all fieldlines;
+        else they are computed and written to it. The vector field is identified by its values
+        on the perpendicular grid. In MPI each process uses its own file with the process rank appended to the name.
     * @note If there is a limiter, the boundary condition on the first/last plane is set
         by the \c grid.bcz() variable and can be changed by the set_boundaries function.
         If there is no limiter, the boundary condition is periodic.
@@ -340,6 +357,8 @@ void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg:
     - \c dg::IHMatrix, or \c dg::IDMatrix, \c dg::MIHMatrix, or \c dg::MIDMatrix
 * @tparam container The container-class on which the interpolation matrix operates on
     - \c dg::HVec, or \c dg::DVec, \c dg::MHVec, or \c dg::MDVec
+* @note The fieldline integration in the constructor is distributed among OpenMP threads; in the MPI
+    version the processes that share the same perpendicular domain (i.e. differ only in the plane index) split the points among themselves
 * @sa The pdf <a href="./parallel.pdf" target="_blank">parallel derivative</a> writeup
 */
 template<class ProductGeometry, class IMatrix, class container >
@@ -360,10 +379,10 @@ struct Fieldaligned
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1)
+        double deltaPhi = -1, std::string cache = "")
     {
         dg::geo::BinaryVectorLvl0 bhat( (dg::geo::BHatR)(vec), (dg::geo::BHatZ)(vec), (dg::geo::BHatP)(vec));
-        construct( bhat, grid, bcx, bcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi);
+        construct( bhat, grid, bcx, bcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi, cache);
     }
 
     ///@brief Construct from a vector field and a grid
@@ -378,9 +397,9 @@ struct Fieldaligned
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1)
+        double deltaPhi = -1, std::string cache = "")
     {
-        construct( vec, grid, bcx, bcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi);
+        construct( vec, grid, bcx, bcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi, cache);
     }
     ///@brief Construct from a field and a grid
     ///@copydoc hide_fieldaligned_physics_parameters
@@ -394,7 +413,7 @@ struct Fieldaligned
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1);
+        double deltaPhi = -1, std::string cache = "");
 
     bool dependsOnX()const{return m_dependsOnX;}
     bool dependsOnY()const{return m_dependsOnY;}
@@ -534,7 +553,7 @@ template <class Limiter>
 void Fieldaligned<Geometry, IMatrix, container>::construct(
     const dg::geo::BinaryVectorLvl0& vec, const Geometry& grid,
     dg::bc bcx, dg::bc bcy, Limiter limit, double eps,
-    unsigned mx, unsigned my, bool bx, bool by, bool integrateAll, double deltaPhi)
+    unsigned mx, unsigned my, bool bx, bool by, bool integrateAll, double deltaPhi, std::string cache)
 {
     m_dependsOnX=bx, m_dependsOnY=by;
     m_Nz=grid.Nz(), m_bcz=grid.bcz();
@@ -551,58 +570,76 @@ void Fieldaligned<Geometry, IMatrix, container>::construct(
     dg::blas1::transfer( dg::pullback(limit, grid_coarse.get()), m_limiter);
     dg::blas1::transfer( dg::evaluate(zero, grid_coarse.get()), m_left);
     m_ghostM = m_ghostP = m_right = m_left;
-    //%%%%%%%%%%%%%%%%%%%%%%%%%%Set starting points and integrate field lines%%%%%%%%%%%%%%
-    std::vector<thrust::host_vector<double> > yp_coarse( 3), ym_coarse(yp_coarse), yp, ym;
+    //%%%%%%%%%%%%%%%%%%%%%%%%%%Read matrices from cache if possible%%%%%%%%%%%%%%%%%%%%%%%
+    std::vector<dg::IHMatrix> matrices(4);
+    std::vector<thrust::host_vector<double> > h(2);
+    uint64_t key = 0;
+    if( !cache.empty())
+    {
+        detail::CacheKey hash;
+        detail::add_fieldaligned_parameters( hash, grid_coarse.get(), bcx, bcy, eps, mx, my, integrateAll, deltaPhi);
+        detail::add_fieldaligned_field( hash, vec, grid_coarse.get());
+        key = hash.value();
+    }
+    if( cache.empty() || !detail::read_fieldaligned_cache( cache, key, matrices, h))
+    {
+        //%%%%%%%%%%%%%%%%%%%%%%%%%%Set starting points and integrate field lines%%%%%%%%%%%%%%
+        std::vector<thrust::host_vector<double> > yp_coarse( 3), ym_coarse(yp_coarse), yp, ym;
 
 #ifdef DG_BENCHMARK
-    dg::Timer t;
-    t.tic();
-    std::cout << "Generate high order grid...\n";
+        dg::Timer t;
+        t.tic();
+        std::cout << "Generate high order grid...\n";
 #endif
-    dg::ClonePtr<dg::aGeometry2d> grid_magnetic = grid_coarse;//INTEGRATE HIGH ORDER GRID
-    grid_magnetic.get().set( 7, grid_magnetic.get().Nx(), grid_magnetic.get().Ny());
-    dg::Grid2d grid_fine( grid_coarse.get() );//FINE GRID
-    grid_fine.multiplyCellNumbers((double)mx, (double)my);
+        dg::ClonePtr<dg::aGeometry2d> grid_magnetic = grid_coarse;//INTEGRATE HIGH ORDER GRID
+        grid_magnetic.get().set( 7, grid_magnetic.get().Nx(), grid_magnetic.get().Ny());
+        dg::Grid2d grid_fine( grid_coarse.get() );//FINE GRID
+        grid_fine.multiplyCellNumbers((double)mx, (double)my);
 #ifdef DG_BENCHMARK
-    t.toc();
-     std::cout << "High order grid gen   took: "<<t.diff()<<"\n";
-    t.tic();
+        t.toc();
+         std::cout << "High order grid gen   took: "<<t.diff()<<"\n";
+        t.tic();
 #endif
-    if(integrateAll)
-        detail::integrate_all_fieldlines2d( vec, grid_magnetic.get(), grid_fine, yp, ym, deltaPhi, eps);
-    else
-    {
-        detail::integrate_all_fieldlines2d( vec, grid_magnetic.get(), grid_coarse.get(), yp_coarse, ym_coarse, deltaPhi, eps);
-        dg::IHMatrix interpolate = dg::create::interpolation( grid_fine, grid_coarse.get());  //INTERPOLATE TO FINE GRID
-        dg::geo::detail::interpolate_and_clip( interpolate, grid_fine, grid_fine, yp_coarse, ym_coarse, yp, ym);
-    }
+        if(integrateAll)
+            detail::integrate_all_fieldlines2d( vec, grid_magnetic.get(), grid_fine, yp, ym, deltaPhi, eps);
+        else
+        {
+            detail::integrate_all_fieldlines2d( vec, grid_magnetic.get(), grid_coarse.get(), yp_coarse, ym_coarse, deltaPhi, eps);
+            dg::IHMatrix interpolate = dg::create::interpolation( grid_fine, grid_coarse.get());  //INTERPOLATE TO FINE GRID
+            dg::geo::detail::interpolate_and_clip( interpolate, grid_fine, grid_fine, yp_coarse, ym_coarse, yp, ym);
+        }
 #ifdef DG_BENCHMARK
-    t.toc();
-    std::cout << "Fieldline integration took: "<<t.diff()<<"\n";
+        t.toc();
+        std::cout << "Fieldline integration took: "<<t.diff()<<"\n";
 
-    //%%%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-    t.tic();
+        //%%%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+        t.tic();
 #endif
-    dg::IHMatrix plusFine  = dg::create::interpolation( yp[0], yp[1], grid_coarse.get(), bcx, bcy), plus, plusT;
-    dg::IHMatrix minusFine = dg::create::interpolation( ym[0], ym[1], grid_coarse.get(), bcx, bcy), minus, minusT;
-    dg::IHMatrix projection = dg::create::projection( grid_coarse.get(), grid_fine);
-    cusp::multiply( projection, plusFine, plus);
-    cusp::multiply( projection, minusFine, minus);
+        dg::IHMatrix plusFine  = dg::create::interpolation( yp[0], yp[1], grid_coarse.get(), bcx, bcy);
+        dg::IHMatrix minusFine = dg::create::interpolation( ym[0], ym[1], grid_coarse.get(), bcx, bcy);
+        dg::IHMatrix projection = dg::create::projection( grid_coarse.get(), grid_fine);
+        cusp::multiply( projection, plusFine, matrices[0]);
+        cusp::multiply( projection, minusFine, matrices[2]);
 #ifdef DG_BENCHMARK
-    t.toc();
-    std::cout << "Multiplication        took: "<<t.diff()<<"\n";
+        t.toc();
+        std::cout << "Multiplication        took: "<<t.diff()<<"\n";
 #endif
-    plusT = dg::transpose( plus);
-    minusT = dg::transpose( minus);
-    dg::blas2::transfer( plus, m_plus);
-    dg::blas2::transfer( plusT, m_plusT);
-    dg::blas2::transfer( minus, m_minus);
-    dg::blas2::transfer( minusT, m_minusT);
-    //%%%%%%%%%%%%%%%%%%%%%%%project h and copy into h vectors%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-    thrust::host_vector<double> hp( m_perp_size), hm(hp), hz(hp);
-    dg::blas2::symv( projection, yp[2], hp);
-    dg::blas2::symv( projection, ym[2], hm);
-    dg::blas1::scal( hm, -1.);
+        matrices[1] = dg::transpose( matrices[0]);
+        matrices[3] = dg::transpose( matrices[2]);
+        //%%%%%%%%%%%%%%%%%%%%%%%project h%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+        h[0].resize( m_perp_size), h[1].resize( m_perp_size);
+        dg::blas2::symv( projection, yp[2], h[0]);
+        dg::blas2::symv( projection, ym[2], h[1]);
+        dg::blas1::scal( h[1], -1.);
+        if( !cache.empty())
+            detail::write_fieldaligned_cache( cache, key, matrices, h);
+    }
+    dg::blas2::transfer( matrices[0], m_plus);
+    dg::blas2::transfer( matrices[1], m_plusT);
+    dg::blas2::transfer( matrices[2], m_minus);
+    dg::blas2::transfer( matrices[3], m_minusT);
+    //%%%%%%%%%%%%%%%%%%%%%%%copy into h vectors%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+    thrust::host_vector<double> hp( h[0]), hm(h[1]), hz(hp);
     dg::blas1::axpby(  1., hp, +1., hm, hz);
     dg::blas1::transfer( hp, m_hp);
     dg::blas1::transfer( hm, m_hm);
@@ -693,12 +730,16 @@ void Fieldaligned<G, I, container>::ePlus( enum whichMatrix which, const contain
 {
     dg::split( f, m_f, m_g.get());
     //1. compute 2d interpolation in every plane and store in m_temp
+    //   (all planes in one batch such that the matrix is read only once)
+    std::vector<const container*> in( m_Nz);
+    std::vector<container*> out( m_Nz);
     for( unsigned i0=0; i0<m_Nz; i0++)
     {
         unsigned ip = (i0==m_Nz-1) ? 0:i0+1;
-        if(which == einsPlus)           dg::blas2::symv( m_plus,   m_f[ip], m_temp[i0]);
-        else if(which == einsMinusT)    dg::blas2::symv( m_minusT, m_f[ip], m_temp[i0]);
+        in[i0] = &m_f[ip], out[i0] = &m_temp[i0];
     }
+    if(which == einsPlus)           dg::blas2::symv( m_plus,   in, out);
+    else if(which == einsMinusT)    dg::blas2::symv( m_minusT, in, out);
     //2. apply right boundary conditions in last plane
     unsigned i0=m_Nz-1;
     if( m_bcz != dg::PER)
@@ -722,12 +763,16 @@ void Fieldaligned<G, I, container>::eMinus( enum whichMatrix which, const contai
 {
     dg::split( f, m_f, m_g.get());
     //1. compute 2d interpolation in every plane and store in m_temp
+    //   (all planes in one batch such that the matrix is read only once)
+    std::vector<const container*> in( m_Nz);
+    std::vector<container*> out( m_Nz);
     for( unsigned i0=0; i0<m_Nz; i0++)
     {
         unsigned im = (i0==0) ? m_Nz-1:i0-1;
-        if(which == einsPlusT)          dg::blas2::symv( m_plusT, m_f[im], m_temp[i0]);
-        else if (which == einsMinus)    dg::blas2::symv( m_minus, m_f[im], m_temp[i0]);
+        in[i0] = &m_f[im], out[i0] = &m_temp[i0];
     }
+    if(which == einsPlusT)          dg::blas2::symv( m_plusT, in, out);
+    else if(which == einsMinus)     dg::blas2::symv( m_minus, in, out);
     //2. apply left boundary conditions in first plane
     unsigned i0=0;
     if( m_bcz != dg::PER)
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <process.h>
+#else
+#include <unistd.h>
+#endif //_MSC_VER
+#include <thrust/host_vector.h>
+#include <cusp/csr_matrix.h>
+
+#include "dg/backend/exceptions.h"
+#include "dg/geometry/transform.h"
+#include "dg/geometry/functions.h"
+#include "magnetic_field.h"
+
+/*!@file
+ *
+ * Disk cache for the interpolation matrices of the Fieldaligned class
+ */
+namespace dg{
+namespace geo{
+///@cond
+namespace detail{
+
+//increase whenever the fieldline integration or the file layout changes
+const uint32_t fieldaligned_cache_version = 1;
+
+///64 bit FNV-1a hash
+struct CacheKey
+{
+    CacheKey(): m_hash( 14695981039346656037ULL){}
+    void add( const void* data, size_t bytes)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for( size_t i=0; i<bytes; i++)
+        {
+            m_hash ^= p[i];
+            m_hash *= 1099511628211ULL;
+        }
+    }
+    void add( double value){ add( &value, sizeof(double));}
+    void add( unsigned value){ uint64_t v = value; add( &v, sizeof(uint64_t));}
+    void add( int value){ int64_t v = value; add( &v, sizeof(int64_t));}
+    void add( bool value){ add( value ? 1u : 0u);}
+    void add( dg::bc value){ add( (int)value);}
+    void add( const thrust::host_vector<double>& v)
+    {
+        add( (unsigned)v.size());
+        add( thrust::raw_pointer_cast( v.data()), v.size()*sizeof(double));
+    }
+    uint64_t value() const{ return m_hash;}
+    private:
+    uint64_t m_hash;
+};
+
+//topology and numerical parameters that enter the fieldline integration
+inline void add_fieldaligned_parameters( CacheKey& key, const dg::aTopology2d& g,
+    dg::bc bcx, dg::bc bcy, double eps, unsigned mx, unsigned my, bool integrateAll, double deltaPhi)
+{
+    key.add( fieldaligned_cache_version);
+    key.add( g.x0()), key.add( g.x1()), key.add( g.y0()), key.add( g.y1());
+    key.add( g.n()), key.add( g.Nx()), key.add( g.Ny());
+    key.add( g.bcx()), key.add( g.bcy());
+    key.add( bcx), key.add( bcy);
+    key.add( eps), key.add( mx), key.add( my), key.add( integrateAll), key.add( deltaPhi);
+}
+
+//the vector field is identified by its values (and the grid by its coordinates)
+//on the given grid since the functors do not expose their parameters
+inline void add_fieldaligned_field( CacheKey& key, const dg::geo::BinaryVectorLvl0& vec, const dg::aGeometry2d& g)
+{
+    key.add( dg::pullback( dg::cooX2d, g));
+    key.add( dg::pullback( dg::cooY2d, g));
+    key.add( dg::pullback( vec.x(), g));
+    key.add( dg::pullback( vec.y(), g));
+    key.add( dg::pullback( vec.z(), g));
+}
+
+const char fieldaligned_cache_magic[8] = {'F','E','L','T','O','R','F','A'};
+
+template<class T>
+void write_cache_array( std::ofstream& os, const T* data, uint64_t size)
+{
+    os.write( reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+    os.write( reinterpret_cast<const char*>(data), size*sizeof(T));
+}
+template<class Array>
+bool read_cache_array( std::ifstream& is, Array& data)
+{
+    uint64_t size;
+    if( !is.read( reinterpret_cast<char*>(&size), sizeof(uint64_t)))
+        return false;
+    data.resize( size);
+    return (bool)is.read( reinterpret_cast<char*>( thrust::raw_pointer_cast( data.data())), size*sizeof(typename Array::value_type));
+}
+
+/**
+ * @brief Read matrices and vectors from a cache file
+ *
+ * @param filename the cache file
+ * @param key the expected key
+ * @param matrices contains the matrices on output (size determines how many are read)
+ * @param vectors contains the vectors on output (size determines how many are read)
+ * @return false if the file does not exist, is incomplete or has a different key
+ */
+inline bool read_fieldaligned_cache( const std::string& filename, uint64_t key,
+    std::vector<cusp::csr_matrix<int, double, cusp::host_memory> >& matrices,
+    std::vector<thrust::host_vector<double> >& vectors)
+{
+    std::ifstream is( filename.c_str(), std::ios::binary);
+    if( !is.good())
+        return false;
+    char magic[8];
+    uint64_t file_key, num_matrices, num_vectors;
+    if( !is.read( magic, 8) || std::memcmp( magic, fieldaligned_cache_magic, 8) != 0)
+        return false;
+    if( !is.read( reinterpret_cast<char*>(&file_key), sizeof(uint64_t)) || file_key != key)
+        return false;
+    if( !is.read( reinterpret_cast<char*>(&num_matrices), sizeof(uint64_t)) || num_matrices != matrices.size())
+        return false;
+    if( !is.read( reinterpret_cast<char*>(&num_vectors), sizeof(uint64_t)) || num_vectors != vectors.size())
+        return false;
+    for( unsigned i=0; i<matrices.size(); i++)
+    {
+        uint64_t shape[2];
+        if( !is.read( reinterpret_cast<char*>(shape), 2*sizeof(uint64_t)))
+            return false;
+        cusp::csr_matrix<int, double, cusp::host_memory>& m = matrices[i];
+        if( !read_cache_array( is, m.row_offsets) || !read_cache_array( is, m.column_indices) || !read_cache_array( is, m.values))
+            return false;
+        if( m.row_offsets.size() != shape[0]+1 || m.column_indices.size() != m.values.size())
+            return false;
+        m.num_rows = shape[0], m.num_cols = shape[1], m.num_entries = m.values.size();
+    }
+    for( unsigned i=0; i<vectors.size(); i++)
+        if( !read_cache_array( is, vectors[i]))
+            return false;
+    return true;
+}
+
+//a temporary file name next to filename that no other process (or thread) uses
+inline std::string fieldaligned_cache_temp( const std::string& filename)
+{
+#ifdef _MSC_VER
+    const int pid = _getpid();
+#else
+    const int pid = getpid();
+#endif //_MSC_VER
+    std::random_device rd;
+    std::stringstream ss;
+    ss << filename << ".tmp." << pid << "." << std::hex << rd() << rd();
+    return ss.str();
+}
+
+/**
+ * @brief Write matrices and vectors to a cache file
+ *
+ * The data is first written to a temporary file with a unique name (process id and
+ * a random suffix) which is then renamed, such that
+ * concurrent runs never read an incomplete cache nor write into the same temporary file.
+ * @param filename the cache file
+ * @param key identifies the parameters that generated the data
+ * @param matrices the matrices to write
+ * @param vectors the vectors to write
+ * @throw dg::Error if the file cannot be written
+ */
+inline void write_fieldaligned_cache( const std::string& filename, uint64_t key,
+    const std::vector<cusp::csr_matrix<int, double, cusp::host_memory> >& matrices,
+    const std::vector<thrust::host_vector<double> >& vectors)
+{
+    const std::string temp = fieldaligned_cache_temp( filename);
+    {
+        std::ofstream os( temp.c_str(), std::ios::binary | std::ios::trunc);
+        uint64_t num_matrices = matrices.size(), num_vectors = vectors.size();
+        os.write( fieldaligned_cache_magic, 8);
+        os.write( reinterpret_cast<const char*>(&key), sizeof(uint64_t));
+        os.write( reinterpret_cast<const char*>(&num_matrices), sizeof(uint64_t));
+        os.write( reinterpret_cast<const char*>(&num_vectors), sizeof(uint64_t));
+        for( unsigned i=0; i<matrices.size(); i++)
+        {
+            const cusp::csr_matrix<int, double, cusp::host_memory>& m = matrices[i];
+            uint64_t shape[2] = { (uint64_t)m.num_rows, (uint64_t)m.num_cols};
+            os.write( reinterpret_cast<const char*>(shape), 2*sizeof(uint64_t));
+            write_cache_array( os, thrust::raw_pointer_cast( m.row_offsets.data()), m.row_offsets.size());
+            write_cache_array( os, thrust::raw_pointer_cast( m.column_indices.data()), m.column_indices.size());
+            write_cache_array( os, thrust::raw_pointer_cast( m.values.data()), m.values.size());
+        }
+        for( unsigned i=0; i<vectors.size(); i++)
+            write_cache_array( os, thrust::raw_pointer_cast( vectors[i].data()), vectors[i].size());
+        if( !os.good())
+        {
+            os.close();
+            std::remove( temp.c_str());
+            throw dg::Error( dg::Message(_ping_)<<"Could not write fieldaligned cache file "<<temp);
+        }
+    }
+    if( std::rename( temp.c_str(), filename.c_str()) != 0)
+    {
+        std::remove( temp.c_str());
+        throw dg::Error( dg::Message(_ping_)<<"Could not rename "<<temp<<" to "<<filename);
+    }
+}
+
+}//namespace detail
+///@endcond
+}//namespace geo
+}//namespace dg
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include "dg/backend/memory.h"
 
 namespace dg
@@ -43,6 +44,22 @@ struct aBinaryFunctor
         return operator()(R,Z);
     }
     /**
+    * @brief The function values on many points
+    *
+    * Replaces \c n virtual calls to the scalar \c operator() by one and is used by
+    * \c dg::evaluate and \c dg::pullback. Functors derived from
+    * \c aCloneableBatchBinaryFunctor evaluate their formula in a loop without virtual calls
+    * that the compiler can vectorize.
+    * @param R radii (cylindrical coordinate) of size \c n
+    * @param Z heights (cylindrical coordinate) of size \c n
+    * @param out (write only) f(R[i],Z[i]) (may not alias \c R or \c Z)
+    * @param n number of points
+    */
+    void compute( const double* R, const double* Z, double* out, size_t n) const
+    {
+        do_compute_batch( R, Z, out, n);
+    }
+    /**
     * @brief abstract copy of a binary functor
     *
     * @return a functor on the heap
@@ -61,6 +78,11 @@ struct aBinaryFunctor
     aBinaryFunctor& operator=(const aBinaryFunctor&){return *this;}
     private:
     virtual double do_compute(double R, double Z) const=0;
+    virtual void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        for( size_t i=0; i<n; i++)
+            out[i] = do_compute( R[i], Z[i]);
+    }
 };
 
 /**
@@ -81,6 +103,33 @@ struct aCloneableBinaryFunctor : public aBinaryFunctor
         return new Derived(static_cast<Derived const &>(*this));
     }
 };
+/**
+ * @brief Intermediate implementation helper class that adds a devirtualized batch evaluation to the clone pattern
+ *
+ * The batch evaluation \c compute calls the \c do_compute function of \c Derived directly in a loop,
+ * such that it can be inlined and vectorized. \c Derived must be a friend of this class:
+@code
+struct Psip: public aCloneableBatchBinaryFunctor<Psip>
+{
+    Psip( Parameters gp): R_0_(gp.R_0), A_(gp.A), c_(gp.c) {}
+  private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
+    double do_compute(double R, double Z) const { ... }
+    ...
+};
+@endcode
+*/
+template<class Derived>
+struct aCloneableBatchBinaryFunctor : public aCloneableBinaryFunctor<Derived>
+{
+    private:
+    virtual void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        const Derived& f = static_cast<const Derived&>(*this);
+        for( size_t i=0; i<n; i++)
+            out[i] = f.Derived::do_compute( R[i], Z[i]); //qualified call is not virtual
+    }
+};
 /**
  * @brief With this adapater class you can make any Functor cloneable
  *
@@ -93,6 +142,11 @@ struct BinaryFunctorAdapter : public aCloneableBinaryFunctor<BinaryFunctorAdapte
     BinaryFunctorAdapter( const BinaryFunctor& f):f_(f){}
     private:
     double do_compute(double x, double y)const{return f_(x,y);}
+    void do_compute_batch( const double* x, const double* y, double* out, size_t n) const
+    {
+        for( size_t i=0; i<n; i++)
+            out[i] = f_( x[i], y[i]);
+    }
     BinaryFunctor f_;
 };
 /**
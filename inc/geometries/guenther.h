@@ -31,10 +31,11 @@ namespace guenther
 /**
  * @brief \f[\cos(\pi(R-R_0)/2)\cos(\pi Z/2)\f]
  */
-struct Psip : public aCloneableBinaryFunctor<Psip>
+struct Psip : public aCloneableBatchBinaryFunctor<Psip>
 {
     Psip(double R_0 ):   R_0(R_0) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
     double do_compute(double R, double Z) const
     {
         return cos(M_PI*0.5*(R-R_0))*cos(M_PI*Z*0.5);
@@ -44,10 +45,11 @@ struct Psip : public aCloneableBinaryFunctor<Psip>
 /**
  * @brief \f[-\pi\sin(\pi(R-R_0)/2)\cos(\pi Z/2)/2\f]
  */
-struct PsipR : public aCloneableBinaryFunctor<PsipR>
+struct PsipR : public aCloneableBatchBinaryFunctor<PsipR>
 {
     PsipR(double R_0 ):   R_0(R_0) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipR>;
     double do_compute(double R, double Z) const
     {
         return -M_PI*0.5*sin(M_PI*0.5*(R-R_0))*cos(M_PI*Z*0.5);
@@ -57,10 +59,11 @@ struct PsipR : public aCloneableBinaryFunctor<PsipR>
 /**
  * @brief \f[-\pi^2\cos(\pi(R-R_0)/2)\cos(\pi Z/2)/4\f]
  */
-struct PsipRR : public aCloneableBinaryFunctor<PsipRR>
+struct PsipRR : public aCloneableBatchBinaryFunctor<PsipRR>
 {
     PsipRR(double R_0 ):   R_0(R_0) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRR>;
     double do_compute(double R, double Z) const
     {
         return -M_PI*M_PI*0.25*cos(M_PI*0.5*(R-R_0))*cos(M_PI*Z*0.5);
@@ -70,11 +73,12 @@ struct PsipRR : public aCloneableBinaryFunctor<PsipRR>
 /**
  * @brief \f[-\pi\cos(\pi(R-R_0)/2)\sin(\pi Z/2)/2\f]
  */
-struct PsipZ : public aCloneableBinaryFunctor<PsipZ>
+struct PsipZ : public aCloneableBatchBinaryFunctor<PsipZ>
 
 {
     PsipZ(double R_0 ):   R_0(R_0) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZ>;
     double do_compute(double R, double Z) const
     {
         return -M_PI*0.5*cos(M_PI*0.5*(R-R_0))*sin(M_PI*Z*0.5);
@@ -84,10 +88,11 @@ struct PsipZ : public aCloneableBinaryFunctor<PsipZ>
 /**
  * @brief \f[-\pi^2\cos(\pi(R-R_0)/2)\cos(\pi Z/2)/4\f]
  */
-struct PsipZZ : public aCloneableBinaryFunctor<PsipZZ>
+struct PsipZZ : public aCloneableBatchBinaryFunctor<PsipZZ>
 {
     PsipZZ(double R_0 ):   R_0(R_0){}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZZ>;
     double do_compute(double R, double Z) const
     {
         return -M_PI*M_PI*0.25*cos(M_PI*0.5*(R-R_0))*cos(M_PI*Z*0.5);
@@ -97,10 +102,11 @@ struct PsipZZ : public aCloneableBinaryFunctor<PsipZZ>
 /**
  * @brief \f[ \pi^2\sin(\pi(R-R_0)/2)\sin(\pi Z/2)/4\f]
  */
-struct PsipRZ : public aCloneableBinaryFunctor<PsipRZ>
+struct PsipRZ : public aCloneableBatchBinaryFunctor<PsipRZ>
 {
     PsipRZ(double R_0 ):   R_0(R_0) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRZ>;
     double do_compute(double R, double Z) const
     {
         return M_PI*M_PI*0.25*sin(M_PI*0.5*(R-R_0))*sin(M_PI*Z*0.5);
@@ -111,29 +117,32 @@ struct PsipRZ : public aCloneableBinaryFunctor<PsipRZ>
 /**
  * @brief \f[ I_0\f]
  */
-struct Ipol : public aCloneableBinaryFunctor<Ipol>
+struct Ipol : public aCloneableBatchBinaryFunctor<Ipol>
 {
     Ipol( double I_0):   I_0(I_0) {}
     private:
+    friend struct aCloneableBatchBinaryFunctor<Ipol>;
     double do_compute(double R, double Z) const { return I_0; }
     double I_0;
 };
 /**
  * @brief \f[0\f]
  */
-struct IpolR : public aCloneableBinaryFunctor<IpolR>
+struct IpolR : public aCloneableBatchBinaryFunctor<IpolR>
 {
     IpolR(  ) {}
     private:
+    friend struct aCloneableBatchBinaryFunctor<IpolR>;
     double do_compute(double R, double Z) const { return 0; }
 };
 /**
  * @brief \f[0\f]
  */
-struct IpolZ : public aCloneableBinaryFunctor<IpolZ>
+struct IpolZ : public aCloneableBatchBinaryFunctor<IpolZ>
 {
     IpolZ(  ) {}
     private:
+    friend struct aCloneableBatchBinaryFunctor<IpolZ>;
     double do_compute(double R, double Z) const { return 0; }
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "fluxfunctions.h"
 
 /*!@file
@@ -12,6 +13,19 @@ namespace geo
 {
 
 
+///@cond
+namespace detail
+{
+//the values of f on all points
+inline std::vector<double> compute( const aBinaryFunctor& f, const double* R, const double* Z, size_t n)
+{
+    std::vector<double> out( n);
+    f.compute( R, Z, out.data(), n);
+    return out;
+}
+}//namespace detail
+///@endcond
+
 ///@addtogroup magnetic
 ///@{
 /**
@@ -78,6 +92,12 @@ struct Bmodule : public aCloneableBinaryFunctor<Bmodule>
 {
     Bmodule( const TokamakMagneticField& mag): mag_(mag)  { }
   private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipZ = detail::compute( mag_.psipZ(), R, Z, n), ipol = detail::compute( mag_.ipol(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = mag_.R0()/R[i]*sqrt(ipol[i]*ipol[i]+psipR[i]*psipR[i] +psipZ[i]*psipZ[i]);
+    }
     double do_compute(double R, double Z) const
     {
         double psipR = mag_.psipR()(R,Z), psipZ = mag_.psipZ()(R,Z), ipol = mag_.ipol()(R,Z);
@@ -97,6 +117,12 @@ struct InvB : public aCloneableBinaryFunctor<InvB>
 {
     InvB(  const TokamakMagneticField& mag): mag_(mag){ }
   private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipZ = detail::compute( mag_.psipZ(), R, Z, n), ipol = detail::compute( mag_.ipol(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = R[i]/(mag_.R0()*sqrt(ipol[i]*ipol[i] + psipR[i]*psipR[i] +psipZ[i]*psipZ[i]));
+    }
     double do_compute(double R, double Z) const
     {
         double psipR = mag_.psipR()(R,Z), psipZ = mag_.psipZ()(R,Z), ipol = mag_.ipol()(R,Z);
@@ -116,6 +142,12 @@ struct LnB : public aCloneableBinaryFunctor<LnB>
 {
     LnB(const TokamakMagneticField& mag): mag_(mag) { }
   private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipZ = detail::compute( mag_.psipZ(), R, Z, n), ipol = detail::compute( mag_.ipol(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = log(mag_.R0()/R[i]*sqrt(ipol[i]*ipol[i] + psipR[i]*psipR[i] +psipZ[i]*psipZ[i]));
+    }
     double do_compute(double R, double Z) const
     {
         double psipR = mag_.psipR()(R,Z), psipZ = mag_.psipZ()(R,Z), ipol = mag_.ipol()(R,Z);
@@ -138,6 +170,18 @@ struct BR: public aCloneableBinaryFunctor<BR>
 {
     BR(const TokamakMagneticField& mag): invB_(mag), mag_(mag) { }
   private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n);
+        std::vector<double> ipol = detail::compute( mag_.ipol(), R, Z, n), ipolR = detail::compute( mag_.ipolR(), R, Z, n);
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipRR = detail::compute( mag_.psipRR(), R, Z, n);
+        std::vector<double> psipZ = detail::compute( mag_.psipZ(), R, Z, n), psipRZ = detail::compute( mag_.psipRZ(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+        {
+            double Rn = R[i]/mag_.R0();
+            out[i] = -1./R[i]/invB[i] + invB[i]/Rn/Rn*(ipol[i]*ipolR[i] + psipR[i]*psipRR[i] + psipZ[i]*psipRZ[i]);
+        }
+    }
     double do_compute(double R, double Z) const
     {
         double Rn;
@@ -162,6 +206,18 @@ struct BZ: public aCloneableBinaryFunctor<BZ>
 {
     BZ(const TokamakMagneticField& mag ): mag_(mag), invB_(mag) { }
   private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n);
+        std::vector<double> ipol = detail::compute( mag_.ipol(), R, Z, n), ipolZ = detail::compute( mag_.ipolZ(), R, Z, n);
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipRZ = detail::compute( mag_.psipRZ(), R, Z, n);
+        std::vector<double> psipZ = detail::compute( mag_.psipZ(), R, Z, n), psipZZ = detail::compute( mag_.psipZZ(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+        {
+            double Rn = R[i]/mag_.R0();
+            out[i] = (invB[i]/Rn/Rn)*(ipol[i]*ipolZ[i] + psipR[i]*psipRZ[i] + psipZ[i]*psipZZ[i]);
+        }
+    }
     double do_compute(double R, double Z) const
     {
         double Rn;
@@ -183,6 +239,12 @@ struct CurvatureNablaBR: public aCloneableBinaryFunctor<CurvatureNablaBR>
 {
     CurvatureNablaBR(const TokamakMagneticField& mag): invB_(mag), bZ_(mag) { }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n), bZ = detail::compute( bZ_, R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = -invB[i]*invB[i]*bZ[i];
+    }
     double do_compute( double R, double Z) const
     {
         return -invB_(R,Z)*invB_(R,Z)*bZ_(R,Z);
@@ -200,6 +262,12 @@ struct CurvatureNablaBZ: public aCloneableBinaryFunctor<CurvatureNablaBZ>
 {
     CurvatureNablaBZ( const TokamakMagneticField& mag): invB_(mag), bR_(mag) { }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n), bR = detail::compute( bR_, R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = invB[i]*invB[i]*bR[i];
+    }
     double do_compute( double R, double Z) const
     {
         return invB_(R,Z)*invB_(R,Z)*bR_(R,Z);
@@ -233,6 +301,12 @@ struct CurvatureKappaZ: public aCloneableBinaryFunctor<CurvatureKappaZ>
 {
     CurvatureKappaZ( const TokamakMagneticField& mag): invB_(mag) { }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        invB_.compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = -out[i]/R[i];
+    }
     double do_compute( double R, double Z) const
     {
         return -invB_(R,Z)/R;
@@ -249,6 +323,12 @@ struct DivCurvatureKappa: public aCloneableBinaryFunctor<DivCurvatureKappa>
 {
     DivCurvatureKappa( const TokamakMagneticField& mag): invB_(mag), bZ_(mag){ }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n), bZ = detail::compute( bZ_, R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = bZ[i]*invB[i]*invB[i]/R[i];
+    }
     double do_compute( double R, double Z) const
     {
         return bZ_(R,Z)*invB_(R,Z)*invB_(R,Z)/R;
@@ -266,6 +346,13 @@ struct GradLnB: public aCloneableBinaryFunctor<GradLnB>
 {
     GradLnB( const TokamakMagneticField& mag): mag_(mag), invB_(mag), bR_(mag), bZ_(mag) { }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n), bR = detail::compute( bR_, R, Z, n), bZ = detail::compute( bZ_, R, Z, n);
+        std::vector<double> psipR = detail::compute( mag_.psipR(), R, Z, n), psipZ = detail::compute( mag_.psipZ(), R, Z, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = mag_.R0()*invB[i]*invB[i]*(bR[i]*psipZ[i]-bZ[i]*psipR[i])/R[i];
+    }
     double do_compute( double R, double Z) const
     {
         double invB = invB_(R,Z);
@@ -282,10 +369,16 @@ struct GradLnB: public aCloneableBinaryFunctor<GradLnB>
  *\f[  \nabla\cdot \vec b = -\nabla_\parallel \ln B \f]
  *@sa \c GradLnB
  */
-struct Divb: public aCloneableBinaryFunctor<GradLnB>
+struct Divb: public aCloneableBinaryFunctor<Divb>
 {
     Divb( const TokamakMagneticField& mag): m_gradLnB(mag) { }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        m_gradLnB.compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = -out[i];
+    }
     double do_compute( double R, double Z) const
     {
         return -m_gradLnB(R,Z);
@@ -300,6 +393,12 @@ struct FieldP: public aCloneableBinaryFunctor<FieldP>
 {
     FieldP( const TokamakMagneticField& mag): mag_(mag){}
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        mag_.ipol().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = mag_.R0()*out[i]/R[i]/R[i];
+    }
     double do_compute( double R, double Z) const
     {
         return mag_.R0()*mag_.ipol()(R,Z)/R/R;
@@ -315,6 +414,12 @@ struct FieldR: public aCloneableBinaryFunctor<FieldR>
 {
     FieldR( const TokamakMagneticField& mag): mag_(mag){}
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        mag_.psipZ().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = mag_.R0()/R[i]*out[i];
+    }
     double do_compute( double R, double Z) const
     {
         return  mag_.R0()/R*mag_.psipZ()(R,Z);
@@ -330,6 +435,12 @@ struct FieldZ: public aCloneableBinaryFunctor<FieldZ>
 {
     FieldZ( const TokamakMagneticField& mag): mag_(mag){}
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        mag_.psipR().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = -mag_.R0()/R[i]*out[i];
+    }
     double do_compute( double R, double Z) const
     {
         return -mag_.R0()/R*mag_.psipR()(R,Z);
@@ -367,6 +478,13 @@ struct BHatR: public aCloneableBinaryFunctor<BHatR>
 {
     BHatR( const TokamakMagneticField& mag): mag_(mag), invB_(mag){ }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n);
+        mag_.psipZ().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = invB[i]*mag_.R0()/R[i]*out[i];
+    }
     double do_compute( double R, double Z) const
     {
         return  invB_(R,Z)*mag_.R0()/R*mag_.psipZ()(R,Z);
@@ -383,6 +501,13 @@ struct BHatZ: public aCloneableBinaryFunctor<BHatZ>
 {
     BHatZ( const TokamakMagneticField& mag): mag_(mag), invB_(mag){ }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n);
+        mag_.psipR().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = -invB[i]*mag_.R0()/R[i]*out[i];
+    }
     double do_compute( double R, double Z) const
     {
         return  -invB_(R,Z)*mag_.R0()/R*mag_.psipR()(R,Z);
@@ -398,6 +523,13 @@ struct BHatP: public aCloneableBinaryFunctor<BHatP>
 {
     BHatP( const TokamakMagneticField& mag): mag_(mag), invB_(mag){ }
     private:
+    void do_compute_batch( const double* R, const double* Z, double* out, size_t n) const
+    {
+        std::vector<double> invB = detail::compute( invB_, R, Z, n);
+        mag_.ipol().compute( R, Z, out, n);
+        for( size_t i=0; i<n; i++)
+            out[i] = invB[i]*mag_.R0()*out[i]/R[i]/R[i];
+    }
     double do_compute( double R, double Z) const
     {
         return invB_(R,Z)*mag_.R0()*mag_.ipol()(R,Z)/R/R;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <sstream>
+
 #include "dg/backend/mpi_matrix.h"
 #include "dg/backend/blas2_dispatch_mpi.h"
 #include "dg/backend/mpi_collective.h"
@@ -21,39 +23,90 @@ namespace geo{
 ///@cond
 namespace detail{
 
-///basically a copy across processes
+/**
+ * @brief Initiate sending a plane to the next process in z (basically a copy across processes)
+ *
+ * @param in the plane to send (must not be changed until sendForward_wait returns)
+ * @param out (write only) receives the plane of the previous process (must not be used until sendForward_wait returns)
+ * @param comm 3d Cartesian communicator
+ * @param rqst two request variables to be passed to sendForward_wait
+ */
 template<class thrust_vector>
-void sendForward( const thrust_vector& in, thrust_vector& out, MPI_Comm comm) //send to next plane
+void sendForward_init( const thrust_vector& in, thrust_vector& out, MPI_Comm comm, MPI_Request rqst[2])
 {
     int source, dest;
-    MPI_Status status;
     MPI_Cart_shift( comm, 2, +1, &source, &dest);
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
     cudaDeviceSynchronize();//wait until device functions are finished before sending data
 #endif //THRUST_DEVICE_SYSTEM
     unsigned size = in.size();
-    MPI_Sendrecv(   thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
-                    dest, 9,  //destination
-                    thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
-                    source, 9, //source
-                    comm, &status);
+    MPI_Isend( thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
+               dest, 9, comm, &rqst[0]);  //destination
+    MPI_Irecv( thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
+               source, 9, comm, &rqst[1]); //source
+}
+///@brief Wait until the communication initiated by sendForward_init is finished
+inline void sendForward_wait( MPI_Request rqst[2])
+{
+    MPI_Waitall( 2, rqst, MPI_STATUSES_IGNORE);
 }
-///basically a copy across processes
+/**
+ * @brief Initiate sending a plane to the previous process in z (basically a copy across processes)
+ *
+ * @param in the plane to send (must not be changed until sendBackward_wait returns)
+ * @param out (write only) receives the plane of the next process (must not be used until sendBackward_wait returns)
+ * @param comm 3d Cartesian communicator
+ * @param rqst two request variables to be passed to sendBackward_wait
+ */
 template<class thrust_vector>
-void sendBackward( const thrust_vector& in, thrust_vector& out, MPI_Comm comm) //send to next plane
+void sendBackward_init( const thrust_vector& in, thrust_vector& out, MPI_Comm comm, MPI_Request rqst[2])
 {
     int source, dest;
-    MPI_Status status;
     MPI_Cart_shift( comm, 2, -1, &source, &dest);
 #if THRUST_DEVICE_SYSTEM==THRUST_DEVICE_SYSTEM_CUDA
     cudaDeviceSynchronize();//wait until device functions are finished before sending data
 #endif //THRUST_DEVICE_SYSTEM
     unsigned size = in.size();
-    MPI_Sendrecv(   thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
-                    dest, 3,  //destination
-                    thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
-                    source, 3, //source
-                    comm, &status);
+    MPI_Isend( thrust::raw_pointer_cast(in.data()), size, MPI_DOUBLE,  //sender
+               dest, 3, comm, &rqst[0]);  //destination
+    MPI_Irecv( thrust::raw_pointer_cast(out.data()), size, MPI_DOUBLE, //receiver
+               source, 3, comm, &rqst[1]); //source
+}
+///@brief Wait until the communication initiated by sendBackward_init is finished
+inline void sendBackward_wait( MPI_Request rqst[2])
+{
+    MPI_Waitall( 2, rqst, MPI_STATUSES_IGNORE);
+}
+
+//the processes in comm (all containing the same perpendicular points grid_evaluate)
+//share the integration and exchange the results
+void integrate_all_fieldlines2d( const dg::geo::BinaryVectorLvl0& vec, const dg::aGeometry2d& grid_field, const dg::aTopology2d& grid_evaluate, std::vector<thrust::host_vector<double> >& yp_result, std::vector<thrust::host_vector<double> >& ym_result , double deltaPhi, double eps, MPI_Comm comm)
+{
+    int rank, size;
+    MPI_Comm_rank( comm, &rank);
+    MPI_Comm_size( comm, &size);
+    const unsigned num_points = grid_evaluate.size();
+    std::vector<int> counts( size), displs( size);
+    for( int r=0; r<size; r++)
+    {
+        displs[r] = (unsigned)((uint64_t)num_points*r/size);
+        counts[r] = (unsigned)((uint64_t)num_points*(r+1)/size) - displs[r];
+    }
+    integrate_fieldlines2d( vec, grid_field, grid_evaluate, yp_result, ym_result, deltaPhi, eps, displs[rank], displs[rank]+counts[rank]);
+    for( unsigned i=0; i<3; i++)
+    {
+        MPI_Allgatherv( MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, thrust::raw_pointer_cast( yp_result[i].data()), &counts[0], &displs[0], MPI_DOUBLE, comm);
+        MPI_Allgatherv( MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, thrust::raw_pointer_cast( ym_result[i].data()), &counts[0], &displs[0], MPI_DOUBLE, comm);
+    }
+}
+
+inline void add_fieldaligned_field( CacheKey& key, const dg::geo::BinaryVectorLvl0& vec, const dg::aMPIGeometry2d& g)
+{
+    key.add( dg::pullback( dg::cooX2d, g).data());
+    key.add( dg::pullback( dg::cooY2d, g).data());
+    key.add( dg::pullback( vec.x(), g).data());
+    key.add( dg::pullback( vec.y(), g).data());
+    key.add( dg::pullback( vec.z(), g).data());
 }
 }//namespace detail
 
@@ -70,10 +123,10 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1)
+        double deltaPhi = -1, std::string cache = "")
     {
         dg::geo::BinaryVectorLvl0 bhat( (dg::geo::BHatR)(vec), (dg::geo::BHatZ)(vec), (dg::geo::BHatP)(vec));
-        construct( bhat, grid, globalbcx, globalbcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi);
+        construct( bhat, grid, globalbcx, globalbcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi, cache);
     }
     template <class Limiter>
     Fieldaligned(const dg::geo::BinaryVectorLvl0& vec,
@@ -84,9 +137,9 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1)
+        double deltaPhi = -1, std::string cache = "")
     {
-        construct( vec, grid, globalbcx, globalbcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi);
+        construct( vec, grid, globalbcx, globalbcy, limit, eps, multiplyX, multiplyY, dependsOnX, dependsOnY, integrateAll, deltaPhi, cache);
     }
     template <class Limiter>
     void construct(const dg::geo::BinaryVectorLvl0& vec,
@@ -97,7 +150,7 @@ struct Fieldaligned< ProductMPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY
         double eps = 1e-5,
         unsigned multiplyX=10, unsigned multiplyY=10,
         bool dependsOnX=true, bool dependsOnY=true, bool integrateAll = true,
-        double deltaPhi = -1);
+        double deltaPhi = -1, std::string cache = "");
 
     bool dependsOnX()const{return m_dependsOnX;}
     bool dependsOnY()const{return m_dependsOnY;}
@@ -162,7 +215,7 @@ template <class Limiter>
 void Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vector<LocalContainer> >::construct(
     const dg::geo::BinaryVectorLvl0& vec, const MPIGeometry& grid,
     dg::bc globalbcx, dg::bc globalbcy, Limiter limit, double eps,
-    unsigned mx, unsigned my, bool bx, bool by, bool integrateAll, double deltaPhi)
+    unsigned mx, unsigned my, bool bx, bool by, bool integrateAll, double deltaPhi, std::string cache)
 {
     m_dependsOnX=bx, m_dependsOnY=by;
     m_Nz=grid.local().Nz(), m_bcz=grid.bcz();
@@ -182,56 +235,96 @@ void Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vec
     dg::blas1::transfer( dg::pullback(limit, grid_coarse.get()), m_limiter);
     dg::blas1::transfer( dg::evaluate(zero, grid_coarse.get()), m_left);
     m_ghostM = m_ghostP = m_right = m_left;
-    //%%%%%%%%%%%%%%%%%%%%%%%%%%Set starting points and integrate field lines%%%%%%%%%%%%%%
-    std::vector<thrust::host_vector<double> > yp_coarse( 3), ym_coarse(yp_coarse), yp, ym;
-
 #ifdef DG_BENCHMARK
     dg::Timer t;
     int rank;
     MPI_Comm_rank( grid.communicator(), &rank);
-    t.tic();
-    if(rank==0)std::cout << "Generate high order grid...\n";
 #endif
-    dg::ClonePtr<dg::aMPIGeometry2d> grid_magnetic = grid_coarse;//INTEGRATE HIGH ORDER GRID
-    grid_magnetic.get().set( 7, grid_magnetic.get().Nx(), grid_magnetic.get().Ny());
-    dg::ClonePtr<dg::aGeometry2d> global_grid_magnetic = grid_magnetic.get().global_geometry();
-    dg::MPIGrid2d grid_fine( grid_coarse.get() );//FINE GRID
-    grid_fine.multiplyCellNumbers((double)mx, (double)my);
-#ifdef DG_BENCHMARK
-    t.toc();
-    if(rank==0) std::cout << "High order grid gen   took: "<<t.diff()<<"\n";
-    t.tic();
-#endif
-    if(integrateAll)
-        detail::integrate_all_fieldlines2d( vec, global_grid_magnetic.get(), grid_fine.local(), yp, ym, deltaPhi, eps);
-    else
+    //%%%%%%%%%%%%%%%%%%%%%%%%%%Read matrices from cache if possible%%%%%%%%%%%%%%%%%%%%%%%
+    std::vector<dg::IHMatrix> matrices(2);
+    std::vector<thrust::host_vector<double> > h(2);
+    uint64_t key = 0;
+    if( !cache.empty())
     {
-        detail::integrate_all_fieldlines2d( vec, global_grid_magnetic.get(), grid_coarse.get().local(), yp_coarse, ym_coarse, deltaPhi, eps);
-        dg::IHMatrix interpolate = dg::create::interpolation( grid_fine.local(), grid_coarse.get().local());  //INTERPOLATE TO FINE GRID
-        dg::geo::detail::interpolate_and_clip( interpolate, grid_fine.local(), grid_fine.global(), yp_coarse, ym_coarse, yp, ym);
+        int process;
+        MPI_Comm_rank( grid.communicator(), &process);
+        std::stringstream ss;
+        ss << cache << "." << process;
+        cache = ss.str();
+        detail::CacheKey hash;
+        detail::add_fieldaligned_parameters( hash, grid_coarse.get().global(), globalbcx, globalbcy, eps, mx, my, integrateAll, deltaPhi);
+        for( unsigned u=0; u<3; u++)
+            hash.add( dims[u]), hash.add( coords[u]);
+        detail::add_fieldaligned_field( hash, vec, grid_coarse.get());
+        key = hash.value();
     }
+    int cached = !cache.empty() && detail::read_fieldaligned_cache( cache, key, matrices, h);
+    //the integration is shared among processes so either all or none use the cache
+    MPI_Allreduce( MPI_IN_PLACE, &cached, 1, MPI_INT, MPI_MIN, grid.communicator());
+    if( !cached)
+    {
+        //%%%%%%%%%%%%%%%%%%%%%%%%%%Set starting points and integrate field lines%%%%%%%%%%%%%%
+        std::vector<thrust::host_vector<double> > yp_coarse( 3), ym_coarse(yp_coarse), yp, ym;
+
 #ifdef DG_BENCHMARK
-    t.toc();
-    if(rank==0) std::cout << "Fieldline integration took: "<<t.diff()<<"\n";
+        t.tic();
+        if(rank==0)std::cout << "Generate high order grid...\n";
+#endif
+        dg::ClonePtr<dg::aMPIGeometry2d> grid_magnetic = grid_coarse;//INTEGRATE HIGH ORDER GRID
+        grid_magnetic.get().set( 7, grid_magnetic.get().Nx(), grid_magnetic.get().Ny());
+        dg::ClonePtr<dg::aGeometry2d> global_grid_magnetic = grid_magnetic.get().global_geometry();
+        dg::MPIGrid2d grid_fine( grid_coarse.get() );//FINE GRID
+        grid_fine.multiplyCellNumbers((double)mx, (double)my);
+#ifdef DG_BENCHMARK
+        t.toc();
+        if(rank==0) std::cout << "High order grid gen   took: "<<t.diff()<<"\n";
+        t.tic();
+#endif
+        //processes that differ only in the plane index have the same perpendicular points
+        MPI_Comm planes;
+        int remain_dims[] = {false,false,true};
+        MPI_Cart_sub( m_g.get().communicator(), remain_dims, &planes);
+        if(integrateAll)
+            detail::integrate_all_fieldlines2d( vec, global_grid_magnetic.get(), grid_fine.local(), yp, ym, deltaPhi, eps, planes);
+        else
+        {
+            detail::integrate_all_fieldlines2d( vec, global_grid_magnetic.get(), grid_coarse.get().local(), yp_coarse, ym_coarse, deltaPhi, eps, planes);
+            dg::IHMatrix interpolate = dg::create::interpolation( grid_fine.local(), grid_coarse.get().local());  //INTERPOLATE TO FINE GRID
+            dg::geo::detail::interpolate_and_clip( interpolate, grid_fine.local(), grid_fine.global(), yp_coarse, ym_coarse, yp, ym);
+        }
+        MPI_Comm_free( &planes);
+#ifdef DG_BENCHMARK
+        t.toc();
+        if(rank==0) std::cout << "Fieldline integration took: "<<t.diff()<<"\n";
 
-    //%%%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
-    t.tic();
+        //%%%%%%%%%%%%%%%%%%Create interpolation and projection%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+        t.tic();
 #endif
-    dg::IHMatrix plusFine  = dg::create::interpolation( yp[0], yp[1], grid_coarse.get().global(), globalbcx, globalbcy), plus;
-    dg::IHMatrix minusFine = dg::create::interpolation( ym[0], ym[1], grid_coarse.get().global(), globalbcx, globalbcy), minus;
-    dg::IHMatrix projection = dg::create::projection( grid_coarse.get().local(), grid_fine.local());
-    cusp::multiply( projection, plusFine, plus);
-    cusp::multiply( projection, minusFine, minus);
+        dg::IHMatrix plusFine  = dg::create::interpolation( yp[0], yp[1], grid_coarse.get().global(), globalbcx, globalbcy);
+        dg::IHMatrix minusFine = dg::create::interpolation( ym[0], ym[1], grid_coarse.get().global(), globalbcx, globalbcy);
+        dg::IHMatrix projection = dg::create::projection( grid_coarse.get().local(), grid_fine.local());
+        cusp::multiply( projection, plusFine, matrices[0]);
+        cusp::multiply( projection, minusFine, matrices[1]);
+#ifdef DG_BENCHMARK
+        t.toc();
+        if(rank==0) std::cout << "Multiplication        took: "<<t.diff()<<"\n";
+#endif
+        //%%%%%%%%%%%%%%%%%%%%%%%project h%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+        h[0].resize( m_perp_size), h[1].resize( m_perp_size);
+        dg::blas2::symv( projection, yp[2], h[0]);
+        dg::blas2::symv( projection, ym[2], h[1]);
+        dg::blas1::scal( h[1], -1.);
+        if( !cache.empty())
+            detail::write_fieldaligned_cache( cache, key, matrices, h);
+    }
 #ifdef DG_BENCHMARK
-    t.toc();
-    if(rank==0) std::cout << "Multiplication        took: "<<t.diff()<<"\n";
     t.tic();
 #endif
-    dg::MIHMatrix temp = dg::convert( plus, grid_coarse.get()), tempT;
+    dg::MIHMatrix temp = dg::convert( matrices[0], grid_coarse.get()), tempT;
     tempT  = dg::transpose( temp);
     dg::blas2::transfer( temp, m_plus);
     dg::blas2::transfer( tempT, m_plusT);
-    temp = dg::convert( minus, grid_coarse.get());
+    temp = dg::convert( matrices[1], grid_coarse.get());
     tempT  = dg::transpose( temp);
     dg::blas2::transfer( temp, m_minus);
     dg::blas2::transfer( tempT, m_minusT);
@@ -239,11 +332,9 @@ void Fieldaligned<MPIGeometry, MPIDistMat<LocalIMatrix, CommunicatorXY>, MPI_Vec
     t.toc();
     if(rank==0) std::cout << "Conversion            took: "<<t.diff()<<"\n";
 #endif
-    //%%%%%%%%%%%%%%%%%%%%%%%project h and copy into h vectors%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+    //%%%%%%%%%%%%%%%%%%%%%%%copy into h vectors%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
     dg::MHVec hp( dg::evaluate( dg::zero, grid_coarse.get())), hm(hp), hz(hp);
-    dg::blas2::symv( projection, yp[2], hp.data());
-    dg::blas2::symv( projection, ym[2], hm.data());
-    dg::blas1::scal( hm, -1.);
+    hp.data() = h[0], hm.data() = h[1];
     dg::blas1::axpby(  1., hp, +1., hm, hz);
     dg::blas1::transfer( hp, m_hp);
     dg::blas1::transfer( hm, m_hm);
@@ -333,19 +424,34 @@ template<class G, class M, class C, class container>
 void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::ePlus( enum whichMatrix which, const MPI_Vector<container>& f, MPI_Vector<container>& fpe )
 {
     dg::split( f, m_f, m_g.get());
+    const MPIDistMat<M,C>& m = which == einsPlus ? m_plus : m_minusT;
     //1. compute 2d interpolation in every plane and store in m_temp
+    //   (all planes in one batch such that the matrix is read only once)
+    //   If the last plane is sent to the previous process it is computed first
+    //   and the remaining planes are interpolated while the message is in flight
+    std::vector<const MPI_Vector<container>*> in;
+    std::vector<MPI_Vector<container>*> out;
+    MPI_Request rqst[2];
+    if( m_sizeZ != 1)
+    {
+        unsigned i0 = m_Nz-1;
+        dg::blas2::symv( m, m_f[0], m_temp[i0]);
+        detail::sendBackward_init( m_temp[i0].data(), m_ghostM.data(), m_g.get().communicator(), rqst);
+    }
     for( unsigned i0=0; i0<m_Nz; i0++)
     {
+        if( i0==m_Nz-1 && m_sizeZ != 1) continue;
         unsigned ip = (i0==m_Nz-1) ? 0:i0+1;
-        if(which == einsPlus)           dg::blas2::symv( m_plus,   m_f[ip], m_temp[i0]);
-        else if(which == einsMinusT)    dg::blas2::symv( m_minusT, m_f[ip], m_temp[i0]);
+        in.push_back( &m_f[ip]), out.push_back( &m_temp[i0]);
     }
+    if( !in.empty())
+        dg::blas2::symv( m, in, out);
 
-    //2. communicate halo in z
+    //2. finish communication of halo in z
     if( m_sizeZ != 1)
     {
         unsigned i0 = m_Nz-1;
-        detail::sendBackward( m_temp[i0].data(), m_ghostM.data(), m_g.get().communicator());
+        detail::sendBackward_wait( rqst);
         m_temp[i0].swap( m_ghostM);
     }
 
@@ -373,19 +479,34 @@ void Fieldaligned<G,MPIDistMat<M,C>, MPI_Vector<container> >::eMinus( enum which
     int rank;
     MPI_Comm_rank(m_g.get().communicator(), &rank);
     dg::split( f, m_f, m_g.get());
+    const MPIDistMat<M,C>& m = which == einsPlusT ? m_plusT : m_minus;
     //1. compute 2d interpolation in every plane and store in m_temp
+    //   (all planes in one batch such that the matrix is read only once)
+    //   If the first plane is sent to the next process it is computed first
+    //   and the remaining planes are interpolated while the message is in flight
+    std::vector<const MPI_Vector<container>*> in;
+    std::vector<MPI_Vector<container>*> out;
+    MPI_Request rqst[2];
+    if( m_sizeZ != 1)
+    {
+        unsigned i0 = 0;
+        dg::blas2::symv( m, m_f[m_Nz-1], m_temp[i0]);
+        detail::sendForward_init( m_temp[i0].data(), m_ghostP.data(), m_g.get().communicator(), rqst);
+    }
     for( unsigned i0=0; i0<m_Nz; i0++)
     {
+        if( i0==0 && m_sizeZ != 1) continue;
         unsigned im = (i0==0) ? m_Nz-1:i0-1;
-        if(which == einsPlusT)         dg::blas2::symv( m_plusT, m_f[im], m_temp[i0]);
-        else if(which == einsMinus)    dg::blas2::symv( m_minus, m_f[im], m_temp[i0]);
+        in.push_back( &m_f[im]), out.push_back( &m_temp[i0]);
     }
+    if( !in.empty())
+        dg::blas2::symv( m, in, out);
 
-    //2. communicate halo in z
+    //2. finish communication of halo in z
     if( m_sizeZ != 1)
     {
         unsigned i0 = 0;
-        detail::sendForward( m_temp[i0].data(), m_ghostP.data(), m_g.get().communicator());
+        detail::sendForward_wait( rqst);
         m_temp[i0].swap( m_ghostP);
     }
 
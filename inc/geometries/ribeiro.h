@@ -7,6 +7,7 @@
 #include "dg/geometry/geometry.h"
 #include "dg/functors.h"
 #include "dg/runge_kutta.h"
+#include "dg/adaptive.h"
 #include "dg/nullstelle.h"
 #include "generator.h"
 #include "utilities.h"
@@ -37,19 +38,11 @@ struct Fpsi
     //finds the starting points for the integration in y direction
     void find_initial( double psi, double& R_0, double& Z_0)
     {
-        unsigned N = 50;
-		std::array<double, 2> begin2d{ {0,0} }, end2d(begin2d), end2d_old(begin2d);
-        begin2d[0] = end2d[0] = end2d_old[0] = R_init;
-        begin2d[1] = end2d[1] = end2d_old[1] = Z_init;
         if(m_verbose)std::cout << "In init function\n";
-        double eps = 1e10, eps_old = 2e10;
-        while( (eps < eps_old || eps > 1e-7) && eps > 1e-14)
-        {
-            eps_old = eps; end2d_old = end2d;
-            N*=2; dg::stepperRK<17>( fieldRZtau_, psip_.f()(R_init, Z_init), begin2d, psi, end2d, N);
-            eps = sqrt( (end2d[0]-end2d_old[0])*(end2d[0]-end2d_old[0]) + (end2d[1]-end2d_old[1])*(end2d[1]-end2d_old[1]));
-        }
-        R_init = R_0 = end2d_old[0], Z_init = Z_0 = end2d_old[1];
+        std::array<double, 2> begin2d{ {R_init, Z_init} }, end2d(begin2d);
+        //1e-12 bounds the local error of each step
+        dg::integrateERK<dg::dormand_prince>( fieldRZtau_, psip_.f()(R_init, Z_init), begin2d, psi, end2d, 1e-12);
+        R_init = R_0 = end2d[0], Z_init = Z_0 = end2d[1];
         if(m_verbose)std::cout << "In init function error: psi(R,Z)-psi0: "<<psip_.f()(R_init, Z_init)-psi<<"\n";
     }
 
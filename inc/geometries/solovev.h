@@ -57,7 +57,7 @@ namespace solovev
       with \f$ \bar R := \frac{ R}{R_0} \f$ and \f$\bar Z := \frac{Z}{R_0}\f$
  *
  */
-struct Psip: public aCloneableBinaryFunctor<Psip>
+struct Psip: public aCloneableBatchBinaryFunctor<Psip>
 {
     /**
      * @brief Construct from given geometric parameters
@@ -66,6 +66,7 @@ struct Psip: public aCloneableBinaryFunctor<Psip>
      */
     Psip( Parameters gp): R_0_(gp.R_0), A_(gp.A), c_(gp.c) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
     double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,Zn5,Zn6,lgRn;
@@ -135,11 +136,12 @@ struct Psip: public aCloneableBinaryFunctor<Psip>
       \ln{(\bar{R}   )})\Bigg\} \f]
       with \f$ \bar R := \frac{ R}{R_0} \f$ and \f$\bar Z := \frac{Z}{R_0}\f$
  */
-struct PsipR: public aCloneableBinaryFunctor<PsipR>
+struct PsipR: public aCloneableBatchBinaryFunctor<PsipR>
 {
     ///@copydoc Psip::Psip()
     PsipR( Parameters gp): R_0_(gp.R_0), A_(gp.A), c_(gp.c) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipR>;
     double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn3,Rn5,Zn,Zn2,Zn3,Zn4,lgRn;
@@ -176,11 +178,12 @@ struct PsipR: public aCloneableBinaryFunctor<PsipR>
       + c_7 (-165 \bar{R}^4 +2160 \bar{R}^2  \bar{Z}^2-640  \bar{Z}^4-450 \bar{R}^4  \ln{(\bar{R}   )}+2160 \bar{R}^2  \bar{Z}^2
       \ln{(\bar{R}   )}-240  \bar{Z}^4 \ln{(\bar{R}   )})\Bigg\}\f]
  */
-struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
+struct PsipRR: public aCloneableBatchBinaryFunctor<PsipRR>
 {
     ///@copydoc Psip::Psip()
     PsipRR( Parameters gp ): R_0_(gp.R_0), A_(gp.A), c_(gp.c) {}
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRR>;
     double do_compute(double R, double Z) const
     {
        double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,lgRn;
@@ -212,11 +215,12 @@ struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
       +c_7 (150 \bar{R}^4  \bar{Z}-560 \bar{R}^2  \bar{Z}^3+48
       \bar{Z}^5+360 \bar{R}^4  \bar{Z} \ln{(\bar{R}   )}-480 \bar{R}^2  \bar{Z}^3 \ln{(\bar{R}   )})\Bigg\} \f]
  */
-struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
+struct PsipZ: public aCloneableBatchBinaryFunctor<PsipZ>
 {
     ///@copydoc Psip::Psip()
     PsipZ( Parameters gp ): R_0_(gp.R_0), A_(gp.A), c_(gp.c) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZ>;
     double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,Zn5,lgRn;
@@ -250,11 +254,12 @@ struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
       +c_7 (150 \bar{R}^4 -1680 \bar{R}^2  \bar{Z}^2+240  \bar{Z}^4+360 \bar{R}^4
       \ln{(\bar{R}   )}-1440 \bar{R}^2  \bar{Z}^2 \ln{(\bar{R}   )})\Bigg\} \f]
  */
-struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
+struct PsipZZ: public aCloneableBatchBinaryFunctor<PsipZZ>
 {
     ///@copydoc Psip::Psip()
     PsipZZ( Parameters gp): R_0_(gp.R_0), A_(gp.A), c_(gp.c) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZZ>;
     double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn4,Zn,Zn2,Zn3,Zn4,lgRn;
@@ -280,11 +285,12 @@ struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
       +c_7(960 \bar{R}^3  \bar{Z}-1600 \bar{R}  \bar{Z}^3+1440 \bar{R}^3  \bar{Z} \ln{(\bar{R}
       )}-960 \bar{R}  \bar{Z}^3 \ln{(\bar{R}   )})\Bigg\} \f]
  */
-struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
+struct PsipRZ: public aCloneableBatchBinaryFunctor<PsipRZ>
 {
     ///@copydoc Psip::Psip()
     PsipRZ( Parameters gp ): R_0_(gp.R_0), A_(gp.A), c_(gp.c) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRZ>;
     double do_compute(double R, double Z) const
     {
         double Rn,Rn2,Rn3,Zn,Zn2,Zn3,lgRn;
@@ -306,11 +312,12 @@ struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
 
     \f[\hat{I}= \sqrt{-2 A \hat{\psi}_p / \hat{R}_0 +1}\f]
  */
-struct Ipol: public aCloneableBinaryFunctor<Ipol>
+struct Ipol: public aCloneableBatchBinaryFunctor<Ipol>
 {
     ///@copydoc Psip::Psip()
     Ipol(  Parameters gp ):  R_0_(gp.R_0), A_(gp.A), qampl_(gp.qampl), psip_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<Ipol>;
     double do_compute(double R, double Z) const
     {
         //sign before A changed to -
@@ -322,11 +329,12 @@ struct Ipol: public aCloneableBinaryFunctor<Ipol>
 /**
  * @brief \f[\hat I_R\f]
  */
-struct IpolR: public aCloneableBinaryFunctor<IpolR>
+struct IpolR: public aCloneableBatchBinaryFunctor<IpolR>
 {
     ///@copydoc Psip::Psip()
     IpolR(  Parameters gp ):  R_0_(gp.R_0), A_(gp.A), qampl_(gp.qampl), psip_(gp), psipR_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<IpolR>;
     double do_compute(double R, double Z) const
     {
         return -qampl_/sqrt(-2.*A_* psip_(R,Z) /R_0_ + 1.)*(A_*psipR_(R,Z)/R_0_);
@@ -338,11 +346,12 @@ struct IpolR: public aCloneableBinaryFunctor<IpolR>
 /**
  * @brief \f[\hat I_Z\f]
  */
-struct IpolZ: public aCloneableBinaryFunctor<IpolZ>
+struct IpolZ: public aCloneableBatchBinaryFunctor<IpolZ>
 {
     ///@copydoc Psip::Psip()
     IpolZ(  Parameters gp ):  R_0_(gp.R_0), A_(gp.A), qampl_(gp.qampl), psip_(gp), psipZ_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<IpolZ>;
     double do_compute(double R, double Z) const
     {
         return -qampl_/sqrt(-2.*A_* psip_(R,Z) /R_0_ + 1.)*(A_*psipZ_(R,Z)/R_0_);
@@ -373,7 +382,7 @@ dg::geo::TokamakMagneticField createMagField( Parameters gp)
 namespace mod
 {
 
-struct Psip: public aCloneableBinaryFunctor<Psip>
+struct Psip: public aCloneableBatchBinaryFunctor<Psip>
 {
     Psip( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50,1.)
@@ -384,6 +393,7 @@ struct Psip: public aCloneableBinaryFunctor<Psip>
 
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
     double do_compute(double R, double Z) const
     {
         double psip_RZ = psip_(R,Z);
@@ -399,7 +409,7 @@ struct Psip: public aCloneableBinaryFunctor<Psip>
     solovev::PsipZZ psipZZ_;
     dg::Cauchy cauchy_;
 };
-struct PsipR: public aCloneableBinaryFunctor<PsipR>
+struct PsipR: public aCloneableBatchBinaryFunctor<PsipR>
 {
     PsipR( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipR_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50,1.)
@@ -409,6 +419,7 @@ struct PsipR: public aCloneableBinaryFunctor<PsipR>
         psipRR_X_ = psipRR_(R_X, Z_X);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipR>;
     double do_compute(double R, double Z) const
     {
         double psipR_RZ = psipR_(R,Z);
@@ -427,7 +438,7 @@ struct PsipR: public aCloneableBinaryFunctor<PsipR>
     solovev::PsipZZ psipZZ_;
     dg::Cauchy cauchy_;
 };
-struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
+struct PsipZ: public aCloneableBatchBinaryFunctor<PsipZ>
 {
     PsipZ( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipZ_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50, 1)
@@ -437,6 +448,7 @@ struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
         psipRR_X_ = psipRR_(R_X, Z_X);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZ>;
     double do_compute(double R, double Z) const
     {
         double psipZ_RZ = psipZ_(R,Z);
@@ -456,7 +468,7 @@ struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
     dg::Cauchy cauchy_;
 };
 
-struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
+struct PsipZZ: public aCloneableBatchBinaryFunctor<PsipZZ>
 {
     PsipZZ( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipZ_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50, 1)
@@ -466,6 +478,7 @@ struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
         psipRR_X_ = psipRR_(R_X, Z_X);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZZ>;
     double do_compute(double R, double Z) const
     {
         double psipZZ_RZ = psipZZ_(R,Z);
@@ -485,7 +498,7 @@ struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
     solovev::PsipZZ psipZZ_;
     dg::Cauchy cauchy_;
 };
-struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
+struct PsipRR: public aCloneableBatchBinaryFunctor<PsipRR>
 {
     PsipRR( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipR_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50, 1)
@@ -495,6 +508,7 @@ struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
         psipRR_X_ = psipRR_(R_X, Z_X);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRR>;
     double do_compute(double R, double Z) const
     {
         double psipRR_RZ = psipRR_(R,Z);
@@ -514,7 +528,7 @@ struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
     solovev::PsipZZ psipZZ_;
     dg::Cauchy cauchy_;
 };
-struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
+struct PsipRZ: public aCloneableBatchBinaryFunctor<PsipRZ>
 {
     PsipRZ( Parameters gp): R_X( gp.R_0-1.1*gp.triangularity*gp.a), Z_X(-1.1*gp.elongation*gp.a),
         psip_(gp), psipR_(gp), psipZ_(gp), psipRR_(gp), psipRZ_(gp), psipZZ_(gp), cauchy_( R_X, Z_X, 50, 50, 1)
@@ -524,6 +538,7 @@ struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
         psipRR_X_ = psipRR_(R_X, Z_X);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRZ>;
     double do_compute(double R, double Z) const
     {
         double psipRZ_RZ = psipRZ_(R,Z);
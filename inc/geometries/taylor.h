@@ -41,7 +41,7 @@ typedef dg::geo::solovev::Parameters Parameters; //!< bring Parameters into the
  * This is taken from A. J. Cerfon and M. O'Neil: Exact axisymmetric Taylor states for shaped plasmas, Physics of Plasmas 21, 064501 (2014)
  * @attention When the taylor field is used we need the <a href="http://www.boost.org"> boost</a> library for special functions
  */
-struct Psip : public aCloneableBinaryFunctor<Psip>
+struct Psip : public aCloneableBatchBinaryFunctor<Psip>
 { /**
      * @brief Construct from given geometric parameters
      *
@@ -51,6 +51,7 @@ struct Psip : public aCloneableBinaryFunctor<Psip>
         cs_ = sqrt( c_[11]*c_[11]-c_[10]*c_[10]);
     }
   private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
     double do_compute(double R, double Z) const
     {
         double Rn = R/R0_, Zn = Z/R0_;
@@ -80,7 +81,7 @@ struct Psip : public aCloneableBinaryFunctor<Psip>
  * @brief \f[\psi_R\f]
  * @attention When the taylor field is used we need the boost library for special functions
  */
-struct PsipR: public aCloneableBinaryFunctor<PsipR>
+struct PsipR: public aCloneableBatchBinaryFunctor<PsipR>
 {
     ///@copydoc Psip::Psip()
     PsipR( solovev::Parameters gp): R0_(gp.R_0), c_(gp.c) {
@@ -88,6 +89,7 @@ struct PsipR: public aCloneableBinaryFunctor<PsipR>
 
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipR>;
     double do_compute(double R, double Z) const
     {
         double Rn=R/R0_, Zn=Z/R0_;
@@ -118,13 +120,14 @@ struct PsipR: public aCloneableBinaryFunctor<PsipR>
 /**
  * @brief \f[ \frac{\partial^2  \hat{\psi}_p }{ \partial \hat{R}^2}\f]
  */
-struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
+struct PsipRR: public aCloneableBatchBinaryFunctor<PsipRR>
 {
     ///@copydoc Psip::Psip()
     PsipRR( solovev::Parameters gp ): R0_(gp.R_0), c_(gp.c) {
         cs_ = sqrt( c_[11]*c_[11]-c_[10]*c_[10]);
     }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRR>;
     double do_compute(double R, double Z) const
     {
         double Rn=R/R0_, Zn=Z/R0_;
@@ -151,13 +154,14 @@ struct PsipRR: public aCloneableBinaryFunctor<PsipRR>
 /**
  * @brief \f[\frac{\partial \hat{\psi}_p }{ \partial \hat{Z}}\f]
  */
-struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
+struct PsipZ: public aCloneableBatchBinaryFunctor<PsipZ>
 {
     ///@copydoc Psip::Psip()
     PsipZ( solovev::Parameters gp ): R0_(gp.R_0), c_(gp.c) {
         cs_ = sqrt( c_[11]*c_[11]-c_[10]*c_[10]);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZ>;
     double do_compute(double R, double Z) const
     {
         double Rn = R/R0_, Zn = Z/R0_;
@@ -182,13 +186,14 @@ struct PsipZ: public aCloneableBinaryFunctor<PsipZ>
 /**
  * @brief \f[ \frac{\partial^2  \hat{\psi}_p }{ \partial \hat{Z}^2}\f]
  */
-struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
+struct PsipZZ: public aCloneableBatchBinaryFunctor<PsipZZ>
 {
     ///@copydoc Psip::Psip()
     PsipZZ( solovev::Parameters gp): R0_(gp.R_0), c_(gp.c) {
         cs_ = sqrt( c_[11]*c_[11]-c_[10]*c_[10]);
     }
     private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZZ>;
     double do_compute(double R, double Z) const
     {
         double Rn = R/R0_, Zn = Z/R0_;
@@ -211,13 +216,14 @@ struct PsipZZ: public aCloneableBinaryFunctor<PsipZZ>
 /**
  * @brief  \f[\frac{\partial^2  \hat{\psi}_p }{ \partial \hat{R} \partial\hat{Z}}\f]
  */
-struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
+struct PsipRZ: public aCloneableBatchBinaryFunctor<PsipRZ>
 {
     ///@copydoc Psip::Psip()
     PsipRZ( solovev::Parameters gp ): R0_(gp.R_0), c_(gp.c) {
         cs_ = sqrt( c_[11]*c_[11]-c_[10]*c_[10]);
     }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipRZ>;
     double do_compute(double R, double Z) const
     {
         double Rn=R/R0_, Zn=Z/R0_;
@@ -249,11 +255,12 @@ struct PsipRZ: public aCloneableBinaryFunctor<PsipRZ>
  *
    \f[\hat{I}= \sqrt{-2 A \hat{\psi}_p / \hat{R}_0 +1}\f]
  */
-struct Ipol: public aCloneableBinaryFunctor<Ipol>
+struct Ipol: public aCloneableBatchBinaryFunctor<Ipol>
 {
     ///@copydoc Psip::Psip()
     Ipol(  solovev::Parameters gp ): c12_(gp.c[11]), psip_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<Ipol>;
     double do_compute(double R, double Z) const
     {
         return c12_*psip_(R,Z);
@@ -265,11 +272,12 @@ struct Ipol: public aCloneableBinaryFunctor<Ipol>
 /**
  * @brief \f[\hat I_R\f]
  */
-struct IpolR: public aCloneableBinaryFunctor<IpolR>
+struct IpolR: public aCloneableBatchBinaryFunctor<IpolR>
 {
     ///@copydoc Psip::Psip()
     IpolR(  solovev::Parameters gp ): c12_(gp.c[11]), psipR_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<IpolR>;
     double do_compute(double R, double Z) const
     {
         return c12_*psipR_(R,Z);
@@ -280,11 +288,12 @@ struct IpolR: public aCloneableBinaryFunctor<IpolR>
 /**
  * @brief \f[\hat I_Z\f]
  */
-struct IpolZ: public aCloneableBinaryFunctor<IpolZ>
+struct IpolZ: public aCloneableBatchBinaryFunctor<IpolZ>
 {
     ///@copydoc Psip::Psip()
     IpolZ(  solovev::Parameters gp ): c12_(gp.c[11]), psipZ_(gp) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<IpolZ>;
     double do_compute(double R, double Z) const
     {
         return c12_*psipZ_(R,Z);
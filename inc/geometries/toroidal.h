@@ -48,13 +48,14 @@ namespace circular{
  * @brief \f[ \psi_p = \frac{1}{2}\left((R-R_0)^2 + Z^2 \right) \f]
  * gives circular flux surfaces
  */
-struct Psip : public aCloneableBinaryFunctor<Psip>
+struct Psip : public aCloneableBatchBinaryFunctor<Psip>
 { /**
      * @brief Construct from major radius
      * @param R0 the major radius
      */
     Psip( double R0): m_R0(R0) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<Psip>;
     double do_compute(double R, double Z) const
     {
         return 0.5*((R-m_R0)*(R-m_R0) + Z*Z);
@@ -62,13 +63,14 @@ struct Psip : public aCloneableBinaryFunctor<Psip>
     double m_R0;
 };
 /// @brief \f[ R-R_0 \f]
-struct PsipR : public aCloneableBinaryFunctor<PsipR>
+struct PsipR : public aCloneableBatchBinaryFunctor<PsipR>
 { /**
      * @brief Construct from major radius
      * @param R0 the major radius
      */
     PsipR( double R0): m_R0(R0) { }
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipR>;
     double do_compute(double R, double Z) const
     {
         return R-m_R0;
@@ -76,9 +78,10 @@ struct PsipR : public aCloneableBinaryFunctor<PsipR>
     double m_R0;
 };
 ///@brief \f[ Z \f]
-struct PsipZ : public aCloneableBinaryFunctor<PsipZ>
+struct PsipZ : public aCloneableBatchBinaryFunctor<PsipZ>
 {
   private:
+    friend struct aCloneableBatchBinaryFunctor<PsipZ>;
     double do_compute(double R, double Z) const
     {
         return Z;
@@ -248,6 +248,8 @@ int main( int argc, char* argv[])
 #endif//DG_BENCHMARK
         for( unsigned i=0; i<p.itstp; i++)
         {
+            //energies are needed only for dEdt at the last step before a plot
+            feltor.compute_energies( i+2 >= p.itstp);
             try{ karniadakis.step( feltor, rolkar, time, y0);}
             catch( dg::Fail& fail) { 
                 std::cerr << "CG failed to converge to "<<fail.epsilon()<<"\n";
@@ -256,21 +258,22 @@ int main( int argc, char* argv[])
                 break;
             }
             step++;
-//             feltor.energies( y0); //update energetics
+            if( i+2 < p.itstp)
+                continue;
+            E1 = feltor.energy();
+            dEdt = (E1 - E0)/p.dt; //
+            E0 = E1;
+            if( i+1 < p.itstp)
+                continue;
             //Compute probe values
             dg::blas2::gemv(probeinterp,y0[0],probevalue);
             std::cout << " Ne_p - 1  = " << probevalue[0] <<"\t";
             dg::blas2::gemv(probeinterp,feltor.potential()[0],probevalue);
             std::cout << " Phi_p = " << probevalue[0] <<"\t";
             std::cout << "(m_tot-m_0)/m_0: "<< (feltor.mass()-mass0)/mass0<<"\t";
-            E1 = feltor.energy();
-            dEdt = (E1 - E0)/p.dt; //
             double diss = feltor.energy_diffusion( );
             std::cout << "(E_tot-E_0)/E_0: "<< (E1-energy0)/energy0<<"\t";
             std::cout << "Accuracy: "<< 2.*fabs((dEdt-diss)/(dEdt+diss))<<" d E/dt = " << dEdt <<" Lambda =" << diss << "\n";
-            
-            E0 = E1;
-
         }
 #ifdef DG_BENCHMARK
         t.toc();
@@ -170,6 +170,58 @@ struct Explicit
      */
     double fieldalignment() { return aligned_;}
 
+    /**
+     * @brief Switch the energy diagnostics in \c operator() on or off (default: on)
+     *
+     * The energies and the dissipation terms need a number of scalar products and
+     * parallel and perpendicular derivatives that do not enter the right hand side.
+     * If they are needed only at output steps switch them off in between and
+     * on again before the last two steps before an output (two consecutive
+     * energies are needed for the time derivative of the energy).
+     * @param compute if false, mass(), energy(), energy_vector(), energy_diffusion()
+     * and fieldalignment() keep their last values
+     */
+    void compute_energies( bool compute) { compute_energies_ = compute;}
+
+    /**
+     * @brief Write the past solutions of the field solvers, the potential and the energies into a checkpoint
+     *
+     * @tparam Checkpoint e.g. \c file::Checkpoint
+     * @param chk the checkpoint
+     * @param name prefix of the stored names
+     */
+    template<class Checkpoint>
+    void save_state( Checkpoint& chk, std::string name) const
+    {
+        old_phi.save_state( chk, name+"_old_phi");
+        old_psi.save_state( chk, name+"_old_psi");
+        old_gammaN.save_state( chk, name+"_old_gammaN");
+        invert_pol.save_state( chk, name+"_invert_pol");
+        invert_invgamma.save_state( chk, name+"_invert_invgamma");
+        chk.put( name+"_phi", phi);
+        chk.put( name+"_mass", mass_), chk.put( name+"_energy", energy_);
+        chk.put( name+"_diff", diff_), chk.put( name+"_ediff", ediff_);
+        chk.put( name+"_aligned", aligned_);
+        for( unsigned i=0; i<evec.size(); i++)
+            chk.put( name+"_evec"+std::to_string(i), evec[i]);
+    }
+    ///@brief Restore the state written by \c save_state
+    template<class Checkpoint>
+    void load_state( const Checkpoint& chk, std::string name)
+    {
+        old_phi.load_state( chk, name+"_old_phi");
+        old_psi.load_state( chk, name+"_old_psi");
+        old_gammaN.load_state( chk, name+"_old_gammaN");
+        invert_pol.load_state( chk, name+"_invert_pol");
+        invert_invgamma.load_state( chk, name+"_invert_invgamma");
+        chk.get( name+"_phi", phi);
+        chk.get( name+"_mass", mass_), chk.get( name+"_energy", energy_);
+        chk.get( name+"_diff", diff_), chk.get( name+"_ediff", ediff_);
+        chk.get( name+"_aligned", aligned_);
+        for( unsigned i=0; i<evec.size(); i++)
+            chk.get( name+"_evec"+std::to_string(i), evec[i]);
+    }
+
   private:
     void vecdotnablaN(const container& x, const container& y, const container& z, container& target);
     void vecdotnablaDIR(const container& x, const container& y, const container& z, container& target);
@@ -208,6 +260,7 @@ struct Explicit
 
     double mass_, energy_, diff_, ediff_, aligned_;
     std::vector<double> evec;
+    bool compute_energies_ = true;
 };
 ///@}
 
@@ -382,47 +435,49 @@ double Explicit<G, IMatrix, M, V>::add_parallel_dynamics( const std::vector<V>&
         dsN_.centered(-p.tau[i]/p.mu[i], logn[i], 1.0, yp[2+i]);   //dtU += - tau/(hat(mu))*ds lnN  
         dsDIR_.centered(-1./p.mu[i], phi[i], 1.0, yp[2+i]);      //dtU +=  - 1/(hat(mu))  *ds psi  
     }
-    //Parallel dissipation
+    //Parallel dissipation (enters only the energy diagnostics)
+    if( !compute_energies_)
+        return 0.;
 //     double nu_parallel[] = {-p.mu[0]/p.c, -p.mu[0]/p.c, p.nu_parallel, p.nu_parallel};
     double nu_parallel[] = {p.nu_parallel, p.nu_parallel, p.nu_parallel, p.nu_parallel};
     for( unsigned i=0; i<2;i++)
     {
-        //Compute parallel dissipation and dissipative energy for N///////////////
-
-        dg::blas2::symv(dsN_,y[i],lambda); // lambda= ds^2 N
-        dg::blas1::axpby( nu_parallel[i], lambda,  0., lambda,lambda);  //lambda = nu_parallel ds^2 N
-      
-
-        //compute chi = (tau_e(1+lnN_e)+phi + 0.5 mu U^2)
-        dg::blas1::axpby(1.,one,1., logn[i] ,chi); //chi = (1+lnN_e)
-        dg::blas1::pointwiseDot(y[i+2],y[i+2], omega);  //U^2
-        dg::blas1::axpbypgz(0.5*p.mu[i], omega, 1.0, phi[i], p.tau[i], chi); //chi = (tau (1+lnN_e) + psi + 0.5 mu U^2)
-        Dpar[i] = z[i]*dg::blas2::dot(chi, w3d, lambda); //Z*(tau (1+lnN )+psi + 0.5 mu U^2) nu_para *(ds^2 N -ds lnB ds N)
-        if( i==0) //only electrons
-        {
-            //do not write into chi 
-            dg::blas1::axpby(1.,one,1., logn[i] ,omega); //omega = (1+lnN)
-            aligned_ = dg::blas2::dot( omega, w3d, lambda); //(1+lnN)*Delta_s N
-        }
+        //dsy serve as helper variables, the scalar products of one species are reduced together
+        //Compute parallel dissipation for N
+        dg::blas2::symv(dsN_,y[i],dsy[0]); // dsy[0]= ds^2 N
+        dg::blas1::axpby( nu_parallel[i], dsy[0],  0., dsy[0],dsy[0]);  //dsy[0] = nu_parallel ds^2 N
 
         //Compute perp dissipation for N
         dg::blas2::gemv( lapperpN, y[i], lambda);
-        dg::blas2::gemv( lapperpN, lambda, omega);//nabla_RZ^4 N_e
-        Dperp[i] = -z[i]* p.nu_perp*dg::blas2::dot(chi, w3d, omega);  
+        dg::blas2::gemv( lapperpN, lambda, dsy[1]);//nabla_RZ^4 N_e
 
-    
-        dg::blas2::symv(dsDIR_, y[i+2],lambda);
-        dg::blas1::axpby( nu_parallel[i+2], lambda,  0., lambda,lambda); 
-        
-        //compute omega = NU
-        dg::blas1::pointwiseDot( npe[i], y[i+2], omega); //N U   
-        Dpar[i+2] = z[i]*p.mu[i]*dg::blas2::dot(omega, w3d, lambda);      //Z*N*U nu_para *(ds^2 U -ds lnB ds U)  
+        //Compute parallel dissipation for U
+        dg::blas2::symv(dsDIR_, y[i+2],dsy[2]);
+        dg::blas1::axpby( nu_parallel[i+2], dsy[2],  0., dsy[2],dsy[2]);
+
+        //compute dsy[3] = NU
+        dg::blas1::pointwiseDot( npe[i], y[i+2], dsy[3]); //N U
 
         //Compute perp dissipation  for U
         dg::blas2::gemv( lapperpDIR, y[i+2], lambda);
-        dg::blas2::gemv( lapperpDIR, lambda,chi);//nabla_RZ^4 U
-        Dperp[i+2] = -z[i]*p.mu[i]*p.nu_perp* dg::blas2::dot(omega, w3d, chi);
+        dg::blas2::gemv( lapperpDIR, lambda,omega);//nabla_RZ^4 U
 
+        //compute chi = (tau_e(1+lnN_e)+phi + 0.5 mu U^2)
+        dg::blas1::axpby(1.,one,1., logn[i] ,chi); //chi = (1+lnN_e)
+        dg::blas1::pointwiseDot(y[i+2],y[i+2], lambda);  //U^2
+        dg::blas1::axpbypgz(0.5*p.mu[i], lambda, 1.0, phi[i], p.tau[i], chi); //chi = (tau (1+lnN_e) + psi + 0.5 mu U^2)
+        //do not write into chi
+        dg::blas1::axpby(1.,one,1., logn[i] ,lambda); //lambda = (1+lnN)
+
+        std::vector<double> dots = dg::blas2::dot(
+            {&chi,    &chi,    &dsy[3], &dsy[3], &lambda}, w3d,
+            {&dsy[0], &dsy[1], &dsy[2], &omega,  &dsy[0]});
+        Dpar[i] = z[i]*dots[0]; //Z*(tau (1+lnN )+psi + 0.5 mu U^2) nu_para *(ds^2 N -ds lnB ds N)
+        Dperp[i] = -z[i]* p.nu_perp*dots[1];
+        Dpar[i+2] = z[i]*p.mu[i]*dots[2];      //Z*N*U nu_para *(ds^2 U -ds lnB ds U)
+        Dperp[i+2] = -z[i]*p.mu[i]*p.nu_perp* dots[3];
+        if( i==0) //only electrons
+            aligned_ = dots[4]; //(1+lnN)*Delta_s N
     }
     return Dpar[0]+Dperp[0]+Dpar[1]+Dperp[1]+Dpar[2]+Dperp[2]+Dpar[3]+Dperp[3];
 }
@@ -451,25 +506,32 @@ void Explicit<Geometry, IMatrix, Matrix, container>::operator()( double ttt, con
         dg::blas1::transform( npe[i], logn[i], dg::LN<double>());
     }
     //compute energies
-
-    double z[2]    = {-1.0,1.0};
-    double S[2]    = {0.0, 0.0};
-    double Tpar[2] = {0.0, 0.0};
-    //compute energies
-    for(unsigned i=0; i<2; i++)
+    double Dres = 0.;
+    if( compute_energies_)
     {
-        S[i]    = z[i]*p.tau[i]*dg::blas2::dot( logn[i], w3d, npe[i]);
-        dg::blas1::pointwiseDot( y[i+2], y[i+2], chi); 
-        Tpar[i] = z[i]*0.5*p.mu[i]*dg::blas2::dot( npe[i], w3d, chi);
+        double z[2]    = {-1.0,1.0};
+        double S[2]    = {0.0, 0.0};
+        double Tpar[2] = {0.0, 0.0};
+        //dsy serve as helper variables, all scalar products are reduced together
+        dg::blas1::pointwiseDot( y[2], y[2], dsy[0]); //U_e^2
+        dg::blas1::pointwiseDot( y[3], y[3], dsy[1]); //U_i^2
+        // resistive energy (consistent density, momentum conservation, quadratic current in energy)
+        dg::blas1::axpby( -1., y[2], 1., y[3], dsy[2]); //dsy[2]  = - U_e + U_i
+        dg::blas1::pointwiseDivide(dsy[2],npe[0],dsy[2]); // dsy[2] = N_e (U_i - U_e)
+        std::vector<double> dots = dg::blas2::dot(
+            {&logn[0], &logn[1], &npe[0], &npe[1], &one, &npe[1], &dsy[2]}, w3d,
+            {&npe[0],  &npe[1],  &dsy[0], &dsy[1], &y[0], &omega, &dsy[2]});
+        for(unsigned i=0; i<2; i++)
+        {
+            S[i]    = z[i]*p.tau[i]*dots[i];
+            Tpar[i] = z[i]*0.5*p.mu[i]*dots[i+2];
+        }
+        mass_ = dots[4]; //take real ion density which is electron density!!
+        double Tperp = 0.5*p.mu[1]*dots[5];   //= 0.5 mu_i N_i u_E^2
+        energy_ = S[0] + S[1]  + Tperp + Tpar[0] + Tpar[1];
+        evec[0] = S[0], evec[1] = S[1], evec[2] = Tperp, evec[3] = Tpar[0], evec[4] = Tpar[1];
+        Dres = -p.c*dots[6]; //- C*(N_e (U_i - U_e))^2
     }
-    mass_ = dg::blas2::dot( one, w3d, y[0] ); //take real ion density which is electron density!!
-    double Tperp = 0.5*p.mu[1]*dg::blas2::dot( npe[1], w3d, omega);   //= 0.5 mu_i N_i u_E^2
-    energy_ = S[0] + S[1]  + Tperp + Tpar[0] + Tpar[1]; 
-    evec[0] = S[0], evec[1] = S[1], evec[2] = Tperp, evec[3] = Tpar[0], evec[4] = Tpar[1];
-    // resistive energy (consistent density, momentum conservation, quadratic current in energy)
-    dg::blas1::axpby( -1., y[2], 1., y[3], omega); //omega  = - U_e + U_i   
-    dg::blas1::pointwiseDivide(omega,npe[0],omega); // omega = N_e (U_i - U_e)
-    double Dres = -p.c*dg::blas2::dot(omega, w3d, omega); //- C*(N_e (U_i - U_e))^2
     for( unsigned i=0; i<2; i++)
     {
         //ExB dynamics
@@ -531,30 +593,30 @@ void Explicit<Geometry, IMatrix, Matrix, container>::operator()( double ttt, con
             vecdotnablaN(curvX, curvY, y[i], curvy[i]);                   //K(N) = K(N-1)
             vecdotnablaDIR(curvX, curvY,  y[i+2], curvy[2+i]);            //K(U) = K(U)
             vecdotnablaDIR(curvX, curvY, phi[i], curvphi[i]);             //K(phi)
-            
-            dg::blas1::pointwiseDot(-0.5*p.mu[i], y[i+2], y[i+2], curvy[2+i],1., yp[2+i]); //dtU +=- 0.5 (hat(mu)) U^2 K(U)
-            dg::blas1::pointwiseDot(-p.mu[i], npe[i], y[i+2], curvy[2+i], 1., yp[i]); //dtN += - (hat(mu)) N U K(U)
-
-            vecdotnablaN(curvX, curvY, logn[i], omega);                   //K(ln N) 
-            dg::blas1::pointwiseDot(-p.tau[i], y[i+2], omega, 1., yp[2+i]); //dtU += - tau U K(lnN)
-            
-            dg::blas1::pointwiseDot(-0.5*p.mu[i],  y[i+2], y[i+2], curvy[i], 1., yp[i]);  //dtN += - 0.5 mu U^2 K(N)
-
-            dg::blas1::pointwiseDot(npe[i],curvphi[i], omega);            //N K(psi)
-            dg::blas1::axpbypgz( -p.tau[i], curvy[i], -1., omega, 1., yp[i]); //dtN+= - tau K(N) - N K(psi)
-
-            dg::blas1::pointwiseDot( y[i+2], curvphi[i], omega);          //U K(phi)
-            dg::blas1::axpbypgz(-2.*p.tau[i], curvy[2+i], -0.5, omega, 1., yp[2+i]);   //dtU += - 2 tau K(U) -0.5 U K(psi)
+            vecdotnablaN(curvX, curvY, logn[i], omega);                   //K(ln N)
+
+            //all pointwise updates in one pass; arguments: 0 U, 1 N, 2 K(U), 3 K(N), 4 K(psi), 5 K(ln N), 6 dtN, 7 dtU, 8 one
+            dg::blas1::subroutine( dg::blas1::fuse(
+                dg::blas1::on<0,0,2,7>( dg::PointwiseDot<double>( -0.5*p.mu[i], 1.)),     //dtU +=- 0.5 (hat(mu)) U^2 K(U)
+                dg::blas1::on<1,0,2,6>( dg::PointwiseDot<double>( -p.mu[i], 1.)),         //dtN += - (hat(mu)) N U K(U)
+                dg::blas1::on<0,5,7>( dg::PointwiseDot<double>( -p.tau[i], 1.)),          //dtU += - tau U K(lnN)
+                dg::blas1::on<0,0,3,6>( dg::PointwiseDot<double>( -0.5*p.mu[i], 1.)),     //dtN += - 0.5 mu U^2 K(N)
+                dg::blas1::on<8,3,1,4,6>( dg::PointwiseDot<double>( -p.tau[i], -1., 1.)), //dtN+= - tau K(N) - N K(psi)
+                dg::blas1::on<8,2,0,4,7>( dg::PointwiseDot<double>( -2.*p.tau[i], -0.5, 1.))), //dtU += - 2 tau K(U) -0.5 U K(psi)
+                y[i+2], npe[i], curvy[2+i], curvy[i], curvphi[i], omega, yp[i], yp[2+i], 1.);
         }
     }
     //parallel dynamics
     double Dpar_plus_perp = add_parallel_dynamics( y, yp);
-    ediff_= Dpar_plus_perp + Dres;
+    if( compute_energies_)
+        ediff_= Dpar_plus_perp + Dres;
     for( unsigned i=0; i<2; i++)
     {
-        //damping 
-        dg::blas1::pointwiseDot( damping, yp[i], yp[i]);
-        dg::blas1::pointwiseDot( damping, yp[i+2], yp[i+2]); 
+        //damping (in one pass)
+        dg::blas1::subroutine( dg::blas1::fuse(
+            dg::blas1::on<0,1>( dg::PointwiseDot<double>( 1., 0.)),
+            dg::blas1::on<0,2>( dg::PointwiseDot<double>( 1., 0.))),
+            damping, yp[i], yp[i+2]);
 
     }
     //add particle source to dtN
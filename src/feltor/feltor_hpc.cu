@@ -1,10 +1,13 @@
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <vector>
 #include <sstream>
 #include <cmath>
 
 #include "file/nc_utilities.h"
+#include "file/async_writer.h"
+#include "file/checkpoint.h"
 #include "feltor.cuh"
 
 /*
@@ -12,6 +15,9 @@
    - Initializes and integrates Explicit and 
    - writes outputs to a given outputfile using netcdf 
         density fields are the real densities in XSPACE ( not logarithmic values)
+   - writes the full state to outputfile.chk every checkpoint_every outputs (and at the end) and
+     continues from a given restartfile (bit-for-bit); the outputfile of the
+     run that wrote the restartfile is then appended from the stored output on
 
 */
 
@@ -22,9 +28,9 @@ int main( int argc, char* argv[])
     Json::CharReaderBuilder parser;
     parser["collectComments"] = false;
     std::string errs;
-    if( argc != 4)
+    if( argc != 4 && argc != 5)
     {
-        std::cerr << "ERROR: Wrong number of arguments!\nUsage: "<< argv[0]<<" [inputfile] [geomfile] [outputfile]\n";
+        std::cerr << "ERROR: Wrong number of arguments!\nUsage: "<< argv[0]<<" [inputfile] [geomfile] [outputfile] ([restartfile])\n";
         return -1;
     }
     else 
@@ -38,6 +44,7 @@ int main( int argc, char* argv[])
     const dg::geo::solovev::Parameters gp(gs);
     p.display( std::cout);
     gp.display( std::cout);
+    dg::profiler().set_enabled( p.profile);
     std::string input = js.toStyledString(), geom = gs.toStyledString();
     ////////////////////////////////set up computations///////////////////////////
 
@@ -94,58 +101,108 @@ int main( int argc, char* argv[])
     dg::blas1::axpby( 0., y0[3], 0., y0[3]); //set Ui = 0
     
     dg::Karniadakis< std::vector<dg::DVec> > karniadakis( y0, y0[0].size(), p.eps_time);
-    karniadakis.init( feltor, rolkar, 0., y0, p.dt);
+    double time = 0, energy0 = 0, mass0 = 0;
+    //index of the last output (also the record index of the energies) and the number of steps
+    unsigned output = 0, step = 0;
+    const bool restart = (argc == 5);
+    if( restart)
+    {
+        std::cout << "Restart from "<<argv[4]<<"\n";
+        file::Checkpoint chk( argv[4], NC_NOWRITE);
+        double index;
+        chk.get( "time", time);
+        chk.get( "output", index), output = (unsigned)index;
+        chk.get( "step", index), step = (unsigned)index;
+        chk.get( "energy0", energy0), chk.get( "mass0", mass0);
+        chk.get( "y0", y0);
+        karniadakis.load_state( chk, "karniadakis");
+        feltor.load_state( chk, "feltor");
+    }
+    else
+        karniadakis.init( feltor, rolkar, time, y0, p.dt);
+    const std::string checkpoint = std::string( argv[3]) + ".chk";
     /////////////////////////////set up netcdf/////////////////////////////////////
     file::NC_Error_Handle err;
     int ncid;
-    err = nc_create( argv[3],NC_NETCDF4|NC_CLOBBER, &ncid);
-    err = nc_put_att_text( ncid, NC_GLOBAL, "inputfile", input.size(), input.data());
-    err = nc_put_att_text( ncid, NC_GLOBAL, "geomfile", geom.size(), geom.data());
-    int dim_ids[4], tvarID;
-    {
-        err = file::define_dimensions( ncid, dim_ids, &tvarID, grid_out);
-        dg::geo::TokamakMagneticField c=dg::geo::createSolovevField(gp);
-        dg::geo::FieldR fieldR(c);
-        dg::geo::FieldZ fieldZ(c);
-        dg::geo::FieldP fieldP(c);
-
-        dg::HVec vecR = dg::evaluate( fieldR, grid_out);
-        dg::HVec vecZ = dg::evaluate( fieldZ, grid_out);
-        dg::HVec vecP = dg::evaluate( fieldP, grid_out);
-        int vecID[3];
-        err = nc_def_var( ncid, "BR", NC_DOUBLE, 3, &dim_ids[1], &vecID[0]);
-        err = nc_def_var( ncid, "BZ", NC_DOUBLE, 3, &dim_ids[1], &vecID[1]);
-        err = nc_def_var( ncid, "BP", NC_DOUBLE, 3, &dim_ids[1], &vecID[2]);
-        err = nc_enddef( ncid);
-        err = nc_put_var_double( ncid, vecID[0], vecR.data());
-        err = nc_put_var_double( ncid, vecID[1], vecZ.data());
-        err = nc_put_var_double( ncid, vecID[2], vecP.data());
-        err = nc_redef(ncid);
-    }
-    
-    //field IDs
     std::string names[5] = {"electrons", "ions", "Ue", "Ui", "potential"}; 
     int dataIDs[5]; 
-    for( unsigned i=0; i<5; i++){
-        err = nc_def_var( ncid, names[i].data(), NC_DOUBLE, 4, dim_ids, &dataIDs[i]);}
-    //energy IDs
-    int EtimeID, EtimevarID;
-    err = file::define_time( ncid, "energy_time", &EtimeID, &EtimevarID);
-    int energyID, massID, energyIDs[5], dissID, alignedID, dEdtID, accuracyID;
-    err = nc_def_var( ncid, "energy",   NC_DOUBLE, 1, &EtimeID, &energyID);
-    err = nc_def_var( ncid, "mass",   NC_DOUBLE, 1, &EtimeID, &massID);
     std::string energies[5] = {"Se", "Si", "Uperp", "Upare", "Upari"}; 
-    for( unsigned i=0; i<5; i++){
-        err = nc_def_var( ncid, energies[i].data(), NC_DOUBLE, 1, &EtimeID, &energyIDs[i]);}
-    err = nc_def_var( ncid, "dissipation",   NC_DOUBLE, 1, &EtimeID, &dissID);
-    err = nc_def_var( ncid, "alignment",   NC_DOUBLE, 1, &EtimeID, &alignedID);
-    err = nc_def_var( ncid, "dEdt",     NC_DOUBLE, 1, &EtimeID, &dEdtID);
-    err = nc_def_var( ncid, "accuracy", NC_DOUBLE, 1, &EtimeID, &accuracyID);
-    //probe vars definition
+    int tvarID, EtimevarID;
+    int energyID, massID, energyIDs[5], dissID, alignedID, dEdtID, accuracyID;
     int NepID,phipID;
-    err = nc_def_var( ncid, "Ne_p",     NC_DOUBLE, 1, &EtimeID, &NepID);
-    err = nc_def_var( ncid, "phi_p",    NC_DOUBLE, 1, &EtimeID, &phipID);  
-    err = nc_enddef(ncid);
+    if( restart)
+    {
+        //continue the output file of the run that wrote the checkpoint
+        err = nc_open( argv[3], NC_WRITE, &ncid);
+        for( unsigned i=0; i<5; i++)
+            err = nc_inq_varid( ncid, names[i].data(), &dataIDs[i]);
+        for( unsigned i=0; i<5; i++)
+            err = nc_inq_varid( ncid, energies[i].data(), &energyIDs[i]);
+        err = nc_inq_varid( ncid, "time", &tvarID);
+        err = nc_inq_varid( ncid, "energy_time", &EtimevarID);
+        err = nc_inq_varid( ncid, "energy", &energyID);
+        err = nc_inq_varid( ncid, "mass", &massID);
+        err = nc_inq_varid( ncid, "dissipation", &dissID);
+        err = nc_inq_varid( ncid, "alignment", &alignedID);
+        err = nc_inq_varid( ncid, "dEdt", &dEdtID);
+        err = nc_inq_varid( ncid, "accuracy", &accuracyID);
+        err = nc_inq_varid( ncid, "Ne_p", &NepID);
+        err = nc_inq_varid( ncid, "phi_p", &phipID);
+    }
+    else
+    {
+        err = nc_create( argv[3],NC_NETCDF4|NC_CLOBBER, &ncid);
+        err = nc_put_att_text( ncid, NC_GLOBAL, "inputfile", input.size(), input.data());
+        err = nc_put_att_text( ncid, NC_GLOBAL, "geomfile", geom.size(), geom.data());
+        int dim_ids[4];
+        {
+            err = file::define_dimensions( ncid, dim_ids, &tvarID, grid_out);
+            dg::geo::TokamakMagneticField c=dg::geo::createSolovevField(gp);
+            dg::geo::FieldR fieldR(c);
+            dg::geo::FieldZ fieldZ(c);
+            dg::geo::FieldP fieldP(c);
+
+            dg::HVec vecR = dg::evaluate( fieldR, grid_out);
+            dg::HVec vecZ = dg::evaluate( fieldZ, grid_out);
+            dg::HVec vecP = dg::evaluate( fieldP, grid_out);
+            int vecID[3];
+            err = nc_def_var( ncid, "BR", NC_DOUBLE, 3, &dim_ids[1], &vecID[0]);
+            err = nc_def_var( ncid, "BZ", NC_DOUBLE, 3, &dim_ids[1], &vecID[1]);
+            err = nc_def_var( ncid, "BP", NC_DOUBLE, 3, &dim_ids[1], &vecID[2]);
+            err = nc_enddef( ncid);
+            err = nc_put_var_double( ncid, vecID[0], vecR.data());
+            err = nc_put_var_double( ncid, vecID[1], vecZ.data());
+            err = nc_put_var_double( ncid, vecID[2], vecP.data());
+            err = nc_redef(ncid);
+        }
+        
+        //field IDs
+        file::VariableOptions field_opt;
+        field_opt.deflate = p.output_deflate, field_opt.shuffle = p.output_deflate > 0;
+        field_opt.bits = p.output_bits, field_opt.single_precision = p.output_float;
+        //by default one plane per chunk
+        const size_t planeNy = grid_out.n()*grid_out.Ny(), planeNx = grid_out.n()*grid_out.Nx();
+        field_opt.chunks = {1, 1,
+            p.output_chunk_Ny == 0 ? planeNy : std::min<size_t>( p.output_chunk_Ny, planeNy),
+            p.output_chunk_Nx == 0 ? planeNx : std::min<size_t>( p.output_chunk_Nx, planeNx)};
+        for( unsigned i=0; i<5; i++){
+            err = file::define_variable( ncid, names[i].data(), 4, dim_ids, &dataIDs[i], field_opt);}
+        //energy IDs
+        int EtimeID;
+        err = file::define_time( ncid, "energy_time", &EtimeID, &EtimevarID);
+        err = nc_def_var( ncid, "energy",   NC_DOUBLE, 1, &EtimeID, &energyID);
+        err = nc_def_var( ncid, "mass",   NC_DOUBLE, 1, &EtimeID, &massID);
+        for( unsigned i=0; i<5; i++){
+            err = nc_def_var( ncid, energies[i].data(), NC_DOUBLE, 1, &EtimeID, &energyIDs[i]);}
+        err = nc_def_var( ncid, "dissipation",   NC_DOUBLE, 1, &EtimeID, &dissID);
+        err = nc_def_var( ncid, "alignment",   NC_DOUBLE, 1, &EtimeID, &alignedID);
+        err = nc_def_var( ncid, "dEdt",     NC_DOUBLE, 1, &EtimeID, &dEdtID);
+        err = nc_def_var( ncid, "accuracy", NC_DOUBLE, 1, &EtimeID, &accuracyID);
+        //probe vars definition
+        err = nc_def_var( ncid, "Ne_p",     NC_DOUBLE, 1, &EtimeID, &NepID);
+        err = nc_def_var( ncid, "phi_p",    NC_DOUBLE, 1, &EtimeID, &phipID);  
+        err = nc_enddef(ncid);
+    }
 
     ///////////////////////////////////PROBE//////////////////////////////
     const dg::HVec Xprobe(1,gp.R_0+p.boxscaleRp*gp.a);
@@ -154,55 +211,59 @@ int main( int argc, char* argv[])
     dg::IDMatrix probeinterp(dg::create::interpolation( Xprobe,  Zprobe,Phiprobe,grid, dg::NEU));
     dg::DVec probevalue(1,0.);  
     ///////////////////////////////////first output/////////////////////////
-    std::cout << "First output ... \n";
     size_t start[4] = {0, 0, 0, 0};
     size_t count[4] = {1, grid_out.Nz(), grid_out.n()*grid_out.Ny(), grid_out.n()*grid_out.Nx()};
     dg::DVec transfer(  dg::evaluate(dg::zero, grid));
     dg::DVec transferD( dg::evaluate(dg::zero, grid_out));
     dg::HVec transferH( dg::evaluate(dg::zero, grid_out));
     dg::IDMatrix interpolate = dg::create::interpolation( grid_out, grid); 
-    for( unsigned i=0; i<4; i++)
+    size_t Estart[] = {step};
+    size_t Ecount[] = {1};
+    double E0 = feltor.energy(), mass = feltor.mass(), E1 = 0.0, dEdt = 0., diss = 0., aligned=0, accuracy=0.;
+    std::vector<double> evec = feltor.energy_vector();
+    double Nep = 0, phip = 0;
+    if( !restart) //a restarted run continues after the output of the checkpoint
     {
-        dg::blas2::symv( interpolate, y0[i], transferD);
+        std::cout << "First output ... \n";
+        for( unsigned i=0; i<4; i++)
+        {
+            dg::blas2::symv( interpolate, y0[i], transferD);
+            dg::blas1::transfer( transferD, transferH);
+            err = file::put_vara( ncid, dataIDs[i], start, count, transferH, p.output_bits);
+        }
+        transfer = feltor.potential()[0];
+        dg::blas2::symv( interpolate, transfer, transferD);
         dg::blas1::transfer( transferD, transferH);
-        err = nc_put_vara_double( ncid, dataIDs[i], start, count, transferH.data() );
-    }
-    transfer = feltor.potential()[0];
-    dg::blas2::symv( interpolate, transfer, transferD);
-    dg::blas1::transfer( transferD, transferH);
-    err = nc_put_vara_double( ncid, dataIDs[4], start, count, transferH.data() );
-    double time = 0;
-    err = nc_put_vara_double( ncid, tvarID, start, count, &time);
-    err = nc_put_vara_double( ncid, EtimevarID, start, count, &time);
+        err = file::put_vara( ncid, dataIDs[4], start, count, transferH, p.output_bits);
+        err = nc_put_vara_double( ncid, tvarID, start, count, &time);
+        err = nc_put_vara_double( ncid, EtimevarID, start, count, &time);
 
-    size_t Estart[] = {0};
-    size_t Ecount[] = {1};
-    double energy0 = feltor.energy(), mass0 = feltor.mass(), E0 = energy0, mass = mass0, E1 = 0.0, dEdt = 0., diss = 0., aligned=0, accuracy=0.;
-    std::vector<double> evec = feltor.energy_vector();
-    err = nc_put_vara_double( ncid, energyID, Estart, Ecount, &energy0);
-    err = nc_put_vara_double( ncid, massID,   Estart, Ecount, &mass0);
-    for( unsigned i=0; i<5; i++)
-        err = nc_put_vara_double( ncid, energyIDs[i], Estart, Ecount, &evec[i]);
+        energy0 = E0, mass0 = mass;
+        err = nc_put_vara_double( ncid, energyID, Estart, Ecount, &energy0);
+        err = nc_put_vara_double( ncid, massID,   Estart, Ecount, &mass0);
+        for( unsigned i=0; i<5; i++)
+            err = nc_put_vara_double( ncid, energyIDs[i], Estart, Ecount, &evec[i]);
 
-    err = nc_put_vara_double( ncid, dissID,     Estart, Ecount,&diss);
-    err = nc_put_vara_double( ncid, alignedID,  Estart, Ecount,&aligned);
-    err = nc_put_vara_double( ncid, dEdtID,     Estart, Ecount,&dEdt);
-    err = nc_put_vara_double( ncid, accuracyID, Estart, Ecount,&accuracy);
-    //probe
+        err = nc_put_vara_double( ncid, dissID,     Estart, Ecount,&diss);
+        err = nc_put_vara_double( ncid, alignedID,  Estart, Ecount,&aligned);
+        err = nc_put_vara_double( ncid, dEdtID,     Estart, Ecount,&dEdt);
+        err = nc_put_vara_double( ncid, accuracyID, Estart, Ecount,&accuracy);
+        //probe
 
-    dg::blas2::gemv(probeinterp,y0[0],probevalue);
-    double Nep= probevalue[0] ;
-    dg::blas2::gemv(probeinterp,feltor.potential()[0],probevalue);
-    double phip=probevalue[0] ;
-    err = nc_put_vara_double( ncid, NepID,      Estart, Ecount,&Nep);
-    err = nc_put_vara_double( ncid, phipID,     Estart, Ecount,&phip);
-    err = nc_close(ncid);
-    std::cout << "First write successful!\n";
+        dg::blas2::gemv(probeinterp,y0[0],probevalue);
+        Nep= probevalue[0] ;
+        dg::blas2::gemv(probeinterp,feltor.potential()[0],probevalue);
+        phip=probevalue[0] ;
+        err = nc_put_vara_double( ncid, NepID,      Estart, Ecount,&Nep);
+        err = nc_put_vara_double( ncid, phipID,     Estart, Ecount,&phip);
+        std::cout << "First write successful!\n";
+    }
+    //the file stays open, all further output is written on a background thread
+    file::AsyncWriter writer( ncid);
     ///////////////////////////////////////Timeloop/////////////////////////////////
     dg::Timer t;
     t.tic();
-    unsigned step = 0;
-    for( unsigned i=1; i<=p.maxout; i++)
+    for( unsigned i=output+1; i<=p.maxout; i++)
     {
 
 #ifdef DG_BENCHMARK
@@ -211,43 +272,51 @@ int main( int argc, char* argv[])
 #endif//DG_BENCHMARK
         for( unsigned j=0; j<p.itstp; j++)
         {
-            try{ karniadakis.step( feltor, rolkar, time, y0);}
+            try{
+                dg::ProfileScope scope( "step");
+                //energies are needed only for dEdt at the last step before an output
+                feltor.compute_energies( j+2 >= p.itstp);
+                karniadakis.step( feltor, rolkar, time, y0);
+            }
             catch( dg::Fail& fail) { 
                 std::cerr << "CG failed to converge to "<<fail.epsilon()<<"\n";
                 std::cerr << "Does Simulation respect CFL condition?\n";
+                writer.flush();
                 err = nc_close(ncid);
                 return -1;
             }
             step++;
             time+=p.dt;
-            Estart[0] = step;
+            if( j+2 < p.itstp)
+                continue;
             E1 = feltor.energy(), mass = feltor.mass(), diss = feltor.energy_diffusion();
             dEdt = (E1 - E0)/p.dt; 
             E0 = E1;
             accuracy = 2.*fabs( (dEdt-diss)/(dEdt + diss));
+            if( j+1 < p.itstp)
+                continue;
+            Estart[0] = i;
             evec = feltor.energy_vector();
-            err = nc_open(argv[3], NC_WRITE, &ncid);
-            err = nc_put_vara_double( ncid, EtimevarID, Estart, Ecount, &time);
-            err = nc_put_vara_double( ncid, energyID, Estart, Ecount, &E1);
-            err = nc_put_vara_double( ncid, massID,   Estart, Ecount, &mass);
+            writer.put_var1( EtimevarID, Estart[0], time);
+            writer.put_var1( energyID,   Estart[0], E1);
+            writer.put_var1( massID,     Estart[0], mass);
             for( unsigned i=0; i<5; i++)
-                err = nc_put_vara_double( ncid, energyIDs[i], Estart, Ecount, &evec[i]);
-            err = nc_put_vara_double( ncid, dissID,     Estart, Ecount,&diss);
-            err = nc_put_vara_double( ncid, alignedID,  Estart, Ecount,&aligned);
-            err = nc_put_vara_double( ncid, dEdtID,     Estart, Ecount,&dEdt);
-            err = nc_put_vara_double( ncid, accuracyID, Estart, Ecount,&accuracy);
+                writer.put_var1( energyIDs[i], Estart[0], evec[i]);
+            writer.put_var1( dissID,     Estart[0], diss);
+            writer.put_var1( alignedID,  Estart[0], aligned);
+            writer.put_var1( dEdtID,     Estart[0], dEdt);
+            writer.put_var1( accuracyID, Estart[0], accuracy);
 
             dg::blas2::gemv(probeinterp,y0[0],probevalue);
             Nep= probevalue[0] ;
             dg::blas2::gemv(probeinterp,feltor.potential()[0],probevalue);
             phip=probevalue[0] ;
-            err = nc_put_vara_double( ncid, NepID,      Estart, Ecount,&Nep);
-            err = nc_put_vara_double( ncid, phipID,     Estart, Ecount,&phip);
+            writer.put_var1( NepID,      Estart[0], Nep);
+            writer.put_var1( phipID,     Estart[0], phip);
 
             std::cout << "(m_tot-m_0)/m_0: "<< (feltor.mass()-mass0)/mass0<<"\t";
             std::cout << "(E_tot-E_0)/E_0: "<< (E1-energy0)/energy0<<"\t";
             std::cout <<" d E/dt = " << dEdt <<" Lambda = " << diss << " -> Accuracy: "<< accuracy << "\n";
-            err = nc_close(ncid);
 
         }
 #ifdef DG_BENCHMARK
@@ -257,32 +326,55 @@ int main( int argc, char* argv[])
         ti.tic();
 #endif//DG_BENCHMARK
         //////////////////////////write fields////////////////////////
+        dg::ProfileScope scope( "output", 5.*transferD.size()*sizeof(double));
         start[0] = i;
-        err = nc_open(argv[3], NC_WRITE, &ncid);
         for( unsigned j=0; j<4; j++)
         {
             dg::blas2::symv( interpolate, y0[j], transferD);
-            dg::blas1::transfer( transferD, transferH);
-            err = nc_put_vara_double( ncid, dataIDs[j], start, count, transferH.data());
+            writer.put_vara( dataIDs[j], start, count, transferD, p.output_bits);
         }
         transfer = feltor.potential()[0];
         dg::blas2::symv( interpolate, transfer, transferD);
-        dg::blas1::transfer( transferD, transferH);
-        err = nc_put_vara_double( ncid, dataIDs[4], start, count, transferH.data() );
-        err = nc_put_vara_double( ncid, tvarID, start, count, &time);
-        err = nc_close(ncid);
+        writer.put_vara( dataIDs[4], start, count, transferD, p.output_bits);
+        writer.put_var1( tvarID, i, time);
+        if( (p.checkpoint_every > 0 && i%p.checkpoint_every == 0) || i == p.maxout)
+        {
+            dg::ProfileScope scope( "checkpoint");
+            //the checkpoint uses netcdf on this thread and refers to the records written so far
+            writer.flush();
+            err = nc_sync( ncid);
+            file::Checkpoint chk( checkpoint, NC_CLOBBER);
+            chk.put( "time", time);
+            chk.put( "output", (double)i), chk.put( "step", (double)step);
+            chk.put( "energy0", energy0), chk.put( "mass0", mass0);
+            chk.put( "y0", y0);
+            karniadakis.save_state( chk, "karniadakis");
+            feltor.save_state( chk, "feltor");
+        }
 #ifdef DG_BENCHMARK
         ti.toc();
         std::cout << "\n\t Time for output: "<<ti.diff()<<"s\n\n"<<std::flush;
 #endif//DG_BENCHMARK
     }
+    writer.flush();
+    err = nc_close(ncid);
     t.toc();
+    if( p.profile)
+    {
+        std::ostringstream os;
+        dg::profiler().write_json( os);
+        std::string profile = os.str();
+        err = nc_open( argv[3], NC_WRITE, &ncid);
+        err = nc_redef( ncid);
+        err = nc_put_att_text( ncid, NC_GLOBAL, "profile", profile.size(), profile.data());
+        err = nc_close( ncid);
+    }
     unsigned hour = (unsigned)floor(t.diff()/3600);
     unsigned minute = (unsigned)floor( (t.diff() - hour*3600)/60);
     double second = t.diff() - hour*3600 - minute*60;
     std::cout << std::fixed << std::setprecision(2) <<std::setfill('0');
     std::cout <<"Computation Time \t"<<hour<<":"<<std::setw(2)<<minute<<":"<<second<<"\n";
-    std::cout <<"which is         \t"<<t.diff()/p.itstp/p.maxout<<"s/step\n";
+    std::cout <<"which is         \t"<<t.diff()/p.itstp/(p.maxout-output)<<"s/step\n";
 
     return 0;
 
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <vector>
 #include <sstream>
 #include <cmath>
@@ -8,6 +9,8 @@
 
 #include "netcdf_par.h" //exclude if par netcdf=OFF
 #include "file/nc_utilities.h"
+#include "file/parallel_writer.h"
+#include "file/checkpoint.h"
 
 #include "feltor.cuh"
 
@@ -17,6 +20,9 @@
         the parallel netcdf output 
     - pay attention that both the grid dimensions as well as the 
         output dimensions must be divisible by the mpi process numbers
+    - writes the full state to outputfile.chk every checkpoint_every outputs (and at the end) and
+        continues from a given restartfile (bit-for-bit, with the same number of processes);
+        the outputfile of the run that wrote the restartfile is then appended from the stored output on
 */
 
 int main( int argc, char* argv[])
@@ -55,9 +61,9 @@ int main( int argc, char* argv[])
     Json::CharReaderBuilder parser;
     parser["collectComments"] = false;
     std::string errs;
-    if( argc != 4)
+    if( argc != 4 && argc != 5)
     {
-        if(rank==0)std::cerr << "ERROR: Wrong number of arguments!\nUsage: "<< argv[0]<<" [inputfile] [geomfile] [outputfile]\n";
+        if(rank==0)std::cerr << "ERROR: Wrong number of arguments!\nUsage: "<< argv[0]<<" [inputfile] [geomfile] [outputfile] ([restartfile])\n";
         return -1;
     }
     else 
@@ -71,6 +77,7 @@ int main( int argc, char* argv[])
     const dg::geo::solovev::Parameters gp(gs);
     if(rank==0)p.display( std::cout);
     if(rank==0)gp.display( std::cout);
+    dg::profiler().set_enabled( p.profile);
     std::string input = js.toStyledString(), geom = gs.toStyledString();
     ////////////////////////////////set up computations///////////////////////////
     
@@ -127,75 +134,113 @@ int main( int argc, char* argv[])
     dg::blas1::axpby( 0., y0[3], 0., y0[3]); //set Ui = 0
     
     dg::Karniadakis< std::vector<dg::MDVec> > karniadakis( y0, y0[0].size(), p.eps_time);
-    karniadakis.init( feltor, rolkar, 0., y0, p.dt);
-    /////////////////////////////set up netcdf/////////////////////////////////
-    file::NC_Error_Handle err;
-    int ncid;
-    MPI_Info info = MPI_INFO_NULL;
-    err = nc_create_par( argv[3], NC_NETCDF4|NC_MPIIO|NC_CLOBBER, comm, info, &ncid); //MPI ON
-    //err = nc_create( argv[3],NC_NETCDF4|NC_CLOBBER, &ncid); //MPI OFF
-
-    err = nc_put_att_text( ncid, NC_GLOBAL, "inputfile", input.size(), input.data());
-    err = nc_put_att_text( ncid, NC_GLOBAL, "geomfile",  geom.size(), geom.data());
-    int dimids[4], tvarID;
+    double time = 0, energy0 = 0, mass0 = 0;
+    //index of the last output (also the record index of the energies) and the number of steps
+    unsigned output = 0, step = 0;
+    const bool restart = (argc == 5);
+    if( restart)
     {
-        dg::geo::TokamakMagneticField c = dg::geo::createSolovevField(gp);
-        err = file::define_dimensions( ncid, dimids, &tvarID, grid_out.global());
-        dg::geo::FieldR fieldR(c);
-        dg::geo::FieldZ fieldZ(c);
-        dg::geo::FieldP fieldP(c);
-        dg::HVec vecR = dg::evaluate( fieldR, grid_out.global());
-        dg::HVec vecZ = dg::evaluate( fieldZ, grid_out.global());
-        dg::HVec vecP = dg::evaluate( fieldP, grid_out.global());
-        int vecID[3];
-        err = nc_def_var( ncid, "BR", NC_DOUBLE, 3, &dimids[1], &vecID[0]);
-        err = nc_def_var( ncid, "BZ", NC_DOUBLE, 3, &dimids[1], &vecID[1]);
-        err = nc_def_var( ncid, "BP", NC_DOUBLE, 3, &dimids[1], &vecID[2]);
-        err = nc_enddef( ncid);
-        err = nc_put_var_double( ncid, vecID[0], vecR.data());
-        err = nc_put_var_double( ncid, vecID[1], vecZ.data());
-        err = nc_put_var_double( ncid, vecID[2], vecP.data());
-        err = nc_redef(ncid);
+        if(rank==0)std::cout << "Restart from "<<argv[4]<<"\n";
+        file::Checkpoint chk( argv[4], NC_NOWRITE, comm);
+        double index;
+        chk.get( "time", time);
+        chk.get( "output", index), output = (unsigned)index;
+        chk.get( "step", index), step = (unsigned)index;
+        chk.get( "energy0", energy0), chk.get( "mass0", mass0);
+        chk.get( "y0", y0);
+        karniadakis.load_state( chk, "karniadakis");
+        feltor.load_state( chk, "feltor");
     }
-
-    //field IDs 
+    else
+        karniadakis.init( feltor, rolkar, time, y0, p.dt);
+    const std::string checkpoint = std::string( argv[3]) + ".chk";
+    /////////////////////////////set up netcdf/////////////////////////////////
+    file::NC_Error_Handle err;
+    //the output of all processes on p.nodes_per_writer nodes is written by one process
+    //(a restarted run continues the output file of the run that wrote the checkpoint)
+    file::ParallelWriter writer( argv[3], comm, p.nodes_per_writer, restart ? NC_WRITE : NC_CLOBBER);
+    const int ncid = writer.ncid();
+    file::VariableOptions field_opt;
+    field_opt.deflate = p.output_deflate, field_opt.shuffle = p.output_deflate > 0;
+    field_opt.bits = p.output_bits, field_opt.single_precision = p.output_float;
+    //by default one plane per chunk
+    const size_t planeNy = grid_out.n()*grid_out.global().Ny(), planeNx = grid_out.n()*grid_out.global().Nx();
+    field_opt.chunks = {1, 1,
+        p.output_chunk_Ny == 0 ? planeNy : std::min<size_t>( p.output_chunk_Ny, planeNy),
+        p.output_chunk_Nx == 0 ? planeNx : std::min<size_t>( p.output_chunk_Nx, planeNx)};
     std::string names[5] = {"electrons", "ions", "Ue", "Ui", "potential"}; 
     int dataIDs[5]; //VARIABLE IDS
-    for( unsigned i=0; i<5; i++)
-        err = nc_def_var( ncid, names[i].data(), NC_DOUBLE, 4, dimids, &dataIDs[i]);
-    //energy IDs 
-    int EtimeID, EtimevarID;
-    err = file::define_time( ncid, "energy_time", &EtimeID, &EtimevarID);
-    int energyID, massID, energyIDs[5], dissID, alignedID, dEdtID, accuracyID;
-    err = nc_def_var( ncid, "energy",   NC_DOUBLE, 1, &EtimeID, &energyID);
-    err = nc_def_var( ncid, "mass",   NC_DOUBLE, 1, &EtimeID, &massID);
     std::string energies[5] = {"Se", "Si", "Uperp", "Upare", "Upari"}; 
-    for( unsigned i=0; i<5; i++)
-        err = nc_def_var( ncid, energies[i].data(), NC_DOUBLE, 1, &EtimeID, &energyIDs[i]);
-    err = nc_def_var( ncid, "dissipation",   NC_DOUBLE, 1, &EtimeID, &dissID);
-    err = nc_def_var( ncid, "alignment",   NC_DOUBLE, 1, &EtimeID, &alignedID);
-    err = nc_def_var( ncid, "dEdt",     NC_DOUBLE, 1, &EtimeID, &dEdtID);
-    err = nc_def_var( ncid, "accuracy", NC_DOUBLE, 1, &EtimeID, &accuracyID);
-    //probe vars definition
+    int tvarID = 0, EtimevarID = 0;
+    int energyID, massID, energyIDs[5], dissID, alignedID, dEdtID, accuracyID;
     int NepID,phipID;
-    err = nc_def_var( ncid, "Ne_p",     NC_DOUBLE, 1, &EtimeID, &NepID);
-    err = nc_def_var( ncid, "phi_p",    NC_DOUBLE, 1, &EtimeID, &phipID);  
-    for(unsigned i=0; i<5; i++)
+    if( restart)
     {
-        err = nc_var_par_access( ncid, energyIDs[i], NC_COLLECTIVE);
-        err = nc_var_par_access( ncid, dataIDs[i], NC_COLLECTIVE);
+        for( unsigned i=0; i<5; i++)
+            dataIDs[i] = writer.inq_var( names[i].data(), field_opt);
+        for( unsigned i=0; i<5; i++)
+            energyIDs[i] = writer.inq_var( energies[i].data());
+        tvarID     = writer.inq_var( "time");
+        EtimevarID = writer.inq_var( "energy_time");
+        energyID   = writer.inq_var( "energy");
+        massID     = writer.inq_var( "mass");
+        dissID     = writer.inq_var( "dissipation");
+        alignedID  = writer.inq_var( "alignment");
+        dEdtID     = writer.inq_var( "dEdt");
+        accuracyID = writer.inq_var( "accuracy");
+        NepID      = writer.inq_var( "Ne_p");
+        phipID     = writer.inq_var( "phi_p");
+    }
+    else
+    {
+        int dimids[4];
+        int EtimeID;
+        if( writer.is_writer())
+        {
+            err = nc_put_att_text( ncid, NC_GLOBAL, "inputfile", input.size(), input.data());
+            err = nc_put_att_text( ncid, NC_GLOBAL, "geomfile",  geom.size(), geom.data());
+            dg::geo::TokamakMagneticField c = dg::geo::createSolovevField(gp);
+            err = file::define_dimensions( ncid, dimids, &tvarID, grid_out.global());
+            dg::geo::FieldR fieldR(c);
+            dg::geo::FieldZ fieldZ(c);
+            dg::geo::FieldP fieldP(c);
+            dg::HVec vecR = dg::evaluate( fieldR, grid_out.global());
+            dg::HVec vecZ = dg::evaluate( fieldZ, grid_out.global());
+            dg::HVec vecP = dg::evaluate( fieldP, grid_out.global());
+            int vecID[3];
+            err = nc_def_var( ncid, "BR", NC_DOUBLE, 3, &dimids[1], &vecID[0]);
+            err = nc_def_var( ncid, "BZ", NC_DOUBLE, 3, &dimids[1], &vecID[1]);
+            err = nc_def_var( ncid, "BP", NC_DOUBLE, 3, &dimids[1], &vecID[2]);
+            err = nc_enddef( ncid);
+            if( rank == 0) //independent access
+            {
+                err = nc_put_var_double( ncid, vecID[0], vecR.data());
+                err = nc_put_var_double( ncid, vecID[1], vecZ.data());
+                err = nc_put_var_double( ncid, vecID[2], vecP.data());
+            }
+            err = nc_redef(ncid);
+            err = file::define_time( ncid, "energy_time", &EtimeID, &EtimevarID);
+        }
+        tvarID = writer.register_var( tvarID);
+        EtimevarID = writer.register_var( EtimevarID);
+
+        //field IDs 
+        for( unsigned i=0; i<5; i++)
+            dataIDs[i] = writer.def_var( names[i].data(), 4, dimids, field_opt);
+        //energy IDs 
+        energyID = writer.def_var( "energy", 1, &EtimeID);
+        massID   = writer.def_var( "mass",   1, &EtimeID);
+        for( unsigned i=0; i<5; i++)
+            energyIDs[i] = writer.def_var( energies[i].data(), 1, &EtimeID);
+        dissID     = writer.def_var( "dissipation", 1, &EtimeID);
+        alignedID  = writer.def_var( "alignment",   1, &EtimeID);
+        dEdtID     = writer.def_var( "dEdt",        1, &EtimeID);
+        accuracyID = writer.def_var( "accuracy",    1, &EtimeID);
+        //probe vars definition
+        NepID  = writer.def_var( "Ne_p",  1, &EtimeID);
+        phipID = writer.def_var( "phi_p", 1, &EtimeID);
+        writer.enddef();
     }
-    err = nc_var_par_access( ncid, tvarID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, EtimevarID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, energyID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, massID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, dissID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, alignedID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, dEdtID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, accuracyID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, NepID, NC_COLLECTIVE);
-    err = nc_var_par_access( ncid, phipID, NC_COLLECTIVE);
-    err = nc_enddef(ncid);
     ///////////////////////////////////PROBE//////////////////////////////
     const dg::HVec Xprobe(1,gp.R_0+p.boxscaleRp*gp.a);
     const dg::HVec Zprobe(1,0.);
@@ -206,60 +251,57 @@ int main( int argc, char* argv[])
         probeinterp=dg::create::interpolation( Xprobe,Zprobe,Phiprobe,grid.local(), dg::NEU);
     dg::DVec probevalue(1,0.);  
     ///////////////////////////first output/////////////////////////////////
-    if(rank==0)std::cout << "First output ... \n";
     int dims[3],  coords[3];
     MPI_Cart_get( comm, 3, dims, periods, coords);
     size_t count[4] = {1, grid_out.local().Nz(), grid_out.n()*(grid_out.local().Ny()), grid_out.n()*(grid_out.local().Nx())};
     size_t start[4] = {0, coords[2]*count[1], coords[1]*count[2], coords[0]*count[3]};
     dg::MDVec transfer( dg::evaluate(dg::zero, grid));
     dg::DVec transferD( dg::evaluate(dg::zero, grid_out.local()));
-    dg::HVec transferH( dg::evaluate(dg::zero, grid_out.local()));
     dg::IDMatrix interpolate = dg::create::interpolation( grid_out.local(), grid.local()); //create local interpolation matrix
-    for( unsigned i=0; i<4; i++)
+    double E0 = feltor.energy(), mass = feltor.mass(), E1 = 0.0, dEdt = 0., diss = 0., aligned=0, accuracy=0.;
+    std::vector<double> evec = feltor.energy_vector();
+    double Nep=0, phip=0;
+    if( !restart) //a restarted run continues after the output of the checkpoint
     {
-        dg::blas2::gemv( interpolate, y0[i].data(), transferD);
-        dg::blas1::transfer( transferD, transferH);
-        err = nc_put_vara_double( ncid, dataIDs[i], start, count, transferH.data() );
-    }
-    transfer = feltor.potential()[0];
-    dg::blas2::gemv( interpolate, transfer.data(), transferD);
-    dg::blas1::transfer( transferD, transferH);
-    err = nc_put_vara_double( ncid, dataIDs[4], start, count, transferH.data());
-    double time = 0;
-    err = nc_put_vara_double( ncid, tvarID, start, count, &time);
-    err = nc_put_vara_double( ncid, EtimevarID, start, count, &time);
+        if(rank==0)std::cout << "First output ... \n";
+        for( unsigned i=0; i<4; i++)
+        {
+            dg::blas2::gemv( interpolate, y0[i].data(), transferD);
+            writer.put_vara( dataIDs[i], start, count, transferD);
+        }
+        transfer = feltor.potential()[0];
+        dg::blas2::gemv( interpolate, transfer.data(), transferD);
+        writer.put_vara( dataIDs[4], start, count, transferD);
+        writer.put_var1( tvarID, 0, time);
+        writer.put_var1( EtimevarID, 0, time);
 
-    size_t Estart[] = {0};
-    size_t Ecount[] = {1};
-    double energy0 = feltor.energy(), mass0 = feltor.mass(), E0 = energy0, mass = mass0, E1 = 0.0, dEdt = 0., diss = 0., aligned=0, accuracy=0.;
-    std::vector<double> evec = feltor.energy_vector();
-    err = nc_put_vara_double( ncid, energyID, Estart, Ecount, &energy0);
-    err = nc_put_vara_double( ncid, massID,   Estart, Ecount, &mass0);
-    for( unsigned i=0; i<5; i++)
-        err = nc_put_vara_double( ncid, energyIDs[i], Estart, Ecount, &evec[i]);
+        energy0 = E0, mass0 = mass;
+        writer.put_var1( energyID, 0, energy0);
+        writer.put_var1( massID,   0, mass0);
+        for( unsigned i=0; i<5; i++)
+            writer.put_var1( energyIDs[i], 0, evec[i]);
 
-    err = nc_put_vara_double( ncid, dissID,     Estart, Ecount,&diss);
-    err = nc_put_vara_double( ncid, alignedID,  Estart, Ecount,&aligned);
-    err = nc_put_vara_double( ncid, dEdtID,     Estart, Ecount,&dEdt);
-    err = nc_put_vara_double( ncid, accuracyID, Estart, Ecount,&accuracy);
-    //probe
-    double Nep=0, phip=0;
-    if(rank==probeRANK) {
-        dg::blas2::gemv(probeinterp,y0[0].data(),probevalue);
-        Nep=probevalue[0] ;
-        dg::blas2::gemv(probeinterp,feltor.potential()[0].data(),probevalue);
-        phip=probevalue[0] ;
+        writer.put_var1( dissID,     0, diss);
+        writer.put_var1( alignedID,  0, aligned);
+        writer.put_var1( dEdtID,     0, dEdt);
+        writer.put_var1( accuracyID, 0, accuracy);
+        //probe
+        if(rank==probeRANK) {
+            dg::blas2::gemv(probeinterp,y0[0].data(),probevalue);
+            Nep=probevalue[0] ;
+            dg::blas2::gemv(probeinterp,feltor.potential()[0].data(),probevalue);
+            phip=probevalue[0] ;
+        }
+        MPI_Bcast( &Nep,1 , MPI_DOUBLE, probeRANK, grid.communicator());
+        MPI_Bcast( &phip,1 , MPI_DOUBLE, probeRANK, grid.communicator());
+        writer.put_var1( NepID,  0, Nep);
+        writer.put_var1( phipID, 0, phip);
+        if(rank==0)std::cout << "First write successful!\n";
     }
-    MPI_Bcast( &Nep,1 , MPI_DOUBLE, probeRANK, grid.communicator());
-    MPI_Bcast( &phip,1 , MPI_DOUBLE, probeRANK, grid.communicator());
-    err = nc_put_vara_double( ncid, NepID,      Estart, Ecount,&Nep);
-    err = nc_put_vara_double( ncid, phipID,     Estart, Ecount,&phip);
-    if(rank==0)std::cout << "First write successful!\n";
     ///////////////////////////////////////Timeloop/////////////////////////////////
     dg::Timer t;
     t.tic();
-    unsigned step = 0;
-    for( unsigned i=1; i<=p.maxout; i++)
+    for( unsigned i=output+1; i<=p.maxout; i++)
     {
 
 #ifdef DG_BENCHMARK
@@ -268,30 +310,38 @@ int main( int argc, char* argv[])
 #endif//DG_BENCHMARK
         for( unsigned j=0; j<p.itstp; j++)
         {
-            try{ karniadakis.step( feltor, rolkar, time, y0);}
+            try{
+                dg::ProfileScope scope( "step");
+                //energies are needed only for dEdt at the last step before an output
+                feltor.compute_energies( j+2 >= p.itstp);
+                karniadakis.step( feltor, rolkar, time, y0);
+            }
             catch( dg::Fail& fail) { 
                 if(rank==0)std::cerr << "CG failed to converge to "<<fail.epsilon()<<"\n";
                 if(rank==0)std::cerr << "Does Simulation respect CFL condition?"<<std::endl;
-                err = nc_close(ncid);
+                writer.close();
                 MPI_Finalize();
                 return -1;
             }
             step++;
-            Estart[0] = step;
+            if( j+2 < p.itstp)
+                continue;
             E1 = feltor.energy(), mass = feltor.mass(), diss = feltor.energy_diffusion();
             dEdt = (E1 - E0)/p.dt; 
             E0 = E1;
             accuracy = 2.*fabs( (dEdt-diss)/(dEdt + diss));
+            if( j+1 < p.itstp)
+                continue;
             evec = feltor.energy_vector();
-            err = nc_put_vara_double( ncid, EtimevarID, Estart, Ecount, &time);
-            err = nc_put_vara_double( ncid, energyID, Estart, Ecount, &E1);
-            err = nc_put_vara_double( ncid, massID,   Estart, Ecount, &mass);
-            for( unsigned i=0; i<5; i++)
-                err = nc_put_vara_double( ncid, energyIDs[i], Estart, Ecount, &evec[i]);
-            err = nc_put_vara_double( ncid, dissID,     Estart, Ecount,&diss);
-            err = nc_put_vara_double( ncid, alignedID,  Estart, Ecount,&aligned);
-            err = nc_put_vara_double( ncid, dEdtID,     Estart, Ecount,&dEdt);
-            err = nc_put_vara_double( ncid, accuracyID, Estart, Ecount,&accuracy);
+            writer.put_var1( EtimevarID, i, time);
+            writer.put_var1( energyID, i, E1);
+            writer.put_var1( massID,   i, mass);
+            for( unsigned k=0; k<5; k++)
+                writer.put_var1( energyIDs[k], i, evec[k]);
+            writer.put_var1( dissID,     i, diss);
+            writer.put_var1( alignedID,  i, aligned);
+            writer.put_var1( dEdtID,     i, dEdt);
+            writer.put_var1( accuracyID, i, accuracy);
             if(rank==probeRANK)
             {
                 dg::blas2::gemv(probeinterp,y0[0].data(),probevalue);
@@ -301,8 +351,8 @@ int main( int argc, char* argv[])
             }
             MPI_Bcast( &Nep, 1 ,MPI_DOUBLE, probeRANK, grid.communicator());
             MPI_Bcast( &phip,1 ,MPI_DOUBLE, probeRANK, grid.communicator());
-            err = nc_put_vara_double( ncid, NepID,      Estart, Ecount,&Nep);
-            err = nc_put_vara_double( ncid, phipID,     Estart, Ecount,&phip);
+            writer.put_var1( NepID,  i, Nep);
+            writer.put_var1( phipID, i, phip);
             if(rank==0)std::cout << "(m_tot-m_0)/m_0: "<< (feltor.mass()-mass0)/mass0<<"\t";
             if(rank==0)std::cout << "(E_tot-E_0)/E_0: "<< (E1-energy0)/energy0<<"\t";
             if(rank==0)std::cout <<" d E/dt = " << dEdt <<" Lambda = " << diss << " -> Accuracy: "<< accuracy << "\n";
@@ -315,18 +365,31 @@ int main( int argc, char* argv[])
 #endif//DG_BENCHMARK
         //err = nc_open_par( argv[3], NC_WRITE|NC_MPIIO, comm, info, &ncid); //dont do it
         //////////////////////////write fields////////////////////////
+        dg::ProfileScope scope( "output", 5.*transferD.size()*sizeof(double));
         start[0] = i;
         for( unsigned j=0; j<4; j++)
         {
             dg::blas2::gemv( interpolate, y0[j].data(), transferD);
-            dg::blas1::transfer( transferD, transferH);
-            err = nc_put_vara_double( ncid, dataIDs[j], start, count, transferH.data());
+            writer.put_vara( dataIDs[j], start, count, transferD);
         }
         transfer = feltor.potential()[0];
         dg::blas2::gemv( interpolate, transfer.data(), transferD);
-        dg::blas1::transfer( transferD, transferH);
-        err = nc_put_vara_double( ncid, dataIDs[4], start, count, transferH.data() );
-        err = nc_put_vara_double( ncid, tvarID, start, count, &time);
+        writer.put_vara( dataIDs[4], start, count, transferD);
+        writer.put_var1( tvarID, i, time);
+        if( (p.checkpoint_every > 0 && i%p.checkpoint_every == 0) || i == p.maxout)
+        {
+            dg::ProfileScope scope( "checkpoint");
+            //the checkpoint refers to the records written so far
+            if( writer.is_writer())
+                err = nc_sync( ncid);
+            file::Checkpoint chk( checkpoint, NC_CLOBBER, comm);
+            chk.put( "time", time);
+            chk.put( "output", (double)i), chk.put( "step", (double)step);
+            chk.put( "energy0", energy0), chk.put( "mass0", mass0);
+            chk.put( "y0", y0);
+            karniadakis.save_state( chk, "karniadakis");
+            feltor.save_state( chk, "feltor");
+        }
 
         //err = nc_close(ncid); DONT DO IT!
 #ifdef DG_BENCHMARK
@@ -340,8 +403,22 @@ int main( int argc, char* argv[])
     double second = t.diff() - hour*3600 - minute*60;
     if(rank==0)std::cout << std::fixed << std::setprecision(2) <<std::setfill('0');
     if(rank==0)std::cout <<"Computation Time \t"<<hour<<":"<<std::setw(2)<<minute<<":"<<second<<"\n";
-    if(rank==0)std::cout <<"which is         \t"<<t.diff()/p.itstp/p.maxout<<"s/step\n";
-    err = nc_close(ncid);
+    if(rank==0)std::cout <<"which is         \t"<<t.diff()/p.itstp/(p.maxout-output)<<"s/step\n";
+    writer.close();
+    if( p.profile)
+    {
+        std::ostringstream os;
+        dg::profiler().write_json( os, comm);
+        std::string profile = os.str();
+        if(rank==0)
+        {
+            int pncid; //the parallel file is closed, reopen it serially
+            err = nc_open( argv[3], NC_WRITE, &pncid);
+            err = nc_redef( pncid);
+            err = nc_put_att_text( pncid, NC_GLOBAL, "profile", profile.size(), profile.data());
+            err = nc_close( pncid);
+        }
+    }
     MPI_Finalize();
 
     return 0;
@@ -20,6 +20,14 @@ struct Parameters
     unsigned Nz_out; //!< \# of cells in z-direction in output file
     unsigned itstp; //!< \# of steps between outputs
     unsigned maxout; //!< \# of outputs excluding first
+    unsigned output_deflate; //!< deflate level of the output fields (0 = uncompressed)
+    unsigned output_bits; //!< \# of kept mantissa bits of the output fields (0 = lossless)
+    bool output_float; //!< write the output fields in single precision
+    unsigned output_chunk_Ny; //!< \# of points in y-direction per chunk of the output fields (0 = whole plane)
+    unsigned output_chunk_Nx; //!< \# of points in x-direction per chunk of the output fields (0 = whole plane)
+    unsigned nodes_per_writer; //!< \# of nodes that aggregate their output on one writing process (MPI)
+    bool profile; //!< record timings and solver iterations and store them in the output file
+    unsigned checkpoint_every; //!< \# of outputs between checkpoints (0 = only at the end)
 
     double eps_pol;  //!< accuracy of polarization 
     double jfactor; //jump factor € [1,0.01]
@@ -66,6 +74,14 @@ struct Parameters
         Nz_out  = js["Nz_out"].asUInt();
         itstp   = js["itstp"].asUInt();
         maxout  = js["maxout"].asUInt();
+        output_deflate   = js.get( "output_deflate", 0).asUInt();
+        output_bits      = js.get( "output_bits", 0).asUInt();
+        output_float     = js.get( "output_float", false).asBool();
+        output_chunk_Ny  = js.get( "output_chunk_Ny", 0).asUInt();
+        output_chunk_Nx  = js.get( "output_chunk_Nx", 0).asUInt();
+        nodes_per_writer = js.get( "nodes_per_writer", 1).asUInt();
+        profile          = js.get( "profile", true).asBool();
+        checkpoint_every = js.get( "checkpoint_every", 0).asUInt();
 
         eps_pol     = js["eps_pol"].asDouble();
         jfactor     = js["jumpfactor"].asDouble();
@@ -148,7 +164,14 @@ struct Parameters
             <<"     Ny_out =              "<<Ny_out<<"\n"
             <<"     Nz_out =              "<<Nz_out<<"\n"
             <<"     Steps between output: "<<itstp<<"\n"
-            <<"     Number of outputs:    "<<maxout<<"\n";
+            <<"     Number of outputs:    "<<maxout<<"\n"
+            <<"     Deflate level:        "<<output_deflate<<"\n"
+            <<"     Kept mantissa bits:   "<<output_bits<<"\n"
+            <<"     Single precision:     "<<output_float<<"\n"
+            <<"     Chunk shape (y,x):    "<<output_chunk_Ny<<" "<<output_chunk_Nx<<"\n"
+            <<"     Nodes per writer:     "<<nodes_per_writer<<"\n"
+            <<"     Profiling:            "<<profile<<"\n"
+            <<"     Outputs between checkpoints: "<<checkpoint_every<<"\n";
         os << "Boundary condition is: \n"
             <<"     global BC             =              "<<dg::bc2str(bc)<<"\n"
             <<"     Poloidal limiter      =              "<<pollim<<"\n"